@@ -0,0 +1,70 @@
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <sdlxx/mixer/audio_engine.h>
+
+using namespace std;
+using namespace sdlxx;
+
+namespace {
+
+constexpr int FREQUENCY = 48000;
+constexpr size_t BUFFER_FRAMES = 512;
+constexpr int BUFFERS = 2000;
+
+Sound MakeTone(float frequency, int channels) {
+  vector<float> samples(static_cast<size_t>(FREQUENCY * channels));
+  for (size_t i = 0; i < samples.size(); ++i) {
+    auto frame = static_cast<float>(i / static_cast<size_t>(channels));
+    samples[i] = 0.1F * sin(frame * frequency * 6.2831853F / FREQUENCY);
+  }
+  return Sound(move(samples), channels);
+}
+
+// Mix the voices offline, as the audio callback would, and report the time per buffer
+void Measure(size_t voices, bool pitched) {
+  AudioEngineSettings settings;
+  settings.frequency = FREQUENCY;
+  settings.buffer_frames = BUFFER_FRAMES;
+  settings.voices = voices;
+  settings.open_device = false;
+  AudioEngine engine(settings);
+
+  Sound mono = MakeTone(440, 1);
+  Sound stereo = MakeTone(220, 2);
+  for (size_t i = 0; i < voices; ++i) {
+    VoiceParameters parameters;
+    parameters.volume = 0.5F;
+    parameters.pan = static_cast<float>(i % 21) / 10.0F - 1.0F;
+    parameters.pitch = pitched ? 0.5F + static_cast<float>(i % 16) / 10.0F : 1.0F;
+    parameters.bus = i % 4;
+    parameters.loop = true;
+    engine.Play(i % 2 == 0 ? mono : stereo, parameters);
+  }
+
+  vector<float> output(BUFFER_FRAMES * 2);
+  for (int i = 0; i < BUFFERS; ++i) {
+    engine.Mix(output.data(), BUFFER_FRAMES);
+  }
+  AudioStatistics statistics = engine.GetStatistics();
+  double load = static_cast<double>(statistics.average_mix_time.AsMicroseconds()) /
+                static_cast<double>(statistics.buffer_duration.AsMicroseconds());
+  cout << setw(4) << voices << " voices, " << (pitched ? "pitched " : "original") << ": "
+       << setw(5) << statistics.average_mix_time.AsMicroseconds() << " us average, " << setw(5)
+       << statistics.max_mix_time.AsMicroseconds() << " us max per "
+       << statistics.buffer_duration.AsMicroseconds() << " us buffer, " << fixed
+       << setprecision(2) << load * 100 << "% of a core" << endl;
+}
+
+}  // namespace
+
+int main() {
+  for (size_t voices : {16, 64, 256}) {
+    Measure(voices, false);
+    Measure(voices, true);
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * \file
+ * \brief A self-contained microbenchmark harness.
+ *
+ * A benchmark belongs to a group and has a variant name, so that the sdlxx wrapper and the raw
+ * SDL baseline of the same operation are measured with the same code path and reported side by
+ * side. The harness calibrates the number of iterations, repeats the measurement and reports
+ * the median time per iteration.
+ */
+
+#ifndef SDLXX_BENCHMARKS_BENCHMARK_H
+#define SDLXX_BENCHMARKS_BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sdlxx::bench {
+
+/// Variant name of benchmarks that use the sdlxx wrappers
+constexpr const char* WRAPPER = "sdlxx";
+
+/// Variant name of benchmarks that call SDL directly
+constexpr const char* BASELINE = "SDL";
+
+/**
+ * A state of a running benchmark, that tells the benchmark loop when to stop.
+ *
+ * \code
+ * SDLXX_BENCHMARK(fill_rect, WRAPPER) {
+ *   // Setup
+ *   while (state.KeepRunning()) {
+ *     // Measured code
+ *   }
+ * }
+ * \endcode
+ */
+class State {
+public:
+  explicit State(std::size_t iterations) : remaining(iterations), iterations(iterations) {}
+
+  bool KeepRunning() {
+    if (remaining == iterations) {
+      start = std::chrono::steady_clock::now();
+    }
+    if (remaining == 0) {
+      end = std::chrono::steady_clock::now();
+      return false;
+    }
+    --remaining;
+    return true;
+  }
+
+  std::size_t GetIterations() const { return iterations; }
+
+  /// Mark a benchmark that can not run, for example because a resource is missing
+  void Skip(std::string reason) { skip_reason = std::move(reason); }
+
+  const std::string& GetSkipReason() const { return skip_reason; }
+
+  double GetSeconds() const { return std::chrono::duration<double>(end - start).count(); }
+
+private:
+  std::size_t remaining;
+  std::size_t iterations;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+  std::string skip_reason;
+};
+
+/// Prevent the compiler from removing a computation whose result is not used
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+struct Entry {
+  std::string group;
+  std::string variant;
+  std::function<void(State&)> function;
+};
+
+std::vector<Entry>& GetEntries();
+
+struct Registrar {
+  Registrar(std::string group, std::string variant, std::function<void(State&)> function) {
+    GetEntries().push_back({std::move(group), std::move(variant), std::move(function)});
+  }
+};
+
+}  // namespace sdlxx::bench
+
+#define SDLXX_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define SDLXX_BENCHMARK_CONCAT(a, b) SDLXX_BENCHMARK_CONCAT_IMPL(a, b)
+
+/// Register a benchmark `void(State& state)` of a group with the given variant name
+#define SDLXX_BENCHMARK(group, variant)                                                       \
+  static void SDLXX_BENCHMARK_CONCAT(benchmark_, __LINE__)(sdlxx::bench::State&);             \
+  static const sdlxx::bench::Registrar SDLXX_BENCHMARK_CONCAT(benchmark_registrar_, __LINE__){ \
+      #group, sdlxx::bench::variant, &SDLXX_BENCHMARK_CONCAT(benchmark_, __LINE__)};           \
+  static void SDLXX_BENCHMARK_CONCAT(benchmark_, __LINE__)(sdlxx::bench::State & state)
+
+#endif  // SDLXX_BENCHMARKS_BENCHMARK_H
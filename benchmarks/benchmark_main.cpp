@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+using namespace std;
+using namespace sdlxx::bench;
+
+namespace {
+
+constexpr int REPETITIONS = 5;
+
+// Returns a negative value if the benchmark was skipped
+double MeasureNanoseconds(const Entry& entry, double min_time) {
+  // Grow the number of iterations until a run is long enough to be timed reliably
+  size_t iterations = 1;
+  while (true) {
+    State state(iterations);
+    entry.function(state);
+    if (!state.GetSkipReason().empty()) {
+      cerr << entry.group << "/" << entry.variant << " skipped: " << state.GetSkipReason() << endl;
+      return -1.0;
+    }
+    if (state.GetSeconds() >= min_time / 10 || iterations >= (size_t{1} << 30U)) {
+      double per_iteration = state.GetSeconds() / static_cast<double>(iterations);
+      iterations = max<size_t>(1, static_cast<size_t>(min_time / max(per_iteration, 1e-12)));
+      break;
+    }
+    iterations *= 10;
+  }
+  vector<double> samples;
+  for (int i = 0; i < REPETITIONS; ++i) {
+    State state(iterations);
+    entry.function(state);
+    samples.push_back(state.GetSeconds() * 1e9 / static_cast<double>(iterations));
+  }
+  sort(samples.begin(), samples.end());
+  return samples[samples.size() / 2];
+}
+
+}  // namespace
+
+vector<Entry>& sdlxx::bench::GetEntries() {
+  static vector<Entry> entries;
+  return entries;
+}
+
+int main(int argc, char* argv[]) {
+  string filter;
+  string json;
+  double min_time = 0.1;
+  for (int i = 1; i < argc; ++i) {
+    string argument = argv[i];
+    if (argument == "--filter" && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (argument == "--json" && i + 1 < argc) {
+      json = argv[++i];
+    } else if (argument == "--min-time" && i + 1 < argc) {
+      min_time = stod(argv[++i]);
+    } else {
+      cerr << "Usage: " << argv[0] << " [--filter TEXT] [--json FILE] [--min-time SECONDS]"
+           << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Groups in registration order, with nanoseconds per iteration of every variant
+  vector<string> groups;
+  map<string, map<string, double>> results;
+  try {
+    for (const Entry& entry : GetEntries()) {
+      if (entry.group.find(filter) == string::npos) {
+        continue;
+      }
+      if (find(groups.begin(), groups.end(), entry.group) == groups.end()) {
+        groups.push_back(entry.group);
+      }
+      double nanoseconds = MeasureNanoseconds(entry, min_time);
+      if (nanoseconds >= 0) {
+        results[entry.group][entry.variant] = nanoseconds;
+      }
+    }
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << left << setw(36) << "Benchmark" << right << setw(14) << "sdlxx ns" << setw(14)
+       << "SDL ns" << setw(12) << "Overhead" << endl;
+  cout << fixed << setprecision(1);
+  for (const string& group : groups) {
+    const map<string, double>& variants = results[group];
+    auto wrapper = variants.find(WRAPPER);
+    auto baseline = variants.find(BASELINE);
+    cout << left << setw(36) << group << right << setw(14);
+    if (wrapper != variants.end()) {
+      cout << wrapper->second;
+    } else {
+      cout << "-";
+    }
+    cout << setw(14);
+    if (baseline != variants.end()) {
+      cout << baseline->second;
+    } else {
+      cout << "-";
+    }
+    if (wrapper != variants.end() && baseline != variants.end()) {
+      cout << setw(11) << (wrapper->second / baseline->second - 1.0) * 100 << "%";
+    }
+    cout << endl;
+  }
+
+  if (!json.empty()) {
+    ofstream stream(json);
+    stream << "{\n  \"benchmarks\": [";
+    bool first = true;
+    for (const string& group : groups) {
+      for (const auto& [variant, nanoseconds] : results[group]) {
+        stream << (first ? "\n" : ",\n") << "    {\"name\": \"" << group << "/" << variant
+               << "\", \"unit\": \"ns\", \"value\": " << nanoseconds << "}";
+        first = false;
+      }
+    }
+    stream << "\n  ]\n}\n";
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,431 @@
+#include <vector>
+
+#include <SDL.h>
+#include <sdlxx/core.h>
+
+#include "benchmark.h"
+
+using namespace std;
+using namespace sdlxx;
+using namespace sdlxx::bench;
+
+namespace {
+
+constexpr Dimensions FRAME_SIZE{640, 480};
+
+// Translucent, so that blits and copies of the pattern blend with the destination
+constexpr Color PATTERN_COLOR(0x336699, 200);
+
+// The 64x64 source of the wrapper variants. Surface::Fill() drops the alpha of the color, so
+// the pixels are written through a view.
+Surface MakePattern() {
+  Surface pattern(64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+  Fill(PixelView<PixelFormat::ARGB8888>(pattern), PATTERN_COLOR);
+  return pattern;
+}
+
+// The same source for the raw variants, which the caller frees
+SDL_Surface* MakeRawPattern() {
+  SDL_Surface* pattern = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+  SDL_FillRect(pattern, nullptr,
+               SDL_MapRGBA(pattern->format, PATTERN_COLOR.r, PATTERN_COLOR.g, PATTERN_COLOR.b,
+                           PATTERN_COLOR.a));
+  return pattern;
+}
+
+/**
+ * Surfaces and renderers shared by all benchmarks.
+ *
+ * Both the wrapper and the raw renderer draw to the same surface with the software renderer, so
+ * the difference between the variants is the cost of the wrapper.
+ */
+struct Fixture {
+  SDL_Surface* raw_surface;
+  Surface surface;
+  Surface pattern;
+  SDL_Renderer* raw_renderer;
+  Renderer renderer;
+  SDL_Texture* raw_texture;
+  Texture texture;
+
+  Fixture()
+      : raw_surface(SDL_CreateRGBSurfaceWithFormat(0, FRAME_SIZE.width, FRAME_SIZE.height, 32,
+                                                   SDL_PIXELFORMAT_ARGB8888)),
+        surface(raw_surface),
+        pattern(MakePattern()),
+        raw_renderer(SDL_CreateSoftwareRenderer(raw_surface)),
+        renderer(surface),
+        raw_texture(nullptr),
+        texture(renderer, pattern) {
+    SDL_Surface* raw_pattern = MakeRawPattern();
+    raw_texture = SDL_CreateTextureFromSurface(raw_renderer, raw_pattern);
+    SDL_FreeSurface(raw_pattern);
+  }
+
+  ~Fixture() {
+    SDL_DestroyTexture(raw_texture);
+    SDL_DestroyRenderer(raw_renderer);
+  }
+};
+
+Fixture& GetFixture() {
+  static CoreApi core_api = [] {
+    CoreApi::SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    return CoreApi(CoreApi::Flag::VIDEO | CoreApi::Flag::EVENTS);
+  }();
+  static Fixture fixture;
+  return fixture;
+}
+
+vector<Rectangle> MakeRectangles() {
+  vector<Rectangle> rectangles;
+  for (int i = 0; i < 64; ++i) {
+    rectangles.push_back({(i * 37) % 600, (i * 53) % 440, 16, 16});
+  }
+  return rectangles;
+}
+
+vector<SDL_Rect> MakeRawRectangles() {
+  vector<SDL_Rect> rectangles;
+  for (const Rectangle& r : MakeRectangles()) {
+    rectangles.push_back({r.x, r.y, r.width, r.height});
+  }
+  return rectangles;
+}
+
+vector<Point> MakePoints() {
+  vector<Point> points;
+  for (int i = 0; i < 256; ++i) {
+    points.push_back({(i * 37) % 640, (i * 53) % 480});
+  }
+  return points;
+}
+
+}  // namespace
+
+// Renderer primitives
+
+SDLXX_BENCHMARK(renderer_clear, WRAPPER) {
+  Renderer& renderer = GetFixture().renderer;
+  while (state.KeepRunning()) {
+    renderer.SetDrawColor(Color::BLACK);
+    renderer.Clear();
+  }
+}
+
+SDLXX_BENCHMARK(renderer_clear, BASELINE) {
+  SDL_Renderer* renderer = GetFixture().raw_renderer;
+  while (state.KeepRunning()) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+  }
+}
+
+SDLXX_BENCHMARK(renderer_fill_rectangle_8x8, WRAPPER) {
+  Renderer& renderer = GetFixture().renderer;
+  while (state.KeepRunning()) {
+    renderer.FillRectangle({100, 100, 8, 8});
+  }
+  renderer.Flush();
+}
+
+SDLXX_BENCHMARK(renderer_fill_rectangle_8x8, BASELINE) {
+  SDL_Renderer* renderer = GetFixture().raw_renderer;
+  while (state.KeepRunning()) {
+    SDL_Rect rect{100, 100, 8, 8};
+    SDL_RenderFillRect(renderer, &rect);
+  }
+  SDL_RenderFlush(renderer);
+}
+
+SDLXX_BENCHMARK(renderer_fill_rectangles_64, WRAPPER) {
+  Renderer& renderer = GetFixture().renderer;
+  vector<Rectangle> rectangles = MakeRectangles();
+  while (state.KeepRunning()) {
+    renderer.FillRectangles(rectangles);
+  }
+  renderer.Flush();
+}
+
+SDLXX_BENCHMARK(renderer_fill_rectangles_64, BASELINE) {
+  SDL_Renderer* renderer = GetFixture().raw_renderer;
+  vector<SDL_Rect> rectangles = MakeRawRectangles();
+  while (state.KeepRunning()) {
+    SDL_RenderFillRects(renderer, rectangles.data(), static_cast<int>(rectangles.size()));
+  }
+  SDL_RenderFlush(renderer);
+}
+
+SDLXX_BENCHMARK(renderer_draw_points_256, WRAPPER) {
+  Renderer& renderer = GetFixture().renderer;
+  vector<Point> points = MakePoints();
+  while (state.KeepRunning()) {
+    renderer.DrawPoints(points);
+  }
+  renderer.Flush();
+}
+
+SDLXX_BENCHMARK(renderer_draw_points_256, BASELINE) {
+  SDL_Renderer* renderer = GetFixture().raw_renderer;
+  vector<SDL_Point> points;
+  for (const Point& point : MakePoints()) {
+    points.push_back({point.x, point.y});
+  }
+  while (state.KeepRunning()) {
+    SDL_RenderDrawPoints(renderer, points.data(), static_cast<int>(points.size()));
+  }
+  SDL_RenderFlush(renderer);
+}
+
+SDLXX_BENCHMARK(renderer_draw_line, WRAPPER) {
+  Renderer& renderer = GetFixture().renderer;
+  while (state.KeepRunning()) {
+    renderer.DrawLine({10, 10}, {300, 200});
+  }
+  renderer.Flush();
+}
+
+SDLXX_BENCHMARK(renderer_draw_line, BASELINE) {
+  SDL_Renderer* renderer = GetFixture().raw_renderer;
+  while (state.KeepRunning()) {
+    SDL_RenderDrawLine(renderer, 10, 10, 300, 200);
+  }
+  SDL_RenderFlush(renderer);
+}
+
+SDLXX_BENCHMARK(renderer_copy_64x64, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    fixture.renderer.Copy(fixture.texture, {0, 0, 64, 64}, {200, 200, 64, 64});
+  }
+  fixture.renderer.Flush();
+}
+
+SDLXX_BENCHMARK(renderer_copy_64x64, BASELINE) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    SDL_Rect source{0, 0, 64, 64};
+    SDL_Rect dest{200, 200, 64, 64};
+    SDL_RenderCopy(fixture.raw_renderer, fixture.raw_texture, &source, &dest);
+  }
+  SDL_RenderFlush(fixture.raw_renderer);
+}
+
+// Texture creation
+
+SDLXX_BENCHMARK(texture_from_surface_64x64, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    Texture texture(fixture.renderer, fixture.pattern);
+    DoNotOptimize(texture);
+  }
+}
+
+SDLXX_BENCHMARK(texture_from_surface_64x64, BASELINE) {
+  Fixture& fixture = GetFixture();
+  SDL_Surface* pattern = MakeRawPattern();
+  while (state.KeepRunning()) {
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(fixture.raw_renderer, pattern);
+    DoNotOptimize(texture);
+    SDL_DestroyTexture(texture);
+  }
+  SDL_FreeSurface(pattern);
+}
+
+// Surface operations
+
+SDLXX_BENCHMARK(surface_create_64x64, WRAPPER) {
+  while (state.KeepRunning()) {
+    Surface surface(64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    DoNotOptimize(surface);
+  }
+}
+
+SDLXX_BENCHMARK(surface_create_64x64, BASELINE) {
+  while (state.KeepRunning()) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    DoNotOptimize(surface);
+    SDL_FreeSurface(surface);
+  }
+}
+
+SDLXX_BENCHMARK(surface_copy_640x480, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    Surface copy(fixture.surface);
+    DoNotOptimize(copy);
+  }
+}
+
+SDLXX_BENCHMARK(surface_copy_640x480, BASELINE) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    SDL_Surface* copy = SDL_DuplicateSurface(fixture.raw_surface);
+    DoNotOptimize(copy);
+    SDL_FreeSurface(copy);
+  }
+}
+
+SDLXX_BENCHMARK(surface_blit_64x64, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    fixture.surface.Blit(fixture.pattern, {0, 0, 64, 64}, {100, 100, 64, 64});
+  }
+}
+
+SDLXX_BENCHMARK(surface_blit_64x64, BASELINE) {
+  Fixture& fixture = GetFixture();
+  SDL_Surface* pattern = MakeRawPattern();
+  SDL_SetSurfaceBlendMode(pattern, SDL_BLENDMODE_BLEND);
+  while (state.KeepRunning()) {
+    SDL_Rect source{0, 0, 64, 64};
+    SDL_Rect dest{100, 100, 64, 64};
+    SDL_BlitSurface(pattern, &source, fixture.raw_surface, &dest);
+  }
+  SDL_FreeSurface(pattern);
+}
+
+SDLXX_BENCHMARK(surface_blit_scaled_64_to_128, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    fixture.surface.BlitScaled(fixture.pattern, {0, 0, 64, 64}, {100, 100, 128, 128});
+  }
+}
+
+SDLXX_BENCHMARK(surface_blit_scaled_64_to_128, BASELINE) {
+  Fixture& fixture = GetFixture();
+  SDL_Surface* pattern = MakeRawPattern();
+  SDL_SetSurfaceBlendMode(pattern, SDL_BLENDMODE_BLEND);
+  while (state.KeepRunning()) {
+    SDL_Rect source{0, 0, 64, 64};
+    SDL_Rect dest{100, 100, 128, 128};
+    SDL_BlitScaled(pattern, &source, fixture.raw_surface, &dest);
+  }
+  SDL_FreeSurface(pattern);
+}
+
+SDLXX_BENCHMARK(surface_convert_to_rgb565, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    auto converted = fixture.pattern.ConvertFormat(SDL_PIXELFORMAT_RGB565, 0);
+    DoNotOptimize(converted);
+  }
+}
+
+SDLXX_BENCHMARK(surface_convert_to_rgb565, BASELINE) {
+  SDL_Surface* pattern = MakeRawPattern();
+  while (state.KeepRunning()) {
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(pattern, SDL_PIXELFORMAT_RGB565, 0);
+    DoNotOptimize(converted);
+    SDL_FreeSurface(converted);
+  }
+  SDL_FreeSurface(pattern);
+}
+
+SDLXX_BENCHMARK(surface_fill_rectangles_64, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  vector<Rectangle> rectangles = MakeRectangles();
+  while (state.KeepRunning()) {
+    fixture.surface.FillRectangles(rectangles, Color::RED);
+  }
+}
+
+SDLXX_BENCHMARK(surface_fill_rectangles_64, BASELINE) {
+  Fixture& fixture = GetFixture();
+  vector<SDL_Rect> rectangles = MakeRawRectangles();
+  while (state.KeepRunning()) {
+    Uint32 color = SDL_MapRGBA(fixture.raw_surface->format, 255, 0, 0, 255);
+    SDL_FillRects(fixture.raw_surface, rectangles.data(), static_cast<int>(rectangles.size()),
+                  color);
+  }
+}
+
+// Event queue
+
+SDLXX_BENCHMARK(events_push_poll, WRAPPER) {
+  GetFixture();
+  Event event{};
+  event.type = SDL_USEREVENT;
+  while (state.KeepRunning()) {
+    Events::Push(&event);
+    Events::Poll(&event);
+  }
+}
+
+SDLXX_BENCHMARK(events_push_poll, BASELINE) {
+  GetFixture();
+  SDL_Event event{};
+  event.type = SDL_USEREVENT;
+  while (state.KeepRunning()) {
+    SDL_PushEvent(&event);
+    SDL_PollEvent(&event);
+  }
+}
+
+SDLXX_BENCHMARK(events_add_get_16, WRAPPER) {
+  GetFixture();
+  Event event{};
+  event.type = SDL_USEREVENT;
+  vector<Event> events(16, event);
+  while (state.KeepRunning()) {
+    Events::Add(events);
+    vector<Event> received = Events::Get(16);
+    DoNotOptimize(received);
+  }
+}
+
+SDLXX_BENCHMARK(events_add_get_16, BASELINE) {
+  GetFixture();
+  SDL_Event event{};
+  event.type = SDL_USEREVENT;
+  vector<SDL_Event> events(16, event);
+  vector<SDL_Event> received(16);
+  while (state.KeepRunning()) {
+    SDL_PeepEvents(events.data(), 16, SDL_ADDEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+    SDL_PeepEvents(received.data(), 16, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+    DoNotOptimize(received);
+  }
+}
+
+// Value types
+
+SDLXX_BENCHMARK(color_from_hex, WRAPPER) {
+  uint32_t value = 0x123456;
+  while (state.KeepRunning()) {
+    Color color(value);
+    DoNotOptimize(color);
+    ++value;
+  }
+}
+
+SDLXX_BENCHMARK(color_from_hex, BASELINE) {
+  uint32_t value = 0x123456;
+  while (state.KeepRunning()) {
+    SDL_Color color{static_cast<Uint8>(value >> 16U), static_cast<Uint8>(value >> 8U),
+                    static_cast<Uint8>(value), 255};
+    DoNotOptimize(color);
+    ++value;
+  }
+}
+
+SDLXX_BENCHMARK(rectangle_contains, WRAPPER) {
+  Rectangle rectangle{10, 20, 300, 200};
+  Point point{0, 0};
+  while (state.KeepRunning()) {
+    bool inside = rectangle.Contains(point);
+    DoNotOptimize(inside);
+    point.x = (point.x + 7) % 400;
+    point.y = (point.y + 3) % 300;
+  }
+}
+
+SDLXX_BENCHMARK(rectangle_contains, BASELINE) {
+  SDL_Rect rectangle{10, 20, 300, 200};
+  SDL_Point point{0, 0};
+  while (state.KeepRunning()) {
+    bool inside = SDL_PointInRect(&point, &rectangle) == SDL_TRUE;
+    DoNotOptimize(inside);
+    point.x = (point.x + 7) % 400;
+    point.y = (point.y + 3) % 300;
+  }
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <sdlxx/ecs.h>
+#include <sdlxx/gui/parent_node.h>
+
+using namespace std;
+using namespace sdlxx;
+
+namespace {
+
+constexpr size_t ENTITIES = 100000;
+constexpr int ITERATIONS = 200;
+constexpr Time TIME_STEP = Time::Milliseconds(16);
+
+class Mover : public Node {
+public:
+  Mover(float x, float y, float vx, float vy) : Node("mover"), vx(vx), vy(vy) {
+    ResetTransform({x, y});
+  }
+
+  void Update(Time dt) override {
+    const float seconds = dt.AsSeconds();
+    Transform& transform = GetTransform();
+    transform.x += vx * seconds;
+    transform.y += vy * seconds;
+  }
+
+private:
+  float vx;
+  float vy;
+};
+
+class Root : public ParentNode {
+public:
+  Root() : ParentNode("root") {}
+
+  using ParentNode::AddChild;
+};
+
+template <typename Function>
+void Measure(const char* name, Function&& function) {
+  function();  // Warm up
+  vector<double> samples;
+  samples.reserve(ITERATIONS);
+  for (int i = 0; i < ITERATIONS; ++i) {
+    auto start = chrono::steady_clock::now();
+    function();
+    auto end = chrono::steady_clock::now();
+    samples.push_back(chrono::duration<double, micro>(end - start).count());
+  }
+  sort(samples.begin(), samples.end());
+  double median = samples[samples.size() / 2];
+  cout << name << ": median " << median << " us per pass, " << median * 1000.0 / ENTITIES
+       << " ns per entity (min " << samples.front() << " us, max " << samples.back() << " us)"
+       << endl;
+}
+
+}  // namespace
+
+int main() {
+  // The same pseudo-random initial state for both implementations
+  vector<float> values(ENTITIES * 4);
+  uint32_t seed = 12345;
+  for (float& value : values) {
+    seed = seed * 1664525U + 1013904223U;
+    value = static_cast<float>(seed >> 8U) / static_cast<float>(1U << 24U) * 100.0F;
+  }
+
+  Root root;
+  for (size_t i = 0; i < ENTITIES; ++i) {
+    root.AddChild(make_unique<Mover>(values[i * 4], values[i * 4 + 1], values[i * 4 + 2],
+                                     values[i * 4 + 3]));
+  }
+
+  ECS::World world;
+  for (size_t i = 0; i < ENTITIES; ++i) {
+    world.Create(ECS::Position{values[i * 4], values[i * 4 + 1]},
+                 ECS::Velocity{values[i * 4 + 2], values[i * 4 + 3]});
+  }
+  ECS::Scheduler scheduler;
+  scheduler.Add("movement", ECS::MakeMovementSystem());
+
+  cout << "Updating " << ENTITIES << " entities, " << ITERATIONS << " passes" << endl;
+  Measure("Node tree", [&root] { root.Update(TIME_STEP); });
+  Measure("ECS world", [&] { scheduler.Update(world, TIME_STEP); });
+  return 0;
+}
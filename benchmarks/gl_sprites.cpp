@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <SDL_pixels.h>
+#include <sdlxx/core.h>
+#include <sdlxx/core/gl_renderer.h>
+
+using namespace std;
+using namespace sdlxx;
+
+namespace {
+
+constexpr Dimensions SIZE{1280, 720};
+constexpr double SECONDS_PER_COUNT = 1.0;
+const size_t COUNTS[] = {10000, 50000, 100000, 200000, 500000};
+
+Surface MakeSprite(Color color) {
+  Surface surface(16, 16, 32, SDL_PIXELFORMAT_RGBA32);
+  surface.Fill(Color::TRANSPARENT);
+  surface.FillRectangle({2, 2, 12, 12}, color);
+  return surface;
+}
+
+// Draw frames of the given number of moving, rotated sprites and report the sustained rate
+void Measure(const char* name, size_t count, const function<void(size_t, size_t)>& frame) {
+  size_t frames = 0;
+  auto start = chrono::steady_clock::now();
+  double seconds = 0.0;
+  while (seconds < SECONDS_PER_COUNT || frames < 3) {
+    frame(count, frames++);
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+  double fps = static_cast<double>(frames) / seconds;
+  cout << left << setw(14) << name << right << setw(8) << count << " sprites: " << fixed
+       << setprecision(1) << setw(7) << fps << " FPS, " << setprecision(2) << setw(6)
+       << fps * static_cast<double>(count) / 1e6 << " Msprites/s, "
+       << static_cast<size_t>(fps * static_cast<double>(count) / 60.0)
+       << " sprites per frame at 60 FPS" << endl;
+}
+
+template <typename Sprites, typename Texture>
+void DrawSprites(Sprites& sprites, const Texture& texture, size_t count, size_t frame,
+                 int layers) {
+  for (size_t i = 0; i < count; ++i) {
+    auto x = static_cast<float>((i * 37 + frame * 3) % SIZE.width);
+    auto y = static_cast<float>((i * 11 + frame) % SIZE.height);
+    auto angle = static_cast<float>((i + frame) % 360);
+    if constexpr (is_same_v<Sprites, GL::Renderer>) {
+      sprites.Draw(texture, static_cast<int>(i % layers), {0, 0, 16, 16}, x, y, 16.0F, 16.0F,
+                   angle);
+    } else {
+      sprites.Draw(texture, {0, 0, 16, 16}, x, y, 16.0F, 16.0F, angle);
+    }
+  }
+  sprites.Flush();
+}
+
+void MeasureGl() {
+  GL::Context::SetAttribute(GL::Attribute::CONTEXT_PROFILE_MASK,
+                            static_cast<int>(GL::Profile::CORE));
+  GL::Context::SetAttribute(GL::Attribute::CONTEXT_MAJOR_VERSION, 3);
+  GL::Context::SetAttribute(GL::Attribute::CONTEXT_MINOR_VERSION, 3);
+  Window window("gl_sprites", SIZE, Window::Flag::OPENGL | Window::Flag::HIDDEN);
+  GL::Context context(window);
+  context.MakeCurrent(window);
+  GL::Context::SetSwapInterval(0);
+  GL::Renderer renderer(context, GL::Context::GetDrawableSize(window));
+  GL::Texture texture(renderer, vector<Surface>{MakeSprite(Color::RED), MakeSprite(Color::GREEN),
+                                                MakeSprite(Color::BLUE), MakeSprite(Color::WHITE)});
+  cout << "GL::Renderer: " << (renderer.IsPersistentlyMapped() ? "persistent" : "orphaned")
+       << " streaming buffer" << endl;
+  for (size_t count : COUNTS) {
+    renderer.ResetStatistics();
+    Measure("GL::Renderer", count, [&](size_t count, size_t frame) {
+      renderer.SetDrawColor(Color::BLACK);
+      renderer.Clear();
+      DrawSprites(renderer, texture, count, frame, texture.GetLayerCount());
+      // Wait for the frame, so queued frames are not measured as drawn
+      renderer.GetFunctions().Finish();
+      GL::Context::SwapWindow(window);
+    });
+  }
+}
+
+void MeasureSdl() {
+  Window window("sdl_sprites", SIZE, Window::Flag::HIDDEN);
+  Renderer renderer(window, Renderer::Flag::ACCELERATED);
+  Texture texture(renderer, MakeSprite(Color::WHITE));
+  texture.SetBlendMode(BlendMode::BLEND);
+  SpriteBatch batch(renderer);
+  vector<uint8_t> pixel(4);
+  for (size_t count : COUNTS) {
+    Measure("SpriteBatch", count, [&](size_t count, size_t frame) {
+      renderer.SetDrawColor(Color::BLACK);
+      renderer.Clear();
+      DrawSprites(batch, texture, count, frame, 1);
+      // Reading a pixel waits for the frame
+      renderer.ReadPixels({0, 0, 1, 1}, SDL_PIXELFORMAT_RGBA32, pixel.data(), 4);
+      renderer.RenderPresent();
+    });
+  }
+}
+
+}  // namespace
+
+// Sprites per second of GL::Renderer compared to SpriteBatch on an SDL renderer. Set
+// SDL_VIDEODRIVER=offscreen and LIBGL_ALWAYS_SOFTWARE=1 to measure llvmpipe headlessly.
+int main() {
+  try {
+    CoreApi core(CoreApi::Flag::VIDEO);
+    MeasureGl();
+    MeasureSdl();
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
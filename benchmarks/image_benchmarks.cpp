@@ -0,0 +1,140 @@
+#include <cstdint>
+#include <vector>
+
+#include <SDL.h>
+#include <sdlxx/core.h>
+
+#include "benchmark.h"
+
+using namespace std;
+using namespace sdlxx;
+using namespace sdlxx::bench;
+
+namespace {
+
+constexpr Dimensions k4K{3840, 2160};
+constexpr Dimensions HALF{1920, 1080};
+constexpr Dimensions THUMBNAIL{256, 144};
+
+/**
+ * A 4K frame with a gradient and a grid, shared by all benchmarks.
+ *
+ * Filters do the same work for any content, but a pattern keeps the results checkable.
+ */
+struct Fixture {
+  ThreadPool pool;
+  ImageProcessor processor;
+  Surface frame;
+
+  Fixture() : processor(pool), frame(k4K.width, k4K.height, 32, SDL_PIXELFORMAT_ARGB8888) {
+    auto* pixels = static_cast<uint8_t*>(frame.GetPixels());
+    for (int y = 0; y < k4K.height; ++y) {
+      auto* row = reinterpret_cast<uint32_t*>(pixels + y * frame.GetPitch());
+      for (int x = 0; x < k4K.width; ++x) {
+        uint32_t grid = (x % 64 == 0 || y % 64 == 0) ? 0xFFU : 0x00U;
+        row[x] = 0xFF000000U | static_cast<uint32_t>(x * 255 / k4K.width) << 16U |
+                 static_cast<uint32_t>(y * 255 / k4K.height) << 8U | grid;
+      }
+    }
+  }
+};
+
+Fixture& GetFixture() {
+  static Fixture fixture;
+  return fixture;
+}
+
+void BenchmarkResize(State& state, const Dimensions& size, ResizeFilter filter) {
+  Fixture& fixture = GetFixture();
+  Surface dest(size.width, size.height, 32, SDL_PIXELFORMAT_ARGB8888);
+  while (state.KeepRunning()) {
+    fixture.processor.Resize(fixture.frame, dest, filter);
+  }
+  DoNotOptimize(dest.GetPixels());
+}
+
+}  // namespace
+
+// Resizing from 4K. The SDL variant of the first group is the nearest-neighbor SDL_BlitScaled,
+// which shows the cost of filtering.
+
+SDLXX_BENCHMARK(resize_4k_to_1080p_bilinear, WRAPPER) {
+  BenchmarkResize(state, HALF, ResizeFilter::BILINEAR);
+}
+
+SDLXX_BENCHMARK(resize_4k_to_1080p_bilinear, BASELINE) {
+  const Surface& frame = GetFixture().frame;
+  SDL_Surface* source = SDL_CreateRGBSurfaceWithFormatFrom(
+      const_cast<void*>(frame.GetPixels()), k4K.width, k4K.height, 32, frame.GetPitch(),
+      SDL_PIXELFORMAT_ARGB8888);
+  SDL_Surface* dest =
+      SDL_CreateRGBSurfaceWithFormat(0, HALF.width, HALF.height, 32, SDL_PIXELFORMAT_ARGB8888);
+  SDL_SetSurfaceBlendMode(source, SDL_BLENDMODE_NONE);
+  while (state.KeepRunning()) {
+    SDL_BlitScaled(source, nullptr, dest, nullptr);
+  }
+  DoNotOptimize(dest->pixels);
+  SDL_FreeSurface(dest);
+  SDL_FreeSurface(source);
+}
+
+SDLXX_BENCHMARK(resize_4k_to_1080p_bicubic, WRAPPER) {
+  BenchmarkResize(state, HALF, ResizeFilter::BICUBIC);
+}
+
+SDLXX_BENCHMARK(resize_4k_to_1080p_lanczos, WRAPPER) {
+  BenchmarkResize(state, HALF, ResizeFilter::LANCZOS);
+}
+
+SDLXX_BENCHMARK(resize_4k_to_thumbnail_bilinear, WRAPPER) {
+  BenchmarkResize(state, THUMBNAIL, ResizeFilter::BILINEAR);
+}
+
+SDLXX_BENCHMARK(resize_1080p_to_4k_bicubic, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  Surface source = fixture.processor.Resize(fixture.frame, HALF);
+  Surface dest(k4K.width, k4K.height, 32, SDL_PIXELFORMAT_ARGB8888);
+  while (state.KeepRunning()) {
+    fixture.processor.Resize(source, dest, ResizeFilter::BICUBIC);
+  }
+  DoNotOptimize(dest.GetPixels());
+}
+
+// Blurs of a 4K frame with the sizes of typical drop shadows
+
+SDLXX_BENCHMARK(box_blur_4k_radius_4, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  Surface dest(k4K.width, k4K.height, 32, SDL_PIXELFORMAT_ARGB8888);
+  while (state.KeepRunning()) {
+    fixture.processor.BoxBlur(fixture.frame, dest, 4);
+  }
+  DoNotOptimize(dest.GetPixels());
+}
+
+SDLXX_BENCHMARK(gaussian_blur_4k_sigma_3, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  Surface dest(k4K.width, k4K.height, 32, SDL_PIXELFORMAT_ARGB8888);
+  while (state.KeepRunning()) {
+    fixture.processor.GaussianBlur(fixture.frame, dest, 3.0F);
+  }
+  DoNotOptimize(dest.GetPixels());
+}
+
+SDLXX_BENCHMARK(gaussian_blur_4k_in_place_sigma_3, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  Surface frame = fixture.frame.Clone();
+  while (state.KeepRunning()) {
+    fixture.processor.GaussianBlur(frame, 3.0F);
+  }
+  DoNotOptimize(frame.GetPixels());
+}
+
+// Full mip chain of a 4K frame, down to 1x1
+
+SDLXX_BENCHMARK(mipmaps_4k, WRAPPER) {
+  Fixture& fixture = GetFixture();
+  while (state.KeepRunning()) {
+    vector<Surface> chain = fixture.processor.GenerateMipmaps(fixture.frame);
+    DoNotOptimize(chain.back().GetPixels());
+  }
+}
@@ -0,0 +1,295 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sdlxx/net/message_stream.h>
+#include <sdlxx/net/reactor.h>
+#include <sdlxx/net/socket.h>
+
+using namespace std;
+using namespace sdlxx;
+
+namespace {
+
+constexpr auto DURATION = chrono::seconds(2);
+
+// Connections that are being opened at the same time by the connection benchmark, which runs
+// for a shorter time, so that closed connections do not use up the ephemeral ports
+constexpr size_t CONNECTIONS_IN_FLIGHT = 64;
+constexpr auto CONNECTION_DURATION = chrono::seconds(1);
+
+// Connections and messages in flight per connection of the message benchmark
+constexpr size_t CONNECTIONS = 1000;
+constexpr size_t PIPELINE_DEPTH = 8;
+constexpr size_t MESSAGE_SIZE = 32;
+
+// Connections and messages in flight per connection of the framed message benchmark
+constexpr size_t FRAMED_CONNECTIONS = 100;
+constexpr size_t FRAMED_PIPELINE_DEPTH = 256;
+constexpr size_t FRAMED_MESSAGE_SIZE = 16;
+
+/**
+ * A server that echoes everything it receives, running a reactor on its own thread.
+ *
+ * Clients never have more than a few messages in flight, so the send buffer of a connection
+ * never fills up and the echo does not need to queue data.
+ */
+class EchoServer {
+public:
+  EchoServer() : listener(Address::Loopback(0)) {
+    reactor.Add(listener, IoEvent::READ, [this](BitMask<IoEvent>) { AcceptAll(); });
+    thread = std::thread([this] { reactor.Run(); });
+  }
+
+  ~EchoServer() {
+    reactor.Stop();
+    thread.join();
+  }
+
+  Address GetAddress() const { return listener.GetLocalAddress(); }
+
+private:
+  TcpListener listener;
+  Reactor reactor;
+  unordered_map<int, unique_ptr<TcpSocket>> connections;
+  std::thread thread;
+
+  void AcceptAll() {
+    while (optional<TcpSocket> accepted = listener.Accept()) {
+      auto connection = make_unique<TcpSocket>(std::move(*accepted));
+      TcpSocket* socket = connection.get();
+      reactor.Add(*socket, IoEvent::READ, [this, socket](BitMask<IoEvent>) { Echo(*socket); });
+      connections[socket->GetHandle()] = std::move(connection);
+    }
+  }
+
+  void Echo(TcpSocket& socket) {
+    char buffer[4096];
+    optional<size_t> received = socket.Receive(buffer, sizeof(buffer));
+    if (!received) {
+      return;
+    }
+    if (*received == 0) {
+      int handle = socket.GetHandle();
+      reactor.Remove(socket);
+      connections.erase(handle);
+      return;
+    }
+    size_t sent = 0;
+    while (sent < *received) {
+      sent += socket.Send(buffer + sent, *received - sent).value_or(0);
+    }
+  }
+};
+
+/**
+ * A server that echoes every message it receives with a MessageStream.
+ *
+ * Messages are echoed as views of the receive buffer, and all echoes of one read are sent by
+ * one flush.
+ */
+class FramedEchoServer {
+public:
+  explicit FramedEchoServer(Framing framing) : listener(Address::Loopback(0)), framing(framing) {
+    reactor.Add(listener, IoEvent::READ, [this](BitMask<IoEvent>) { AcceptAll(); });
+    thread = std::thread([this] { reactor.Run(); });
+  }
+
+  ~FramedEchoServer() {
+    reactor.Stop();
+    thread.join();
+  }
+
+  Address GetAddress() const { return listener.GetLocalAddress(); }
+
+private:
+  TcpListener listener;
+  Framing framing;
+  Reactor reactor;
+  unordered_map<int, unique_ptr<MessageStream>> streams;
+  std::thread thread;
+
+  void AcceptAll() {
+    while (optional<TcpSocket> accepted = listener.Accept()) {
+      auto stream = make_unique<MessageStream>(std::move(*accepted), framing);
+      MessageStream* raw = stream.get();
+      reactor.Add(raw->GetSocket(), IoEvent::READ,
+                  [this, raw](BitMask<IoEvent> events) { Echo(*raw, events); });
+      streams[raw->GetSocket().GetHandle()] = std::move(stream);
+    }
+  }
+
+  void Echo(MessageStream& stream, BitMask<IoEvent> events) {
+    if (events.IsSet(IoEvent::READ)) {
+      if (!stream.Receive()) {
+        int handle = stream.GetSocket().GetHandle();
+        reactor.Remove(stream.GetSocket());
+        streams.erase(handle);
+        return;
+      }
+      while (optional<string_view> message = stream.Next()) {
+        stream.Send(*message);
+      }
+    }
+    // Wait until the socket is writable while echoes are queued
+    bool flushed = stream.Flush();
+    reactor.Modify(stream.GetSocket(),
+                   flushed ? BitMask<IoEvent>(IoEvent::READ) : IoEvent::READ | IoEvent::WRITE);
+  }
+};
+
+double Seconds(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/// Open and close connections, keeping a fixed number of attempts in flight
+void MeasureConnections(const Address& address) {
+  Reactor reactor;
+  unordered_map<int, unique_ptr<TcpSocket>> sockets;
+  size_t completed = 0;
+  auto start = chrono::steady_clock::now();
+  bool running = true;
+
+  function<void()> open = [&] {
+    auto socket = make_unique<TcpSocket>(TcpSocket::Connect(address));
+    TcpSocket* raw = socket.get();
+    reactor.Add(*raw, IoEvent::WRITE, [&, raw](BitMask<IoEvent>) {
+      if (raw->GetError() == 0) {
+        ++completed;
+      }
+      int handle = raw->GetHandle();
+      reactor.Remove(*raw);
+      sockets.erase(handle);
+      if (running) {
+        open();
+      }
+    });
+    sockets[raw->GetHandle()] = std::move(socket);
+  };
+
+  for (size_t i = 0; i < CONNECTIONS_IN_FLIGHT; ++i) {
+    open();
+  }
+  while (chrono::steady_clock::now() - start < CONNECTION_DURATION) {
+    reactor.Poll(Time::Milliseconds(10));
+  }
+  running = false;
+  double seconds = Seconds(start);
+  cout << "Connections: " << completed << " in " << seconds << " s, "
+       << static_cast<double>(completed) / seconds << " connections/s" << endl;
+  for (auto& [handle, socket] : sockets) {
+    reactor.Remove(*socket);
+  }
+}
+
+/// Send small messages over many connections and count the echoed ones
+void MeasureMessages(const Address& address) {
+  Reactor reactor;
+  vector<TcpSocket> sockets(CONNECTIONS);
+  vector<size_t> pending_bytes(CONNECTIONS, 0);
+  size_t messages = 0;
+  char message[MESSAGE_SIZE] = {};
+
+  for (size_t i = 0; i < CONNECTIONS; ++i) {
+    sockets[i] = TcpSocket::Connect(address);
+    sockets[i].SetNoDelay(true);
+    reactor.Add(sockets[i], IoEvent::WRITE, [&, i](BitMask<IoEvent> events) {
+      TcpSocket& socket = sockets[i];
+      if (events.IsSet(IoEvent::WRITE)) {
+        // Connected: fill the pipeline and wait for the echoes
+        for (size_t j = 0; j < PIPELINE_DEPTH; ++j) {
+          socket.Send(message, sizeof(message));
+        }
+        reactor.Modify(socket, IoEvent::READ);
+        return;
+      }
+      // Count the echoes and send a new message for every complete one
+      char buffer[4096];
+      optional<size_t> received = socket.Receive(buffer, sizeof(buffer));
+      if (!received || *received == 0) {
+        return;
+      }
+      pending_bytes[i] += *received;
+      size_t complete = pending_bytes[i] / MESSAGE_SIZE;
+      pending_bytes[i] %= MESSAGE_SIZE;
+      messages += complete;
+      for (size_t j = 0; j < complete; ++j) {
+        socket.Send(message, sizeof(message));
+      }
+    });
+  }
+
+  auto start = chrono::steady_clock::now();
+  while (chrono::steady_clock::now() - start < DURATION) {
+    reactor.Poll(Time::Milliseconds(10));
+  }
+  double seconds = Seconds(start);
+  cout << "Messages: " << messages << " echoes of " << MESSAGE_SIZE << " bytes over "
+       << CONNECTIONS << " connections in " << seconds << " s, "
+       << static_cast<double>(messages) / seconds << " messages/s" << endl;
+  for (TcpSocket& socket : sockets) {
+    reactor.Remove(socket);
+  }
+}
+
+/// Send small framed messages in batches and count the echoed ones
+void MeasureFramedMessages(const Address& address, Framing framing, const char* name) {
+  Reactor reactor;
+  vector<unique_ptr<MessageStream>> streams;
+  size_t messages = 0;
+  const string message(FRAMED_MESSAGE_SIZE, 'x');
+
+  for (size_t i = 0; i < FRAMED_CONNECTIONS; ++i) {
+    streams.push_back(make_unique<MessageStream>(TcpSocket::Connect(address), framing));
+    MessageStream* stream = streams.back().get();
+    reactor.Add(stream->GetSocket(), IoEvent::WRITE, [&, stream](BitMask<IoEvent> events) {
+      size_t replies = 0;
+      if (events.IsSet(IoEvent::WRITE)) {
+        // Connected: fill the pipeline
+        replies = FRAMED_PIPELINE_DEPTH;
+        reactor.Modify(stream->GetSocket(), IoEvent::READ);
+      } else if (stream->Receive()) {
+        while (stream->Next()) {
+          ++replies;
+        }
+        messages += replies;
+      }
+      for (size_t j = 0; j < replies; ++j) {
+        stream->Send(message);
+      }
+      stream->Flush();
+    });
+  }
+
+  auto start = chrono::steady_clock::now();
+  while (chrono::steady_clock::now() - start < DURATION) {
+    reactor.Poll(Time::Milliseconds(10));
+  }
+  double seconds = Seconds(start);
+  cout << name << " messages: " << messages << " echoes of " << FRAMED_MESSAGE_SIZE
+       << " bytes over " << FRAMED_CONNECTIONS << " connections in " << seconds << " s, "
+       << static_cast<double>(messages) / seconds << " messages/s" << endl;
+  for (auto& stream : streams) {
+    reactor.Remove(stream->GetSocket());
+  }
+}
+
+}  // namespace
+
+int main() {
+  EchoServer server;
+  Address address = server.GetAddress();
+  cout << "Echo server on " << address.ToString() << endl;
+  MeasureConnections(address);
+  MeasureMessages(address);
+  for (auto [framing, name] : {pair{Framing::LENGTH_PREFIX, "Length-prefixed"},
+                               pair{Framing::VARINT, "Varint"}}) {
+    FramedEchoServer framed_server(framing);
+    MeasureFramedMessages(framed_server.GetAddress(), framing, name);
+  }
+  return 0;
+}
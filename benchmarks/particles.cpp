@@ -0,0 +1,159 @@
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <SDL_pixels.h>
+#include <sdlxx/core.h>
+#include <sdlxx/core/gl_renderer.h>
+#include <sdlxx/particles.h>
+
+using namespace std;
+using namespace sdlxx;
+
+namespace {
+
+constexpr Dimensions SIZE{1280, 720};
+constexpr double SECONDS = 2.0;
+constexpr float DELTA = 1.0F / 60.0F;
+
+// A fountain that keeps about 100k particles alive: 50k per second living two seconds on average
+EmitterSettings MakeSettings() {
+  EmitterSettings settings;
+  settings.capacity = 120000;
+  settings.rate = 50000.0F;
+  settings.life_min = 1.5F;
+  settings.life_max = 2.5F;
+  settings.direction = -90.0F;
+  settings.spread = 60.0F;
+  settings.speed_min = 200.0F;
+  settings.speed_max = 500.0F;
+  settings.spawn_width = 40.0F;
+  settings.gravity_y = 300.0F;
+  settings.drag = 0.2F;
+  settings.size = Curve({{0.0F, 2.0F}, {0.2F, 6.0F}, {1.0F, 1.0F}});
+  settings.color = Gradient({{0.0F, Color(255, 255, 160)},
+                             {0.5F, Color(255, 96, 0, 192)},
+                             {1.0F, Color(64, 0, 0, 0)}});
+  return settings;
+}
+
+Emitter MakeEmitter() {
+  Emitter emitter(MakeSettings());
+  emitter.SetPosition(SIZE.width / 2.0F, SIZE.height - 40.0F);
+  // Run until the number of live particles is steady
+  for (int frame = 0; frame < 180; ++frame) {
+    emitter.Update(DELTA);
+  }
+  return emitter;
+}
+
+Surface MakeParticle() {
+  Surface surface(8, 8, 32, SDL_PIXELFORMAT_RGBA32);
+  surface.Fill(Color::WHITE);
+  return surface;
+}
+
+// Run frames for a while and report the sustained rate
+void Measure(const char* name, const Emitter& emitter, const function<void()>& frame) {
+  size_t frames = 0;
+  size_t particles = 0;
+  auto start = chrono::steady_clock::now();
+  double seconds = 0.0;
+  while (seconds < SECONDS || frames < 3) {
+    frame();
+    particles += emitter.GetCount();
+    ++frames;
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+  double fps = static_cast<double>(frames) / seconds;
+  cout << left << setw(28) << name << right << setw(8) << particles / frames << " particles: "
+       << fixed << setprecision(1) << setw(8) << fps << " FPS, " << setprecision(3) << setw(7)
+       << 1000.0 / fps << " ms per frame" << endl;
+}
+
+void MeasureUpdate(ThreadPool& pool) {
+  Emitter emitter = MakeEmitter();
+  Measure("Update", emitter, [&] { emitter.Update(DELTA); });
+  Measure("Update, thread pool", emitter, [&] { emitter.Update(DELTA, &pool); });
+}
+
+void MeasureSoftware(ThreadPool& pool) {
+  Surface surface(SIZE.width, SIZE.height, 32, SDL_PIXELFORMAT_RGBA32);
+  Renderer renderer(surface);
+  Texture texture(renderer, MakeParticle());
+  texture.SetBlendMode(BlendMode::ADD);
+  Emitter emitter = MakeEmitter();
+  Measure("Software renderer", emitter, [&] {
+    renderer.SetDrawColor(Color::BLACK);
+    renderer.Clear();
+    emitter.Update(DELTA, &pool);
+    emitter.Render(renderer, &texture, &pool);
+  });
+}
+
+void MeasureAccelerated(ThreadPool& pool) {
+  Window window("particles", SIZE, Window::Flag::HIDDEN);
+  Renderer renderer(window, Renderer::Flag::ACCELERATED);
+  Texture texture(renderer, MakeParticle());
+  texture.SetBlendMode(BlendMode::ADD);
+  Emitter emitter = MakeEmitter();
+  vector<uint8_t> pixel(4);
+  Measure("Accelerated renderer", emitter, [&] {
+    renderer.SetDrawColor(Color::BLACK);
+    renderer.Clear();
+    emitter.Update(DELTA, &pool);
+    emitter.Render(renderer, &texture, &pool);
+    // Reading a pixel waits for the frame
+    renderer.ReadPixels({0, 0, 1, 1}, SDL_PIXELFORMAT_RGBA32, pixel.data(), 4);
+    renderer.RenderPresent();
+  });
+}
+
+void MeasureGl(ThreadPool& pool) {
+  GL::Context::SetAttribute(GL::Attribute::CONTEXT_PROFILE_MASK,
+                            static_cast<int>(GL::Profile::CORE));
+  GL::Context::SetAttribute(GL::Attribute::CONTEXT_MAJOR_VERSION, 3);
+  GL::Context::SetAttribute(GL::Attribute::CONTEXT_MINOR_VERSION, 3);
+  Window window("particles_gl", SIZE, Window::Flag::OPENGL | Window::Flag::HIDDEN);
+  GL::Context context(window);
+  context.MakeCurrent(window);
+  GL::Context::SetSwapInterval(0);
+  GL::Renderer renderer(context, GL::Context::GetDrawableSize(window));
+  GL::Texture texture(renderer, MakeParticle());
+  texture.SetBlendMode(BlendMode::ADD);
+  Emitter emitter = MakeEmitter();
+  Measure("GL::Renderer", emitter, [&] {
+    renderer.SetDrawColor(Color::BLACK);
+    renderer.Clear();
+    emitter.Update(DELTA, &pool);
+    emitter.Render(renderer, texture);
+    renderer.Flush();
+    // Wait for the frame, so queued frames are not measured as drawn
+    renderer.GetFunctions().Finish();
+    GL::Context::SwapWindow(window);
+  });
+}
+
+}  // namespace
+
+// Frame rate of a fountain of 100k particles: the simulation alone, then simulated and drawn with
+// the software renderer, an accelerated SDL renderer and GL::Renderer. Set
+// SDL_VIDEODRIVER=offscreen to run headlessly.
+int main() {
+  try {
+    CoreApi core(CoreApi::Flag::VIDEO);
+    ThreadPool pool;
+    cout << "Thread pool: " << pool.GetThreadCount() << " threads" << endl;
+    MeasureUpdate(pool);
+    MeasureSoftware(pool);
+    MeasureAccelerated(pool);
+    MeasureGl(pool);
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
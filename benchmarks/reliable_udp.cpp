@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sdlxx/net/network_simulator.h>
+#include <sdlxx/net/udp_connection.h>
+
+using namespace std;
+using namespace sdlxx;
+
+namespace {
+
+constexpr int TICK_RATE = 60;
+constexpr int TICKS = TICK_RATE * 30;
+constexpr int64_t TICK_MICROSECONDS = 1000000 / TICK_RATE;
+
+// Every tick sends a position update of the player and a reliable event, and every second
+// a reliable 8 KB chunk of a level that needs several fragments
+constexpr size_t POSITION_SIZE = 32;
+constexpr size_t EVENT_SIZE = 48;
+constexpr size_t CHUNK_SIZE = 8192;
+
+enum Channel : size_t { POSITIONS, EVENTS };
+
+struct Latencies {
+  vector<int64_t> samples;
+  size_t sent = 0;
+
+  void Report(const char* name) {
+    sort(samples.begin(), samples.end());
+    auto percentile = [&](double p) {
+      return samples.empty()
+                 ? 0.0
+                 : samples[static_cast<size_t>(p * static_cast<double>(samples.size() - 1))] /
+                       1000.0;
+    };
+    cout << "  " << left << setw(10) << name << right << setw(6) << samples.size() << "/"
+         << setw(5) << sent << " delivered, latency p50 " << setw(6) << percentile(0.5)
+         << " ms, p99 " << setw(6) << percentile(0.99) << " ms, max " << setw(6)
+         << percentile(1.0) << " ms" << endl;
+  }
+};
+
+string MakeMessage(size_t size, int64_t time) {
+  string message(size, 'x');
+  memcpy(message.data(), &time, sizeof(time));
+  return message;
+}
+
+void Simulate(float loss) {
+  NetworkSimulator::Settings settings;
+  settings.loss = loss;
+  settings.duplicate = 0.01F;
+  settings.latency = Time::Milliseconds(40);
+  settings.jitter = Time::Milliseconds(10);
+  NetworkSimulator uplink(settings, 1);
+  NetworkSimulator downlink(settings, 2);
+
+  Time now;
+  vector<Delivery> channels{Delivery::UNRELIABLE_SEQUENCED, Delivery::RELIABLE_ORDERED};
+  UdpConnection client(channels, [&](const uint8_t* data, size_t size) {
+    uplink.Send(data, size, now);
+  });
+  UdpConnection server(channels, [&](const uint8_t* data, size_t size) {
+    downlink.Send(data, size, now);
+  });
+
+  Latencies positions;
+  Latencies events;
+  // Run for a while after the last message, so that reliable messages arrive
+  for (int tick = 0; tick < TICKS + TICK_RATE * 2; ++tick) {
+    int64_t time = tick * TICK_MICROSECONDS;
+    now = Time::Microseconds(time);
+    if (tick < TICKS) {
+      client.Send(POSITIONS, MakeMessage(POSITION_SIZE, time));
+      ++positions.sent;
+      client.Send(EVENTS, MakeMessage(tick % TICK_RATE == 0 ? CHUNK_SIZE : EVENT_SIZE, time));
+      ++events.sent;
+    }
+    uplink.Deliver(now, [&](const uint8_t* data, size_t size) {
+      server.ReceivePacket(data, size, now);
+    });
+    downlink.Deliver(now, [&](const uint8_t* data, size_t size) {
+      client.ReceivePacket(data, size, now);
+    });
+    while (optional<UdpConnection::Message> message = server.Receive()) {
+      int64_t sent = 0;
+      memcpy(&sent, message->data.data(), sizeof(sent));
+      (message->channel == POSITIONS ? positions : events).samples.push_back(time - sent);
+    }
+    client.Update(now);
+    server.Update(now);
+  }
+
+  const UdpConnection::Statistics& statistics = client.GetStatistics();
+  cout << fixed << setprecision(1) << "Loss " << loss * 100 << "%, RTT "
+       << client.GetRoundTripTime().AsMicroseconds() / 1000.0 << " ms, "
+       << statistics.bytes_sent * 8.0 / (TICKS / TICK_RATE) / 1000.0 << " kbit/s, "
+       << statistics.packets_sent << " packets, " << statistics.packets_lost << " lost, "
+       << statistics.resent_fragments << " fragments resent" << endl;
+  positions.Report("positions");
+  events.Report("events");
+}
+
+}  // namespace
+
+int main() {
+  for (float loss : {0.0F, 0.05F, 0.2F}) {
+    Simulate(loss);
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <sdlxx/net/bit_stream.h>
+#include <sdlxx/net/schema.h>
+#include <sdlxx/net/snapshot.h>
+
+using namespace std;
+using namespace sdlxx;
+
+namespace {
+
+constexpr size_t ENTITIES = 1000;
+constexpr int TICK_RATE = 60;
+constexpr int TICKS = TICK_RATE * 10;
+
+// Snapshots are confirmed after a round trip of 100 ms, and every 50th snapshot is lost
+constexpr int ACK_DELAY = 6;
+constexpr int LOSS_INTERVAL = 50;
+
+struct EntityState {
+  float x = 0;
+  float y = 0;
+  float angle = 0;
+  float vx = 0;
+  float vy = 0;
+  uint8_t health = 100;
+  bool firing = false;
+  uint16_t animation = 0;
+};
+
+// Positions with 1/128 unit precision in a 8192x8192 world, angles with 0.4 degree precision
+using EntitySchema = Schema<EntityState,
+                            Field<&EntityState::x, Codec::Quantized<-4096, 4096, 20>>,
+                            Field<&EntityState::y, Codec::Quantized<-4096, 4096, 20>>,
+                            Field<&EntityState::angle, Codec::Quantized<0, 6284, 10, 1000>>,
+                            Field<&EntityState::vx, Codec::Quantized<-512, 512, 12>>,
+                            Field<&EntityState::vy, Codec::Quantized<-512, 512, 12>>,
+                            Field<&EntityState::health, Codec::Unsigned<uint8_t, 7>>,
+                            Field<&EntityState::firing, Codec::Bool>,
+                            Field<&EntityState::animation, Codec::VarInt<uint16_t>>>;
+
+uint32_t NextRandom(uint32_t& seed) {
+  seed = seed * 1664525U + 1013904223U;
+  return seed >> 8U;
+}
+
+/// A world where 30% of the entities stand still and the others walk and turn now and then
+class World {
+public:
+  World() {
+    snapshot.entities.resize(ENTITIES);
+    for (size_t i = 0; i < ENTITIES; ++i) {
+      auto& entity = snapshot.entities[i];
+      entity.id = static_cast<uint32_t>(i * 3);  // Sparse identifiers, as after despawns
+      entity.state.x = static_cast<float>(NextRandom(seed) % 6000) - 3000.0F;
+      entity.state.y = static_cast<float>(NextRandom(seed) % 6000) - 3000.0F;
+      if (i % 10 >= 3) {
+        Turn(entity.state);
+      }
+    }
+  }
+
+  const Snapshot<EntityState>& Step() {
+    const float dt = 1.0F / TICK_RATE;
+    for (auto& entity : snapshot.entities) {
+      EntityState& state = entity.state;
+      if (state.vx == 0 && state.vy == 0) {
+        continue;
+      }
+      state.x += state.vx * dt;
+      state.y += state.vy * dt;
+      if (NextRandom(seed) % 120 == 0) {
+        Turn(state);
+      }
+      state.firing = NextRandom(seed) % 30 == 0;
+      if (state.firing && state.health > 0) {
+        --state.health;
+      }
+      state.animation = static_cast<uint16_t>((state.animation + 1) % 24);
+    }
+    ++snapshot.sequence;
+    return snapshot;
+  }
+
+private:
+  Snapshot<EntityState> snapshot;
+  uint32_t seed = 12345;
+
+  void Turn(EntityState& state) {
+    state.angle = static_cast<float>(NextRandom(seed) % 6283) / 1000.0F;
+    state.vx = std::cos(state.angle) * 150.0F;
+    state.vy = std::sin(state.angle) * 150.0F;
+  }
+};
+
+}  // namespace
+
+int main() {
+  World world;
+  SnapshotEncoder<EntitySchema> encoder;
+  SnapshotDecoder<EntitySchema> decoder;
+  // Never receives confirmations, so it writes every snapshot in full
+  SnapshotEncoder<EntitySchema> full_encoder;
+  BitWriter writer;
+  BitWriter full_writer;
+  vector<uint32_t> received;
+  size_t delta_bytes = 0;
+  size_t full_bytes = 0;
+  double encode_seconds = 0;
+  double decode_seconds = 0;
+
+  for (int tick = 0; tick < TICKS; ++tick) {
+    const Snapshot<EntityState>& snapshot = world.Step();
+
+    full_writer.Clear();
+    full_encoder.Encode(full_writer, snapshot);
+    full_bytes += full_writer.GetByteCount();
+
+    writer.Clear();
+    auto start = chrono::steady_clock::now();
+    encoder.Encode(writer, snapshot);
+    const vector<uint8_t>& packet = writer.GetData();
+    auto encoded = chrono::steady_clock::now();
+    delta_bytes += packet.size();
+
+    if (tick % LOSS_INTERVAL != LOSS_INTERVAL - 1) {
+      BitReader reader(packet.data(), packet.size());
+      const Snapshot<EntityState>& decoded = decoder.Decode(reader);
+      decode_seconds += chrono::duration<double>(chrono::steady_clock::now() - encoded).count();
+      if (decoded.entities.size() != ENTITIES) {
+        cerr << "Decoded " << decoded.entities.size() << " entities instead of " << ENTITIES
+             << endl;
+        return 1;
+      }
+      received.push_back(decoded.sequence);
+    }
+    encode_seconds += chrono::duration<double>(encoded - start).count();
+
+    // Confirmations arrive after the round trip
+    while (!received.empty() &&
+           static_cast<int>(snapshot.sequence - received.front()) >= ACK_DELAY) {
+      encoder.Acknowledge(received.front());
+      received.erase(received.begin());
+    }
+  }
+
+  double raw_bytes = static_cast<double>((sizeof(EntityState) + sizeof(uint32_t)) * ENTITIES);
+  double delta_per_tick = static_cast<double>(delta_bytes) / TICKS;
+  double full_per_tick = static_cast<double>(full_bytes) / TICKS;
+  cout << "Replicating " << ENTITIES << " entities at " << TICK_RATE << " Hz for " << TICKS
+       << " ticks" << endl;
+  cout << "Raw structs: " << raw_bytes << " bytes per tick, "
+       << raw_bytes * 8 * TICK_RATE / 1000 << " kbit/s" << endl;
+  cout << "Quantized full snapshots: " << full_per_tick << " bytes per tick, "
+       << full_per_tick * 8 * TICK_RATE / 1000 << " kbit/s" << endl;
+  cout << "Delta snapshots: " << delta_per_tick << " bytes per tick, "
+       << delta_per_tick * 8 * TICK_RATE / 1000 << " kbit/s" << endl;
+  cout << "Encoding: " << encode_seconds * 1e6 / TICKS << " us per tick, decoding: "
+       << decode_seconds * 1e6 / (TICKS - TICKS / LOSS_INTERVAL) << " us per tick" << endl;
+  return 0;
+}
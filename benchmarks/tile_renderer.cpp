@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <SDL_pixels.h>
+#include <sdlxx/core.h>
+
+using namespace std;
+using namespace sdlxx;
+
+namespace {
+
+constexpr Dimensions SIZE{1920, 1080};
+constexpr double SECONDS = 2.0;
+
+Surface MakePattern() {
+  Surface surface(64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+  surface.Fill(Color(255, 128, 0, 160));
+  return surface;
+}
+
+// The same frame for every run: blended rectangles, long lines and sprites over a cleared target
+void DrawFrame(TileRenderer& tiles, const Surface& pattern) {
+  mt19937 random(1);
+  auto next = [&random](int bound) { return static_cast<int>(random() % bound); };
+  tiles.SetDrawColor(Color::BLACK);
+  tiles.Clear();
+  tiles.SetDrawBlendMode(BlendMode::BLEND);
+  tiles.SetDrawColor(Color(255, 0, 0, 128));
+  for (int i = 0; i < 500; ++i) {
+    tiles.FillRectangle({next(SIZE.width - 128), next(SIZE.height - 128), 128, 128});
+  }
+  tiles.SetDrawBlendMode(BlendMode::ADD);
+  tiles.SetDrawColor(Color(0, 128, 255, 200));
+  for (int i = 0; i < 2000; ++i) {
+    tiles.DrawLine({next(SIZE.width), next(SIZE.height)},
+                   {next(SIZE.width), next(SIZE.height)});
+  }
+  for (int i = 0; i < 1000; ++i) {
+    tiles.Copy(pattern, {0, 0, 64, 64}, {next(SIZE.width - 64), next(SIZE.height - 64), 64, 64});
+  }
+  tiles.Present();
+}
+
+// Draw frames for a while and return the time per frame in milliseconds
+double Measure(size_t threads, Surface& target, const Surface& pattern) {
+  ThreadPool pool(threads);
+  TileRenderer tiles(target, pool);
+  DrawFrame(tiles, pattern);
+  size_t frames = 0;
+  auto start = chrono::steady_clock::now();
+  double seconds = 0.0;
+  while (seconds < SECONDS || frames < 3) {
+    DrawFrame(tiles, pattern);
+    ++frames;
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+  return 1000.0 * seconds / static_cast<double>(frames);
+}
+
+}  // namespace
+
+// Time per frame of TileRenderer with thread pools of 0, 1, 3, ... workers up to one per core.
+// The calling thread takes part in Present(), so N workers use N + 1 cores. The speedup is
+// relative to no workers, and is only meaningful for thread counts within the core count.
+int main() {
+  try {
+    Surface target(SIZE.width, SIZE.height, 32, SDL_PIXELFORMAT_ARGB8888);
+    Surface pattern = MakePattern();
+    size_t cores = max(thread::hardware_concurrency(), 1U);
+    cout << "Cores: " << cores << endl;
+    vector<size_t> counts;
+    for (size_t threads = 0; threads < cores; threads = threads * 2 + 1) {
+      counts.push_back(threads);
+    }
+    if (counts.back() != cores - 1) {
+      counts.push_back(cores - 1);
+    }
+    double single = 0.0;
+    for (size_t threads : counts) {
+      double milliseconds = Measure(threads, target, pattern);
+      single = threads == 0 ? milliseconds : single;
+      cout << setw(3) << threads << " workers: " << fixed << setprecision(3) << setw(8)
+           << milliseconds << " ms per frame, " << setprecision(2) << single / milliseconds
+           << "x" << endl;
+    }
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
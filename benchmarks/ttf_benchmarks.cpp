@@ -0,0 +1,85 @@
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <SDL_ttf.h>
+#include <sdlxx/core/color.h>
+#include <sdlxx/core/surface.h>
+#include <sdlxx/ttf.h>
+
+#include "benchmark.h"
+
+using namespace std;
+using namespace sdlxx;
+using namespace sdlxx::bench;
+
+namespace {
+
+constexpr int POINT_SIZE = 16;
+constexpr const char* TEXT = "The quick brown fox jumps over the lazy dog";
+
+/// The font file is taken from the SDLXX_BENCHMARK_FONT environment variable
+const char* GetFontPath() { return getenv("SDLXX_BENCHMARK_FONT"); }
+
+TtfApi& GetTtfApi() {
+  static TtfApi ttf_api;
+  return ttf_api;
+}
+
+}  // namespace
+
+SDLXX_BENCHMARK(font_render_solid, WRAPPER) {
+  if (GetFontPath() == nullptr) {
+    state.Skip("SDLXX_BENCHMARK_FONT is not set");
+    return;
+  }
+  GetTtfApi();
+  Font font(GetFontPath(), POINT_SIZE);
+  while (state.KeepRunning()) {
+    Surface surface = font.RenderSolid(TEXT, Color::WHITE);
+    DoNotOptimize(surface);
+  }
+}
+
+SDLXX_BENCHMARK(font_render_solid, BASELINE) {
+  if (GetFontPath() == nullptr) {
+    state.Skip("SDLXX_BENCHMARK_FONT is not set");
+    return;
+  }
+  GetTtfApi();
+  unique_ptr<TTF_Font, void (*)(TTF_Font*)> font(TTF_OpenFont(GetFontPath(), POINT_SIZE),
+                                                 TTF_CloseFont);
+  while (state.KeepRunning()) {
+    SDL_Surface* surface = TTF_RenderText_Solid(font.get(), TEXT, {255, 255, 255, 255});
+    DoNotOptimize(surface);
+    SDL_FreeSurface(surface);
+  }
+}
+
+SDLXX_BENCHMARK(font_render_blended, WRAPPER) {
+  if (GetFontPath() == nullptr) {
+    state.Skip("SDLXX_BENCHMARK_FONT is not set");
+    return;
+  }
+  GetTtfApi();
+  Font font(GetFontPath(), POINT_SIZE);
+  while (state.KeepRunning()) {
+    Surface surface = font.RenderBlended(TEXT, Color::WHITE);
+    DoNotOptimize(surface);
+  }
+}
+
+SDLXX_BENCHMARK(font_render_blended, BASELINE) {
+  if (GetFontPath() == nullptr) {
+    state.Skip("SDLXX_BENCHMARK_FONT is not set");
+    return;
+  }
+  GetTtfApi();
+  unique_ptr<TTF_Font, void (*)(TTF_Font*)> font(TTF_OpenFont(GetFontPath(), POINT_SIZE),
+                                                 TTF_CloseFont);
+  while (state.KeepRunning()) {
+    SDL_Surface* surface = TTF_RenderText_Blended(font.get(), TEXT, {255, 255, 255, 255});
+    DoNotOptimize(surface);
+    SDL_FreeSurface(surface);
+  }
+}
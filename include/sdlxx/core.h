@@ -28,24 +28,38 @@
 #ifndef SDLXX_CORE_H
 #define SDLXX_CORE_H
 
+#include "sdlxx/utils/angle.h"
 #include "sdlxx/utils/bitmask.h"
 #include "sdlxx/core/blendmode.h"
+#include "sdlxx/core/channel.h"
 #include "sdlxx/core/color.h"
 #include "sdlxx/core/core_api.h"
 #include "sdlxx/core/dimensions.h"
 #include "sdlxx/core/display.h"
+#include "sdlxx/core/event_batch.h"
 #include "sdlxx/core/events.h"
 #include "sdlxx/core/exception.h"
 #include "sdlxx/core/gl.h"
+#include "sdlxx/core/gl_effects.h"
+#include "sdlxx/core/gl_functions.h"
+#include "sdlxx/core/gl_post_processor.h"
+#include "sdlxx/core/gl_renderer.h"
+#include "sdlxx/core/image_processor.h"
 #include "sdlxx/core/keyboard.h"
 #include "sdlxx/core/log.h"
+#include "sdlxx/core/offscreen.h"
+#include "sdlxx/core/pixel_view.h"
 #include "sdlxx/core/point.h"
 #include "sdlxx/core/rectangle.h"
 #include "sdlxx/core/renderable.h"
 #include "sdlxx/core/renderer.h"
+#include "sdlxx/core/sprite_batch.h"
 #include "sdlxx/core/surface.h"
 #include "sdlxx/core/texture.h"
+#include "sdlxx/core/thread_pool.h"
+#include "sdlxx/core/tile_renderer.h"
 #include "sdlxx/core/timer.h"
+#include "sdlxx/core/timer_wheel.h"
 #include "sdlxx/core/version.h"
 #include "sdlxx/core/window.h"
 
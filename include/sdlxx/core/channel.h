@@ -0,0 +1,344 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Channel class that passes typed messages from worker threads to the
+ *        main loop.
+ */
+
+#ifndef SDLXX_CORE_CHANNEL_H
+#define SDLXX_CORE_CHANNEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "sdlxx/core/events.h"
+#include "sdlxx/core/exception.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for Channel-related exceptions.
+ */
+class ChannelException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A class that wakes up the main loop blocked in Events::Wait() or Events::WaitTimeout().
+ *
+ * At most one wake-up event is posted to the SDL event queue between two calls to Reset(), so
+ * producers do not contend on the SDL queue no matter how many messages they send.
+ */
+class ChannelWaker {
+public:
+  /**
+   * \brief Post a wake-up event unless one is already pending.
+   *
+   * This function is thread-safe.
+   *
+   * \upstream SDL_PushEvent
+   */
+  void Wake();
+
+  /**
+   * \brief Allow the next call to Wake() to post an event.
+   *
+   * Should be called by the consumer before it drains the channel.
+   */
+  void Reset() { pending.store(false, std::memory_order_release); }
+
+  /**
+   * \brief Test whether the event is a wake-up event posted by a channel.
+   */
+  static bool IsWakeEvent(const Event& event);
+
+  /**
+   * \brief Get the user-defined event type used for wake-up events.
+   *
+   * The type is registered with Events::Register() on the first call.
+   */
+  static uint32_t GetEventType();
+
+private:
+  std::atomic<bool> pending{false};
+};
+
+/**
+ * \brief Statistics of a channel.
+ */
+struct ChannelStatistics {
+  uint64_t pushed = 0;             ///< Number of messages accepted by the channel
+  uint64_t rejected = 0;           ///< Number of messages rejected because the channel was full
+  uint64_t drained = 0;            ///< Number of messages received by the consumer
+  std::size_t high_watermark = 0;  ///< Maximum observed number of queued messages
+};
+
+/**
+ * \brief A bounded lock-free multiple-producer single-consumer queue of typed messages.
+ *
+ * Producers on any thread call TryPush(), which never blocks and never allocates: if the channel
+ * is full, the message is rejected and counted in the statistics, so that the producer can apply
+ * backpressure. The main loop drains the channel once per frame with Drain().
+ *
+ * \tparam T The type of messages.
+ */
+template <typename T>
+class Channel {
+public:
+  /**
+   * \brief Construct a channel.
+   *
+   * \param capacity The maximum number of queued messages, rounded up to a power of two.
+   * \param wake_event_loop Whether pushing a message should wake up the main loop that waits for
+   *                        events.
+   */
+  explicit Channel(std::size_t capacity, bool wake_event_loop = true);
+
+  /**
+   * \brief Destroy the channel and all queued messages.
+   */
+  ~Channel();
+
+  // Deleted copy constructor
+  Channel(const Channel&) = delete;
+
+  // Deleted copy assignment operator
+  Channel& operator=(const Channel&) = delete;
+
+  // Deleted move constructor
+  Channel(Channel&&) = delete;
+
+  // Deleted move assignment operator
+  Channel& operator=(Channel&&) = delete;
+
+  /**
+   * \brief Try to add a message to the channel.
+   *
+   * This function is thread-safe and lock-free.
+   *
+   * \param args Arguments to construct the message with. If constructing from them may throw, the
+   *             message is constructed before it is queued and then moved into the channel.
+   *
+   * \return true if the message was queued, false if the channel was full.
+   *
+   * \throw Any exception thrown by the constructor of the message, in which case the channel is
+   *        not changed.
+   */
+  template <typename... Args>
+  bool TryPush(Args&&... args);
+
+  /**
+   * \brief Remove the message from the front of the channel.
+   *
+   * \note Must be called only from the consumer thread.
+   *
+   * \return std::optional<T> The message, or std::nullopt if the channel is empty.
+   */
+  std::optional<T> TryPop();
+
+  /**
+   * \brief Pass queued messages to the handler in order and remove them from the channel.
+   *
+   * Messages pushed while draining may or may not be included.
+   *
+   * \note Must be called only from the consumer thread.
+   *
+   * \param handler A callable object that accepts T&&.
+   * \param max_messages The maximum number of messages to process.
+   *
+   * \return std::size_t The number of processed messages.
+   *
+   * \throw Any exception thrown by the handler, in which case the message passed to it has been
+   *        removed, and the following messages stay queued.
+   */
+  template <typename Handler>
+  std::size_t Drain(Handler&& handler, std::size_t max_messages = SIZE_MAX);
+
+  /**
+   * \brief Get the maximum number of queued messages.
+   */
+  std::size_t GetCapacity() const { return mask + 1; }
+
+  /**
+   * \brief Get the approximate number of queued messages.
+   */
+  std::size_t GetSize() const {
+    return enqueue_position.load(std::memory_order_relaxed) -
+           dequeue_position.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * \brief Get the statistics of the channel.
+   */
+  ChannelStatistics GetStatistics() const {
+    return {pushed.load(std::memory_order_relaxed), rejected.load(std::memory_order_relaxed),
+            drained, high_watermark.load(std::memory_order_relaxed)};
+  }
+
+private:
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+    T* Get() { return std::launder(reinterpret_cast<T*>(&storage)); }
+  };
+
+  std::unique_ptr<Cell[]> cells;
+  std::size_t mask;
+  std::unique_ptr<ChannelWaker> waker;
+
+  alignas(CACHE_LINE) std::atomic<std::size_t> enqueue_position{0};
+  alignas(CACHE_LINE) std::atomic<std::size_t> dequeue_position{0};
+
+  alignas(CACHE_LINE) std::atomic<uint64_t> pushed{0};
+  std::atomic<uint64_t> rejected{0};
+  std::atomic<std::size_t> high_watermark{0};
+
+  // Only modified by the consumer
+  alignas(CACHE_LINE) uint64_t drained = 0;
+
+  static std::size_t RoundUpToPowerOfTwo(std::size_t value);
+};
+
+template <typename T>
+std::size_t Channel<T>::RoundUpToPowerOfTwo(std::size_t value) {
+  std::size_t result = 1;
+  while (result < value) { result <<= 1U; }
+  return result;
+}
+
+template <typename T>
+Channel<T>::Channel(std::size_t capacity, bool wake_event_loop)
+    : mask(RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1) {
+  cells = std::make_unique<Cell[]>(mask + 1);
+  for (std::size_t i = 0; i <= mask; ++i) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  if (wake_event_loop) {
+    waker = std::make_unique<ChannelWaker>();
+  }
+}
+
+template <typename T>
+Channel<T>::~Channel() {
+  while (TryPop()) {}
+}
+
+template <typename T>
+template <typename... Args>
+bool Channel<T>::TryPush(Args&&... args) {
+  if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>) {
+    // A claimed cell must be published, or the consumer would wait for it forever, so a message
+    // whose constructor may throw is constructed before a cell is claimed
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "Messages must be constructible or movable without exceptions");
+    T message(std::forward<Args>(args)...);
+    return TryPush(std::move(message));
+  }
+  Cell* cell = nullptr;
+  std::size_t position = enqueue_position.load(std::memory_order_relaxed);
+  while (true) {
+    cell = &cells[position & mask];
+    std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+    if (difference == 0) {
+      if (enqueue_position.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      rejected.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+  new (&cell->storage) T(std::forward<Args>(args)...);
+  cell->sequence.store(position + 1, std::memory_order_release);
+
+  pushed.fetch_add(1, std::memory_order_relaxed);
+  std::size_t size = position + 1 - dequeue_position.load(std::memory_order_relaxed);
+  std::size_t watermark = high_watermark.load(std::memory_order_relaxed);
+  while (size > watermark &&
+         !high_watermark.compare_exchange_weak(watermark, size, std::memory_order_relaxed)) {}
+
+  if (waker) {
+    waker->Wake();
+  }
+  return true;
+}
+
+template <typename T>
+std::optional<T> Channel<T>::TryPop() {
+  std::size_t position = dequeue_position.load(std::memory_order_relaxed);
+  Cell& cell = cells[position & mask];
+  if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+    return std::nullopt;
+  }
+  std::optional<T> result(std::move(*cell.Get()));
+  cell.Get()->~T();
+  cell.sequence.store(position + mask + 1, std::memory_order_release);
+  dequeue_position.store(position + 1, std::memory_order_relaxed);
+  ++drained;
+  return result;
+}
+
+template <typename T>
+template <typename Handler>
+std::size_t Channel<T>::Drain(Handler&& handler, std::size_t max_messages) {
+  if (waker) {
+    waker->Reset();
+  }
+  std::size_t count = 0;
+  std::size_t position = dequeue_position.load(std::memory_order_relaxed);
+  while (count < max_messages) {
+    Cell& cell = cells[position & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+      break;
+    }
+    // The message is removed before the handler is called, so that it is not passed again by
+    // the next drain if the handler throws
+    T message(std::move(*cell.Get()));
+    cell.Get()->~T();
+    cell.sequence.store(position + mask + 1, std::memory_order_release);
+    ++position;
+    ++count;
+    ++drained;
+    dequeue_position.store(position, std::memory_order_relaxed);
+    handler(std::move(message));
+  }
+  return count;
+}
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_CHANNEL_H
@@ -49,6 +49,18 @@ struct Dimensions {
    * \param height Height of a 2D object.
    */
   constexpr Dimensions(int width, int height) : width(width), height(height) {}
+
+  /**
+   * \brief Test whether the dimensions are equal to other.
+   */
+  constexpr bool operator==(const Dimensions& other) const {
+    return width == other.width && height == other.height;
+  }
+
+  /**
+   * \brief Test whether the dimensions are not equal to other.
+   */
+  constexpr bool operator!=(const Dimensions& other) const { return !(*this == other); }
 };
 
 }  // namespace sdlxx
@@ -0,0 +1,275 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the EventBatch class that drains the event queue into a reusable buffer.
+ */
+
+#ifndef SDLXX_CORE_EVENT_BATCH_H
+#define SDLXX_CORE_EVENT_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <SDL_events.h>
+
+#include "sdlxx/core/events.h"
+#include "sdlxx/utils/bitmask.h"
+
+namespace sdlxx {
+
+/**
+ * \brief The kinds of events that EventBatch::Dispatch() routes to different typed handlers.
+ *
+ * Used as a bit mask to select the events that a receiver is interested in.
+ */
+enum class EventKind : uint32_t {
+  NONE = 0,
+  QUIT = 1U << 0U,          ///< SDL_QuitEvent
+  WINDOW = 1U << 1U,        ///< SDL_WindowEvent
+  KEYBOARD = 1U << 2U,      ///< SDL_KeyboardEvent
+  TEXT_INPUT = 1U << 3U,    ///< SDL_TextInputEvent
+  MOUSE_MOTION = 1U << 4U,  ///< SDL_MouseMotionEvent
+  MOUSE_BUTTON = 1U << 5U,  ///< SDL_MouseButtonEvent
+  MOUSE_WHEEL = 1U << 6U,   ///< SDL_MouseWheelEvent
+  TOUCH = 1U << 7U,         ///< SDL_TouchFingerEvent
+  USER = 1U << 8U,          ///< SDL_UserEvent
+  OTHER = 1U << 9U,         ///< Any other event
+  ALL = (1U << 10U) - 1U
+};
+
+/**
+ * \brief A helper that combines several callables into a single overloaded handler.
+ *
+ * \code
+ * batch.Dispatch(EventHandlers{
+ *     [](const SDL_QuitEvent& e) { ... },
+ *     [](const SDL_MouseMotionEvent& e) { ... },
+ *     [](const Event& e) { ... }  // Any other event
+ * });
+ * \endcode
+ */
+template <typename... Handlers>
+struct EventHandlers : Handlers... {
+  using Handlers::operator()...;
+};
+
+template <typename... Handlers>
+EventHandlers(Handlers...) -> EventHandlers<Handlers...>;
+
+/**
+ * \brief A class that drains the event queue into a preallocated buffer.
+ *
+ * The buffer is reused between frames, so draining the queue does not allocate once the buffer
+ * has grown to the typical number of events per frame. Redundant mouse motion and window resize
+ * events are coalesced while draining.
+ */
+class EventBatch {
+public:
+  /**
+   * \brief Construct an event batch.
+   *
+   * \param capacity The number of events to preallocate space for.
+   */
+  explicit EventBatch(std::size_t capacity = 256);
+
+  /**
+   * \brief Pump the event loop and move all pending events to the batch.
+   *
+   * Events from the previous call are discarded.
+   *
+   * \param coalesce Whether consecutive mouse motion and window resize events should be merged.
+   *
+   * \return std::size_t The number of events in the batch.
+   *
+   * \throw EventException if there was some error.
+   *
+   * \upstream SDL_PumpEvents
+   * \upstream SDL_PeepEvents
+   */
+  std::size_t Drain(bool coalesce = true);
+
+  /**
+   * \brief Remove all events from the batch without freeing the buffer.
+   */
+  void Clear() { count = 0; }
+
+  /**
+   * \brief Get the number of events in the batch.
+   */
+  std::size_t GetSize() const { return count; }
+
+  /**
+   * \brief Test whether the batch is empty.
+   */
+  bool IsEmpty() const { return count == 0; }
+
+  /**
+   * \brief Get the number of events that were merged into other events by the last Drain().
+   */
+  std::size_t GetCoalescedCount() const { return coalesced; }
+
+  const Event* begin() const { return events.data(); }
+
+  const Event* end() const { return events.data() + count; }
+
+  const Event& operator[](std::size_t i) const { return events[i]; }
+
+  /**
+   * \brief Call the handler that matches the type of the event.
+   *
+   * The handler is selected at compile time by the type of the event structure: a handler that
+   * accepts \c const SDL_MouseMotionEvent& receives mouse motion events, and so on. Events
+   * without a matching typed handler are passed to the handler that accepts \c const Event&, if
+   * any, and ignored otherwise.
+   *
+   * \param event   The event to dispatch.
+   * \param handler A callable object, usually EventHandlers.
+   *
+   * \return The value returned by the handler if it returns bool, true if the handler returns
+   *         nothing, or false if there was no suitable handler.
+   */
+  template <typename Handler>
+  static bool Dispatch(const Event& event, Handler&& handler);
+
+  /**
+   * \brief Get the kind of an event, which selects its handler in Dispatch().
+   */
+  static EventKind GetKind(const Event& event);
+
+  /**
+   * \brief Dispatch all events in the batch in order.
+   *
+   * \param handler A callable object, usually EventHandlers.
+   *
+   * \return std::size_t The number of events that were handled.
+   */
+  template <typename Handler>
+  std::size_t Dispatch(Handler&& handler) const {
+    std::size_t handled = 0;
+    for (const Event& event : *this) {
+      if (Dispatch(event, handler)) { ++handled; }
+    }
+    return handled;
+  }
+
+private:
+  std::vector<Event> events;
+  std::size_t count = 0;
+  std::size_t coalesced = 0;
+
+  void Coalesce();
+
+  template <typename Handler, typename T>
+  static bool Invoke(Handler& handler, const T& typed_event, const Event& event);
+};
+
+template <typename Handler, typename T>
+bool EventBatch::Invoke(Handler& handler, const T& typed_event, const Event& event) {
+  if constexpr (std::is_invocable_v<Handler&, const T&>) {
+    if constexpr (std::is_same_v<std::invoke_result_t<Handler&, const T&>, void>) {
+      handler(typed_event);
+      return true;
+    } else {
+      return static_cast<bool>(handler(typed_event));
+    }
+  } else if constexpr (std::is_invocable_v<Handler&, const Event&>) {
+    if constexpr (std::is_same_v<std::invoke_result_t<Handler&, const Event&>, void>) {
+      handler(event);
+      return true;
+    } else {
+      return static_cast<bool>(handler(event));
+    }
+  } else {
+    return false;
+  }
+}
+
+inline EventKind EventBatch::GetKind(const Event& event) {
+  switch (event.type) {
+    case SDL_QUIT:
+      return EventKind::QUIT;
+    case SDL_WINDOWEVENT:
+      return EventKind::WINDOW;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      return EventKind::KEYBOARD;
+    case SDL_TEXTINPUT:
+      return EventKind::TEXT_INPUT;
+    case SDL_MOUSEMOTION:
+      return EventKind::MOUSE_MOTION;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      return EventKind::MOUSE_BUTTON;
+    case SDL_MOUSEWHEEL:
+      return EventKind::MOUSE_WHEEL;
+    case SDL_FINGERDOWN:
+    case SDL_FINGERUP:
+    case SDL_FINGERMOTION:
+      return EventKind::TOUCH;
+    default:
+      if (event.type >= SDL_USEREVENT && event.type < SDL_LASTEVENT) {
+        return EventKind::USER;
+      }
+      return EventKind::OTHER;
+  }
+}
+
+template <typename Handler>
+bool EventBatch::Dispatch(const Event& event, Handler&& handler) {
+  switch (event.type) {
+    case SDL_QUIT:
+      return Invoke(handler, event.quit, event);
+    case SDL_WINDOWEVENT:
+      return Invoke(handler, event.window, event);
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      return Invoke(handler, event.key, event);
+    case SDL_TEXTINPUT:
+      return Invoke(handler, event.text, event);
+    case SDL_MOUSEMOTION:
+      return Invoke(handler, event.motion, event);
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      return Invoke(handler, event.button, event);
+    case SDL_MOUSEWHEEL:
+      return Invoke(handler, event.wheel, event);
+    case SDL_FINGERDOWN:
+    case SDL_FINGERUP:
+    case SDL_FINGERMOTION:
+      return Invoke(handler, event.tfinger, event);
+    default:
+      if (event.type >= SDL_USEREVENT && event.type < SDL_LASTEVENT) {
+        return Invoke(handler, event.user, event);
+      }
+      return Invoke(handler, event, event);
+  }
+}
+
+}  // namespace sdlxx
+
+ENABLE_BITMASK_OPERATORS(sdlxx::EventKind);
+
+#endif  // SDLXX_CORE_EVENT_BATCH_H
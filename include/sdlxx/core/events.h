@@ -235,6 +235,25 @@ public:
   static std::vector<Event> Peek(int numevents, Type min_type = Type::FIRSTEVENT,
                                  Type max_type = Type::LASTEVENT);
 
+  /**
+   * \brief Peek up to \c numevents events at the front of the event queue into a caller-provided
+   * buffer, within the specified minimum and maximum type.
+   *
+   * This function is thread-safe and does not allocate.
+   *
+   * \param events Buffer of at least \c numevents events.
+   * \param numevents Maximum number of events to peek.
+   * \param min_type, max_type Range of event types.
+   *
+   * \return int The number of events stored in the buffer.
+   *
+   * \throw EventException if there was some error.
+   *
+   * \upstream SDL_PeepEvents
+   */
+  static int Peek(Event* events, int numevents, Type min_type = Type::FIRSTEVENT,
+                  Type max_type = Type::LASTEVENT);
+
   /**
    * \brief Get up to \c numevents events at the front of the event queue,
    * within the specified minimum and maximum type, and remove them from the
@@ -254,6 +273,25 @@ public:
   static std::vector<Event> Get(int numevents, Type min_type = Type::FIRSTEVENT,
                                 Type max_type = Type::LASTEVENT);
 
+  /**
+   * \brief Get up to \c numevents events at the front of the event queue into a caller-provided
+   * buffer, within the specified minimum and maximum type, and remove them from the queue.
+   *
+   * This function is thread-safe and does not allocate.
+   *
+   * \param events Buffer of at least \c numevents events.
+   * \param numevents Maximum number of events to get.
+   * \param min_type, max_type Range of event types.
+   *
+   * \return int The number of events stored in the buffer.
+   *
+   * \throw EventException if there was some error.
+   *
+   * \upstream SDL_PeepEvents
+   */
+  static int Get(Event* events, int numevents, Type min_type = Type::FIRSTEVENT,
+                 Type max_type = Type::LASTEVENT);
+
   /**
    * \brief Checks to see if certain event type is in the event queue.
    *
@@ -364,8 +402,21 @@ public:
    */
   static bool Push(Event* event);
 
+  /**
+   * \brief Allocate a set of user-defined events.
+   *
+   * \param numevents The number of events to be allocated.
+   *
+   * \return uint32_t The beginning event number of the allocated range.
+   *
+   * \throw EventException if there are not enough user-defined events left.
+   *
+   * \upstream SDL_RegisterEvents
+   */
+  static uint32_t Register(int numevents = 1);
+
   // TODO: SDL_EventFilter, SDL_SetEventFilter, SDL_GetEventFilter, SDL_AddEventWatch,
-  // SDL_DelEventWatch, SDL_FilterEvents, SDL_EventState, SDL_GetEventState, SDL_RegisterEvents
+  // SDL_DelEventWatch, SDL_FilterEvents, SDL_EventState, SDL_GetEventState
 };
 
 }  // namespace sdlxx
@@ -0,0 +1,125 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the built-in post-processing effects of the OpenGL backend.
+ */
+
+#ifndef SDLXX_CORE_GL_EFFECTS_H
+#define SDLXX_CORE_GL_EFFECTS_H
+
+#include "sdlxx/core/gl_post_processor.h"
+
+namespace sdlxx {
+
+namespace GL {  // NOLINT(readability-identifier-naming)
+
+/**
+ * \brief Settings of the ColorGrading effect.
+ */
+struct ColorGradingSettings {
+  float brightness = 0.0F;                      ///< Value added to every channel
+  float contrast = 1.0F;                        ///< Scale of the distance from mid-gray
+  float saturation = 1.0F;                      ///< 0 is grayscale, 1 keeps the colors
+  float gamma = 1.0F;                           ///< Gamma that is applied last
+  float tint[4] = {1.0F, 1.0F, 1.0F, 1.0F};     ///< Color multiplied into the image first
+};
+
+/**
+ * \brief An effect that tints, brightens, adjusts contrast, saturation and gamma.
+ */
+class ColorGrading : public ShaderEffect {
+public:
+  explicit ColorGrading(PostProcessor& processor,
+                        const ColorGradingSettings& settings = ColorGradingSettings());
+
+  /**
+   * \brief Change the settings.
+   */
+  void SetSettings(const ColorGradingSettings& settings) { SetParameters(settings); }
+};
+
+/**
+ * \brief Settings of the CrtEffect.
+ */
+struct CrtSettings {
+  float curvature = 0.1F;   ///< Barrel distortion of the screen, 0 for a flat screen
+  float scanlines = 0.25F;  ///< Darkening of every other output row
+  float vignette = 0.3F;    ///< Darkening of the corners
+  float aberration = 1.0F;  ///< Distance between red and blue channels in input pixels
+};
+
+/**
+ * \brief An effect that imitates a cathode-ray tube screen.
+ */
+class CrtEffect : public ShaderEffect {
+public:
+  explicit CrtEffect(PostProcessor& processor, const CrtSettings& settings = CrtSettings());
+
+  /**
+   * \brief Change the settings.
+   */
+  void SetSettings(const CrtSettings& settings) { SetParameters(settings); }
+};
+
+/**
+ * \brief Settings of the Bloom effect.
+ */
+struct BloomSettings {
+  float threshold = 0.7F;  ///< Luminance above which pixels glow
+  float intensity = 1.0F;  ///< Scale of the glow that is added to the image
+  float spread = 1.0F;     ///< Scale of the blur radius
+  int iterations = 2;      ///< Number of blur passes at half resolution
+};
+
+/**
+ * \brief An effect that makes bright areas glow.
+ *
+ * Bright pixels are extracted to a half-resolution target, blurred with separable Gaussian
+ * passes and added to the image. Intermediate targets are borrowed from the processor's pool.
+ */
+class Bloom : public Effect {
+public:
+  explicit Bloom(PostProcessor& processor, const BloomSettings& settings = BloomSettings());
+
+  /**
+   * \brief Change the settings.
+   */
+  void SetSettings(const BloomSettings& settings);
+
+  void Apply(PostProcessor& processor, const RenderTarget& input, RenderTarget* output) override;
+
+private:
+  GLuint threshold_program;
+  GLuint horizontal_program;
+  GLuint vertical_program;
+  GLuint combine_program;
+  UniformBuffer parameters;
+  int iterations = 0;
+};
+
+}  // namespace GL
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_GL_EFFECTS_H
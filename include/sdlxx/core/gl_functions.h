@@ -0,0 +1,152 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the table of OpenGL functions loaded from the current context.
+ */
+
+#ifndef SDLXX_CORE_GL_FUNCTIONS_H
+#define SDLXX_CORE_GL_FUNCTIONS_H
+
+#include <SDL_opengl.h>
+
+namespace sdlxx {
+
+namespace GL {  // NOLINT(readability-identifier-naming)
+
+/**
+ * \brief A table of OpenGL functions used by the GL rendering backend.
+ *
+ * Functions are loaded with GL::GetProcAddress(), so the backend does not link with the OpenGL
+ * library and works with both desktop OpenGL 3.3 core and OpenGL ES 3.0 contexts. Pointers are
+ * only valid for the context that was current when the table was loaded.
+ */
+struct Functions {
+  /**
+   * \brief Load the functions of the current context.
+   *
+   * \throw GlException if there is no current context, its version is lower than OpenGL 3.3 or
+   *                    OpenGL ES 3.0, or a required function is missing.
+   */
+  Functions();
+
+  /**
+   * \brief Check whether the context supports an extension.
+   */
+  bool HasExtension(const char* extension) const;
+
+  int major_version = 0;        ///< Major version of the context
+  int minor_version = 0;        ///< Minor version of the context
+  bool es = false;              ///< True for OpenGL ES contexts
+  bool buffer_storage = false;  ///< True if immutable buffers can be persistently mapped
+
+  decltype(&glBindTexture) BindTexture = nullptr;
+  decltype(&glClear) Clear = nullptr;
+  decltype(&glClearColor) ClearColor = nullptr;
+  decltype(&glDeleteTextures) DeleteTextures = nullptr;
+  decltype(&glDisable) Disable = nullptr;
+  decltype(&glDrawArrays) DrawArrays = nullptr;
+  decltype(&glEnable) Enable = nullptr;
+  decltype(&glFinish) Finish = nullptr;
+  decltype(&glGenTextures) GenTextures = nullptr;
+  decltype(&glGetError) GetError = nullptr;
+  decltype(&glGetIntegerv) GetIntegerv = nullptr;
+  decltype(&glGetString) GetString = nullptr;
+  decltype(&glPixelStorei) PixelStorei = nullptr;
+  decltype(&glReadPixels) ReadPixels = nullptr;
+  decltype(&glScissor) Scissor = nullptr;
+  decltype(&glTexImage2D) TexImage2D = nullptr;
+  decltype(&glTexParameteri) TexParameteri = nullptr;
+  decltype(&glViewport) Viewport = nullptr;
+
+  PFNGLACTIVETEXTUREPROC ActiveTexture = nullptr;
+  PFNGLATTACHSHADERPROC AttachShader = nullptr;
+  PFNGLBINDBUFFERPROC BindBuffer = nullptr;
+  PFNGLBINDBUFFERBASEPROC BindBufferBase = nullptr;
+  PFNGLBINDFRAMEBUFFERPROC BindFramebuffer = nullptr;
+  PFNGLBINDVERTEXARRAYPROC BindVertexArray = nullptr;
+  PFNGLBLENDEQUATIONPROC BlendEquation = nullptr;
+  PFNGLBLENDFUNCSEPARATEPROC BlendFuncSeparate = nullptr;
+  PFNGLBUFFERDATAPROC BufferData = nullptr;
+  PFNGLBUFFERSUBDATAPROC BufferSubData = nullptr;
+  PFNGLBUFFERSTORAGEPROC BufferStorage = nullptr;  ///< Null if buffer_storage is false
+  PFNGLCHECKFRAMEBUFFERSTATUSPROC CheckFramebufferStatus = nullptr;
+  PFNGLCLIENTWAITSYNCPROC ClientWaitSync = nullptr;
+  PFNGLCOMPILESHADERPROC CompileShader = nullptr;
+  PFNGLCREATEPROGRAMPROC CreateProgram = nullptr;
+  PFNGLCREATESHADERPROC CreateShader = nullptr;
+  PFNGLDELETEBUFFERSPROC DeleteBuffers = nullptr;
+  PFNGLDELETEFRAMEBUFFERSPROC DeleteFramebuffers = nullptr;
+  PFNGLDELETEPROGRAMPROC DeleteProgram = nullptr;
+  PFNGLDELETESHADERPROC DeleteShader = nullptr;
+  PFNGLDELETESYNCPROC DeleteSync = nullptr;
+  PFNGLDELETEVERTEXARRAYSPROC DeleteVertexArrays = nullptr;
+  PFNGLDRAWARRAYSINSTANCEDPROC DrawArraysInstanced = nullptr;
+  PFNGLENABLEVERTEXATTRIBARRAYPROC EnableVertexAttribArray = nullptr;
+  PFNGLFENCESYNCPROC FenceSync = nullptr;
+  PFNGLFRAMEBUFFERTEXTURE2DPROC FramebufferTexture2D = nullptr;
+  PFNGLGENBUFFERSPROC GenBuffers = nullptr;
+  PFNGLGENFRAMEBUFFERSPROC GenFramebuffers = nullptr;
+  PFNGLGENVERTEXARRAYSPROC GenVertexArrays = nullptr;
+  PFNGLGETPROGRAMINFOLOGPROC GetProgramInfoLog = nullptr;
+  PFNGLGETPROGRAMIVPROC GetProgramiv = nullptr;
+  PFNGLGETSHADERINFOLOGPROC GetShaderInfoLog = nullptr;
+  PFNGLGETSHADERIVPROC GetShaderiv = nullptr;
+  PFNGLGETSTRINGIPROC GetStringi = nullptr;
+  PFNGLGETUNIFORMBLOCKINDEXPROC GetUniformBlockIndex = nullptr;
+  PFNGLGETUNIFORMLOCATIONPROC GetUniformLocation = nullptr;
+  PFNGLLINKPROGRAMPROC LinkProgram = nullptr;
+  PFNGLMAPBUFFERRANGEPROC MapBufferRange = nullptr;
+  PFNGLSHADERSOURCEPROC ShaderSource = nullptr;
+  PFNGLTEXIMAGE3DPROC TexImage3D = nullptr;
+  PFNGLTEXSUBIMAGE3DPROC TexSubImage3D = nullptr;
+  PFNGLUNIFORM1IPROC Uniform1i = nullptr;
+  PFNGLUNIFORM2FPROC Uniform2f = nullptr;
+  PFNGLUNIFORMBLOCKBINDINGPROC UniformBlockBinding = nullptr;
+  PFNGLUNMAPBUFFERPROC UnmapBuffer = nullptr;
+  PFNGLUSEPROGRAMPROC UseProgram = nullptr;
+  PFNGLVERTEXATTRIBDIVISORPROC VertexAttribDivisor = nullptr;
+  PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer = nullptr;
+};
+
+/**
+ * \brief Compile and link a shader program.
+ *
+ * The version directive is added to both sources: `#version 330 core` for desktop contexts and
+ * `#version 300 es` with default precision qualifiers for OpenGL ES contexts.
+ *
+ * \param gl              Functions of the current context.
+ * \param vertex_source   Source of the vertex shader, without the version directive.
+ * \param fragment_source Source of the fragment shader, without the version directive.
+ *
+ * \return The name of the program.
+ *
+ * \throw GlException with the info log if a shader does not compile or the program does not link.
+ */
+GLuint CreateProgram(const Functions& gl, const char* vertex_source, const char* fragment_source);
+
+}  // namespace GL
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_GL_FUNCTIONS_H
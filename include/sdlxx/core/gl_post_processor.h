@@ -0,0 +1,368 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the post-processing chain of the OpenGL backend.
+ */
+
+#ifndef SDLXX_CORE_GL_POST_PROCESSOR_H
+#define SDLXX_CORE_GL_POST_PROCESSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "sdlxx/core/dimensions.h"
+#include "sdlxx/core/gl_functions.h"
+#include "sdlxx/core/gl_renderer.h"
+
+namespace sdlxx {
+
+namespace GL {  // NOLINT(readability-identifier-naming)
+
+class PostProcessor;
+
+/**
+ * \brief A class for a uniform buffer that backs a std140 uniform block.
+ */
+class UniformBuffer {
+public:
+  /**
+   * \brief Create a uniform buffer of the given size in bytes, filled with zeros.
+   */
+  UniformBuffer(const Functions& gl, std::size_t size);
+
+  /**
+   * \brief Destroy the buffer.
+   */
+  ~UniformBuffer();
+
+  /**
+   * \brief Replace the contents of the buffer.
+   *
+   * \throw GlException if the data is larger than the buffer.
+   */
+  void Update(const void* data, std::size_t size);
+
+  /**
+   * \brief Replace the contents of the buffer with a struct laid out like the std140 block.
+   */
+  template <typename T>
+  void Update(const T& data) {
+    static_assert(std::is_trivially_copyable_v<T>, "Uniform data must be trivially copyable");
+    Update(&data, sizeof(T));
+  }
+
+  /**
+   * \brief Bind the buffer to a uniform block binding point.
+   */
+  void Bind(GLuint binding) const;
+
+  /**
+   * \brief Get the size of the buffer in bytes.
+   */
+  std::size_t GetSize() const { return size; }
+
+  // Deleted copy constructor
+  UniformBuffer(const UniformBuffer&) = delete;
+
+  // Deleted copy assignment operator
+  UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+private:
+  const Functions& gl;
+  GLuint buffer = 0;
+  std::size_t size;
+};
+
+/**
+ * \brief A class that compiles every shader program once.
+ *
+ * Programs are keyed by a 64-bit hash of their sources, so effects that use the same shader
+ * share a program, and recreating an effect does not compile it again. Programs are deleted with
+ * the cache.
+ */
+class ShaderCache {
+public:
+  /**
+   * \brief Create an empty cache for the functions of the current context.
+   */
+  explicit ShaderCache(const Functions& gl) : gl(gl) {}
+
+  /**
+   * \brief Delete all programs.
+   */
+  ~ShaderCache();
+
+  /**
+   * \brief Get the program for the sources, compiling and linking it if it is not cached.
+   *
+   * \param vertex_source   Source of the vertex shader, without the version directive.
+   * \param fragment_source Source of the fragment shader, without the version directive.
+   * \param setup           A function that is called once with a new program, to bind its
+   *                        uniform blocks and samplers.
+   *
+   * \throw GlException if the program can not be compiled or linked.
+   */
+  GLuint Get(std::string_view vertex_source, std::string_view fragment_source,
+             const std::function<void(GLuint)>& setup = {});
+
+  /**
+   * \brief Get the number of compiled programs.
+   */
+  std::size_t GetProgramCount() const { return programs.size(); }
+
+  /**
+   * \brief Compute the 64-bit FNV-1a hash of a string.
+   */
+  static uint64_t Hash(std::string_view data, uint64_t seed = 14695981039346656037ULL);
+
+  // Deleted copy constructor
+  ShaderCache(const ShaderCache&) = delete;
+
+  // Deleted copy assignment operator
+  ShaderCache& operator=(const ShaderCache&) = delete;
+
+private:
+  const Functions& gl;
+  std::unordered_map<uint64_t, GLuint> programs;
+};
+
+/**
+ * \brief An interface of a post-processing effect.
+ */
+class Effect {
+public:
+  virtual ~Effect() = default;
+
+  /**
+   * \brief Draw the effect of an input image to an output.
+   *
+   * \param processor The processor that runs the effect, for passes and intermediate targets.
+   * \param input     The image to process.
+   * \param output    The target to draw to, or nullptr for the default framebuffer.
+   */
+  virtual void Apply(PostProcessor& processor, const RenderTarget& input,
+                     RenderTarget* output) = 0;
+};
+
+/**
+ * \brief A single-pass effect defined by a fragment shader and a block of parameters.
+ *
+ * The source is appended to a prelude that declares:
+ * - `in vec2 v_texcoord`, the texture coordinate of the fragment in the input;
+ * - `out vec4 fragment_color`;
+ * - `uniform sampler2D u_input0`, the input image, and `u_input1` to `u_input3`;
+ * - `uniform Frame` with `vec4 u_output_size` and `vec4 u_input_size`, that contain the width,
+ *   the height and their reciprocals, and `float u_time`.
+ *
+ * Parameters are read from a std140 uniform block named `Parameters`.
+ */
+class ShaderEffect : public Effect {
+public:
+  /**
+   * \brief Create an effect.
+   *
+   * \param processor       The processor that compiles the shader.
+   * \param fragment_source The body of the fragment shader, after the prelude.
+   * \param parameters_size The size of the Parameters block in bytes.
+   *
+   * \throw GlException if the shader can not be compiled.
+   */
+  ShaderEffect(PostProcessor& processor, std::string_view fragment_source,
+               std::size_t parameters_size = 0);
+
+  /**
+   * \brief Set the parameters from a struct laid out like the std140 block.
+   */
+  template <typename T>
+  void SetParameters(const T& parameters) {
+    this->parameters.Update(parameters);
+  }
+
+  void Apply(PostProcessor& processor, const RenderTarget& input, RenderTarget* output) override;
+
+protected:
+  GLuint program;
+  UniformBuffer parameters;
+};
+
+/**
+ * \brief A class that runs a chain of effects over a rendered frame.
+ *
+ * The frame is drawn to a render target between Begin() and End(). End() runs the effects in
+ * order, each reading the output of the previous one, and the last one draws to the default
+ * framebuffer or a given target. Intermediate images are render targets from a pool, that are
+ * returned to the pool as soon as the next effect has read them, so a chain of any length
+ * ping-pongs between two targets and multi-pass effects borrow only what they need. Pooled
+ * targets are kept between frames and only created again when the output size changes.
+ */
+class PostProcessor {
+public:
+  /**
+   * \brief Create a post-processor that draws with the renderer.
+   *
+   * \throw GlException if the shaders can not be compiled.
+   */
+  explicit PostProcessor(Renderer& renderer);
+
+  /**
+   * \brief Destroy the post-processor, its pool and its programs.
+   */
+  ~PostProcessor();
+
+  /**
+   * \brief Add an effect to the end of the chain. The effect must outlive the processor.
+   */
+  void Add(Effect& effect) { effects.push_back(&effect); }
+
+  /**
+   * \brief Remove all effects.
+   */
+  void ClearEffects() { effects.clear(); }
+
+  /**
+   * \brief Set the time that is passed to the shaders, in seconds.
+   */
+  void SetTime(float seconds) { time = seconds; }
+
+  /**
+   * \brief Start a frame: the renderer draws to a pooled target of the output size.
+   */
+  void Begin();
+
+  /**
+   * \brief Finish a frame: run the chain over the frame and draw the result to the output.
+   *
+   * \param output The target to draw to, or nullptr for the default framebuffer.
+   */
+  void End(RenderTarget* output = nullptr);
+
+  /**
+   * \brief Run the chain over an image.
+   */
+  void Apply(const RenderTarget& input, RenderTarget* output = nullptr);
+
+  /**
+   * \brief Get a program for a fragment shader, see ShaderEffect for the prelude.
+   *
+   * \throw GlException if the shader can not be compiled.
+   */
+  GLuint GetProgram(std::string_view fragment_source);
+
+  /**
+   * \brief Draw a full-screen pass.
+   *
+   * \param program    A program from GetProgram().
+   * \param inputs     Up to four images, that are bound to u_input0 to u_input3.
+   * \param output     The target to draw to, or nullptr for the default framebuffer.
+   * \param parameters The buffer for the Parameters block, or nullptr.
+   */
+  void DrawPass(GLuint program, std::initializer_list<const RenderTarget*> inputs,
+                RenderTarget* output, const UniformBuffer* parameters = nullptr);
+
+  /**
+   * \brief Take a render target from the pool, creating it if there is none of this size.
+   */
+  RenderTarget& AcquireTarget(Dimensions size);
+
+  /**
+   * \brief Return a render target to the pool.
+   */
+  void ReleaseTarget(const RenderTarget& target);
+
+  /**
+   * \brief Delete the pooled targets that are not in use.
+   */
+  void TrimPool();
+
+  /**
+   * \brief Get the number of render targets in the pool, including those in use.
+   */
+  std::size_t GetPoolSize() const { return pool.size(); }
+
+  /**
+   * \brief Get the number of passes drawn since the last ResetStatistics().
+   */
+  std::size_t GetPassCount() const { return pass_count; }
+
+  /**
+   * \brief Reset the number of passes.
+   */
+  void ResetStatistics() { pass_count = 0; }
+
+  /**
+   * \brief Get the renderer.
+   */
+  Renderer& GetRenderer() { return renderer; }
+
+  /**
+   * \brief Get the shader cache.
+   */
+  ShaderCache& GetShaderCache() { return shaders; }
+
+  // Deleted copy constructor
+  PostProcessor(const PostProcessor&) = delete;
+
+  // Deleted copy assignment operator
+  PostProcessor& operator=(const PostProcessor&) = delete;
+
+private:
+  struct PooledTarget {
+    std::unique_ptr<RenderTarget> target;
+    bool in_use;
+  };
+
+  /// Layout of the std140 Frame block
+  struct FrameBlock {
+    float output_size[4];
+    float input_size[4];
+    float time;
+    float padding[3];
+  };
+
+  Renderer& renderer;
+  const Functions& gl;
+  ShaderCache shaders;
+  UniformBuffer frame;
+  GLuint vertex_array = 0;
+  GLuint copy_program = 0;
+  std::vector<Effect*> effects;
+  std::vector<PooledTarget> pool;
+  RenderTarget* scene = nullptr;
+  float time = 0.0F;
+  std::size_t pass_count = 0;
+};
+
+}  // namespace GL
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_GL_POST_PROCESSOR_H
@@ -0,0 +1,501 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the OpenGL rendering backend that draws sprites with instanced quads.
+ */
+
+#ifndef SDLXX_CORE_GL_RENDERER_H
+#define SDLXX_CORE_GL_RENDERER_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "sdlxx/core/blendmode.h"
+#include "sdlxx/core/color.h"
+#include "sdlxx/core/dimensions.h"
+#include "sdlxx/core/gl.h"
+#include "sdlxx/core/gl_functions.h"
+#include "sdlxx/core/point.h"
+#include "sdlxx/core/rectangle.h"
+
+namespace sdlxx {
+
+class Surface;
+
+namespace GL {  // NOLINT(readability-identifier-naming)
+
+class Renderer;
+
+/**
+ * \brief A class for an array of equally sized RGBA textures.
+ *
+ * Every sprite selects a layer of the array, so sprites from different layers are drawn in a
+ * single call. Textures use nearest filtering, like the default scale quality of SDL renderers.
+ *
+ * \note The renderer must outlive its textures.
+ */
+class Texture {
+public:
+  /**
+   * \brief Create a texture array with undefined contents.
+   *
+   * \param renderer The renderer that draws the texture.
+   * \param width    The width of every layer in pixels.
+   * \param height   The height of every layer in pixels.
+   * \param layers   The number of layers.
+   *
+   * \throw GlException if the texture can not be created.
+   */
+  Texture(Renderer& renderer, int width, int height, int layers = 1);
+
+  /**
+   * \brief Create a single layer texture from a surface.
+   *
+   * \throw GlException if the texture can not be created.
+   */
+  Texture(Renderer& renderer, const Surface& surface);
+
+  /**
+   * \brief Create a texture array from surfaces of the same size, one surface per layer.
+   *
+   * \throw GlException if the surfaces have different sizes or the texture can not be created.
+   */
+  Texture(Renderer& renderer, const std::vector<Surface>& surfaces);
+
+  /**
+   * \brief Destroy the texture.
+   */
+  ~Texture();
+
+  /**
+   * \brief Replace the contents of a layer with a surface of the same size.
+   *
+   * The surface is converted to SDL_PIXELFORMAT_RGBA32 if it has a different format.
+   *
+   * \throw GlException if the layer or the size is wrong.
+   */
+  void Update(int layer, const Surface& surface);
+
+  /**
+   * \brief Replace the contents of a layer with pixels in SDL_PIXELFORMAT_RGBA32 format.
+   *
+   * \param layer  The index of the layer.
+   * \param pixels The pixels of the whole layer.
+   * \param pitch  The length of a row of pixels in bytes.
+   *
+   * \throw GlException if the layer is out of range.
+   */
+  void Update(int layer, const void* pixels, int pitch);
+
+  /**
+   * \brief Set the blend mode that is used to draw the texture.
+   *
+   * The default blend mode is BlendMode::BLEND.
+   */
+  void SetBlendMode(BlendMode blend_mode) { this->blend_mode = blend_mode; }
+
+  /**
+   * \brief Get the blend mode that is used to draw the texture.
+   */
+  BlendMode GetBlendMode() const { return blend_mode; }
+
+  /**
+   * \brief Get the size of a layer.
+   */
+  Dimensions GetSize() const { return size; }
+
+  /**
+   * \brief Get the number of layers.
+   */
+  int GetLayerCount() const { return layers; }
+
+  /**
+   * \brief Get the OpenGL name of the GL_TEXTURE_2D_ARRAY texture.
+   */
+  GLuint GetHandle() const { return texture; }
+
+  // Deleted copy constructor
+  Texture(const Texture&) = delete;
+
+  // Deleted copy assignment operator
+  Texture& operator=(const Texture&) = delete;
+
+private:
+  friend class Renderer;
+
+  const Functions& gl;
+  GLuint texture = 0;
+  Dimensions size;
+  int layers;
+  float inverse_width;
+  float inverse_height;
+  BlendMode blend_mode = BlendMode::BLEND;
+};
+
+/**
+ * \brief A class for an RGBA texture with a framebuffer, that can be drawn to.
+ *
+ * The texture uses linear filtering, so it can be sampled at a different resolution by
+ * post-processing effects. Like the default framebuffer, row 0 of the texture is the bottom row.
+ *
+ * \note The renderer must outlive its render targets.
+ */
+class RenderTarget {
+public:
+  /**
+   * \brief Create a render target with undefined contents.
+   *
+   * \throw GlException if the framebuffer is not complete.
+   */
+  RenderTarget(Renderer& renderer, Dimensions size);
+
+  /**
+   * \brief Destroy the render target.
+   */
+  ~RenderTarget();
+
+  /**
+   * \brief Get the size of the render target.
+   */
+  Dimensions GetSize() const { return size; }
+
+  /**
+   * \brief Get the OpenGL name of the GL_TEXTURE_2D texture.
+   */
+  GLuint GetTexture() const { return texture; }
+
+  /**
+   * \brief Get the OpenGL name of the framebuffer.
+   */
+  GLuint GetFramebuffer() const { return framebuffer; }
+
+  // Deleted copy constructor
+  RenderTarget(const RenderTarget&) = delete;
+
+  // Deleted copy assignment operator
+  RenderTarget& operator=(const RenderTarget&) = delete;
+
+private:
+  const Functions& gl;
+  GLuint texture = 0;
+  GLuint framebuffer = 0;
+  Dimensions size;
+};
+
+/**
+ * \brief A renderer that draws sprites and primitives with OpenGL 3.3 core or OpenGL ES 3.0.
+ *
+ * The renderer has the sprite API of SpriteBatch and the primitive API of sdlxx::Renderer, but
+ * every sprite, point, line and rectangle is a single instance of a quad that is expanded in the
+ * vertex shader. Instances are written straight into a streaming vertex buffer, that is split
+ * into three segments guarded by fences, so the CPU fills a segment while the GPU reads another.
+ * If buffer storage is supported, the buffer is mapped persistently once and sprites are written
+ * to GPU-visible memory without copies, otherwise every batch is copied with an unsynchronized
+ * buffer mapping.
+ *
+ * Consecutive instances are drawn with one instanced draw call until the texture or the blend
+ * mode changes, or the segment is full. Primitives are drawn within the current batch, if their
+ * blend mode matches it.
+ *
+ * The GL context must be current while the renderer is used, and the renderer changes the bound
+ * framebuffer, program, vertex array, buffer and texture, and the viewport, blend and scissor
+ * state while drawing.
+ */
+class Renderer {
+public:
+  /**
+   * \brief Create a renderer for the current context.
+   *
+   * \param context            The current context.
+   * \param size               The size of the drawable, see Context::GetDrawableSize().
+   * \param capacity           The number of instances in a segment of the streaming buffer.
+   * \param persistent_mapping Whether to map the streaming buffer persistently, if supported.
+   *
+   * \throw GlException if the context is not supported or the resources can not be created.
+   */
+  Renderer(Context& context, Dimensions size, std::size_t capacity = 65536,
+           bool persistent_mapping = true);
+
+  /**
+   * \brief Destroy the renderer and its GL resources.
+   */
+  ~Renderer();
+
+  /**
+   * \brief Get the context that the renderer draws with.
+   */
+  Context& GetContext() { return context; }
+
+  /**
+   * \brief Get the functions of the context.
+   */
+  const Functions& GetFunctions() const { return gl; }
+
+  /**
+   * \brief Set the size of the drawable, after the window is resized.
+   *
+   * Also resets the clip rectangle, if the default framebuffer is the rendering target.
+   */
+  void SetOutputSize(Dimensions size);
+
+  /**
+   * \brief Get the size of the drawable.
+   */
+  Dimensions GetOutputSize() const { return output_size; }
+
+  /**
+   * \brief Draw to a render target instead of the default framebuffer.
+   *
+   * Also resets the clip rectangle. The target must stay alive while it is set.
+   */
+  void SetRenderTarget(RenderTarget& target);
+
+  /**
+   * \brief Draw to the default framebuffer.
+   */
+  void SetRenderTargetDefault();
+
+  /**
+   * \brief Get the size of the current rendering target.
+   */
+  Dimensions GetRenderTargetSize() const { return size; }
+
+  /**
+   * \brief Set the clip rectangle for drawing.
+   */
+  void SetClipRectangle(const Rectangle& rectangle);
+
+  /**
+   * \brief Disable clipping.
+   */
+  void ResetClipRectangle();
+
+  /**
+   * \brief Set the color used for drawing operations (Clear, Line, Rect, etc.).
+   */
+  void SetDrawColor(Color color) { draw_color = color; }
+
+  /**
+   * \brief Get the color used for drawing operations.
+   */
+  Color GetColor() const { return draw_color; }
+
+  /**
+   * \brief Set the blend mode used for drawing operations (Fill and Line).
+   *
+   * The default blend mode is BlendMode::NONE.
+   */
+  void SetDrawBlendMode(BlendMode blend_mode) { draw_blend_mode = blend_mode; }
+
+  /**
+   * \brief Get the blend mode used for drawing operations.
+   */
+  BlendMode GetDrawBlendMode() const { return draw_blend_mode; }
+
+  /**
+   * \brief Clear the current rendering target with the drawing color.
+   *
+   * The entire rendering target is cleared, ignoring the clip rectangle.
+   */
+  void Clear();
+
+  /**
+   * \brief Draw a point on the current rendering target.
+   */
+  void DrawPoint(Point point);
+
+  /**
+   * \brief Draw multiple points on the current rendering target.
+   */
+  void DrawPoints(const std::vector<Point>& points);
+
+  /**
+   * \brief Draw a line on the current rendering target.
+   *
+   * The line is a quad that is one pixel thick and covers both endpoints.
+   */
+  void DrawLine(Point line_start, Point line_end);
+
+  /**
+   * \brief Draw a series of connected lines on the current rendering target.
+   */
+  void DrawLines(const std::vector<Point>& points);
+
+  /**
+   * \brief Draw a rectangle on the current rendering target.
+   */
+  void DrawRectangle(const Rectangle& rectangle);
+
+  /**
+   * \brief Draw some number of rectangles on the current rendering target.
+   */
+  void DrawRectangles(const std::vector<Rectangle>& rectangles);
+
+  /**
+   * \brief Fill a rectangle on the current rendering target with the drawing color.
+   */
+  void FillRectangle(const Rectangle& rectangle);
+
+  /**
+   * \brief Fill some number of rectangles on the current rendering target with the drawing color.
+   */
+  void FillRectangles(const std::vector<Rectangle>& rectangles);
+
+  /**
+   * \brief Copy the first layer of a texture to a rectangle of the rendering target.
+   */
+  void Copy(const Texture& texture, const Rectangle& dest);
+
+  /**
+   * \brief Copy a portion of the first layer of a texture to the rendering target.
+   */
+  void Copy(const Texture& texture, const Rectangle& source, const Rectangle& dest);
+
+  /**
+   * \brief Draw a sprite from the first layer of a texture.
+   *
+   * \see Draw(const Texture&, int, const Rectangle&, float, float, float, float, float, Color)
+   */
+  void Draw(const Texture& texture, const Rectangle& source, float x, float y, float width,
+            float height, float angle = 0.0F, Color color = Color::WHITE) {
+    Draw(texture, 0, source, x, y, width, height, angle, color);
+  }
+
+  /**
+   * \brief Draw a sprite.
+   *
+   * \param texture The texture of the sprite. It must stay alive until the batch is flushed.
+   * \param layer   The layer of the texture.
+   * \param source  The rectangle of the sprite in the layer.
+   * \param x       X coordinate of the top left corner of the destination.
+   * \param y       Y coordinate of the top left corner of the destination.
+   * \param width   The width of the destination.
+   * \param height  The height of the destination.
+   * \param angle   An angle in degrees to rotate the sprite around its center, clockwise.
+   * \param color   The color that is multiplied into the texture color.
+   */
+  void Draw(const Texture& texture, int layer, const Rectangle& source, float x, float y,
+            float width, float height, float angle = 0.0F, Color color = Color::WHITE);
+
+  /**
+   * \brief Draw the collected batch.
+   *
+   * Must be called before Context::SwapWindow() and before other code draws with the context.
+   * Binds the current rendering target.
+   */
+  void Flush();
+
+  /**
+   * \brief Read pixels from the current rendering target in SDL_PIXELFORMAT_RGBA32 format.
+   *
+   * Flushes the batch and waits for the GPU, so it should only be used for tests and
+   * screenshots. Rows are returned from top to bottom.
+   */
+  void ReadPixels(const Rectangle& rectangle, void* pixels, int pitch);
+
+  /**
+   * \brief Check whether the streaming buffer is persistently mapped.
+   */
+  bool IsPersistentlyMapped() const { return persistent; }
+
+  /**
+   * \brief Get the number of draw calls made since the last ResetStatistics().
+   */
+  std::size_t GetRenderCalls() const { return render_calls; }
+
+  /**
+   * \brief Get the number of sprites and primitives drawn since the last ResetStatistics().
+   */
+  std::size_t GetSpriteCount() const { return sprite_count; }
+
+  /**
+   * \brief Get the number of times the CPU waited for the GPU to release a buffer segment.
+   */
+  std::size_t GetStallCount() const { return stall_count; }
+
+  /**
+   * \brief Reset the number of draw calls, drawn sprites and stalls.
+   */
+  void ResetStatistics();
+
+  // Deleted copy constructor
+  Renderer(const Renderer&) = delete;
+
+  // Deleted copy assignment operator
+  Renderer& operator=(const Renderer&) = delete;
+
+private:
+  /// Per-instance attributes of a quad
+  struct Instance {
+    float x, y, width, height;  // Destination rectangle before rotation
+    float u0, v0, u1, v1;       // Normalized texture coordinates
+    float angle;                // Rotation around the center in radians
+    float layer;                // Texture layer, negative for untextured primitives
+    Color color;
+  };
+
+  static constexpr std::size_t SEGMENTS = 3;
+
+  Instance& Append(GLuint texture, BlendMode blend_mode);
+  void AppendRectangle(float x, float y, float width, float height, float angle = 0.0F);
+  void NextSegment();
+  void ApplyBlendMode(BlendMode blend_mode);
+  void ApplyClip();
+  void BindTarget();
+  void Destroy();
+
+  Context& context;
+  Functions gl;
+  Dimensions output_size;
+  Dimensions size;  // Size of the current rendering target
+  GLuint framebuffer = 0;
+  const std::size_t capacity;
+  bool persistent = false;
+  GLuint program = 0;
+  GLint scale_location = -1;
+  GLuint vertex_array = 0;
+  GLuint buffer = 0;
+  Instance* mapped = nullptr;
+  std::vector<Instance> staging;
+  std::array<GLsync, SEGMENTS> fences{};
+  std::size_t segment = 0;
+  std::size_t segment_used = 0;
+  std::size_t batch_start = 0;
+  GLuint batch_texture = 0;
+  BlendMode batch_blend_mode = BlendMode::NONE;
+  Color draw_color = Color::WHITE;
+  BlendMode draw_blend_mode = BlendMode::NONE;
+  bool clip_enabled = false;
+  Rectangle clip;
+  std::size_t render_calls = 0;
+  std::size_t sprite_count = 0;
+  std::size_t stall_count = 0;
+};
+
+}  // namespace GL
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_GL_RENDERER_H
@@ -0,0 +1,164 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the ImageProcessor class that resizes and blurs surfaces in parallel.
+ */
+
+#ifndef SDLXX_CORE_IMAGE_PROCESSOR_H
+#define SDLXX_CORE_IMAGE_PROCESSOR_H
+
+#include <vector>
+
+#include "sdlxx/core/dimensions.h"
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/surface.h"
+
+namespace sdlxx {
+
+class ThreadPool;
+
+/**
+ * \brief A class for ImageProcessor-related exceptions.
+ */
+class ImageProcessorException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief An enumeration of filters used for resizing.
+ */
+enum class ResizeFilter {
+  BILINEAR,  ///< Triangle filter over 2x2 pixels, smooth and fast
+  BICUBIC,   ///< Catmull-Rom spline over 4x4 pixels, sharper than bilinear
+  LANCZOS    ///< Lanczos filter over 6x6 pixels, the sharpest, with slight ringing
+};
+
+/**
+ * \brief A class that filters surfaces on multiple threads.
+ *
+ * All filters are separable: every output row is first filtered vertically into a row of
+ * floating-point pixels, which is then filtered horizontally. Filter weights are computed once
+ * per call, and pixels beyond the edges repeat the nearest edge pixel. Rows are processed in
+ * parallel bands, four channels at a time where SSE2 is available.
+ *
+ * When downscaling, the filters are widened by the scale factor, so every source pixel
+ * contributes to the result and thumbnails do not alias.
+ *
+ * Only 32-bit surfaces with 8-bit channels are supported. Channels, including alpha, are
+ * filtered independently of each other, so surfaces with transparent areas should use
+ * premultiplied alpha to avoid dark fringes.
+ *
+ * Functions that take a source and a destination surface leave the source unchanged. In-place
+ * blurs write the result back into the pixels of the surface, so they also work for surfaces
+ * that a Renderer draws to.
+ */
+class ImageProcessor {
+public:
+  /**
+   * \brief Construct an image processor.
+   *
+   * \param pool The thread pool that filters the rows. It must outlive the processor.
+   */
+  explicit ImageProcessor(ThreadPool& pool);
+
+  /**
+   * \brief Resize a surface into a new surface with the same pixel format.
+   *
+   * \throw ImageProcessorException if the format is not supported or the size is empty.
+   */
+  Surface Resize(const Surface& source, const Dimensions& size,
+                 ResizeFilter filter = ResizeFilter::BILINEAR);
+
+  /**
+   * \brief Resize a surface to the size of the destination surface.
+   *
+   * \throw ImageProcessorException if the formats are not supported or differ.
+   */
+  void Resize(const Surface& source, Surface& dest, ResizeFilter filter = ResizeFilter::BILINEAR);
+
+  /**
+   * \brief Replace a surface with its resized copy.
+   *
+   * The surface gets new pixels, so it must not be the target of a Renderer.
+   *
+   * \throw ImageProcessorException if the format is not supported or the size is empty.
+   */
+  void ResizeInPlace(Surface& surface, const Dimensions& size,
+                     ResizeFilter filter = ResizeFilter::BILINEAR);
+
+  /**
+   * \brief Blur a surface with a box filter into a destination surface of the same size.
+   *
+   * \param radius The number of pixels on each side of a pixel that are averaged with it.
+   *
+   * \throw ImageProcessorException if the formats are not supported or differ, the sizes differ
+   *        or the radius is negative.
+   */
+  void BoxBlur(const Surface& source, Surface& dest, int radius);
+
+  /**
+   * \brief Blur a surface with a box filter in place.
+   */
+  void BoxBlur(Surface& surface, int radius);
+
+  /**
+   * \brief Blur a surface with a Gaussian filter into a destination surface of the same size.
+   *
+   * \param sigma The standard deviation of the filter in pixels. The filter extends to three
+   *              standard deviations on each side.
+   *
+   * \throw ImageProcessorException if the formats are not supported or differ, the sizes differ
+   *        or sigma is negative.
+   */
+  void GaussianBlur(const Surface& source, Surface& dest, float sigma);
+
+  /**
+   * \brief Blur a surface with a Gaussian filter in place.
+   */
+  void GaussianBlur(Surface& surface, float sigma);
+
+  /**
+   * \brief Generate a mip chain of a surface.
+   *
+   * The first level shares the pixels of the source. Every next level halves the size of the
+   * previous one, rounding down and stopping at 1 pixel, and is filtered from the previous
+   * level, so the whole chain costs about a third of resizing the source once.
+   *
+   * \param source The surface of the first level.
+   * \param filter The filter used between levels.
+   * \param levels The maximum number of levels, or 0 to continue until the size is 1x1.
+   *
+   * \throw ImageProcessorException if the format is not supported.
+   */
+  std::vector<Surface> GenerateMipmaps(const Surface& source,
+                                       ResizeFilter filter = ResizeFilter::BILINEAR,
+                                       int levels = 0);
+
+private:
+  ThreadPool& pool;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_IMAGE_PROCESSOR_H
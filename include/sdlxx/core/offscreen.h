@@ -0,0 +1,254 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the OffscreenContext class that renders without a display.
+ */
+
+#ifndef SDLXX_CORE_OFFSCREEN_H
+#define SDLXX_CORE_OFFSCREEN_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sdlxx/core/dimensions.h"
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/renderer.h"
+#include "sdlxx/core/surface.h"
+#include "sdlxx/core/time.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for OffscreenContext-related exceptions.
+ */
+class OffscreenContextException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A class that renders to memory on machines without a display.
+ *
+ * The context selects the dummy video driver and draws with the software renderer into a surface
+ * in RGBA32 format, which has bytes in R, G, B, A order on every platform. The rendered pixels
+ * are accessed in place, without the format conversion and copy of Renderer::ReadPixels().
+ *
+ * Captured frames are copied once and encoded to files on a background thread, so rendering
+ * continues while previous frames are written.
+ *
+ * In deterministic mode, the rendering hints that affect the output are fixed while the context
+ * exists and GetTime() advances by a constant step on every EndFrame(), so the same drawing code
+ * produces the same images on every run, which is required for image-diff testing.
+ *
+ * The previous values of the video driver hint and of the fixed rendering hints are restored
+ * when the context is destroyed.
+ */
+class OffscreenContext {
+public:
+  /**
+   * \brief An enumeration of image file formats for captured frames.
+   */
+  enum class ImageFormat {
+    QOI,  ///< Quite OK Image format, fast lossless compression
+    PNG   ///< Portable Network Graphics without compression
+  };
+
+  /**
+   * \brief A view of the rendered pixels.
+   *
+   * The view is valid until the next drawing operation.
+   */
+  struct Frame {
+    const uint8_t* pixels;  ///< Rows of RGBA32 pixels
+    int width;              ///< The width of the frame in pixels
+    int height;             ///< The height of the frame in pixels
+    int pitch;              ///< The length of a row in bytes
+  };
+
+  /**
+   * \brief Construct an offscreen context.
+   *
+   * \param size          The size of the frames.
+   * \param deterministic Whether to use the deterministic mode.
+   * \param frame_step    The time between frames in deterministic mode.
+   *
+   * \throw OffscreenContextException if the video subsystem can not be initialized.
+   * \throw SurfaceException if the surface can not be created.
+   * \throw RendererException if the renderer can not be created.
+   */
+  explicit OffscreenContext(Dimensions size, bool deterministic = false,
+                            Time frame_step = Time::Microseconds(16667));
+
+  // Deleted copy constructor
+  OffscreenContext(const OffscreenContext&) = delete;
+
+  // Deleted copy assignment operator
+  OffscreenContext& operator=(const OffscreenContext&) = delete;
+
+  /**
+   * \brief Wait for all captured frames to be written and destroy the context.
+   */
+  ~OffscreenContext();
+
+  /**
+   * \brief Get the renderer that draws to the frame.
+   */
+  Renderer& GetRenderer() { return renderer; }
+
+  /**
+   * \brief Get the surface that holds the frame.
+   */
+  Surface& GetSurface() { return surface; }
+
+  /**
+   * \brief Get the size of the frame.
+   */
+  Dimensions GetSize() const { return size; }
+
+  /**
+   * \brief Check if the context is in deterministic mode.
+   */
+  bool IsDeterministic() const { return deterministic; }
+
+  /**
+   * \brief Get the time since the context was created.
+   *
+   * In deterministic mode, this is the number of finished frames multiplied by the frame step.
+   */
+  Time GetTime() const;
+
+  /**
+   * \brief Get the number of frames finished with EndFrame().
+   */
+  std::size_t GetFrameCount() const { return frame_count; }
+
+  /**
+   * \brief Get the rendered pixels without copying them.
+   *
+   * Completes the rendering commands batched by the renderer.
+   *
+   * \throw RendererException if the commands can not be completed.
+   */
+  Frame GetFrame();
+
+  /**
+   * \brief Finish a frame and capture it, if a batch capture is running.
+   *
+   * \throw Rethrows the first error of the encoder thread.
+   */
+  void EndFrame();
+
+  /**
+   * \brief Write the current frame to a file on the encoder thread.
+   *
+   * \param path   The path of the file.
+   * \param format The format of the file.
+   *
+   * \throw Rethrows the first error of the encoder thread.
+   */
+  void Capture(const std::string& path, ImageFormat format = ImageFormat::QOI);
+
+  /**
+   * \brief Capture the next frames finished with EndFrame().
+   *
+   * \param path_prefix The prefix of the file paths, that is followed by a zero-padded frame
+   *                    index and the extension of the format.
+   * \param frames      The number of frames to capture.
+   * \param format      The format of the files.
+   */
+  void CaptureFrames(const std::string& path_prefix, std::size_t frames,
+                     ImageFormat format = ImageFormat::QOI);
+
+  /**
+   * \brief Wait until all captured frames are written.
+   *
+   * \throw Rethrows the first error of the encoder thread.
+   */
+  void WaitForEncoder();
+
+  /**
+   * \brief Encode RGBA32 pixels in QOI format.
+   */
+  static std::vector<uint8_t> EncodeQoi(const Frame& frame);
+
+  /**
+   * \brief Encode RGBA32 pixels in PNG format, using uncompressed deflate blocks.
+   */
+  static std::vector<uint8_t> EncodePng(const Frame& frame);
+
+private:
+  struct Job {
+    std::string path;
+    ImageFormat format;
+    int width;
+    int height;
+    std::vector<uint8_t> pixels;
+  };
+
+  // Maximum number of frames waiting for the encoder before Capture() blocks
+  static constexpr std::size_t MAX_PENDING_JOBS = 16;
+
+  Dimensions size;
+  bool deterministic;
+  Time frame_step;
+  Surface surface;
+  Renderer renderer;
+  std::chrono::steady_clock::time_point start_time;
+  std::size_t frame_count = 0;
+  // The video driver hint replaced by the context, restored by the destructor
+  std::optional<std::string> video_driver;
+  // The scale quality hint replaced in deterministic mode, restored by the destructor
+  std::optional<std::string> scale_quality;
+
+  std::string capture_prefix;
+  ImageFormat capture_format = ImageFormat::QOI;
+  std::size_t capture_remaining = 0;
+  std::size_t capture_index = 0;
+
+  std::mutex mutex;
+  std::condition_variable queue_changed;
+  std::deque<Job> jobs;
+  bool encoding = false;
+  bool stopping = false;
+  std::exception_ptr error;
+  std::thread encoder;
+
+  void Encode();
+
+  void RethrowError();
+
+  void RestoreHints();
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_OFFSCREEN_H
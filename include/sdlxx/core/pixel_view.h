@@ -0,0 +1,467 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the PixelView class template that gives typed access to surface pixels.
+ */
+
+#ifndef SDLXX_CORE_PIXEL_VIEW_H
+#define SDLXX_CORE_PIXEL_VIEW_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "sdlxx/core/color.h"
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/rectangle.h"
+#include "sdlxx/core/surface.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for PixelView-related exceptions.
+ */
+class PixelViewException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A structure that describes how the pixels of a surface are stored in memory.
+ */
+struct PixelLayout {
+  void* pixels = nullptr;           ///< The first pixel of the first row
+  int width = 0;                    ///< The number of pixels in a row
+  int height = 0;                   ///< The number of rows
+  int pitch = 0;                    ///< The length of a row in bytes
+  uint32_t format = 0;              ///< The SDL_PixelFormatEnum value
+  const Color* palette = nullptr;   ///< The palette colors of an indexed format
+  int palette_size = 0;             ///< The number of palette colors
+};
+
+/**
+ * \brief Get the pixel layout of a surface for writing, detaching it from its copies.
+ */
+PixelLayout GetPixelLayout(Surface& surface);
+
+/**
+ * \brief Get the pixel layout of a surface for reading.
+ */
+PixelLayout GetPixelLayout(const Surface& surface);
+
+/**
+ * \brief Pixel formats that PixelView is specialized for.
+ *
+ * Every format defines the pixel type, the SDL_PixelFormatEnum value, and conversions between
+ * pixels and colors that are resolved at compile time.
+ */
+namespace PixelFormat {  // NOLINT(readability-identifier-naming)
+
+/// Packed 32-bit format with the red component in the highest byte
+struct RGBA8888 {
+  using Pixel = uint32_t;
+  static constexpr uint32_t FORMAT = 0x16462004U;
+  static constexpr bool INDEXED = false;
+
+  static constexpr Pixel Pack(Color c) {
+    return static_cast<uint32_t>(c.r) << 24U | static_cast<uint32_t>(c.g) << 16U |
+           static_cast<uint32_t>(c.b) << 8U | c.a;
+  }
+
+  static constexpr Color Unpack(Pixel p) {
+    return {static_cast<uint8_t>(p >> 24U), static_cast<uint8_t>(p >> 16U),
+            static_cast<uint8_t>(p >> 8U), static_cast<uint8_t>(p)};
+  }
+};
+
+/// Packed 32-bit format with the alpha component in the highest byte
+struct ARGB8888 {
+  using Pixel = uint32_t;
+  static constexpr uint32_t FORMAT = 0x16362004U;
+  static constexpr bool INDEXED = false;
+
+  static constexpr Pixel Pack(Color c) {
+    return static_cast<uint32_t>(c.a) << 24U | static_cast<uint32_t>(c.r) << 16U |
+           static_cast<uint32_t>(c.g) << 8U | c.b;
+  }
+
+  static constexpr Color Unpack(Pixel p) {
+    return {static_cast<uint8_t>(p >> 16U), static_cast<uint8_t>(p >> 8U), static_cast<uint8_t>(p),
+            static_cast<uint8_t>(p >> 24U)};
+  }
+};
+
+/// Packed 16-bit format with 5 bits of red, 6 bits of green and 5 bits of blue
+struct RGB565 {
+  using Pixel = uint16_t;
+  static constexpr uint32_t FORMAT = 0x15151002U;
+  static constexpr bool INDEXED = false;
+
+  static constexpr Pixel Pack(Color c) {
+    return static_cast<Pixel>((c.r >> 3U) << 11U | (c.g >> 2U) << 5U | c.b >> 3U);
+  }
+
+  // Low bits are filled with the high bits, so 0 maps to 0 and the maximum maps to 255
+  static constexpr Color Unpack(Pixel p) {
+    auto r = static_cast<uint8_t>((p >> 11U) & 0x1FU);
+    auto g = static_cast<uint8_t>((p >> 5U) & 0x3FU);
+    auto b = static_cast<uint8_t>(p & 0x1FU);
+    return {static_cast<uint8_t>(r << 3U | r >> 2U), static_cast<uint8_t>(g << 2U | g >> 4U),
+            static_cast<uint8_t>(b << 3U | b >> 2U), 255};
+  }
+};
+
+/// 8-bit indices into a palette of colors
+struct INDEX8 {
+  using Pixel = uint8_t;
+  static constexpr uint32_t FORMAT = 0x13000801U;
+  static constexpr bool INDEXED = true;
+};
+
+}  // namespace PixelFormat
+
+/**
+ * \brief A typed view of a rectangle of pixels in a surface.
+ *
+ * The view does not own the pixels and must not outlive the surface. Pixels are addressed by
+ * column and row with the pitch taken into account, and iterators visit the pixels of the view
+ * in row-major order. Conversions between pixels and colors are inlined for the format.
+ *
+ * \tparam Format    One of the PixelFormat structures.
+ * \tparam PixelType The pixel type, which is const for read-only views.
+ */
+template <typename Format, typename PixelType = typename Format::Pixel>
+class PixelView {
+public:
+  using Pixel = PixelType;
+  using Byte = std::conditional_t<std::is_const_v<Pixel>, const uint8_t, uint8_t>;
+
+  static_assert(std::is_same_v<std::remove_const_t<Pixel>, typename Format::Pixel>,
+                "Pixel type does not match the format");
+
+  /**
+   * \brief A row-major iterator over the pixels of a view.
+   */
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_const_t<Pixel>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Pixel*;
+    using reference = Pixel&;
+
+    Iterator() = default;
+
+    Iterator(Byte* row, int x, int width, int pitch) : row(row), x(x), width(width), pitch(pitch) {}
+
+    reference operator*() const { return reinterpret_cast<Pixel*>(row)[x]; }
+
+    pointer operator->() const { return &**this; }
+
+    Iterator& operator++() {
+      if (++x == width) {
+        x = 0;
+        row += pitch;
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const Iterator& other) const { return row == other.row && x == other.x; }
+
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+  private:
+    Byte* row = nullptr;
+    int x = 0;
+    int width = 0;
+    int pitch = 0;
+  };
+
+  /**
+   * \brief Construct a view of raw pixel memory.
+   */
+  PixelView(Byte* pixels, int width, int height, int pitch, const Color* palette = nullptr,
+            int palette_size = 0)
+      : pixels(pixels),
+        width(width),
+        height(height),
+        pitch(pitch),
+        palette(palette),
+        palette_size(palette_size) {}
+
+  /**
+   * \brief Construct a view of all pixels of a surface.
+   *
+   * A writable view detaches and pins the surface, so later copies do not share its pixels.
+   *
+   * \throw PixelViewException if the surface has a different pixel format.
+   */
+  explicit PixelView(std::conditional_t<std::is_const_v<Pixel>, const Surface&, Surface&> surface)
+      : PixelView(CheckLayout(GetPixelLayout(surface))) {}
+
+  int GetWidth() const { return width; }
+
+  int GetHeight() const { return height; }
+
+  int GetPitch() const { return pitch; }
+
+  /**
+   * \brief Get the pointer to the first pixel of a row.
+   */
+  Pixel* Row(int y) const {
+    return reinterpret_cast<Pixel*>(pixels + static_cast<std::ptrdiff_t>(y) * pitch);
+  }
+
+  /**
+   * \brief Get a pixel without bounds checking.
+   */
+  Pixel& operator()(int x, int y) const { return Row(y)[x]; }
+
+  /**
+   * \brief Get a pixel with bounds checking.
+   *
+   * \throw PixelViewException if the pixel is out of the view.
+   */
+  Pixel& At(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+      throw PixelViewException("Pixel is out of the view");
+    }
+    return Row(y)[x];
+  }
+
+  /**
+   * \brief Get the color of a pixel.
+   */
+  Color GetColor(int x, int y) const {
+    if constexpr (Format::INDEXED) {
+      uint8_t index = (*this)(x, y);
+      return index < palette_size ? palette[index] : Color::TRANSPARENT;
+    } else {
+      return Format::Unpack((*this)(x, y));
+    }
+  }
+
+  /**
+   * \brief Set the color of a pixel.
+   */
+  void SetColor(int x, int y, Color color) const {
+    static_assert(!std::is_const_v<Pixel>, "View is read-only");
+    static_assert(!Format::INDEXED, "Indexed pixels are set by index");
+    (*this)(x, y) = Format::Pack(color);
+  }
+
+  /**
+   * \brief Get a view of a rectangle of this view.
+   *
+   * \throw PixelViewException if the rectangle is not inside the view.
+   */
+  PixelView SubView(const Rectangle& rectangle) const {
+    if (rectangle.x < 0 || rectangle.y < 0 || rectangle.width < 0 || rectangle.height < 0 ||
+        rectangle.x + rectangle.width > width || rectangle.y + rectangle.height > height) {
+      throw PixelViewException("Rectangle is out of the view");
+    }
+    Byte* origin = pixels + static_cast<std::ptrdiff_t>(rectangle.y) * pitch +
+                   static_cast<std::ptrdiff_t>(rectangle.x) * sizeof(Pixel);
+    return {origin, rectangle.width, rectangle.height, pitch, palette, palette_size};
+  }
+
+  /**
+   * \brief Get the palette colors of an indexed view.
+   */
+  const Color* GetPalette() const { return palette; }
+
+  int GetPaletteSize() const { return palette_size; }
+
+  Iterator begin() const {
+    return width > 0 && height > 0 ? Iterator(pixels, 0, width, pitch) : end();
+  }
+
+  Iterator end() const {
+    return Iterator(pixels + static_cast<std::ptrdiff_t>(width > 0 ? height : 0) * pitch, 0, width,
+                    pitch);
+  }
+
+private:
+  Byte* pixels;
+  int width;
+  int height;
+  int pitch;
+  const Color* palette;
+  int palette_size;
+
+  explicit PixelView(const PixelLayout& layout)
+      : PixelView(static_cast<Byte*>(layout.pixels), layout.width, layout.height, layout.pitch,
+                  layout.palette, layout.palette_size) {}
+
+  static const PixelLayout& CheckLayout(const PixelLayout& layout) {
+    if (layout.format != Format::FORMAT) {
+      throw PixelViewException("Surface has a different pixel format");
+    }
+    return layout;
+  }
+};
+
+/// A read-only view of pixels
+template <typename Format>
+using ConstPixelView = PixelView<Format, const typename Format::Pixel>;
+
+/**
+ * \brief Set all pixels of a view to a color.
+ */
+template <typename Format>
+void Fill(const PixelView<Format>& view, Color color) {
+  const typename Format::Pixel pixel = Format::Pack(color);
+  for (int y = 0; y < view.GetHeight(); ++y) {
+    std::fill_n(view.Row(y), view.GetWidth(), pixel);
+  }
+}
+
+/**
+ * \brief Replace every pixel of a view with the result of a function of the pixel.
+ *
+ * The rows are processed as plain arrays, so a simple inline function is vectorized.
+ */
+template <typename Format, typename Function>
+void TransformPixels(const PixelView<Format>& view, Function function) {
+  for (int y = 0; y < view.GetHeight(); ++y) {
+    typename Format::Pixel* row = view.Row(y);
+    for (int x = 0; x < view.GetWidth(); ++x) {
+      row[x] = function(row[x]);
+    }
+  }
+}
+
+/**
+ * \brief Write a function of every source pixel to the destination view of the same size.
+ *
+ * \throw PixelViewException if the views have different sizes.
+ */
+template <typename SourceFormat, typename SourcePixel, typename DestFormat, typename Function>
+void TransformPixels(const PixelView<SourceFormat, SourcePixel>& source,
+                     const PixelView<DestFormat>& dest, Function function) {
+  if (source.GetWidth() != dest.GetWidth() || source.GetHeight() != dest.GetHeight()) {
+    throw PixelViewException("Views have different sizes");
+  }
+  for (int y = 0; y < source.GetHeight(); ++y) {
+    const auto* source_row = source.Row(y);
+    typename DestFormat::Pixel* dest_row = dest.Row(y);
+    for (int x = 0; x < source.GetWidth(); ++x) {
+      dest_row[x] = function(source_row[x]);
+    }
+  }
+}
+
+/**
+ * \brief Convert the pixels of a view to another format.
+ *
+ * \throw PixelViewException if the views have different sizes.
+ */
+template <typename SourceFormat, typename SourcePixel, typename DestFormat>
+void Convert(const PixelView<SourceFormat, SourcePixel>& source,
+             const PixelView<DestFormat>& dest) {
+  static_assert(!DestFormat::INDEXED, "Conversion to an indexed format needs quantization");
+  if constexpr (SourceFormat::INDEXED) {
+    // Convert the palette once, then look the pixels up
+    std::array<typename DestFormat::Pixel, 256> lookup{};
+    for (int i = 0; i < source.GetPaletteSize() && i < 256; ++i) {
+      lookup[i] = DestFormat::Pack(source.GetPalette()[i]);
+    }
+    TransformPixels(source, dest, [&lookup](uint8_t index) { return lookup[index]; });
+  } else {
+    TransformPixels(source, dest, [](typename SourceFormat::Pixel pixel) {
+      return DestFormat::Pack(SourceFormat::Unpack(pixel));
+    });
+  }
+}
+
+/**
+ * \brief Convolve a view with a square kernel of odd size, writing to a view of the same size.
+ *
+ * Pixels beyond the edges repeat the nearest edge pixel. Every color channel, including alpha,
+ * is convolved separately, and the results are rounded and clamped to [0, 255]. The kernel size
+ * is known at compile time, so the kernel loops are unrolled, and pixels that are at least the
+ * kernel radius away from the edges skip the edge checks.
+ *
+ * \throw PixelViewException if the views have different sizes.
+ */
+template <typename Format, typename SourcePixel, std::size_t Size>
+void Convolve(const PixelView<Format, SourcePixel>& source, const PixelView<Format>& dest,
+              const std::array<float, Size>& kernel) {
+  static_assert(!Format::INDEXED, "Indexed pixels can not be convolved");
+  constexpr int side = [] {
+    int s = 1;
+    while (static_cast<std::size_t>(s * s) < Size) {
+      s += 2;
+    }
+    return s;
+  }();
+  static_assert(static_cast<std::size_t>(side * side) == Size, "Kernel must be an odd square");
+  constexpr int radius = side / 2;
+  if (source.GetWidth() != dest.GetWidth() || source.GetHeight() != dest.GetHeight()) {
+    throw PixelViewException("Views have different sizes");
+  }
+  const int width = source.GetWidth();
+  const int height = source.GetHeight();
+  auto clamp = [](float value) {
+    return static_cast<uint8_t>(std::min(std::max(value + 0.5F, 0.0F), 255.0F));
+  };
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      float r = 0;
+      float g = 0;
+      float b = 0;
+      float a = 0;
+      bool inner = x >= radius && y >= radius && x < width - radius && y < height - radius;
+      for (int ky = 0; ky < side; ++ky) {
+        for (int kx = 0; kx < side; ++kx) {
+          int sx = x + kx - radius;
+          int sy = y + ky - radius;
+          if (!inner) {
+            sx = std::min(std::max(sx, 0), width - 1);
+            sy = std::min(std::max(sy, 0), height - 1);
+          }
+          Color color = Format::Unpack(source(sx, sy));
+          float weight = kernel[ky * side + kx];
+          r += weight * color.r;
+          g += weight * color.g;
+          b += weight * color.b;
+          a += weight * color.a;
+        }
+      }
+      dest(x, y) = Format::Pack({clamp(r), clamp(g), clamp(b), clamp(a)});
+    }
+  }
+}
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_PIXEL_VIEW_H
@@ -658,6 +658,43 @@ public:
   void Copy(const Texture& texture, const Rectangle& source, const Rectangle& dest, double angle,
             Point center, Flip flip = Flip::NONE);
 
+  /**
+   * \brief A structure that represents a vertex of textured geometry.
+   *
+   * \upstream SDL_Vertex
+   */
+  struct Vertex {
+    float x;      ///< X coordinate of the vertex in the rendering target
+    float y;      ///< Y coordinate of the vertex in the rendering target
+    Color color;  ///< Color that is multiplied into the texture color
+    float u;      ///< Normalized horizontal texture coordinate
+    float v;      ///< Normalized vertical texture coordinate
+  };
+
+  /**
+   * \brief Test whether the renderer supports drawing of arbitrary geometry.
+   *
+   * Geometry rendering requires SDL 2.0.18 or newer, both at compile time and at runtime.
+   */
+  static bool IsGeometrySupported();
+
+  /**
+   * \brief Render a list of triangles, optionally using a texture.
+   *
+   * \param texture      The texture to use, or nullptr to draw solid triangles.
+   * \param vertices     The vertices.
+   * \param num_vertices The number of vertices.
+   * \param indices      The indices into the vertex array, three per triangle, or nullptr to use
+   *                     the vertices in order.
+   * \param num_indices  The number of indices.
+   *
+   * \throw RendererException on error or if geometry rendering is not supported.
+   *
+   * \upstream SDL_RenderGeometry
+   */
+  void RenderGeometry(const Texture* texture, const Vertex* vertices, int num_vertices,
+                      const int* indices = nullptr, int num_indices = 0);
+
   // TODO: SDL_RenderDrawPointF, SDL_RenderDrawPointsF, SDL_RenderDrawLineF, SDL_RenderDrawLinesF,
   // SDL_RenderDrawRectF, SDL_RenderDrawRectsF, SDL_RenderFillRectF, SDL_RenderFillRectsF,
   // SDL_RenderCopyF, SDL_RenderCopyExF
@@ -702,7 +739,16 @@ public:
    */
   void RenderPresent();
 
-  // TODO: SDL_RenderFlush, SDL_RenderGetMetalLayer, SDL_RenderGetMetalCommandEncoder
+  /**
+   * \brief Force the rendering commands batched by the renderer to complete.
+   *
+   * \throw RendererException on error.
+   *
+   * \upstream SDL_RenderFlush
+   */
+  void Flush();
+
+  // TODO: SDL_RenderGetMetalLayer, SDL_RenderGetMetalCommandEncoder
 
   void Render(Renderable& renderable);
 
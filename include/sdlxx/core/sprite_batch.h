@@ -0,0 +1,134 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the SpriteBatch class that draws many sprites with few render calls.
+ */
+
+#ifndef SDLXX_CORE_SPRITE_BATCH_H
+#define SDLXX_CORE_SPRITE_BATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "sdlxx/core/color.h"
+#include "sdlxx/core/rectangle.h"
+#include "sdlxx/core/renderer.h"
+
+namespace sdlxx {
+
+class Texture;
+
+/**
+ * \brief A class that collects sprites and submits them to the renderer in batches.
+ *
+ * Consecutive sprites that use the same texture are converted to textured quads and drawn with
+ * a single call to Renderer::RenderGeometry(), so a frame with thousands of sprites from a few
+ * texture atlases costs only a few render calls. Sprites should be sorted by texture to get the
+ * largest batches.
+ *
+ * If geometry rendering is not supported, every sprite is drawn with Renderer::Copy(), and the
+ * sprite colors are ignored.
+ */
+class SpriteBatch {
+public:
+  /**
+   * \brief Construct a sprite batch.
+   *
+   * \param renderer The renderer to draw with.
+   * \param capacity The number of sprites to preallocate space for.
+   */
+  explicit SpriteBatch(Renderer& renderer, std::size_t capacity = 1024);
+
+  // Deleted copy constructor
+  SpriteBatch(const SpriteBatch&) = delete;
+
+  // Deleted copy assignment operator
+  SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+  /**
+   * \brief Add a sprite to the batch.
+   *
+   * The sprite may be drawn immediately, if the texture differs from the previous sprite, or if
+   * the batch is full.
+   *
+   * \param texture The texture of the sprite. It must stay alive until the batch is flushed.
+   * \param source  The rectangle of the sprite in the texture.
+   * \param x       X coordinate of the top left corner of the destination.
+   * \param y       Y coordinate of the top left corner of the destination.
+   * \param width   The width of the destination.
+   * \param height  The height of the destination.
+   * \param angle   An angle in degrees to rotate the sprite around its center, clockwise.
+   * \param color   The color that is multiplied into the texture color.
+   *
+   * \throw RendererException if the previous batch can not be drawn.
+   */
+  void Draw(const Texture& texture, const Rectangle& source, float x, float y, float width,
+            float height, float angle = 0.0F, Color color = Color::WHITE);
+
+  /**
+   * \brief Draw all collected sprites.
+   *
+   * Must be called before Renderer::RenderPresent().
+   *
+   * \throw RendererException on error.
+   */
+  void Flush();
+
+  /**
+   * \brief Get the number of render calls made since the last ResetStatistics().
+   */
+  std::size_t GetRenderCalls() const { return render_calls; }
+
+  /**
+   * \brief Get the number of sprites drawn since the last ResetStatistics().
+   */
+  std::size_t GetSpriteCount() const { return sprite_count; }
+
+  /**
+   * \brief Reset the number of render calls and drawn sprites.
+   */
+  void ResetStatistics();
+
+private:
+  struct Sprite {
+    Rectangle source;
+    Rectangle dest;
+    float angle;
+  };
+
+  Renderer& renderer;
+  const bool geometry;
+  const Texture* texture = nullptr;
+  float inverse_width = 0.0F;
+  float inverse_height = 0.0F;
+  std::vector<Renderer::Vertex> vertices;
+  std::vector<int> indices;
+  std::vector<Sprite> sprites;
+  std::size_t render_calls = 0;
+  std::size_t sprite_count = 0;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_SPRITE_BATCH_H
@@ -28,6 +28,7 @@
 #ifndef SDLXX_CORE_SURFACE_H
 #define SDLXX_CORE_SURFACE_H
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -61,6 +62,16 @@ class SurfaceException : public Exception {
  * \note  This class should be treated as read-only, except for \c GetPixels(),
  *        which, if not equal to \a nullptr, contains the raw pixel data for the surface.
  *
+ * Copies share the pixels until one of them is modified, so passing a surface by value costs
+ * no more than copying a pointer. Every modifying method first detaches the surface by
+ * duplicating the shared pixels. Use Clone() for an immediate deep copy.
+ *
+ * A surface whose pixels are referenced from outside, such as the target of a software Renderer,
+ * a window surface or a surface created from user-provided pixels, is pinned: its copies are
+ * always deep, so the outside reference keeps pointing to the pixels of this object. The
+ * non-const GetPixels(), Lock() and a writable PixelView pin the surface too, because the
+ * pointer they hand out can be written through after the surface is copied.
+ *
  * \upstream SDL_Surface
  */
 class Surface {
@@ -145,18 +156,20 @@ public:
   /**
    * \brief Copy constructor
    *
-   * Creates a new surface identical to the existing surface
+   * Shares the pixels with the existing surface until one of them is modified.
+   * Pinned surfaces are duplicated immediately.
    *
-   * \upstream SDL_DuplicateSurface
+   * \throw SurfaceException if a pinned surface can not be duplicated.
    */
   Surface(const Surface& other);
 
   /**
    * \brief Copy assignment operator
    *
-   * Creates a new surface identical to the existing surface
+   * Shares the pixels with the existing surface until one of them is modified.
+   * Pinned surfaces are duplicated immediately.
    *
-   * \upstream SDL_DuplicateSurface
+   * \throw SurfaceException if a pinned surface can not be duplicated.
    */
   Surface& operator=(const Surface& other);
 
@@ -175,6 +188,40 @@ public:
    */
   virtual ~Surface() = default;
 
+  /**
+   * \brief Create a new surface with a copy of the pixels.
+   *
+   * \throw SurfaceException if the surface can not be duplicated.
+   *
+   * \upstream SDL_DuplicateSurface
+   */
+  Surface Clone() const;
+
+  /**
+   * \brief Make sure that the pixels are not shared with other surfaces, copying them if needed.
+   *
+   * \throw SurfaceException if the surface can not be duplicated.
+   */
+  void Detach();
+
+  /**
+   * \brief Check if the pixels are shared with other surfaces.
+   */
+  bool IsShared() const;
+
+  /**
+   * \brief Get the number of pixel copies made by copy-on-write, Clone() and copies of pinned
+   *        surfaces since the last call to ResetDeepCopyCount().
+   *
+   * Resetting the counter at the start of every frame shows how many copies a frame makes.
+   */
+  static std::size_t GetDeepCopyCount();
+
+  /**
+   * \brief Reset the number of pixel copies.
+   */
+  static void ResetDeepCopyCount();
+
   // TODO: SDL_SetSurfacePalette
 
   /**
@@ -187,6 +234,8 @@ public:
    * Not all surfaces require locking. If the surface can be accessed at any time and the
    * pixel format of the surface will not change, this method does nothing.
    *
+   * Detaches and pins the surface like the non-const GetPixels().
+   *
    * No operating system or library calls should be made between lock/unlock
    * pairs, as critical system locks may be held during this time.
    *
@@ -433,13 +482,34 @@ public:
   Dimensions GetSize() const;
 
   /**
-   * \brief Get the pointer to the surface pixel data.
+   * \brief Get the pointer to the surface pixel data for writing.
+   *
+   * Detaches the surface from its copies and pins it, so that later copies do not share the
+   * pixels that are written through the pointer.
    *
    * \return void* The pointer to the surface pixel data.
    *
+   * \throw SurfaceException if the surface can not be detached.
+   *
    * \upstream SDL_Surface::pixels
    */
-  void* GetPixels() const;
+  void* GetPixels();
+
+  /**
+   * \brief Get the pointer to the surface pixel data for reading.
+   *
+   * \return const void* The pointer to the surface pixel data.
+   *
+   * \upstream SDL_Surface::pixels
+   */
+  const void* GetPixels() const;
+
+  /**
+   * \brief Get the length of a row of pixels in bytes.
+   *
+   * \upstream SDL_Surface::pitch
+   */
+  int GetPitch() const;
 
   /**
    * \brief Get the pointer to the surface pixel format.
@@ -454,6 +524,7 @@ public:
    * \brief Get the raw pointer to SDL_Surface.
    *
    * After this operation you are responsible for freeing the memory of the surface.
+   * Shared pixels are duplicated first.
    *
    * \return A pointer to the SDL_Surface
    */
@@ -463,13 +534,29 @@ public:
   friend class Renderer;
   friend class Window;
   friend class Texture;
+  friend class ImageProcessor;
 
 private:
-  struct Deleter {
-    void operator()(SDL_Surface* ptr) const;
+  // The SDL surface shared by copies of a Surface
+  struct Buffer {
+    SDL_Surface* ptr;
+
+    explicit Buffer(SDL_Surface* ptr) : ptr(ptr) {}
+
+    ~Buffer();
   };
 
-  std::unique_ptr<SDL_Surface, Deleter> surface_ptr;
+  std::shared_ptr<Buffer> buffer;
+  bool pinned = false;
+
+  // Get the surface for reading
+  SDL_Surface* Get() const { return buffer ? buffer->ptr : nullptr; }
+
+  // Get the surface for writing
+  SDL_Surface* GetForWriting();
+
+  // Detach the surface and always copy it from now on
+  SDL_Surface* Pin();
 };
 
 /**
@@ -0,0 +1,113 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the ThreadPool class that runs data-parallel loops on worker threads.
+ */
+
+#ifndef SDLXX_CORE_THREAD_POOL_H
+#define SDLXX_CORE_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sdlxx {
+
+/**
+ * \brief A class that runs the iterations of a loop on a fixed set of worker threads.
+ *
+ * Iterations are handed out one at a time from a shared counter, so uneven work, such as screen
+ * tiles of different complexity, is balanced between the threads. The calling thread takes part
+ * in the loop, so a pool with N threads uses N + 1 cores.
+ */
+class ThreadPool {
+public:
+  /**
+   * \brief Construct a thread pool.
+   *
+   * \param threads The number of worker threads, by default one less than the number of cores.
+   */
+  explicit ThreadPool(std::size_t threads = GetDefaultThreadCount());
+
+  // Deleted copy constructor
+  ThreadPool(const ThreadPool&) = delete;
+
+  // Deleted copy assignment operator
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * \brief Stop and join all worker threads.
+   */
+  ~ThreadPool();
+
+  /**
+   * \brief Call a function for every index in range [0, count) and wait for all calls.
+   *
+   * Must not be called concurrently or from inside the function.
+   *
+   * \param count    The number of iterations.
+   * \param function The function that takes the index of an iteration.
+   *
+   * \throw Rethrows the first exception thrown by the function, after all iterations are done.
+   */
+  void ParallelFor(std::size_t count, const std::function<void(std::size_t)>& function);
+
+  /**
+   * \brief Get the number of worker threads.
+   */
+  std::size_t GetThreadCount() const { return workers.size(); }
+
+  /**
+   * \brief Get the number of worker threads that leaves one core for the calling thread.
+   */
+  static std::size_t GetDefaultThreadCount();
+
+private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable finish;
+  uint64_t job = 0;
+  std::size_t active = 0;
+  bool stopping = false;
+
+  const std::function<void(std::size_t)>* function = nullptr;
+  std::size_t count = 0;
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr error;
+
+  void Work();
+
+  void RunIterations();
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_THREAD_POOL_H
@@ -0,0 +1,220 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the TileRenderer class that rasterizes 2D drawing commands in parallel.
+ */
+
+#ifndef SDLXX_CORE_TILE_RENDERER_H
+#define SDLXX_CORE_TILE_RENDERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sdlxx/core/blendmode.h"
+#include "sdlxx/core/color.h"
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/point.h"
+#include "sdlxx/core/rectangle.h"
+
+namespace sdlxx {
+
+class Surface;
+class ThreadPool;
+
+/**
+ * \brief A class for TileRenderer-related exceptions.
+ */
+class TileRendererException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A class that draws to a surface on multiple threads.
+ *
+ * Drawing functions only record commands. Present() sorts the commands into square screen
+ * tiles and rasterizes the tiles in parallel, so every tile is written by exactly one thread
+ * and commands inside a tile keep their order. Spans are filled and blended four pixels at a
+ * time where SSE2 is available.
+ *
+ * Only 32-bit surfaces with 8-bit channels are supported. Blending follows the formulas of
+ * BlendMode, so the result matches the software Renderer within rounding error.
+ */
+class TileRenderer {
+public:
+  /// The width and the height of a tile in pixels
+  static constexpr int TILE_SIZE = 64;
+
+  /**
+   * \brief Construct a renderer that draws to a surface.
+   *
+   * \param target The surface to draw to. It must outlive the renderer.
+   * \param pool   The thread pool that rasterizes the tiles.
+   *
+   * \throw TileRendererException if the surface format is not supported.
+   */
+  TileRenderer(Surface& target, ThreadPool& pool);
+
+  // Deleted copy constructor
+  TileRenderer(const TileRenderer&) = delete;
+
+  // Deleted copy assignment operator
+  TileRenderer& operator=(const TileRenderer&) = delete;
+
+  /**
+   * \brief Set the color used for drawing operations.
+   */
+  void SetDrawColor(const Color& color);
+
+  /**
+   * \brief Get the color used for drawing operations.
+   */
+  Color GetDrawColor() const { return color; }
+
+  /**
+   * \brief Set the blend mode used for drawing operations.
+   *
+   * \throw TileRendererException if the blend mode is not supported.
+   */
+  void SetDrawBlendMode(BlendMode mode);
+
+  /**
+   * \brief Get the blend mode used for drawing operations.
+   */
+  BlendMode GetDrawBlendMode() const { return blend_mode; }
+
+  /**
+   * \brief Set the clip rectangle for the following drawing operations.
+   */
+  void SetClipRectangle(const Rectangle& rectangle);
+
+  /**
+   * \brief Disable clipping for the following drawing operations.
+   */
+  void DisableClipping();
+
+  /**
+   * \brief Fill the whole surface with the drawing color, ignoring the clip rectangle.
+   */
+  void Clear();
+
+  /**
+   * \brief Draw a point.
+   */
+  void DrawPoint(const Point& point);
+
+  /**
+   * \brief Draw multiple points.
+   */
+  void DrawPoints(const std::vector<Point>& points);
+
+  /**
+   * \brief Draw a line, including both end points.
+   */
+  void DrawLine(const Point& first, const Point& second);
+
+  /**
+   * \brief Draw a sequence of connected lines.
+   */
+  void DrawLines(const std::vector<Point>& points);
+
+  /**
+   * \brief Draw the outline of a rectangle.
+   */
+  void DrawRectangle(const Rectangle& rectangle);
+
+  /**
+   * \brief Fill a rectangle.
+   */
+  void FillRectangle(const Rectangle& rectangle);
+
+  /**
+   * \brief Fill multiple rectangles.
+   */
+  void FillRectangles(const std::vector<Rectangle>& rectangles);
+
+  /**
+   * \brief Copy a portion of a surface, scaling it with the nearest neighbour filter.
+   *
+   * \param source The surface to copy from. It must have the same pixel format as the target,
+   *               must not need locking and must stay alive until Present().
+   * \param src    The rectangle of the source surface to copy.
+   * \param dst    The rectangle of the target surface to copy to.
+   * \param mode   The blend mode to use with the source alpha.
+   *
+   * \throw TileRendererException if the pixel formats do not match.
+   */
+  void Copy(const Surface& source, const Rectangle& src, const Rectangle& dst,
+            BlendMode mode = BlendMode::BLEND);
+
+  /**
+   * \brief Rasterize all recorded commands to the target surface.
+   *
+   * \throw Rethrows exceptions from the worker threads.
+   */
+  void Present();
+
+  /**
+   * \brief Get the number of commands recorded since the last Present().
+   */
+  std::size_t GetCommandCount() const { return commands.size(); }
+
+private:
+  enum class CommandType : uint8_t { FILL, LINE, COPY };
+
+  struct Command {
+    CommandType type;
+    BlendMode mode;
+    uint32_t pixel;           ///< Mapped drawing color
+    uint8_t alpha;            ///< Alpha of the source if the target has no alpha channel
+    Rectangle bounds;         ///< Affected pixels, clipped to the surface and clip rectangle
+    Rectangle shape;          ///< Destination rectangle, or line end points as (x, y, x2, y2)
+    Rectangle src;            ///< Source rectangle of a copy
+    const Surface* source;    ///< Source surface of a copy
+  };
+
+  Surface& target;
+  ThreadPool& pool;
+  uint32_t alpha_mask;
+  uint32_t alpha_shift;
+  int width;
+  int height;
+  int columns;
+  int rows;
+  Color color = Color::WHITE;
+  BlendMode blend_mode = BlendMode::NONE;
+  Rectangle clip;
+  bool clipping = false;
+  std::vector<Command> commands;
+  std::vector<std::vector<uint32_t>> bins;
+
+  void Record(CommandType type, const Rectangle& bounds, const Rectangle& shape,
+              BlendMode mode, const Rectangle& src = {}, const Surface* source = nullptr);
+
+  void RasterizeTile(std::size_t tile, uint8_t* pixels, int pitch) const;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_TILE_RENDERER_H
@@ -0,0 +1,189 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the TimerWheel class that manages many timers on the owning thread.
+ */
+
+#ifndef SDLXX_CORE_TIMER_WHEEL_H
+#define SDLXX_CORE_TIMER_WHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "sdlxx/core/time.h"
+#include "sdlxx/core/timer.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class that represents a hierarchical timer wheel.
+ *
+ * Unlike Timer, which runs every callback on the SDL timer thread, the wheel is driven by the
+ * main loop: Advance() fires the expired timers on the calling thread. Scheduling and cancelling
+ * a timer is O(1), and firing does not allocate memory, so thousands of gameplay timers can
+ * expire in a single frame.
+ *
+ * Time is measured in ticks of a configurable resolution. The wheel has four levels of 256 slots,
+ * so delays up to 2^32 ticks are handled without overflow; longer delays are cascaded again when
+ * they reach the top level.
+ *
+ * \note This class is not thread-safe.
+ */
+class TimerWheel {
+public:
+  /**
+   * \brief Function prototype for the timer callback function.
+   */
+  using Callback = std::function<void()>;
+
+  /**
+   * \brief A handle that identifies a scheduled timer.
+   *
+   * Handles stay safe to use after the timer has fired or has been cancelled.
+   */
+  struct Handle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+  };
+
+  /**
+   * \brief Construct a timer wheel.
+   *
+   * \param resolution The duration of a tick. Timers fire on the first Advance() after their
+   *                   expiration time, rounded up to a tick.
+   * \param capacity   The number of timers to preallocate space for.
+   */
+  explicit TimerWheel(Time resolution = Time::Microseconds(250), std::size_t capacity = 1024);
+
+  /**
+   * \brief Schedule a timer.
+   *
+   * \param delay    The time after which the callback is called.
+   * \param callback The callback function.
+   * \param period   If not zero, the timer is rescheduled with this period after it fires.
+   *
+   * \return Handle The handle of the timer.
+   */
+  Handle Schedule(Time delay, Callback callback, Time period = Time{});
+
+  /**
+   * \brief Cancel a timer.
+   *
+   * A timer may be cancelled from any callback, including its own.
+   *
+   * \param handle The handle of the timer.
+   *
+   * \return true if the timer was cancelled, false if it has already fired or been cancelled.
+   */
+  bool Cancel(Handle handle);
+
+  /**
+   * \brief Test whether the timer is scheduled.
+   */
+  bool IsScheduled(Handle handle) const;
+
+  /**
+   * \brief Fire all timers that expired by the current value of the performance counter.
+   *
+   * An exception thrown by a callback is passed to the caller. The timer that threw is then
+   * rescheduled or released as if its callback had returned, and the other timers that expired
+   * in the same tick fire on the next tick.
+   *
+   * \return std::size_t The number of fired timers.
+   *
+   * \upstream SDL_GetPerformanceCounter
+   */
+  std::size_t Advance();
+
+  /**
+   * \brief Advance the wheel by the specified time and fire all expired timers.
+   *
+   * Useful for deterministic simulations, e.g. from the fixed-step Update().
+   *
+   * \param elapsed The elapsed time.
+   *
+   * \return std::size_t The number of fired timers.
+   */
+  std::size_t Advance(Time elapsed);
+
+  /**
+   * \brief Get the number of scheduled timers.
+   */
+  std::size_t GetSize() const { return size; }
+
+  /**
+   * \brief Get the duration of a tick.
+   */
+  Time GetResolution() const { return Time::Microseconds(resolution); }
+
+private:
+  static constexpr uint32_t NONE = UINT32_MAX;
+  static constexpr int LEVELS = 4;
+  static constexpr int SLOT_BITS = 8;
+  static constexpr uint32_t SLOTS = 1U << SLOT_BITS;
+  static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+  static constexpr uint16_t FIRING_LIST = LEVELS * SLOTS;
+
+  enum class State : uint8_t { FREE, WHEEL, FIRING, RUNNING };
+
+  struct Entry {
+    uint64_t expiry = 0;  ///< Expiration time in ticks
+    uint64_t period = 0;  ///< Period in ticks, or 0 for one-shot timers
+    Callback callback;
+    uint32_t previous = NONE;
+    uint32_t next = NONE;
+    uint32_t generation = 0;
+    uint16_t list = 0;  ///< Index of the list that contains the entry, see GetHead()
+    State state = State::FREE;
+  };
+
+  int64_t resolution;  ///< Duration of a tick in microseconds
+  uint64_t current_tick = 0;
+  int64_t remainder = 0;  ///< Elapsed microseconds that do not make up a whole tick
+  uint64_t last_counter;
+  std::size_t size = 0;
+
+  std::deque<Entry> entries;  // Deque keeps references stable while callbacks add timers
+  uint32_t free_list = NONE;
+  std::array<std::array<uint32_t, SLOTS>, LEVELS> wheel;
+  uint32_t firing = NONE;
+
+  uint32_t Allocate();
+  void Free(uint32_t index);
+  uint32_t& GetHead(uint16_t list);
+  void Link(uint32_t index, uint16_t list);
+  void Unlink(uint32_t index);
+  void Insert(uint32_t index);
+  void Cascade(int level);
+  std::size_t Tick();
+  void Finish(uint32_t index, uint32_t generation);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_TIMER_WHEEL_H
@@ -0,0 +1,213 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Archetype class that stores entities with the same set of components.
+ */
+
+#ifndef SDLXX_ECS_ARCHETYPE_H
+#define SDLXX_ECS_ARCHETYPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sdlxx/ecs/component.h"
+
+namespace sdlxx {
+
+namespace ECS {  // NOLINT(readability-identifier-naming)
+
+/**
+ * \brief A handle that identifies an entity.
+ *
+ * Handles stay safe to use after the entity has been destroyed.
+ */
+struct Entity {
+  uint32_t index = UINT32_MAX;
+  uint32_t generation = 0;
+
+  bool operator==(const Entity& other) const {
+    return index == other.index && generation == other.generation;
+  }
+
+  bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+/**
+ * \brief A class that stores all entities that have exactly the same set of components.
+ *
+ * Entities are stored in fixed-size chunks as a structure of arrays: every chunk holds a column
+ * of entity handles followed by a column per component type, so systems iterate over tightly
+ * packed arrays of components. All chunks except the last one are full, and removing an entity
+ * moves the last entity into its place.
+ */
+class Archetype {
+public:
+  /**
+   * \brief The size of a chunk in bytes.
+   */
+  static constexpr std::size_t CHUNK_SIZE = 16 * 1024;
+
+  /**
+   * \brief A block of memory that stores a fixed number of entities.
+   */
+  struct Chunk {
+    struct Deleter {
+      void operator()(std::byte* data) const;
+    };
+
+    std::unique_ptr<std::byte[], Deleter> data;
+    uint32_t size = 0;
+  };
+
+  /**
+   * \brief Construct an archetype for a set of components.
+   *
+   * \param components The sorted identifiers of the component types.
+   */
+  explicit Archetype(std::vector<ComponentId> components);
+
+  // Deleted copy constructor
+  Archetype(const Archetype&) = delete;
+
+  // Deleted copy assignment operator
+  Archetype& operator=(const Archetype&) = delete;
+
+  /**
+   * \brief Destroy the archetype and all components of its entities.
+   */
+  ~Archetype();
+
+  /**
+   * \brief Get the sorted identifiers of the component types.
+   */
+  const std::vector<ComponentId>& GetComponents() const { return components; }
+
+  /**
+   * \brief Get the description of the component type of a column.
+   */
+  const ComponentInfo& GetComponentInfo(int column) const { return infos[column]; }
+
+  /**
+   * \brief Get the column of a component type.
+   *
+   * \return int The index of the column, or -1 if the archetype does not have the component.
+   */
+  int GetColumn(ComponentId id) const;
+
+  /**
+   * \brief Get the number of entities that fit in a chunk.
+   */
+  uint32_t GetChunkCapacity() const { return chunk_capacity; }
+
+  /**
+   * \brief Get the number of chunks.
+   */
+  std::size_t GetChunkCount() const { return chunks.size(); }
+
+  /**
+   * \brief Get the number of entities.
+   */
+  std::size_t GetSize() const {
+    return chunks.empty() ? 0 : (chunks.size() - 1) * chunk_capacity + chunks.back().size;
+  }
+
+  /**
+   * \brief Get the number of entities in a chunk.
+   */
+  uint32_t GetChunkSize(std::size_t chunk) const { return chunks[chunk].size; }
+
+  /**
+   * \brief Get the entity handles of a chunk.
+   */
+  Entity* GetEntities(std::size_t chunk) const {
+    return reinterpret_cast<Entity*>(chunks[chunk].data.get());
+  }
+
+  /**
+   * \brief Get the components of a chunk.
+   *
+   * \param chunk  The index of the chunk.
+   * \param column The column of the component type.
+   */
+  void* GetColumnData(std::size_t chunk, int column) const {
+    return chunks[chunk].data.get() + offsets[column];
+  }
+
+  /**
+   * \brief Get a component of an entity.
+   *
+   * \param chunk  The index of the chunk.
+   * \param row    The index of the entity in the chunk.
+   * \param column The column of the component type.
+   */
+  void* GetComponent(std::size_t chunk, uint32_t row, int column) const {
+    return chunks[chunk].data.get() + offsets[column] + row * infos[column].size;
+  }
+
+  /**
+   * \brief Append an entity with uninitialized components.
+   *
+   * \param entity The handle of the entity.
+   * \param chunk  The index of the chunk of the new entity.
+   * \param row    The index of the new entity in the chunk.
+   */
+  void Append(Entity entity, uint32_t& chunk, uint32_t& row);
+
+  /**
+   * \brief Remove an entity, whose components are already destroyed or relocated.
+   *
+   * \param chunk The index of the chunk of the entity.
+   * \param row   The index of the entity in the chunk.
+   *
+   * \return Entity The entity that was moved into the freed place, or an invalid handle if the
+   *                removed entity was the last one.
+   */
+  Entity Remove(uint32_t chunk, uint32_t row);
+
+  /**
+   * \brief Destroy the components of an entity.
+   */
+  void Destroy(uint32_t chunk, uint32_t row);
+
+  /**
+   * \brief Destroy all entities.
+   */
+  void Clear();
+
+private:
+  std::vector<ComponentId> components;
+  std::vector<ComponentInfo> infos;
+  std::vector<std::size_t> offsets;
+  std::size_t chunk_bytes = CHUNK_SIZE;
+  uint32_t chunk_capacity = 0;
+  std::vector<Chunk> chunks;
+};
+
+}  // namespace ECS
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_ECS_ARCHETYPE_H
@@ -0,0 +1,118 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the component type registry of the entity-component-system.
+ */
+
+#ifndef SDLXX_ECS_COMPONENT_H
+#define SDLXX_ECS_COMPONENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "sdlxx/core/exception.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for ECS-related exceptions.
+ */
+class EcsException : public Exception {
+  using Exception::Exception;
+};
+
+namespace ECS {  // NOLINT(readability-identifier-naming)
+
+/**
+ * \brief A unique identifier of a component type.
+ */
+using ComponentId = uint32_t;
+
+/**
+ * \brief A structure that describes how to store a component type in untyped memory.
+ */
+struct ComponentInfo {
+  std::size_t size;       ///< Size of the component
+  std::size_t alignment;  ///< Alignment of the component
+
+  /**
+   * \brief Move-construct a component from another one, and destroy the other one.
+   */
+  void (*relocate)(void* destination, void* source) noexcept;
+
+  /**
+   * \brief Destroy a component.
+   */
+  void (*destroy)(void* component) noexcept;
+};
+
+/**
+ * \brief Register a component type.
+ *
+ * \param info The description of the component type.
+ *
+ * \return ComponentId The identifier of the component type.
+ */
+ComponentId RegisterComponent(const ComponentInfo& info);
+
+/**
+ * \brief Get the description of a registered component type.
+ *
+ * \param id The identifier of the component type.
+ *
+ * \throw EcsException if the component type is not registered.
+ */
+ComponentInfo GetComponentInfo(ComponentId id);
+
+/**
+ * \brief Get the identifier of a component type, registering it on the first call.
+ *
+ * \tparam T The component type. Components are stored in untyped memory and relocated when an
+ *           entity changes its set of components, so they must be nothrow move constructible.
+ */
+template <typename T>
+ComponentId GetComponentId() {
+  static_assert(std::is_same_v<T, std::remove_cv_t<std::remove_reference_t<T>>>,
+                "Component type must not be a cv-qualified or reference type");
+  static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>,
+                "Component type must be nothrow move constructible and destructible");
+  static const ComponentId id = RegisterComponent(
+      {sizeof(T), alignof(T),
+       [](void* destination, void* source) noexcept {
+         T* value = static_cast<T*>(source);
+         new (destination) T(std::move(*value));
+         value->~T();
+       },
+       [](void* component) noexcept { static_cast<T*>(component)->~T(); }});
+  return id;
+}
+
+}  // namespace ECS
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_ECS_COMPONENT_H
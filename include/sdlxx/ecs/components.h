@@ -0,0 +1,91 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the common components of the entity-component-system.
+ */
+
+#ifndef SDLXX_ECS_COMPONENTS_H
+#define SDLXX_ECS_COMPONENTS_H
+
+#include "sdlxx/core/color.h"
+#include "sdlxx/core/rectangle.h"
+
+namespace sdlxx {
+
+class Texture;
+
+namespace ECS {  // NOLINT(readability-identifier-naming)
+
+/**
+ * \brief A component that represents a position of an entity.
+ */
+struct Position {
+  float x = 0.0F;  ///< X coordinate of the entity origin
+  float y = 0.0F;  ///< Y coordinate of the entity origin
+};
+
+/**
+ * \brief A component that represents a velocity of an entity.
+ */
+struct Velocity {
+  float x = 0.0F;  ///< Horizontal velocity in units per second
+  float y = 0.0F;  ///< Vertical velocity in units per second
+};
+
+/**
+ * \brief A component that represents a rotation of an entity.
+ */
+struct Rotation {
+  float angle = 0.0F;  ///< Rotation angle in degrees, clockwise
+};
+
+/**
+ * \brief A component that represents a textured rectangle centered at the entity position.
+ */
+struct Sprite {
+  const Texture* texture = nullptr;  ///< Texture of the sprite, not owned
+  Rectangle source;                  ///< Rectangle of the sprite in the texture
+  float width = 0.0F;                ///< Width of the sprite
+  float height = 0.0F;               ///< Height of the sprite
+  Color color = Color::WHITE;        ///< Color that is multiplied into the texture color
+};
+
+/**
+ * \brief A component that refers to a body of a physics engine.
+ *
+ * Pointer components are optional in World::Each(), so a body handle such as b2Body* is wrapped
+ * in this structure to be a required component.
+ *
+ * \tparam Body The type of a handle of a body, e.g. b2Body* for Box2D.
+ */
+template <typename Body>
+struct PhysicsBody {
+  Body body;  ///< Handle of the body, not owned
+};
+
+}  // namespace ECS
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_ECS_COMPONENTS_H
@@ -0,0 +1,123 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Scheduler class that runs the systems of the entity-component-system.
+ */
+
+#ifndef SDLXX_ECS_SCHEDULER_H
+#define SDLXX_ECS_SCHEDULER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "sdlxx/core/time.h"
+#include "sdlxx/ecs/world.h"
+
+namespace sdlxx {
+
+namespace ECS {  // NOLINT(readability-identifier-naming)
+
+/**
+ * \brief A class that runs systems in stages.
+ *
+ * Systems of a stage run in the order they were added, and the deferred changes of the world
+ * are applied after every system, so a system sees the entities created by the previous ones.
+ */
+class Scheduler {
+public:
+  /**
+   * \brief Stages of a frame.
+   */
+  enum class Stage {
+    PHYSICS,  ///< Simulation and synchronization with physics engines
+    UPDATE,   ///< Game logic
+    RENDER    ///< Drawing, called once per frame
+  };
+
+  /**
+   * \brief Function prototype for a system.
+   */
+  using System = std::function<void(World& world, Time dt)>;
+
+  /**
+   * \brief Add a system.
+   *
+   * \param name   The unique name of the system.
+   * \param system The system.
+   * \param stage  The stage to run the system in.
+   *
+   * \throw EcsException if a system with the same name already exists.
+   */
+  void Add(std::string name, System system, Stage stage = Stage::UPDATE);
+
+  /**
+   * \brief Remove a system.
+   *
+   * \return true if the system was removed, false if it does not exist.
+   */
+  bool Remove(const std::string& name);
+
+  /**
+   * \brief Enable or disable a system.
+   *
+   * \throw EcsException if the system does not exist.
+   */
+  void SetEnabled(const std::string& name, bool enabled);
+
+  /**
+   * \brief Test whether the system exists and is enabled.
+   */
+  bool IsEnabled(const std::string& name) const;
+
+  /**
+   * \brief Run all enabled systems of a stage.
+   *
+   * \param world The world to run the systems on.
+   * \param stage The stage.
+   * \param dt    The elapsed time.
+   */
+  void Run(World& world, Stage stage, Time dt);
+
+  /**
+   * \brief Run all enabled systems of the physics and update stages.
+   */
+  void Update(World& world, Time dt);
+
+private:
+  struct Entry {
+    std::string name;
+    System system;
+    Stage stage;
+    bool enabled;
+  };
+
+  std::vector<Entry> systems;
+};
+
+}  // namespace ECS
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_ECS_SCHEDULER_H
@@ -0,0 +1,107 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the common systems of the entity-component-system.
+ */
+
+#ifndef SDLXX_ECS_SYSTEMS_H
+#define SDLXX_ECS_SYSTEMS_H
+
+#include <utility>
+
+#include "sdlxx/ecs/components.h"
+#include "sdlxx/ecs/scheduler.h"
+
+namespace sdlxx {
+
+class SpriteBatch;
+
+namespace ECS {  // NOLINT(readability-identifier-naming)
+
+/**
+ * \brief A pose of a body reported by a physics engine.
+ */
+struct Pose {
+  float x;      ///< X coordinate of the body origin
+  float y;      ///< Y coordinate of the body origin
+  float angle;  ///< Rotation angle in degrees, clockwise
+};
+
+/**
+ * \brief Create a system that moves entities with a Position and a Velocity.
+ *
+ * A simple integrator for entities that are not simulated by a physics engine.
+ */
+Scheduler::System MakeMovementSystem();
+
+/**
+ * \brief Create a system that draws entities with a Position and a Sprite.
+ *
+ * Sprites are centered at the entity position, and rotated if the entity has a Rotation. They
+ * are submitted to the batch in storage order, so entities that share a texture should share an
+ * archetype to get the largest batches. The batch is flushed at the end of the system.
+ *
+ * \param batch The sprite batch to draw with.
+ */
+Scheduler::System MakeRenderSystem(SpriteBatch& batch);
+
+/**
+ * \brief Create a system that copies the poses of physics bodies into Position and Rotation.
+ *
+ * Entities refer to their bodies with a PhysicsBody component, e.g. PhysicsBody<b2Body*> for
+ * Box2D:
+ * \code
+ * world.Create(ECS::PhysicsBody<b2Body*>{body}, ECS::Position{}, ECS::Rotation{});
+ * scheduler.Add("box2d", ECS::MakePhysicsBridge<b2Body*>([scale](b2Body* body) {
+ *   b2Vec2 position = body->GetPosition();
+ *   return ECS::Pose{position.x * scale, position.y * scale, body->GetAngle() * 57.2958F};
+ * }), ECS::Scheduler::Stage::PHYSICS);
+ * \endcode
+ * The engine itself should be stepped by a system that runs before the bridge.
+ *
+ * \tparam Body     The type of a handle of a body in PhysicsBody.
+ * \tparam Function The type of a function that returns the Pose of a body.
+ *
+ * \param get_pose The function that returns the Pose of a body.
+ */
+template <typename Body, typename Function>
+Scheduler::System MakePhysicsBridge(Function get_pose) {
+  return [get_pose = std::move(get_pose)](World& world, Time /* dt */) {
+    world.Each<const PhysicsBody<Body>, Position, Rotation*>(
+        [&get_pose](const PhysicsBody<Body>& body, Position& position, Rotation* rotation) {
+          Pose pose = get_pose(body.body);
+          position.x = pose.x;
+          position.y = pose.y;
+          if (rotation != nullptr) {
+            rotation->angle = pose.angle;
+          }
+        });
+  };
+}
+
+}  // namespace ECS
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_ECS_SYSTEMS_H
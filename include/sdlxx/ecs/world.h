@@ -0,0 +1,379 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the World class that owns entities and their components.
+ */
+
+#ifndef SDLXX_ECS_WORLD_H
+#define SDLXX_ECS_WORLD_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sdlxx/ecs/archetype.h"
+#include "sdlxx/ecs/component.h"
+
+namespace sdlxx {
+
+namespace ECS {  // NOLINT(readability-identifier-naming)
+
+/**
+ * \brief A class that owns entities and their components.
+ *
+ * Entities with the same set of components share an Archetype, so a query visits only the
+ * archetypes that have the requested components and iterates over contiguous arrays.
+ *
+ * Queries are typed:
+ * \code
+ * world.Each<Position, const Velocity>([dt](Position& position, const Velocity& velocity) {
+ *   position.x += velocity.x * dt;
+ *   position.y += velocity.y * dt;
+ * });
+ * \endcode
+ * A pointer type requests an optional component, which is nullptr for entities that do not
+ * have it, and the function may take the Entity handle as its first parameter.
+ *
+ * Entities can not be created or destroyed, and components can not be added or removed while a
+ * query is running. Such changes should be deferred with Defer().
+ *
+ * \note This class is not thread-safe.
+ */
+class World {
+public:
+  /**
+   * \brief Construct an empty world.
+   */
+  World() = default;
+
+  // Deleted copy constructor
+  World(const World&) = delete;
+
+  // Deleted copy assignment operator
+  World& operator=(const World&) = delete;
+
+  /**
+   * \brief Create an entity with the specified components.
+   *
+   * \param components The components of the entity, all of distinct types.
+   *
+   * \return Entity The handle of the new entity.
+   *
+   * \throw EcsException if a query is running.
+   */
+  template <typename... Ts>
+  Entity Create(Ts&&... components);
+
+  /**
+   * \brief Destroy an entity and all of its components.
+   *
+   * \param entity The handle of the entity.
+   *
+   * \return true if the entity was destroyed, false if it is not alive.
+   *
+   * \throw EcsException if a query is running.
+   */
+  bool Destroy(Entity entity);
+
+  /**
+   * \brief Test whether the entity is alive.
+   */
+  bool IsAlive(Entity entity) const {
+    return entity.index < records.size() && records[entity.index].generation == entity.generation &&
+           records[entity.index].archetype != NONE;
+  }
+
+  /**
+   * \brief Test whether the entity has a component.
+   */
+  template <typename T>
+  bool Has(Entity entity) const {
+    return Find(entity, GetComponentId<T>()) != nullptr;
+  }
+
+  /**
+   * \brief Get a component of an entity.
+   *
+   * \return T* The component, or nullptr if the entity does not have it or is not alive.
+   */
+  template <typename T>
+  T* TryGet(Entity entity) const {
+    return static_cast<T*>(Find(entity, GetComponentId<T>()));
+  }
+
+  /**
+   * \brief Get a component of an entity.
+   *
+   * \throw EcsException if the entity does not have the component or is not alive.
+   */
+  template <typename T>
+  T& Get(Entity entity) const {
+    T* component = TryGet<T>(entity);
+    if (component == nullptr) {
+      throw EcsException("Entity does not have the requested component");
+    }
+    return *component;
+  }
+
+  /**
+   * \brief Add a component to an entity, or replace the existing one.
+   *
+   * \param entity    The handle of the entity.
+   * \param component The component.
+   *
+   * \return T& The component stored in the world.
+   *
+   * \throw EcsException if the entity is not alive or a query is running.
+   */
+  template <typename T>
+  std::decay_t<T>& Add(Entity entity, T&& component);
+
+  /**
+   * \brief Remove a component from an entity.
+   *
+   * \return true if the component was removed, false if the entity does not have it.
+   *
+   * \throw EcsException if the entity is not alive or a query is running.
+   */
+  template <typename T>
+  bool Remove(Entity entity);
+
+  /**
+   * \brief Call a function for every entity that has the specified components.
+   *
+   * \tparam Ts The component types. A const type is passed by const reference, and a pointer
+   *            type is an optional component.
+   *
+   * \param function The function that takes the components, optionally preceded by the Entity.
+   */
+  template <typename... Ts, typename Function>
+  void Each(Function&& function);
+
+  /**
+   * \brief Count the entities that have the specified components.
+   */
+  template <typename... Ts>
+  std::size_t Count() const;
+
+  /**
+   * \brief Defer a structural change until the running queries finish.
+   *
+   * Deferred changes are applied by FlushDeferred(), which is called by the Scheduler after
+   * every system.
+   */
+  void Defer(std::function<void(World&)> change) { deferred.push_back(std::move(change)); }
+
+  /**
+   * \brief Apply all deferred changes.
+   */
+  void FlushDeferred();
+
+  /**
+   * \brief Get the number of alive entities.
+   */
+  std::size_t GetSize() const { return size; }
+
+  /**
+   * \brief Destroy all entities.
+   *
+   * \throw EcsException if a query is running.
+   */
+  void Clear();
+
+private:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  struct Record {
+    uint32_t generation = 0;
+    uint32_t archetype = NONE;
+    uint32_t chunk = 0;
+    uint32_t row = 0;
+  };
+
+  std::vector<std::unique_ptr<Archetype>> archetypes;
+  std::map<std::vector<ComponentId>, uint32_t> archetype_index;
+  std::vector<Record> records;
+  std::vector<uint32_t> free_records;
+  std::vector<std::function<void(World&)>> deferred;
+  std::size_t size = 0;
+  int iterating = 0;
+
+  template <typename T>
+  using ComponentOf = std::remove_cv_t<std::remove_pointer_t<T>>;
+
+  template <typename T>
+  static constexpr bool IS_OPTIONAL = std::is_pointer_v<T>;
+
+  uint32_t GetArchetype(std::vector<ComponentId> components);
+
+  Entity Allocate(uint32_t archetype);
+
+  void Move(Entity entity, uint32_t archetype);
+
+  void* Find(Entity entity, ComponentId id) const;
+
+  void CheckNotIterating() const;
+
+  template <typename... Ts>
+  static bool Matches(const Archetype& archetype);
+
+  template <typename... Ts, typename Function, std::size_t... Is>
+  void EachIn(Archetype& archetype, Function& function, std::index_sequence<Is...>);
+};
+
+template <typename... Ts>
+Entity World::Create(Ts&&... components) {
+  CheckNotIterating();
+  std::vector<ComponentId> ids{GetComponentId<std::decay_t<Ts>>()...};
+  std::sort(ids.begin(), ids.end());
+  if (std::adjacent_find(ids.begin(), ids.end()) != ids.end()) {
+    throw EcsException("Entity components must have distinct types");
+  }
+  // Components are constructed before the entity, so that a throwing constructor has no effect
+  std::tuple<std::decay_t<Ts>...> values(std::forward<Ts>(components)...);
+  Entity entity = Allocate(GetArchetype(std::move(ids)));
+  std::apply(
+      [this, entity](auto&... value) {
+        (new (Find(entity, GetComponentId<std::decay_t<decltype(value)>>()))
+             std::decay_t<decltype(value)>(std::move(value)),
+         ...);
+      },
+      values);
+  return entity;
+}
+
+template <typename T>
+std::decay_t<T>& World::Add(Entity entity, T&& component) {
+  using Component = std::decay_t<T>;
+  CheckNotIterating();
+  if (!IsAlive(entity)) {
+    throw EcsException("Entity is not alive");
+  }
+  const ComponentId id = GetComponentId<Component>();
+  if (auto* existing = static_cast<Component*>(Find(entity, id))) {
+    *existing = std::forward<T>(component);
+    return *existing;
+  }
+  Component value(std::forward<T>(component));
+  std::vector<ComponentId> ids = archetypes[records[entity.index].archetype]->GetComponents();
+  ids.insert(std::upper_bound(ids.begin(), ids.end(), id), id);
+  Move(entity, GetArchetype(std::move(ids)));
+  return *new (Find(entity, id)) Component(std::move(value));
+}
+
+template <typename T>
+bool World::Remove(Entity entity) {
+  CheckNotIterating();
+  if (!IsAlive(entity)) {
+    throw EcsException("Entity is not alive");
+  }
+  const ComponentId id = GetComponentId<T>();
+  std::vector<ComponentId> ids = archetypes[records[entity.index].archetype]->GetComponents();
+  auto it = std::lower_bound(ids.begin(), ids.end(), id);
+  if (it == ids.end() || *it != id) {
+    return false;
+  }
+  ids.erase(it);
+  Move(entity, GetArchetype(std::move(ids)));
+  return true;
+}
+
+template <typename... Ts, typename Function>
+void World::Each(Function&& function) {
+  ++iterating;
+  try {
+    for (std::size_t i = 0; i < archetypes.size(); ++i) {
+      if (Matches<Ts...>(*archetypes[i])) {
+        EachIn<Ts...>(*archetypes[i], function, std::index_sequence_for<Ts...>{});
+      }
+    }
+  } catch (...) {
+    --iterating;
+    throw;
+  }
+  --iterating;
+}
+
+template <typename... Ts>
+std::size_t World::Count() const {
+  std::size_t count = 0;
+  for (const auto& archetype : archetypes) {
+    if (Matches<Ts...>(*archetype)) {
+      count += archetype->GetSize();
+    }
+  }
+  return count;
+}
+
+template <typename... Ts>
+bool World::Matches(const Archetype& archetype) {
+  return ((IS_OPTIONAL<Ts> || archetype.GetColumn(GetComponentId<ComponentOf<Ts>>()) >= 0) &&
+          ...);
+}
+
+template <typename... Ts, typename Function, std::size_t... Is>
+void World::EachIn(Archetype& archetype, Function& function, std::index_sequence<Is...>) {
+  const std::array<int, sizeof...(Ts)> columns{
+      archetype.GetColumn(GetComponentId<ComponentOf<Ts>>())...};
+  for (std::size_t chunk = 0; chunk < archetype.GetChunkCount(); ++chunk) {
+    const uint32_t count = archetype.GetChunkSize(chunk);
+    const Entity* entities = archetype.GetEntities(chunk);
+    // Base pointers of the columns, nullptr for missing optional components
+    std::tuple<std::remove_pointer_t<Ts>*...> data{static_cast<std::remove_pointer_t<Ts>*>(
+        columns[Is] >= 0 ? archetype.GetColumnData(chunk, columns[Is]) : nullptr)...};
+    auto get = [&data](auto index, uint32_t row) -> decltype(auto) {
+      constexpr std::size_t I = decltype(index)::value;
+      using T = std::tuple_element_t<I, std::tuple<Ts...>>;
+      if constexpr (IS_OPTIONAL<T>) {
+        T base = std::get<I>(data);
+        return base != nullptr ? base + row : nullptr;
+      } else {
+        return static_cast<T&>(std::get<I>(data)[row]);
+      }
+    };
+    for (uint32_t row = 0; row < count; ++row) {
+      if constexpr (std::is_invocable_v<Function&, Entity,
+                                        decltype(get(std::integral_constant<std::size_t, Is>{},
+                                                     row))...>) {
+        function(entities[row], get(std::integral_constant<std::size_t, Is>{}, row)...);
+      } else {
+        function(get(std::integral_constant<std::size_t, Is>{}, row)...);
+      }
+    }
+  }
+}
+
+}  // namespace ECS
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_ECS_WORLD_H
@@ -28,17 +28,21 @@
 #ifndef SDLXX_GUI_H
 #define SDLXX_GUI_H
 
+#include "sdlxx/gui/animator.h"
 #include "sdlxx/gui/button.h"
+#include "sdlxx/gui/layer_cache.h"
 #include "sdlxx/gui/layout.h"
 #include "sdlxx/gui/layouts/grid_layout.h"
 #include "sdlxx/gui/layouts/horizontal_layout.h"
 #include "sdlxx/gui/layouts/manual_layout.h"
 #include "sdlxx/gui/layouts/vertical_layout.h"
 #include "sdlxx/gui/node.h"
+#include "sdlxx/gui/node_pool.h"
 #include "sdlxx/gui/parent_node.h"
 #include "sdlxx/gui/scene.h"
 #include "sdlxx/gui/scene_manager.h"
 #include "sdlxx/gui/style.h"
 #include "sdlxx/gui/texture_manager.h"
+#include "sdlxx/gui/transform.h"
 
 #endif  // SDLXX_GUI_H
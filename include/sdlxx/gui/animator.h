@@ -0,0 +1,314 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Animator class that interpolates node and sprite properties over time.
+ */
+
+#ifndef SDLXX_GUI_ANIMATOR_H
+#define SDLXX_GUI_ANIMATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "sdlxx/core/color.h"
+#include "sdlxx/core/time.h"
+#include "sdlxx/gui/node_pool.h"
+
+namespace sdlxx {
+
+class Node;
+
+/**
+ * \brief An enumeration of easing curves.
+ *
+ * All curves map 0 to 0 and 1 to 1. Only polynomial curves are provided, so that they can be
+ * evaluated for many tweens at once with vector instructions.
+ */
+enum class Easing : uint8_t {
+  LINEAR,        ///< Constant speed
+  QUAD_IN,       ///< Quadratic acceleration from zero velocity
+  QUAD_OUT,      ///< Quadratic deceleration to zero velocity
+  QUAD_IN_OUT,   ///< Quadratic acceleration until halfway, then deceleration
+  CUBIC_IN,      ///< Cubic acceleration from zero velocity
+  CUBIC_OUT,     ///< Cubic deceleration to zero velocity
+  CUBIC_IN_OUT,  ///< Cubic acceleration until halfway, then deceleration
+  QUART_IN,      ///< Quartic acceleration from zero velocity
+  QUART_OUT,     ///< Quartic deceleration to zero velocity
+  QUART_IN_OUT,  ///< Quartic acceleration until halfway, then deceleration
+  SMOOTHSTEP,    ///< Hermite interpolation with zero velocity at both ends
+  BACK_IN,       ///< Moves slightly backwards before accelerating
+  BACK_OUT       ///< Overshoots the target before settling
+};
+
+/**
+ * \brief A class that animates float and color properties with easing curves.
+ *
+ * Active tweens are stored as a structure of arrays, grouped by the easing curve, so each frame
+ * evaluates a tight branch-free loop per curve that the compiler turns into vector instructions,
+ * and only the final values are written to the animated properties. Tens of thousands of
+ * concurrent tweens take a fraction of a millisecond per frame.
+ *
+ * The animated properties are referenced by address, so they must outlive their tweens, or the
+ * tweens must be cancelled first. Animations started with MoveTo(), ScaleTo() and RotateTo()
+ * keep the handle of the node instead, and are cancelled by the next Update() after the node
+ * is destroyed, before the memory of the node can be written.
+ *
+ * \note This class is not thread-safe.
+ */
+class Animator {
+public:
+  /**
+   * \brief Function prototype for the completion callback function.
+   */
+  using Callback = std::function<void()>;
+
+  /**
+   * \brief A handle that identifies an animation.
+   *
+   * Handles stay safe to use after the animation has completed or has been cancelled.
+   */
+  struct Handle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+  };
+
+  /**
+   * \brief Construct an animator.
+   *
+   * \param capacity The number of animations to preallocate space for.
+   */
+  explicit Animator(std::size_t capacity = 1024);
+
+  /**
+   * \brief Animate a float property.
+   *
+   * \param value       The property to animate. The animation starts from its current value.
+   * \param to          The final value of the property.
+   * \param duration    The duration of the animation.
+   * \param easing      The easing curve.
+   * \param on_complete The function that is called after the final value is written.
+   *
+   * \return Handle The handle of the animation.
+   */
+  Handle Animate(float& value, float to, Time duration, Easing easing = Easing::LINEAR,
+                 Callback on_complete = {});
+
+  /**
+   * \brief Animate a color component or any other byte property.
+   *
+   * \copydetails Animate(float&, float, Time, Easing, Callback)
+   */
+  Handle Animate(uint8_t& value, uint8_t to, Time duration, Easing easing = Easing::LINEAR,
+                 Callback on_complete = {});
+
+  /**
+   * \brief Animate a color.
+   *
+   * \copydetails Animate(float&, float, Time, Easing, Callback)
+   */
+  Handle Animate(Color& value, Color to, Time duration, Easing easing = Easing::LINEAR,
+                 Callback on_complete = {});
+
+  /**
+   * \brief Move a node to the specified position.
+   *
+   * \param node        The node to move.
+   * \param x           The final X coordinate of the node origin.
+   * \param y           The final Y coordinate of the node origin.
+   * \param duration    The duration of the animation.
+   * \param easing      The easing curve.
+   * \param on_complete The function that is called after the node reaches the position.
+   *
+   * \return Handle The handle of the animation.
+   */
+  Handle MoveTo(Node& node, float x, float y, Time duration, Easing easing = Easing::LINEAR,
+                Callback on_complete = {});
+
+  /**
+   * \brief Scale a node to the specified factors.
+   *
+   * \param node        The node to scale.
+   * \param scale_x     The final horizontal scaling factor.
+   * \param scale_y     The final vertical scaling factor.
+   * \param duration    The duration of the animation.
+   * \param easing      The easing curve.
+   * \param on_complete The function that is called after the node reaches the scale.
+   *
+   * \return Handle The handle of the animation.
+   */
+  Handle ScaleTo(Node& node, float scale_x, float scale_y, Time duration,
+                 Easing easing = Easing::LINEAR, Callback on_complete = {});
+
+  /**
+   * \brief Rotate a node to the specified angle.
+   *
+   * \param node        The node to rotate.
+   * \param angle       The final rotation angle in degrees, clockwise.
+   * \param duration    The duration of the animation.
+   * \param easing      The easing curve.
+   * \param on_complete The function that is called after the node reaches the angle.
+   *
+   * \return Handle The handle of the animation.
+   */
+  Handle RotateTo(Node& node, float angle, Time duration, Easing easing = Easing::LINEAR,
+                  Callback on_complete = {});
+
+  /**
+   * \brief Cancel an animation.
+   *
+   * The animated property keeps its current value, and the completion callback is not called.
+   *
+   * \param handle The handle of the animation.
+   *
+   * \return true if the animation was cancelled, false if it has already completed or been
+   *         cancelled.
+   */
+  bool Cancel(Handle handle);
+
+  /**
+   * \brief Test whether the animation is running.
+   */
+  bool IsAnimating(Handle handle) const;
+
+  /**
+   * \brief Advance all animations by the specified time.
+   *
+   * Completion callbacks are called after all properties are updated, and may start new
+   * animations or cancel other ones.
+   *
+   * \param dt The elapsed time.
+   *
+   * \return std::size_t The number of completed animations.
+   */
+  std::size_t Update(Time dt);
+
+  /**
+   * \brief Cancel all animations.
+   */
+  void Clear();
+
+  /**
+   * \brief Get the number of running animations.
+   */
+  std::size_t GetSize() const { return size; }
+
+  /**
+   * \brief Evaluate an easing curve.
+   *
+   * \param easing   The easing curve.
+   * \param progress The progress of an animation in range [0, 1].
+   *
+   * \return float The eased progress.
+   */
+  static float Ease(Easing easing, float progress);
+
+private:
+  static constexpr std::size_t EASING_COUNT = static_cast<std::size_t>(Easing::BACK_OUT) + 1;
+  static constexpr std::size_t MAX_COMPONENTS = 4;
+  static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+  /**
+   * \brief Tweens of a single easing curve and property type, stored as a structure of arrays.
+   */
+  template <typename T>
+  struct Lanes {
+    std::vector<float> from;
+    std::vector<float> to;
+    std::vector<float> progress;  ///< Normalized time in range [0, 1]
+    std::vector<float> rate;      ///< Progress per second
+    std::vector<float> value;
+    std::vector<T*> target;
+    std::vector<uint32_t> owner;  ///< Index of the animation slot
+    std::vector<uint8_t> component;
+
+    std::size_t GetSize() const { return target.size(); }
+
+    void Clear() {
+      from.clear();
+      to.clear();
+      progress.clear();
+      rate.clear();
+      value.clear();
+      target.clear();
+      owner.clear();
+      component.clear();
+    }
+  };
+
+  struct Group {
+    Lanes<float> floats;
+    Lanes<uint8_t> bytes;
+  };
+
+  struct Location {
+    bool is_byte = false;
+    uint32_t lane = 0;
+  };
+
+  struct Slot {
+    uint32_t generation = 0;
+    bool active = false;
+    Easing easing = Easing::LINEAR;
+    uint8_t components = 0;
+    uint8_t remaining = 0;
+    std::array<Location, MAX_COMPONENTS> lanes;
+    uint32_t node = NO_NODE;  ///< Index in node_slots of an animation of a node
+    Callback on_complete;
+  };
+
+  std::array<Group, EASING_COUNT> groups;
+  std::vector<Slot> slots;
+  std::vector<uint32_t> free_slots;
+  std::vector<uint32_t> finished;
+  std::vector<uint32_t> completed;
+  std::vector<Callback> callbacks;
+  std::vector<uint32_t> node_slots;            ///< Slots of animations of nodes
+  std::vector<NodePool::Handle> node_handles;  ///< Handles of the nodes of node_slots
+  std::vector<Node*> resolved_nodes;
+  std::size_t size = 0;
+
+  uint32_t Allocate(Easing easing, Callback on_complete);
+
+  void Release(uint32_t index);
+
+  void BindNode(uint32_t index, const Node& node);
+
+  void CancelDestroyedNodes();
+
+  template <typename T>
+  void AddLane(uint32_t index, T& target, float to, Time duration);
+
+  template <typename T>
+  void RemoveLane(Lanes<T>& lanes, uint32_t lane);
+
+  template <typename T>
+  void Step(Lanes<T>& lanes, Easing easing, float dt);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_GUI_ANIMATOR_H
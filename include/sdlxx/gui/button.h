@@ -50,13 +50,16 @@ public:
 
   explicit Button(std::string text, std::function<void()> handler,
                   Font& font = FontManager::GetDefault())
-      : Node("button"), text(std::move(text)), handler(std::move(handler)), font(font) {}
+      : Node("button"), text(std::move(text)), handler(std::move(handler)), font(font) {
+    SetEventMask(EventKind::MOUSE_MOTION | EventKind::MOUSE_BUTTON);
+  }
 
   void OnActivate() override {
     Node::OnActivate();
     Surface text_surface = font.RenderBlended(text, Color::BLACK);
     text_texture = std::make_unique<Texture>(GetContext()->renderer, text_surface);
     text_size = text_surface.GetSize();
+    Invalidate();
   }
 
   void OnDeactivate() override {
@@ -101,18 +104,18 @@ public:
       if (viewport.Contains(mouse)) {
         switch (e.type) {
           case SDL_MOUSEMOTION:
-            state = State::HOVER;
+            SetState(State::HOVER);
             break;
           case SDL_MOUSEBUTTONDOWN:
-            state = State::PRESSED;
+            SetState(State::PRESSED);
             handler();
             return true;
           case SDL_MOUSEBUTTONUP:
-            state = State::RELEASED;
+            SetState(State::RELEASED);
             break;
         }
       } else {
-        state = State::DEFAULT;
+        SetState(State::DEFAULT);
       }
     }
     return false;
@@ -125,6 +128,13 @@ private:
   Font& font;
   std::unique_ptr<Texture> text_texture;
   Dimensions text_size;
+
+  void SetState(State new_state) {
+    if (state != new_state) {
+      state = new_state;
+      Invalidate();
+    }
+  }
 };
 
 }  // namespace sdlxx
@@ -0,0 +1,165 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the LayerCache class that keeps cached renderings of GUI subtrees.
+ */
+
+#ifndef SDLXX_GUI_LAYER_CACHE_H
+#define SDLXX_GUI_LAYER_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "sdlxx/core/dimensions.h"
+#include "sdlxx/core/renderer.h"
+#include "sdlxx/core/texture.h"
+#include "sdlxx/gui/node_pool.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class that owns the target textures of nodes that are cached as bitmaps.
+ *
+ * The total memory of the layers is limited by a budget. When a new layer does not fit, the least
+ * recently drawn layers are evicted, and their nodes are rendered again the next time they are
+ * drawn. A layer that does not fit into the budget alone is not created, and its node is rendered
+ * directly.
+ *
+ * \sa Node::SetCacheAsBitmap()
+ */
+class LayerCache {
+public:
+  /**
+   * \brief Construct a layer cache.
+   *
+   * \param renderer The renderer to create the layers with.
+   * \param budget   The maximum memory of all layers in bytes.
+   */
+  explicit LayerCache(Renderer& renderer, std::size_t budget = 32 * 1024 * 1024);
+
+  // Deleted copy constructor
+  LayerCache(const LayerCache&) = delete;
+
+  // Deleted copy assignment operator
+  LayerCache& operator=(const LayerCache&) = delete;
+
+  /**
+   * \brief Get the layer of a node and mark it as recently used.
+   *
+   * \param node The handle of the node.
+   * \param size The expected size of the layer.
+   *
+   * \return Texture* The layer, or nullptr if there is no layer of this size.
+   */
+  Texture* Find(NodePool::Handle node, Dimensions size);
+
+  /**
+   * \brief Create or resize the layer of a node.
+   *
+   * \param node The handle of the node.
+   * \param size The size of the layer.
+   *
+   * \return Texture* The layer, or nullptr if render targets are not supported or the layer
+   *                  does not fit into the budget.
+   *
+   * \throw TextureException if the texture can not be created.
+   */
+  Texture* Create(NodePool::Handle node, Dimensions size);
+
+  /**
+   * \brief Destroy the layer of a node.
+   */
+  void Release(NodePool::Handle node);
+
+  /**
+   * \brief Redirect rendering to a layer.
+   *
+   * Calls may be nested, so that a cached subtree may contain other cached subtrees.
+   *
+   * \param layer The layer returned by Create().
+   *
+   * \throw RendererException on error.
+   */
+  void BeginLayer(Texture& layer);
+
+  /**
+   * \brief Restore the rendering target that was active before the matching BeginLayer().
+   *
+   * \throw RendererException on error.
+   */
+  void EndLayer();
+
+  /**
+   * \brief Set the maximum memory of all layers, evicting layers if needed.
+   *
+   * \param new_budget The budget in bytes.
+   */
+  void SetBudget(std::size_t new_budget);
+
+  /**
+   * \brief Get the maximum memory of all layers in bytes.
+   */
+  std::size_t GetBudget() const { return budget; }
+
+  /**
+   * \brief Get the memory of all layers in bytes.
+   */
+  std::size_t GetUsage() const { return usage; }
+
+  /**
+   * \brief Get the number of layers.
+   */
+  std::size_t GetSize() const { return layers.size(); }
+
+  /**
+   * \brief Destroy all layers.
+   */
+  void Clear();
+
+private:
+  struct Layer {
+    uint32_t generation;
+    std::unique_ptr<Texture> texture;
+    Dimensions size;
+    std::size_t bytes;
+    std::list<uint32_t>::iterator position;
+  };
+
+  Renderer& renderer;
+  std::size_t budget;
+  std::size_t usage = 0;
+  std::unordered_map<uint32_t, Layer> layers;
+  std::list<uint32_t> recently_used;
+  std::vector<Texture*> targets;
+
+  void Evict(std::size_t required, uint32_t keep);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_GUI_LAYER_CACHE_H
@@ -42,10 +42,14 @@ namespace sdlxx {
 class Layout : public ParentNode {
 public:
   bool HandleEvent(const Event& e) override {
+    const EventKind kind = EventBatch::GetKind(e);
     Renderer& renderer = GetContext()->renderer;
     Rectangle original_viewport = renderer.GetViewport();
     for (size_t i = 0; i < GetChildren().size(); ++i) {
-      renderer.SetViewport(GetPosition(i));
+      if (!GetChild(i)->ReceivesEvents(kind)) {
+        continue;
+      }
+      renderer.SetViewport(GetViewport(original_viewport, i));
       if (GetChild(i)->HandleEvent(e)) {
         renderer.SetViewport(original_viewport);
         return true;
@@ -58,9 +62,9 @@ public:
   void Render(Renderer& renderer) const override {
     Rectangle original_viewport = renderer.GetViewport();
     for (size_t i = 0; i < GetChildren().size(); ++i) {
-      renderer.SetViewport(GetPosition(i));
+      renderer.SetViewport(GetViewport(original_viewport, i));
       renderer.Fill();
-      GetChild(i)->Render(renderer);
+      GetChild(i)->Draw(renderer);
     }
     renderer.SetViewport(original_viewport);
   }
@@ -73,6 +77,8 @@ protected:
   explicit Layout(std::string tag, std::vector<std::unique_ptr<Node>> children,
                   std::vector<Rectangle> positions)
       : ParentNode(std::move(tag), std::move(children)), positions(std::move(positions)) {
+    // A layout only passes events to its children, so it receives the kinds they handle
+    SetEventMask(EventKind::NONE);
     GetPositions().resize(GetChildren().size());
   }
 
@@ -91,6 +97,15 @@ protected:
 
 private:
   std::vector<Rectangle> positions;
+
+  // Positions are relative to the viewport of the layout, so that a layout can be rendered into
+  // a cached layer at the origin
+  Rectangle GetViewport(const Rectangle& layout_viewport, size_t i) const {
+    Rectangle viewport = positions[i];
+    viewport.x += layout_viewport.x;
+    viewport.y += layout_viewport.y;
+    return viewport;
+  }
 };
 
 }  // namespace sdlxx
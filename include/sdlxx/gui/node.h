@@ -31,29 +31,86 @@
 #include <limits>
 #include <stdexcept>
 
+#include "sdlxx/core/event_batch.h"
 #include "sdlxx/core/events.h"
 #include "sdlxx/core/object.h"
 #include "sdlxx/core/renderer.h"
 #include "sdlxx/core/time.h"
+#include "sdlxx/gui/node_pool.h"
 #include "sdlxx/gui/style.h"
+#include "sdlxx/gui/transform.h"
 
 namespace sdlxx {
 
+class Animator;
+class LayerCache;
+class ParentNode;
 class Window;
 class Renderer;
+class TimerWheel;
 
+/**
+ * \brief A class that represents a basic node of the scene graph.
+ *
+ * Nodes are allocated from the NodePool, so creating and destroying them does not call malloc.
+ */
 class Node : public Object {
 public:
   struct Context {
     Window& window;
     Renderer& renderer;
+    float interpolation = 0.0F;    ///< Fraction of the time step elapsed since the last update
+    TimerWheel* timers = nullptr;  ///< Timers that fire on the main loop thread
+    Animator* animator = nullptr;  ///< Animations that advance with every simulation step
+    LayerCache* layers = nullptr;  ///< Cached renderings of subtrees
   };
 
+  // Copy constructor registers a new handle for the copy
+  Node(const Node& other)
+      : tag(other.tag),
+        size(other.size),
+        style(other.style),
+        context(other.context),
+        transform(other.transform),
+        handle(NodePool::GetInstance().Register(this)),
+        event_mask(other.event_mask),
+        is_parent(other.is_parent),
+        cache_as_bitmap(other.cache_as_bitmap) {}
+
+  ~Node() override;
+
+  /**
+   * \brief Allocate a node from the NodePool.
+   */
+  static void* operator new(std::size_t size) { return NodePool::GetInstance().Allocate(size); }
+
+  /**
+   * \brief Return a node to the NodePool.
+   */
+  static void operator delete(void* block, std::size_t size) {
+    NodePool::GetInstance().Deallocate(block, size);
+  }
+
   /**
    * \copydoc Object::HandleEvent
+   *
+   * Parents only pass the kinds of events in the event mask of the node.
    */
   bool HandleEvent(const Event& e) override { return false; }
 
+  /**
+   * \brief Get the kinds of events that the node handles itself.
+   */
+  BitMask<EventKind> GetEventMask() const { return event_mask; }
+
+  /**
+   * \brief Test whether the node or any of its descendants handles events of a kind.
+   *
+   * Parents skip the children that do not, so an event only reaches the branches of the tree
+   * that handle it.
+   */
+  bool ReceivesEvents(EventKind kind) const;
+
   /**
    * \copydoc Object::Update
    */
@@ -64,15 +121,62 @@ public:
    */
   void Render(Renderer& renderer) const override {}
 
+  /**
+   * \brief Render the node into the current viewport, using the cached layer if enabled.
+   *
+   * Parents should call this function instead of Render() to draw their children.
+   *
+   * \param renderer The renderer to draw with.
+   */
+  void Draw(Renderer& renderer) const;
+
+  /**
+   * \brief Enable or disable caching of the rendered node.
+   *
+   * A cached node with all its descendants is rendered once into a target texture of the size
+   * of the viewport, and then drawn with a single copy of this texture until it is invalidated.
+   * Caching is useful for static parts of the GUI, such as menus and panels.
+   *
+   * The cache is invalidated automatically when the size, the style, the context or the children
+   * of the node or its descendants change. Nodes that change their appearance in other ways, e.g.
+   * in HandleEvent() or Update(), must call Invalidate().
+   *
+   * Layers are owned by the LayerCache of the context, which limits their total memory.
+   *
+   * \param enabled true to cache the node, false to render it every frame.
+   */
+  void SetCacheAsBitmap(bool enabled);
+
+  /**
+   * \brief Test whether the node is cached as a bitmap.
+   */
+  bool IsCachedAsBitmap() const { return cache_as_bitmap; }
+
+  /**
+   * \brief Mark the appearance of the node as changed.
+   *
+   * Invalidates the cached layers of the node and all its ancestors.
+   */
+  void Invalidate();
+
   virtual void OnActivate() {}
 
   virtual void OnDeactivate() {}
 
-  virtual void SetSize(Dimensions new_size) { size = new_size; }
+  /**
+   * \brief Start a new fixed simulation step.
+   *
+   * Called before every Update() so that the previous transform is preserved for interpolation.
+   * Swaps the transform of this node only, ParentNode::SwapTransforms() calls it for every node
+   * of a subtree.
+   */
+  virtual void SwapTransform() { transform.Swap(); }
+
+  virtual void SetSize(Dimensions new_size);
 
-  virtual void SetStyle(Style new_style) { style = std::move(new_style); }
+  virtual void SetStyle(Style new_style);
 
-  virtual void SetContext(Context* new_context) { context = new_context; }
+  virtual void SetContext(Context* new_context);
 
   const std::string& GetTag() const { return tag; }
 
@@ -84,14 +188,62 @@ public:
 
   Context* GetContext() const { return context; }
 
+  /**
+   * \brief Get the parent of the node, or nullptr if the node is not attached to a parent.
+   */
+  ParentNode* GetParent() const { return parent; }
+
+  /**
+   * \brief Get the handle that identifies the node until it is destroyed.
+   *
+   * \sa NodePool::Resolve()
+   */
+  NodePool::Handle GetHandle() const { return handle; }
+
+  Transform& GetTransform() { return transform.GetCurrent(); }
+
+  const Transform& GetTransform() const { return transform.GetCurrent(); }
+
+  void ResetTransform(const Transform& new_transform) { transform.Reset(new_transform); }
+
+  /**
+   * \brief Get the transform interpolated between the two latest simulation steps.
+   *
+   * Should be used in Render() to avoid judder when the rendering rate differs from the
+   * simulation rate.
+   */
+  Transform GetInterpolatedTransform() const {
+    return transform.Interpolate(context != nullptr ? context->interpolation : 1.0F);
+  }
+
 protected:
-  explicit Node(std::string tag) : tag(std::move(tag)) {}
+  explicit Node(std::string tag)
+      : tag(std::move(tag)), handle(NodePool::GetInstance().Register(this)) {}
+
+  /**
+   * \brief Set the kinds of events that the node handles itself.
+   *
+   * Nodes receive all kinds of events by default. A node that handles only some kinds may narrow
+   * the mask, usually in its constructor, so that its parents skip it for the other kinds.
+   */
+  void SetEventMask(BitMask<EventKind> mask);
 
 private:
   const std::string tag;
   Dimensions size;
   Style style;
   Context* context = nullptr;
+  TransformBuffer transform;
+  NodePool::Handle handle;
+  ParentNode* parent = nullptr;
+  BitMask<EventKind> event_mask = EventKind::ALL;
+  bool is_parent = false;  ///< Whether the node is a ParentNode
+  bool cache_as_bitmap = false;
+  mutable bool layer_valid = false;
+
+  void ReleaseLayer();
+
+  friend class ParentNode;
 };
 
 }  // namespace sdlxx
@@ -0,0 +1,174 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the NodePool class that allocates scene graph nodes.
+ */
+
+#ifndef SDLXX_GUI_NODE_POOL_H
+#define SDLXX_GUI_NODE_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sdlxx {
+
+class Node;
+
+/**
+ * \brief A class that allocates nodes of the scene graph from slabs of memory.
+ *
+ * Every node is allocated through Node::operator new, so std::make_unique<Button>(...) takes a
+ * block from the free list of the size class of Button instead of calling malloc, and deleting
+ * a node returns the block to the same free list. Size classes are 16 bytes apart, and node
+ * types of similar size share the free list of their class. Building and destroying big menus
+ * costs O(1) per node. Memory is kept when a scene is destroyed and reused by the next one.
+ *
+ * The pool also hands out handles that identify nodes and become invalid when the node is
+ * destroyed, which is safer than keeping raw pointers to nodes owned by someone else.
+ */
+class NodePool {
+public:
+  /**
+   * \brief A handle that identifies a node.
+   */
+  struct Handle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+  };
+
+  /**
+   * \brief Statistics of the pool.
+   */
+  struct Statistics {
+    std::size_t nodes = 0;           ///< Number of alive nodes
+    std::size_t pooled_bytes = 0;    ///< Memory in blocks that are in use
+    std::size_t reserved_bytes = 0;  ///< Memory of all slabs
+    std::size_t slab_count = 0;      ///< Number of slabs
+  };
+
+  /**
+   * \brief The maximum size of a pooled node, larger nodes are allocated with malloc.
+   */
+  static constexpr std::size_t MAX_POOLED_SIZE = 512;
+
+  /**
+   * \brief Get the pool that is shared by all nodes.
+   */
+  static NodePool& GetInstance();
+
+  // Deleted copy constructor
+  NodePool(const NodePool&) = delete;
+
+  // Deleted copy assignment operator
+  NodePool& operator=(const NodePool&) = delete;
+
+  /**
+   * \brief Allocate memory for a node.
+   *
+   * \param size The size of the node.
+   *
+   * \throw std::bad_alloc if there is not enough memory.
+   */
+  void* Allocate(std::size_t size);
+
+  /**
+   * \brief Return memory of a node to the pool.
+   *
+   * \param block The memory returned by Allocate().
+   * \param size  The size of the node.
+   */
+  void Deallocate(void* block, std::size_t size) noexcept;
+
+  /**
+   * \brief Preallocate memory for nodes of the specified size.
+   *
+   * \param size  The size of a node, e.g. sizeof(Button).
+   * \param count The number of nodes.
+   */
+  void Reserve(std::size_t size, std::size_t count);
+
+  /**
+   * \brief Register a node and get its handle.
+   */
+  Handle Register(Node* node);
+
+  /**
+   * \brief Invalidate the handle of a destroyed node.
+   */
+  void Unregister(Handle handle) noexcept;
+
+  /**
+   * \brief Get the node identified by a handle.
+   *
+   * \return Node* The node, or nullptr if it has been destroyed.
+   */
+  Node* Resolve(Handle handle) const;
+
+  /**
+   * \brief Get the nodes identified by many handles at once, taking the lock only once.
+   *
+   * \param handles The handles of the nodes.
+   * \param nodes   The nodes, or nullptr for the ones that have been destroyed.
+   */
+  void Resolve(const std::vector<Handle>& handles, std::vector<Node*>& nodes) const;
+
+  /**
+   * \brief Get the statistics of the pool.
+   */
+  Statistics GetStatistics() const;
+
+private:
+  static constexpr std::size_t GRANULARITY = 16;
+  static constexpr std::size_t CLASS_COUNT = MAX_POOLED_SIZE / GRANULARITY;
+  static constexpr std::size_t SLAB_SIZE = 64 * 1024;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct Slot {
+    Node* node = nullptr;
+    uint32_t generation = 0;
+  };
+
+  mutable std::mutex mutex;
+  std::array<FreeBlock*, CLASS_COUNT> free_lists{};
+  std::vector<std::unique_ptr<std::byte[]>> slabs;
+  std::vector<Slot> slots;
+  std::vector<uint32_t> free_slots;
+  std::size_t nodes = 0;
+  std::size_t pooled_bytes = 0;
+
+  NodePool() = default;
+
+  void Grow(std::size_t size_class, std::size_t count);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_GUI_NODE_POOL_H
@@ -28,17 +28,29 @@
 #ifndef SDLXX_GUI_PARENT_NODE_H
 #define SDLXX_GUI_PARENT_NODE_H
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 
 #include "sdlxx/gui/node.h"
 
 namespace sdlxx {
 
+/**
+ * \brief A class that represents a node of the scene graph with children.
+ *
+ * Besides the children, a parent node caches a flattened pre-order array of all its descendants,
+ * which is rebuilt lazily after the tree below the node changes. Traversals that do not depend
+ * on the structure of the tree, such as SwapTransforms(), walk this array instead of recursing.
+ * Together with the array, the node caches the kinds of events handled in its subtree, so
+ * HandleEvent() only descends into the children that handle the kind of the event.
+ */
 class ParentNode : public Node {
 public:
   bool HandleEvent(const Event& e) override {
+    const EventKind kind = EventBatch::GetKind(e);
     for (auto& child : children) {
-      if (child->HandleEvent(e)) { return true; }
+      if (child->ReceivesEvents(kind) && child->HandleEvent(e)) { return true; }
     }
     return false;
   }
@@ -48,7 +60,7 @@ public:
   }
 
   void Render(Renderer& renderer) const override {
-    for (const auto& child : children) { child->Render(renderer); }
+    for (const auto& child : children) { child->Draw(renderer); }
   }
 
   void OnActivate() override {
@@ -59,6 +71,17 @@ public:
     for (auto& child : children) { child->OnDeactivate(); }
   }
 
+  /**
+   * \brief Start a new fixed simulation step for the node and all its descendants.
+   *
+   * Calls SwapTransform() of every node through the flattened pre-order array, so overrides of
+   * SwapTransform() are respected without recursion.
+   */
+  void SwapTransforms() {
+    SwapTransform();
+    for (Node* node : GetDescendants()) { node->SwapTransform(); }
+  }
+
   void SetSize(Dimensions new_size) override {
     Node::SetSize(new_size);
     for (const auto& child : children) { child->SetSize(new_size); }
@@ -74,26 +97,124 @@ public:
     for (const auto& child : children) { child->SetContext(new_context); }
   }
 
+  /**
+   * \brief Get all descendants of the node in pre-order.
+   *
+   * The array is invalidated by changing the children of this node or of any of its
+   * descendants.
+   */
+  const std::vector<Node*>& GetDescendants() const {
+    if (descendants_dirty) {
+      descendants.clear();
+      AppendDescendants(descendants);
+      subtree_event_mask = GetEventMask();
+      for (const Node* node : descendants) {
+        subtree_event_mask.value |= node->GetEventMask().value;
+      }
+      descendants_dirty = false;
+    }
+    return descendants;
+  }
+
+  /**
+   * \brief Get the kinds of events handled by the node or any of its descendants.
+   */
+  BitMask<EventKind> GetSubtreeEventMask() const {
+    GetDescendants();
+    return subtree_event_mask;
+  }
+
 protected:
   explicit ParentNode(std::string tag, std::vector<std::unique_ptr<Node>> children = {})
-      : Node(std::move(tag)), children(std::move(children)) {}
-
-  std::vector<std::unique_ptr<Node>>& GetChildren() { return children; }
+      : Node(std::move(tag)), children(std::move(children)) {
+    is_parent = true;
+    for (const auto& child : this->children) { child->parent = this; }
+  }
 
+  /**
+   * \brief Get the children of the node.
+   *
+   * The list is read-only, so that the cached descendants stay valid. Children are changed with
+   * AddChild(), ReleaseChild(), RemoveChild() and MoveChild().
+   */
   const std::vector<std::unique_ptr<Node>>& GetChildren() const { return children; }
 
-  std::unique_ptr<Node>& GetChild(size_t i) { return children[i]; }
+  Node* GetChild(size_t i) { return children[i].get(); }
 
-  const std::unique_ptr<Node>& GetChild(size_t i) const { return children[i]; }
+  const Node* GetChild(size_t i) const { return children[i].get(); }
 
   Node& AddChild(std::unique_ptr<Node> node) {
+    node->parent = this;
     children.push_back(std::move(node));
     children.back()->SetContext(GetContext());
+    InvalidateDescendants();
+    Invalidate();
     return *children.back();
   }
 
+  /**
+   * \brief Detach a child from the node and take its ownership.
+   *
+   * \param i The index of the child.
+   *
+   * \return std::unique_ptr<Node> The child, which can be added to another parent.
+   */
+  std::unique_ptr<Node> ReleaseChild(size_t i) {
+    std::unique_ptr<Node> node = std::move(children[i]);
+    children.erase(children.begin() + static_cast<std::ptrdiff_t>(i));
+    node->parent = nullptr;
+    InvalidateDescendants();
+    Invalidate();
+    return node;
+  }
+
+  /**
+   * \brief Destroy a child of the node.
+   *
+   * \param i The index of the child.
+   */
+  void RemoveChild(size_t i) { ReleaseChild(i); }
+
+  /**
+   * \brief Move a child to another position, shifting the children in between.
+   *
+   * \param from The index of the child.
+   * \param to   The new index of the child.
+   */
+  void MoveChild(size_t from, size_t to) {
+    auto source = children.begin() + static_cast<std::ptrdiff_t>(from);
+    auto target = children.begin() + static_cast<std::ptrdiff_t>(to);
+    if (from < to) {
+      std::rotate(source, source + 1, target + 1);
+    } else {
+      std::rotate(target, source, source + 1);
+    }
+    InvalidateDescendants();
+    Invalidate();
+  }
+
 private:
   std::vector<std::unique_ptr<Node>> children;
+  mutable std::vector<Node*> descendants;
+  mutable BitMask<EventKind> subtree_event_mask;
+  mutable bool descendants_dirty = true;
+
+  void InvalidateDescendants() {
+    for (ParentNode* node = this; node != nullptr; node = node->GetParent()) {
+      node->descendants_dirty = true;
+    }
+  }
+
+  void AppendDescendants(std::vector<Node*>& nodes) const {
+    for (const auto& child : children) {
+      nodes.push_back(child.get());
+      if (auto* parent_node = dynamic_cast<ParentNode*>(child.get())) {
+        parent_node->AppendDescendants(nodes);
+      }
+    }
+  }
+
+  friend class Node;
 };
 
 }  // namespace sdlxx
@@ -28,11 +28,18 @@
 #ifndef SDLXX_GUI_SCENE_MANAGER_H
 #define SDLXX_GUI_SCENE_MANAGER_H
 
+#include <algorithm>
 #include <stack>
 
 #include <SDL_events.h>
 
+#include "sdlxx/core/event_batch.h"
+#include "sdlxx/core/log.h"
+#include "sdlxx/core/surface.h"
 #include "sdlxx/core/timer.h"
+#include "sdlxx/core/timer_wheel.h"
+#include "sdlxx/gui/animator.h"
+#include "sdlxx/gui/layer_cache.h"
 #include "sdlxx/gui/node.h"
 #include "sdlxx/gui/scene.h"
 
@@ -46,7 +53,11 @@ public:
   /**
    * \brief Construct a SceneManager object with the given context.
    */
-  explicit SceneManager(Node::Context context) : context(context) {}
+  explicit SceneManager(Node::Context context) : context(context), layers(context.renderer) {
+    this->context.timers = &timers;
+    this->context.animator = &animator;
+    this->context.layers = &layers;
+  }
 
   /**
    * \brief Push a new scene to the top of the stack.
@@ -59,6 +70,10 @@ public:
 
   /**
    * \brief Remove a scene from the top of the stack.
+   *
+   * Nodes of a destroyed scene return to the NodePool, so the next scene is built from the same
+   * memory without calling malloc.
+   *
    * \return A scene that was removed from the top of the stack.
    */
   std::unique_ptr<Scene> Pop() {
@@ -73,12 +88,48 @@ public:
    */
   bool Empty() { return scenes.empty(); }
 
+  /**
+   * \brief Set the duration of a fixed simulation step.
+   *
+   * Scenes are updated with this time step regardless of the rendering rate, and the rendering
+   * is interpolated between the two latest simulation steps, so the simulation rate can be
+   * lowered without visible judder.
+   *
+   * \param step The duration of a simulation step (10 ms by default).
+   */
+  void SetTimeStep(Time step) {
+    if (step.AsMicroseconds() <= 0) {
+      throw std::invalid_argument("Time step must be positive");
+    }
+    time_step = step;
+  }
+
+  /**
+   * \brief Get the duration of a fixed simulation step.
+   */
+  Time GetTimeStep() const { return time_step; }
+
+  /**
+   * \brief Get the timers that are fired by the event loop once per frame.
+   */
+  TimerWheel& GetTimers() { return timers; }
+
+  /**
+   * \brief Get the animator that is advanced with every simulation step.
+   */
+  Animator& GetAnimator() { return animator; }
+
+  /**
+   * \brief Get the cache of the nodes that are cached as bitmaps.
+   */
+  LayerCache& GetLayers() { return layers; }
+
   /**
    * \brief Run the event loop.
    */
   void Run() {
     time_accumulator = 0;
-    current_time = Timer::GetTicks();
+    current_time = Timer::GetPerformanceCounter();
 
     if (!scenes.empty()) {
       ActivateTop();
@@ -118,9 +169,13 @@ public:
 private:
   Node::Context context;
   std::vector<std::unique_ptr<Scene>> scenes;
-  uint32_t time_accumulator;
-  uint32_t current_time;
-  Event event;
+  Time time_step = Time::Milliseconds(10);
+  int64_t time_accumulator = 0;  ///< Simulation time that is not yet consumed, in microseconds
+  uint64_t current_time = 0;     ///< Value of the performance counter at the last update
+  EventBatch events;
+  TimerWheel timers;
+  Animator animator;
+  LayerCache layers;
 
   void ActivateTop() {
     Scene& scene = *scenes.back();
@@ -129,50 +184,74 @@ private:
   }
 
   void HandleEvents(Scene& current_scene) {
-    while (Events::Poll(&event)) {
-      if (event.type == SDL_QUIT) {
-        bool handled = current_scene.HandleEvent(event);
-        if (!handled) {
-          current_scene.Deactivate();
-          while (!scenes.empty()) {
-            Pop();
-          }
-          break;
+    events.Drain();
+    auto handlers = EventHandlers{
+        // Quit event is forwarded to the scene first, and stops the manager if it is not handled
+        [&current_scene](const SDL_QuitEvent& e) {
+          Event event;
+          event.quit = e;
+          return !current_scene.HandleEvent(event);
+        },
+        [&current_scene](const Event& e) {
+          current_scene.HandleEvent(e);
+          return false;
+        }};
+    for (const Event& event : events) {
+      if (EventBatch::Dispatch(event, handlers)) {
+        current_scene.Deactivate();
+        while (!scenes.empty()) {
+          Pop();
         }
-      } else {
-        current_scene.HandleEvent(event);
+        break;
       }
     }
   }
 
-  void Update(Scene& current_scene, uint32_t dt = 10) {
-    uint32_t new_time = Timer::GetTicks();
-    uint32_t frame_time = std::min<uint32_t>(new_time - current_time, 250);
+  void Update(Scene& current_scene) {
+    static const uint64_t frequency = Timer::GetPerformanceFrequency();
+    uint64_t new_time = Timer::GetPerformanceCounter();
+    auto frame_time = static_cast<int64_t>((new_time - current_time) * 1000000 / frequency);
+    frame_time = std::min<int64_t>(frame_time, 250000);
     current_time = new_time;
 
     time_accumulator += frame_time;
 
+    timers.Advance();
+
+    const int64_t dt = time_step.AsMicroseconds();
     while (time_accumulator >= dt) {
       if (current_scene.IsActive()) {
-        current_scene.Update(Time::Milliseconds(static_cast<int32_t>(dt)));
+        current_scene.SwapTransforms();
+        animator.Update(time_step);
+        current_scene.Update(time_step);
       }
       time_accumulator -= dt;
     }
 
-    static uint32_t last_title = 0;
-    if (current_time > last_title) {
+    static uint64_t last_title = 0;
+    if (new_time > last_title) {
       context.window.SetTitle(
-          " [FPS: " + std::to_string(frame_time == 0 ? 0 : static_cast<int>(1000.0 / frame_time)) +
-          "]");
-      last_title = current_time + 1000;
+          " [FPS: " +
+          std::to_string(frame_time == 0 ? 0 : static_cast<int>(1000000.0 / frame_time)) + "]");
+      last_title = new_time + frequency;
     }
   }
 
   void Render(Scene& current_scene) {
+    context.interpolation =
+        static_cast<float>(time_accumulator) / static_cast<float>(time_step.AsMicroseconds());
     context.renderer.SetDrawColor(Color::WHITE);
     context.renderer.Clear();
     context.renderer.Render(current_scene);
     context.renderer.RenderPresent();
+
+#ifndef NDEBUG
+    // Surfaces passed by value should share pixels, so copies in a frame are worth a look
+    if (std::size_t copies = Surface::GetDeepCopyCount(); copies > 0) {
+      Log::Debug(std::to_string(copies) + " surface pixel copies in the last frame");
+      Surface::ResetDeepCopyCount();
+    }
+#endif
   }
 };
 }  // namespace sdlxx
@@ -0,0 +1,120 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Transform structure and the TransformBuffer class that stores the
+ *        simulation state of a node.
+ */
+
+#ifndef SDLXX_GUI_TRANSFORM_H
+#define SDLXX_GUI_TRANSFORM_H
+
+namespace sdlxx {
+
+/**
+ * \brief A structure that represents a position, rotation and scale of a node.
+ */
+struct Transform {
+  float x = 0.0F;        ///< X coordinate of the node origin
+  float y = 0.0F;        ///< Y coordinate of the node origin
+  float angle = 0.0F;    ///< Rotation angle in degrees, clockwise
+  float scale_x = 1.0F;  ///< Horizontal scaling factor
+  float scale_y = 1.0F;  ///< Vertical scaling factor
+
+  /**
+   * \brief Linearly interpolate between two transforms.
+   *
+   * \param from  The transform that corresponds to \c alpha = 0.
+   * \param to    The transform that corresponds to \c alpha = 1.
+   * \param alpha The interpolation factor in range [0, 1].
+   *
+   * \return Transform The interpolated transform.
+   */
+  static constexpr Transform Interpolate(const Transform& from, const Transform& to,
+                                         float alpha) {
+    return {from.x + (to.x - from.x) * alpha, from.y + (to.y - from.y) * alpha,
+            from.angle + (to.angle - from.angle) * alpha,
+            from.scale_x + (to.scale_x - from.scale_x) * alpha,
+            from.scale_y + (to.scale_y - from.scale_y) * alpha};
+  }
+};
+
+/**
+ * \brief A class that stores the transforms of the two latest simulation steps.
+ *
+ * The simulation writes to the current transform, and Swap() is called before every fixed
+ * simulation step, so that the renderer can interpolate between the previous and the current
+ * states when the rendering rate differs from the simulation rate.
+ */
+class TransformBuffer {
+public:
+  /**
+   * \brief Get the transform of the latest simulation step.
+   *
+   * The address of the current transform does not change, so it may be animated through a
+   * pointer, e.g. by the Animator.
+   */
+  Transform& GetCurrent() { return current; }
+
+  /**
+   * \brief Get the transform of the latest simulation step.
+   */
+  const Transform& GetCurrent() const { return current; }
+
+  /**
+   * \brief Get the transform of the previous simulation step.
+   */
+  const Transform& GetPrevious() const { return previous; }
+
+  /**
+   * \brief Start a new simulation step.
+   *
+   * The current transform becomes the previous one, and the new current transform starts as
+   * a copy of it.
+   */
+  void Swap() { previous = current; }
+
+  /**
+   * \brief Set both transforms at once, e.g. to teleport a node without interpolation.
+   *
+   * \param transform The new transform.
+   */
+  void Reset(const Transform& transform) { current = previous = transform; }
+
+  /**
+   * \brief Get the transform interpolated between the previous and the current steps.
+   *
+   * \param alpha The interpolation factor in range [0, 1].
+   */
+  Transform Interpolate(float alpha) const {
+    return Transform::Interpolate(previous, current, alpha);
+  }
+
+private:
+  Transform current;
+  Transform previous;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_GUI_TRANSFORM_H
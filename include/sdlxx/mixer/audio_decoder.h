@@ -0,0 +1,233 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the AudioDecoder interface and the WAV and FLAC decoders that stream audio.
+ */
+
+#ifndef SDLXX_MIXER_AUDIO_DECODER_H
+#define SDLXX_MIXER_AUDIO_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for AudioDecoder-related exceptions.
+ */
+class AudioDecoderException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief An interface of decoders that produce audio incrementally.
+ *
+ * Decoders are used by one thread at a time, usually the worker thread of a MusicPlayer.
+ */
+class AudioDecoder {
+public:
+  virtual ~AudioDecoder() = default;
+
+  /**
+   * \brief Open a WAV or FLAC file with the decoder of its format.
+   *
+   * \throw AudioDecoderException if the file can not be read or its format is not supported.
+   */
+  static std::unique_ptr<AudioDecoder> Open(const std::string& path);
+
+  /**
+   * \brief Get the number of output channels, 1 or 2.
+   */
+  virtual int GetChannels() const = 0;
+
+  /**
+   * \brief Get the frequency of the audio.
+   */
+  virtual int GetFrequency() const = 0;
+
+  /**
+   * \brief Get the total number of frames.
+   */
+  virtual std::size_t GetFrameCount() const = 0;
+
+  /**
+   * \brief Decode the next frames as interleaved floats.
+   *
+   * \return std::size_t The number of decoded frames, which is less than requested only at the
+   *         end of the audio.
+   */
+  virtual std::size_t Decode(float* output, std::size_t frames) = 0;
+
+  /**
+   * \brief Continue decoding from the given frame.
+   */
+  virtual void Seek(std::size_t frame) = 0;
+};
+
+/**
+ * \brief A class that decodes PCM and float WAV files from a memory-mapped file.
+ *
+ * Only the pages that are being decoded are resident, so long tracks do not take memory, and
+ * the kernel is advised to read ahead sequentially. Where memory mapping is not available, the
+ * file is read into memory. Files with more than two channels are decoded as their first two
+ * channels, which are front left and front right.
+ */
+class WavDecoder : public AudioDecoder {
+public:
+  /**
+   * \brief Open a WAV file.
+   *
+   * \throw AudioDecoderException if the file can not be read or its format is not supported.
+   */
+  explicit WavDecoder(const std::string& path);
+
+  /**
+   * \brief Close the file.
+   */
+  ~WavDecoder() override;
+
+  // Deleted copy constructor
+  WavDecoder(const WavDecoder&) = delete;
+
+  // Deleted copy assignment operator
+  WavDecoder& operator=(const WavDecoder&) = delete;
+
+  // Deleted move constructor
+  WavDecoder(WavDecoder&&) = delete;
+
+  // Deleted move assignment operator
+  WavDecoder& operator=(WavDecoder&&) = delete;
+
+  int GetChannels() const override { return channels; }
+
+  int GetFrequency() const override { return frequency; }
+
+  std::size_t GetFrameCount() const override { return frames; }
+
+  std::size_t Decode(float* output, std::size_t count) override;
+
+  void Seek(std::size_t frame) override;
+
+private:
+  enum class Encoding { UINT8, INT16, INT24, INT32, FLOAT32 };
+
+  const uint8_t* file = nullptr;
+  std::size_t file_size = 0;
+  std::vector<uint8_t> contents;
+
+  const uint8_t* data = nullptr;
+  Encoding encoding = Encoding::INT16;
+  std::size_t frame_size = 0;
+  std::size_t sample_size = 0;
+  int channels = 0;
+  int frequency = 0;
+  std::size_t frames = 0;
+  std::size_t position = 0;
+
+  void Parse(const std::string& path);
+};
+
+/**
+ * \brief A class that decodes FLAC files from a memory-mapped file.
+ *
+ * Frames are decoded one at a time, so only one block of samples is kept in memory. Seeking
+ * starts at the nearest point of the seek table of the file, if there is one, and decodes
+ * forward from there. Files with more than two channels are decoded as their first two
+ * channels, and files without the total number of frames are not supported.
+ */
+class FlacDecoder : public AudioDecoder {
+public:
+  /**
+   * \brief Open a FLAC file.
+   *
+   * \throw AudioDecoderException if the file can not be read or its format is not supported.
+   */
+  explicit FlacDecoder(const std::string& path);
+
+  /**
+   * \brief Close the file.
+   */
+  ~FlacDecoder() override;
+
+  // Deleted copy constructor
+  FlacDecoder(const FlacDecoder&) = delete;
+
+  // Deleted copy assignment operator
+  FlacDecoder& operator=(const FlacDecoder&) = delete;
+
+  // Deleted move constructor
+  FlacDecoder(FlacDecoder&&) = delete;
+
+  // Deleted move assignment operator
+  FlacDecoder& operator=(FlacDecoder&&) = delete;
+
+  int GetChannels() const override { return channels; }
+
+  int GetFrequency() const override { return frequency; }
+
+  std::size_t GetFrameCount() const override { return frames; }
+
+  std::size_t Decode(float* output, std::size_t count) override;
+
+  void Seek(std::size_t frame) override;
+
+private:
+  struct SeekPoint {
+    std::size_t frame;
+    std::size_t offset;
+  };
+
+  const uint8_t* file = nullptr;
+  std::size_t file_size = 0;
+  std::vector<uint8_t> contents;
+
+  std::size_t first_frame = 0;
+  std::vector<SeekPoint> seek_points;
+  int file_channels = 0;
+  int bits = 0;
+  int channels = 0;
+  int frequency = 0;
+  std::size_t frames = 0;
+  std::size_t position = 0;
+
+  // The decoded block, with the samples of each channel one after another
+  std::vector<int32_t> samples;
+  std::size_t capacity = 0;
+  std::size_t block_start = 0;
+  std::size_t block_size = 0;
+  std::size_t next_frame = 0;
+
+  void Parse(const std::string& path);
+
+  bool DecodeFrame();
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_MIXER_AUDIO_DECODER_H
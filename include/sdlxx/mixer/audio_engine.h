@@ -0,0 +1,388 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the AudioEngine class that mixes sounds in real time.
+ */
+
+#ifndef SDLXX_MIXER_AUDIO_ENGINE_H
+#define SDLXX_MIXER_AUDIO_ENGINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdlxx/core/channel.h"
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/time.h"
+#include "sdlxx/mixer/sound.h"
+#include "sdlxx/mixer/stream_buffer.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for AudioEngine-related exceptions.
+ */
+class AudioEngineException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief Settings of an audio engine.
+ */
+struct AudioEngineSettings {
+  int frequency = 48000;                ///< Requested output frequency
+  uint16_t buffer_frames = 512;         ///< Requested number of frames per device buffer
+  std::size_t voices = 64;              ///< Maximum number of sounds that play at once
+  std::size_t buses = 4;                ///< Number of buses that voices are mixed into
+  std::size_t command_capacity = 1024;  ///< Maximum number of commands between two buffers
+  std::string device;                   ///< Name of the output device, empty for the default
+  bool open_device = true;              ///< Whether to open a device or let the user call Mix()
+  /// The longest sound that LoadSound() keeps in its cache
+  Time max_cached_duration = Time::Seconds(10);
+};
+
+/**
+ * \brief Parameters of a voice that starts playing.
+ */
+struct VoiceParameters {
+  float volume = 1.0f;  ///< Linear gain
+  float pan = 0.0f;     ///< Position from -1 (left) to 1 (right)
+  float pitch = 1.0f;   ///< Playback rate, from 1/16 to 16, ignored for streams
+  std::size_t bus = 0;  ///< The bus that the voice is mixed into
+  bool loop = false;    ///< Whether the sound starts over when it ends
+};
+
+/**
+ * \brief Statistics of an audio engine.
+ */
+struct AudioStatistics {
+  Time last_mix_time;             ///< Time spent in the last call to Mix()
+  Time average_mix_time;          ///< Average time spent in Mix()
+  Time max_mix_time;              ///< Longest time spent in Mix() since ResetStatistics()
+  Time buffer_duration;           ///< Duration of a buffer of GetBufferFrames() frames
+  float load = 0.0f;              ///< The last mix time relative to the buffer duration
+  std::size_t active_voices = 0;  ///< Number of voices mixed into the last buffer
+  uint64_t buffers = 0;           ///< Number of calls to Mix()
+  uint64_t rejected_voices = 0;   ///< Number of sounds not played because all voices were busy
+  uint64_t dropped_commands = 0;  ///< Number of commands lost because the queue was full
+};
+
+/**
+ * \brief A class that mixes many sounds into an audio device in real time.
+ *
+ * The game thread starts voices and changes their volume, pan and pitch. Every change is a
+ * command in a lock-free queue that the audio callback drains at the start of each buffer, so
+ * the callback never locks, allocates or waits for the game thread. Finished voices are
+ * reported back through another queue and released by Update(), which also frees the samples
+ * of sounds that are no longer used on the game thread.
+ *
+ * Voices play either a Sound or a StreamBuffer that another thread fills, such as the one of a
+ * MusicPlayer. Voices are resampled for their pitch with linear interpolation, and changes of
+ * gain are ramped over a buffer to avoid clicks, or faded over a given time. Voices are mixed
+ * into float stereo buses, which are summed into the output with their volumes and clipped,
+ * using SSE2 where available.
+ *
+ * \code
+ * AudioEngine engine;
+ * Sound shot = engine.LoadSound("shot.wav");
+ * AudioEngine::VoiceId voice = engine.Play(shot, {0.8f, -0.5f});
+ * // Every frame
+ * engine.Update();
+ * \endcode
+ */
+class AudioEngine {
+public:
+  /// An identifier of a playing voice
+  using VoiceId = uint32_t;
+
+  /// An identifier that refers to no voice
+  static constexpr VoiceId INVALID_VOICE = 0;
+
+  /**
+   * \brief Construct an audio engine and start playback.
+   *
+   * The audio subsystem must be initialized if a device is opened. The device output is always
+   * float stereo, but the device may choose another frequency and buffer size.
+   *
+   * \throw AudioEngineException on failure.
+   *
+   * \upstream SDL_OpenAudioDevice
+   */
+  explicit AudioEngine(const AudioEngineSettings& settings = AudioEngineSettings());
+
+  /**
+   * \brief Stop playback and destroy the engine.
+   *
+   * \upstream SDL_CloseAudioDevice
+   */
+  ~AudioEngine();
+
+  // Deleted copy constructor
+  AudioEngine(const AudioEngine&) = delete;
+
+  // Deleted copy assignment operator
+  AudioEngine& operator=(const AudioEngine&) = delete;
+
+  // Deleted move constructor
+  AudioEngine(AudioEngine&&) = delete;
+
+  // Deleted move assignment operator
+  AudioEngine& operator=(AudioEngine&&) = delete;
+
+  /**
+   * \brief Get the output frequency.
+   */
+  int GetFrequency() const { return frequency; }
+
+  /**
+   * \brief Get the number of frames mixed at once.
+   */
+  std::size_t GetBufferFrames() const { return block_frames; }
+
+  /**
+   * \brief Load a WAV file at the output frequency.
+   *
+   * Decoded sounds up to AudioEngineSettings::max_cached_duration are cached by path, so
+   * short effects are decoded only once.
+   *
+   * \throw SoundException on failure.
+   */
+  Sound LoadSound(const std::string& path);
+
+  /**
+   * \brief Remove all sounds from the cache of LoadSound().
+   *
+   * Sounds that are playing or held elsewhere stay alive.
+   */
+  void ClearCache();
+
+  /**
+   * \brief Start playing a sound.
+   *
+   * \return VoiceId The voice, or INVALID_VOICE if all voices are busy, the command queue is
+   *         full or the sound is empty.
+   *
+   * \throw AudioEngineException if the bus does not exist.
+   */
+  VoiceId Play(const Sound& sound, const VoiceParameters& parameters = VoiceParameters());
+
+  /**
+   * \brief Start playing frames that another thread writes to a stream buffer.
+   *
+   * The voice finishes when the stream is finished and drained. Missing frames are played as
+   * silence. When the voice stops for any reason, the stream is closed.
+   *
+   * \return VoiceId The voice, or INVALID_VOICE if all voices are busy or the command queue is
+   *         full.
+   *
+   * \throw AudioEngineException if the bus does not exist.
+   */
+  VoiceId PlayStream(std::shared_ptr<StreamBuffer> stream,
+                     const VoiceParameters& parameters = VoiceParameters());
+
+  /**
+   * \brief Fade out and stop a voice.
+   *
+   * Calls with voices that finished are ignored, as are those of all the setters below.
+   *
+   * \param fade The duration of the fade, or zero for the shortest fade that does not click.
+   */
+  void Stop(VoiceId voice, Time fade = Time());
+
+  /**
+   * \brief Fade out and stop all voices.
+   */
+  void StopAll();
+
+  /**
+   * \brief Set the linear gain of a voice.
+   *
+   * \param fade The duration over which the gain changes linearly, in the audio callback.
+   */
+  void SetVolume(VoiceId voice, float volume, Time fade = Time());
+
+  /**
+   * \brief Set the position of a voice from -1 (left) to 1 (right).
+   */
+  void SetPan(VoiceId voice, float pan);
+
+  /**
+   * \brief Set the playback rate of a voice.
+   */
+  void SetPitch(VoiceId voice, float pitch);
+
+  /**
+   * \brief Check whether a voice is playing, as of the last Update().
+   */
+  bool IsPlaying(VoiceId voice) const;
+
+  /**
+   * \brief Set the linear gain of a bus.
+   *
+   * \throw AudioEngineException if the bus does not exist.
+   */
+  void SetBusVolume(std::size_t bus, float volume);
+
+  /**
+   * \brief Set the linear gain of the output.
+   */
+  void SetMasterVolume(float volume);
+
+  /**
+   * \brief Release the voices that finished playing.
+   *
+   * Should be called once per frame from the game thread.
+   */
+  void Update();
+
+  /**
+   * \brief Mix the next frames of interleaved float stereo output.
+   *
+   * This function is called by the audio device. Without a device it can be called by the
+   * user, e.g. to render audio offline.
+   */
+  void Mix(float* output, std::size_t frames);
+
+  /**
+   * \brief Get the statistics of the engine.
+   */
+  AudioStatistics GetStatistics() const;
+
+  /**
+   * \brief Reset the longest mix time.
+   */
+  void ResetStatistics();
+
+private:
+  struct Command {
+    enum class Type : uint8_t {
+      PLAY,
+      STOP,
+      STOP_ALL,
+      VOLUME,
+      PAN,
+      PITCH,
+      BUS_VOLUME,
+      MASTER_VOLUME
+    };
+    Type type = Type::PLAY;
+    uint16_t index = 0;
+    uint16_t generation = 0;
+    uint16_t bus = 0;
+    bool loop = false;
+    float volume = 1.0f;
+    float pan = 0.0f;
+    float pitch = 1.0f;
+    const float* samples = nullptr;
+    std::size_t frames = 0;
+    int channels = 1;
+    StreamBuffer* stream = nullptr;
+    uint32_t fade_frames = 0;
+  };
+
+  // State of a voice that only the audio callback uses
+  struct Voice {
+    const float* samples = nullptr;
+    std::size_t frames = 0;
+    int channels = 1;
+    StreamBuffer* stream = nullptr;
+    uint64_t position = 0;  ///< In frames, 32.32 fixed point
+    uint64_t step = 0;      ///< In frames, 32.32 fixed point
+    float volume = 1.0f;
+    float target_volume = 1.0f;
+    float fade_step = 0.0f;  ///< Change of volume per frame, or 0 to change at once
+    float pan = 0.0f;
+    float gains[2] = {0.0f, 0.0f};
+    uint16_t generation = 0;
+    uint16_t bus = 0;
+    bool loop = false;
+    bool stopping = false;
+    bool active = false;
+  };
+
+  // State of a voice that only the game thread uses
+  struct Slot {
+    Sound sound;
+    std::shared_ptr<StreamBuffer> stream;
+    uint16_t generation = 0;
+    bool playing = false;
+  };
+
+  int frequency;
+  std::size_t block_frames;
+  Time max_cached_duration;
+  uint32_t device = 0;
+
+  // Game thread
+  std::vector<Slot> slots;
+  std::vector<uint16_t> free_slots;
+  std::unordered_map<std::string, Sound> cache;
+  uint64_t rejected_voices = 0;
+  uint64_t dropped_commands = 0;
+
+  Channel<Command> commands;
+  Channel<uint16_t> finished;
+
+  // Audio callback
+  std::vector<Voice> voices;
+  std::vector<float> bus_volumes;
+  std::vector<float> bus_buffers;
+  std::vector<bool> bus_used;
+  std::vector<float> scratch;
+  float master_volume = 1.0f;
+
+  // Statistics written by the audio callback
+  std::atomic<int64_t> last_mix_ns{0};
+  std::atomic<int64_t> max_mix_ns{0};
+  std::atomic<int64_t> total_mix_ns{0};
+  std::atomic<uint64_t> buffers{0};
+  std::atomic<std::size_t> active_voices{0};
+
+  static void Callback(void* userdata, uint8_t* stream, int length);
+
+  VoiceId Start(Command& command, const VoiceParameters& parameters, const Sound& sound,
+                std::shared_ptr<StreamBuffer> stream);
+
+  bool Send(const Command& command);
+
+  uint32_t ToFrames(Time duration) const;
+
+  void SetFade(Voice& voice, float target, uint32_t frames);
+
+  bool Find(VoiceId voice, uint16_t& index) const;
+
+  void Execute(const Command& command);
+
+  void MixBlock(float* output, std::size_t frames);
+
+  bool MixVoice(Voice& voice, std::size_t frames);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_MIXER_AUDIO_ENGINE_H
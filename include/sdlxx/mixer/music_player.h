@@ -0,0 +1,187 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the MusicPlayer class that streams music from a worker thread.
+ */
+
+#ifndef SDLXX_MIXER_MUSIC_PLAYER_H
+#define SDLXX_MIXER_MUSIC_PLAYER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/time.h"
+#include "sdlxx/mixer/audio_decoder.h"
+#include "sdlxx/mixer/audio_engine.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for MusicPlayer-related exceptions.
+ */
+class MusicPlayerException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief Settings of a music player.
+ */
+struct MusicPlayerSettings {
+  Time read_ahead = Time::Seconds(1);  ///< Least duration of audio decoded ahead of playback
+  std::size_t chunk_frames = 4096;     ///< Number of frames decoded at once
+  std::size_t bus = 0;                 ///< The bus of the engine that music is mixed into
+};
+
+/**
+ * \brief Statistics of a music player.
+ */
+struct MusicStatistics {
+  Time buffered;           ///< Duration of audio decoded ahead for the current track
+  uint64_t underruns = 0;  ///< Number of buffers of the current track that were not ready
+  std::size_t tracks = 0;  ///< Number of tracks being decoded, including fading ones
+};
+
+/**
+ * \brief A class that plays long tracks by decoding them on a worker thread.
+ *
+ * Every track is decoded into its own StreamBuffer of a fixed size, which is played by a
+ * stream voice of the AudioEngine, so memory does not depend on the length of tracks. Looping
+ * tracks seek back to the start in the decoder, so there is no gap between the end and the
+ * start. Tracks at another frequency are resampled on the worker thread.
+ *
+ * A new track can crossfade with the current one. The fades run in the audio callback, and the
+ * worker thread drops tracks whose voices stopped, so the game thread only needs to call
+ * AudioEngine::Update() as usual.
+ *
+ * \code
+ * MusicPlayer music(engine);
+ * music.Play("menu.wav", Time(), true);
+ * // Later, crossfade over two seconds
+ * music.Play("level.flac", Time::Seconds(2), true);
+ * \endcode
+ */
+class MusicPlayer {
+public:
+  /**
+   * \brief Construct a music player and start its worker thread.
+   *
+   * \param engine   The engine that plays the music, which must outlive the player.
+   * \param settings Settings of the player.
+   */
+  explicit MusicPlayer(AudioEngine& engine,
+                       const MusicPlayerSettings& settings = MusicPlayerSettings());
+
+  /**
+   * \brief Stop the music and the worker thread.
+   */
+  ~MusicPlayer();
+
+  // Deleted copy constructor
+  MusicPlayer(const MusicPlayer&) = delete;
+
+  // Deleted copy assignment operator
+  MusicPlayer& operator=(const MusicPlayer&) = delete;
+
+  // Deleted move constructor
+  MusicPlayer(MusicPlayer&&) = delete;
+
+  // Deleted move assignment operator
+  MusicPlayer& operator=(MusicPlayer&&) = delete;
+
+  /**
+   * \brief Start playing a track, and fade out the current one.
+   *
+   * \param decoder   The decoder of the track.
+   * \param crossfade The duration over which the tracks crossfade, or zero to switch at once.
+   * \param loop      Whether the track plays over and over without a gap.
+   *
+   * \return true if the track started, false if no voice was available.
+   *
+   * \throw MusicPlayerException if the decoder has an unsupported format.
+   */
+  bool Play(std::unique_ptr<AudioDecoder> decoder, Time crossfade = Time(), bool loop = false);
+
+  /**
+   * \brief Start playing a WAV or FLAC file, and fade out the current track.
+   *
+   * \throw AudioDecoderException if the file can not be opened.
+   */
+  bool Play(const std::string& path, Time crossfade = Time(), bool loop = false);
+
+  /**
+   * \brief Fade out and stop the current track.
+   */
+  void Stop(Time fade = Time());
+
+  /**
+   * \brief Set the volume of the current and later tracks.
+   */
+  void SetVolume(float volume, Time fade = Time());
+
+  /**
+   * \brief Check whether the current track is playing, as of the last AudioEngine::Update().
+   */
+  bool IsPlaying() const;
+
+  /**
+   * \brief Get the statistics of the player.
+   */
+  MusicStatistics GetStatistics() const;
+
+private:
+  struct Track;
+
+  AudioEngine& engine;
+  std::size_t read_ahead_frames;
+  std::size_t chunk_frames;
+  std::size_t bus;
+  Time poll_interval;
+  float volume = 1.0f;
+
+  AudioEngine::VoiceId voice = AudioEngine::INVALID_VOICE;
+  std::shared_ptr<Track> current;
+
+  // Shared with the worker thread
+  mutable std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<std::shared_ptr<Track>> tracks;
+  bool stopping = false;
+
+  std::thread worker;
+
+  void Run();
+
+  static void Fill(Track& track);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_MIXER_MUSIC_PLAYER_H
@@ -0,0 +1,136 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Sound class that holds decoded samples of a sound effect.
+ */
+
+#ifndef SDLXX_MIXER_SOUND_H
+#define SDLXX_MIXER_SOUND_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/time.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for Sound-related exceptions.
+ */
+class SoundException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A class that holds decoded samples of a sound as interleaved 32-bit floats.
+ *
+ * Samples are shared between copies, so a sound can be played by many voices at once and stays
+ * alive while any voice plays it. The samples must have the frequency of the AudioEngine that
+ * plays them, which LoadWav() takes care of.
+ */
+class Sound {
+public:
+  /**
+   * \brief Construct an empty sound.
+   */
+  Sound() = default;
+
+  /**
+   * \brief Construct a sound that owns the samples.
+   *
+   * \param samples  Interleaved samples.
+   * \param channels The number of channels, 1 or 2.
+   *
+   * \throw SoundException if the number of channels is not supported.
+   */
+  Sound(std::vector<float> samples, int channels);
+
+  /**
+   * \brief Construct a sound that shares samples with their owner.
+   *
+   * \param samples  Interleaved samples, which may point into a larger buffer.
+   * \param frames   The number of frames.
+   * \param channels The number of channels, 1 or 2.
+   *
+   * \throw SoundException if the number of channels is not supported.
+   */
+  Sound(std::shared_ptr<const float> samples, std::size_t frames, int channels);
+
+  /**
+   * \brief Decode a WAV file and convert it to floats at the given frequency.
+   *
+   * Sounds with more than two channels are downmixed to stereo.
+   *
+   * \param path      The path to the file.
+   * \param frequency The output frequency of the engine.
+   *
+   * \throw SoundException on failure.
+   *
+   * \upstream SDL_LoadWAV
+   * \upstream SDL_NewAudioStream
+   */
+  static Sound LoadWav(const std::string& path, int frequency);
+
+  /**
+   * \brief Get the interleaved samples.
+   */
+  const float* GetSamples() const { return samples.get(); }
+
+  /**
+   * \brief Get the shared pointer to the samples.
+   */
+  const std::shared_ptr<const float>& GetSharedSamples() const { return samples; }
+
+  /**
+   * \brief Get the number of frames, each of which has a sample per channel.
+   */
+  std::size_t GetFrameCount() const { return frames; }
+
+  /**
+   * \brief Get the number of channels.
+   */
+  int GetChannels() const { return channels; }
+
+  /**
+   * \brief Check whether the sound has no samples.
+   */
+  bool IsEmpty() const { return frames == 0; }
+
+  /**
+   * \brief Get the duration of the sound when it is played at the given frequency.
+   */
+  Time GetDuration(int frequency) const;
+
+private:
+  std::shared_ptr<const float> samples;
+  std::size_t frames = 0;
+  int channels = 1;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_MIXER_SOUND_H
@@ -0,0 +1,189 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the SoundBank class that keeps converted sound effects in one arena.
+ */
+
+#ifndef SDLXX_MIXER_SOUND_BANK_H
+#define SDLXX_MIXER_SOUND_BANK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+#include "sdlxx/mixer/sound.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for SoundBank-related exceptions.
+ */
+class SoundBankException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A class that converts sound effects once and keeps them in a single arena.
+ *
+ * All sounds are converted to floats at the output frequency of the engine, so voices play
+ * them without conversion, and stored back to back in one allocation. Sounds returned by Get()
+ * share the arena, so the same effect used by many scenes and voices takes memory only once,
+ * and the arena lives until the last of them is released.
+ *
+ * The converted arena can be saved to a cache file, which is used on the next start instead of
+ * decoding and resampling while the source files keep their size and modification time.
+ *
+ * \code
+ * SoundBank bank(engine.GetFrequency());
+ * bank.Add("shot", "sounds/shot.wav");
+ * bank.Add("step", "sounds/step.wav");
+ * bank.Load("cache/sounds.bank");
+ * engine.Play(bank.Get("shot"));
+ * \endcode
+ */
+class SoundBank {
+public:
+  /**
+   * \brief Construct an empty sound bank.
+   *
+   * \param frequency The output frequency of the engine that plays the sounds.
+   */
+  explicit SoundBank(int frequency);
+
+  /**
+   * \brief Add a WAV file to the sounds loaded by the next Load().
+   *
+   * \param name The name that the sound is found by.
+   * \param path The path to the file.
+   *
+   * \throw SoundBankException if a sound with the name was already added.
+   */
+  void Add(const std::string& name, const std::string& path);
+
+  /**
+   * \brief Convert all added sounds and store them in a new arena.
+   *
+   * Sounds returned by Get() before stay valid and keep the previous arena alive.
+   *
+   * \param cache_path The path of a cache file, or empty to convert without a cache. A valid
+   *                   cache is read instead of converting, and an outdated or missing one is
+   *                   written after converting.
+   *
+   * \throw SoundException if a sound can not be loaded.
+   * \throw SoundBankException if the cache can not be written, in which case the sounds are
+   *        loaded nevertheless.
+   */
+  void Load(const std::string& cache_path = std::string());
+
+  /**
+   * \brief Get a sound that shares the samples in the arena.
+   *
+   * \throw SoundBankException if there is no loaded sound with the name.
+   */
+  Sound Get(const std::string& name) const;
+
+  /**
+   * \brief Check whether a sound with the name is loaded.
+   */
+  bool Contains(const std::string& name) const;
+
+  /**
+   * \brief Get the number of loaded sounds.
+   */
+  std::size_t GetCount() const;
+
+  /**
+   * \brief Get the size of the arena in bytes.
+   */
+  std::size_t GetMemoryUsage() const { return arena ? arena->size() * sizeof(float) : 0; }
+
+  /**
+   * \brief Check whether the last Load() read the cache instead of converting.
+   */
+  bool IsLoadedFromCache() const { return loaded_from_cache; }
+
+private:
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  // Allocates the arena at a cache line boundary, so that sounds at aligned offsets are aligned
+  template <typename T>
+  struct CacheLineAllocator {
+    using value_type = T;
+
+    CacheLineAllocator() = default;
+
+    template <typename U>
+    CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+    T* allocate(std::size_t count) {
+      return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(CACHE_LINE)));
+    }
+
+    void deallocate(T* pointer, std::size_t) {
+      ::operator delete(pointer, std::align_val_t(CACHE_LINE));
+    }
+
+    template <typename U>
+    bool operator==(const CacheLineAllocator<U>&) const {
+      return true;
+    }
+
+    template <typename U>
+    bool operator!=(const CacheLineAllocator<U>&) const {
+      return false;
+    }
+  };
+
+  using Arena = std::vector<float, CacheLineAllocator<float>>;
+
+  struct Entry {
+    std::string name;
+    std::string path;
+    uint64_t source_size = 0;
+    int64_t source_time = 0;
+    uint64_t offset = 0;
+    uint64_t frames = 0;
+    uint32_t channels = 0;
+    bool loaded = false;
+  };
+
+  int frequency;
+  std::vector<Entry> entries;
+  std::unordered_map<std::string, std::size_t> indices;
+  std::shared_ptr<Arena> arena;
+  bool loaded_from_cache = false;
+
+  bool ReadCache(const std::string& path, std::vector<Entry>& loaded);
+
+  void WriteCache(const std::string& path) const;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_MIXER_SOUND_BANK_H
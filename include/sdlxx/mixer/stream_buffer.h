@@ -0,0 +1,164 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the StreamBuffer class that passes decoded audio to the audio callback.
+ */
+
+#ifndef SDLXX_MIXER_STREAM_BUFFER_H
+#define SDLXX_MIXER_STREAM_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "sdlxx/core/exception.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for StreamBuffer-related exceptions.
+ */
+class StreamBufferException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A wait-free single-producer single-consumer ring of interleaved float frames.
+ *
+ * A decoder thread writes frames ahead of playback, and the audio callback reads them. The
+ * producer marks the end of the stream with Finish(), and the consumer tells the producer to
+ * stop with Close().
+ */
+class StreamBuffer {
+public:
+  /**
+   * \brief Construct a stream buffer.
+   *
+   * \param frames   The capacity in frames, rounded up to a power of two.
+   * \param channels The number of channels, 1 or 2.
+   *
+   * \throw StreamBufferException if the number of channels is not supported.
+   */
+  StreamBuffer(std::size_t frames, int channels);
+
+  // Deleted copy constructor
+  StreamBuffer(const StreamBuffer&) = delete;
+
+  // Deleted copy assignment operator
+  StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+  // Deleted move constructor
+  StreamBuffer(StreamBuffer&&) = delete;
+
+  // Deleted move assignment operator
+  StreamBuffer& operator=(StreamBuffer&&) = delete;
+
+  /**
+   * \brief Get the number of channels.
+   */
+  int GetChannels() const { return channels; }
+
+  /**
+   * \brief Get the capacity in frames.
+   */
+  std::size_t GetCapacity() const { return mask + 1; }
+
+  /**
+   * \brief Get the number of frames that can be written.
+   *
+   * \note Must be called only from the producer thread.
+   */
+  std::size_t GetWriteSpace() const;
+
+  /**
+   * \brief Write as many frames as fit.
+   *
+   * \note Must be called only from the producer thread.
+   *
+   * \return std::size_t The number of written frames.
+   */
+  std::size_t Write(const float* samples, std::size_t frames);
+
+  /**
+   * \brief Mark the end of the stream after the written frames.
+   *
+   * \note Must be called only from the producer thread.
+   */
+  void Finish() { finished.store(true, std::memory_order_release); }
+
+  /**
+   * \brief Check whether the consumer stopped reading.
+   */
+  bool IsClosed() const { return closed.load(std::memory_order_acquire); }
+
+  /**
+   * \brief Get the number of frames that can be read.
+   */
+  std::size_t GetAvailable() const;
+
+  /**
+   * \brief Read as many frames as are available.
+   *
+   * Reading fewer frames than requested before the end of the stream counts as an underrun,
+   * unless nothing was written yet.
+   *
+   * \note Must be called only from the consumer thread.
+   *
+   * \return std::size_t The number of read frames.
+   */
+  std::size_t Read(float* samples, std::size_t frames);
+
+  /**
+   * \brief Check whether the producer finished and all frames were read.
+   */
+  bool IsFinished() const;
+
+  /**
+   * \brief Tell the producer that no more frames will be read.
+   */
+  void Close() { closed.store(true, std::memory_order_release); }
+
+  /**
+   * \brief Get the number of reads that found fewer frames than requested.
+   */
+  uint64_t GetUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  std::unique_ptr<float[]> samples;
+  std::size_t mask;
+  int channels;
+
+  alignas(CACHE_LINE) std::atomic<uint64_t> write_position{0};
+  std::atomic<bool> finished{false};
+  alignas(CACHE_LINE) std::atomic<uint64_t> read_position{0};
+  std::atomic<bool> closed{false};
+  std::atomic<uint64_t> underruns{0};
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_MIXER_STREAM_BUFFER_H
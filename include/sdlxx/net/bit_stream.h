@@ -0,0 +1,232 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the BitWriter and BitReader classes that pack values into bits.
+ */
+
+#ifndef SDLXX_NET_BIT_STREAM_H
+#define SDLXX_NET_BIT_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for exceptions of BitReader.
+ */
+class BitStreamException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A class that writes values with an arbitrary number of bits.
+ *
+ * Bits are collected in a 64-bit register and stored to the buffer a whole word at a time,
+ * least significant bit first. Values of the same size have the same encoding on every
+ * platform.
+ */
+class BitWriter {
+public:
+  /**
+   * \brief Write the lowest bits of a value.
+   *
+   * \param value The value, whose bits above the count must be zero.
+   * \param count The number of bits, from 0 to 32.
+   */
+  void WriteBits(uint32_t value, int count) {
+    scratch |= static_cast<uint64_t>(value) << scratch_bits;
+    scratch_bits += count;
+    if (scratch_bits >= 32) {
+      StoreWord(static_cast<uint32_t>(scratch));
+      scratch >>= 32U;
+      scratch_bits -= 32;
+    }
+    bit_count += count;
+  }
+
+  /**
+   * \brief Write a single bit.
+   */
+  void WriteBool(bool value) { WriteBits(value ? 1 : 0, 1); }
+
+  /**
+   * \brief Write an unsigned integer in groups of 7 bits, so that small values take 8 bits.
+   */
+  void WriteVarUint(uint64_t value);
+
+  /**
+   * \brief Write a signed integer as a variable-length zigzag code, so that values close to 0
+   *        take 8 bits.
+   */
+  void WriteVarInt(int64_t value);
+
+  /**
+   * \brief Write all 32 bits of a float.
+   */
+  void WriteFloat(float value);
+
+  /**
+   * \brief Write a float in a range with a fixed number of bits.
+   *
+   * The value is clamped to [min, max] and rounded to one of 2^bits evenly spaced steps.
+   */
+  void WriteQuantized(float value, float min, float max, int bits);
+
+  /**
+   * \brief Write zero bits up to the next byte boundary.
+   */
+  void AlignToByte();
+
+  /**
+   * \brief Get the number of bits written.
+   */
+  std::size_t GetBitCount() const { return bit_count; }
+
+  /**
+   * \brief Get the number of bytes needed to hold the bits written.
+   */
+  std::size_t GetByteCount() const { return (bit_count + 7) / 8; }
+
+  /**
+   * \brief Get the written bytes, with the last byte padded with zero bits.
+   */
+  const std::vector<uint8_t>& GetData();
+
+  /**
+   * \brief Remove all bits, keeping the allocated memory.
+   */
+  void Clear();
+
+private:
+  std::vector<uint8_t> buffer;
+  std::size_t stored = 0;  ///< The number of bytes of complete words in the buffer
+  uint64_t scratch = 0;
+  int scratch_bits = 0;
+  std::size_t bit_count = 0;
+
+  void StoreWord(uint32_t word);
+};
+
+/**
+ * \brief A class that reads values written by BitWriter.
+ *
+ * The reader does not own the data. Reading past the end throws, so untrusted data can be
+ * read without checking its size first.
+ */
+class BitReader {
+public:
+  /**
+   * \brief Construct a reader of bytes.
+   */
+  BitReader(const void* data, std::size_t size);
+
+  /**
+   * \brief Read a value with a number of bits.
+   *
+   * \param count The number of bits, from 0 to 32.
+   *
+   * \throw BitStreamException if there are not enough bits left.
+   */
+  uint32_t ReadBits(int count) {
+    if (scratch_bits < count) {
+      Refill(count);
+    }
+    auto mask = (uint64_t{1} << static_cast<unsigned>(count)) - 1;
+    auto value = static_cast<uint32_t>(scratch & mask);
+    scratch >>= static_cast<unsigned>(count);
+    scratch_bits -= count;
+    return value;
+  }
+
+  /**
+   * \brief Read a single bit.
+   */
+  bool ReadBool() { return ReadBits(1) != 0; }
+
+  /**
+   * \brief Read an unsigned integer written by BitWriter::WriteVarUint().
+   *
+   * \throw BitStreamException if the value is longer than 64 bits.
+   */
+  uint64_t ReadVarUint();
+
+  /**
+   * \brief Read a signed integer written by BitWriter::WriteVarInt().
+   */
+  int64_t ReadVarInt();
+
+  /**
+   * \brief Read a float written by BitWriter::WriteFloat().
+   */
+  float ReadFloat();
+
+  /**
+   * \brief Read a float written by BitWriter::WriteQuantized() with the same parameters.
+   */
+  float ReadQuantized(float min, float max, int bits);
+
+  /**
+   * \brief Skip the bits up to the next byte boundary.
+   */
+  void AlignToByte();
+
+  /**
+   * \brief Get the number of bits that are left.
+   */
+  std::size_t GetRemainingBits() const { return (size - position) * 8 + scratch_bits; }
+
+private:
+  const uint8_t* data;
+  std::size_t size;
+  std::size_t position = 0;
+  uint64_t scratch = 0;
+  int scratch_bits = 0;
+
+  void Refill(int count);
+};
+
+/**
+ * \brief Map a float in a range to an integer with a number of bits.
+ */
+inline uint32_t Quantize(float value, float min, float max, int bits) {
+  const auto steps = static_cast<float>((uint64_t{1} << static_cast<unsigned>(bits)) - 1);
+  float clamped = value < min ? min : (value > max ? max : value);
+  return static_cast<uint32_t>((clamped - min) / (max - min) * steps + 0.5F);
+}
+
+/**
+ * \brief Map an integer produced by Quantize() back to a float.
+ */
+inline float Dequantize(uint32_t value, float min, float max, int bits) {
+  const auto steps = static_cast<float>((uint64_t{1} << static_cast<unsigned>(bits)) - 1);
+  return min + static_cast<float>(value) / steps * (max - min);
+}
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_NET_BIT_STREAM_H
@@ -0,0 +1,179 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the MessageStream class that frames messages on a TCP connection.
+ */
+
+#ifndef SDLXX_NET_MESSAGE_STREAM_H
+#define SDLXX_NET_MESSAGE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string_view>
+
+#include "sdlxx/core/exception.h"
+#include "sdlxx/net/ring_buffer.h"
+#include "sdlxx/net/socket.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for MessageStream-related exceptions.
+ */
+class MessageStreamException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief An enumeration of ways to mark the size of a message.
+ */
+enum class Framing {
+  LENGTH_PREFIX,  ///< A 4-byte big-endian size before every message
+  VARINT          ///< A LEB128 size of 1 to 5 bytes before every message, 1 byte up to 127
+};
+
+/**
+ * \brief A class that sends and receives whole messages over a non-blocking TCP connection.
+ *
+ * Received data is read into a ring buffer with as few system calls as possible, and complete
+ * messages are handed out as views into the buffer, so they are never copied. Messages that
+ * arrive in parts are assembled in place.
+ *
+ * Small messages are queued and sent together by Flush(). A message with several parts is
+ * sent straight from the memory of the parts when nothing is queued, and only the part that
+ * the socket did not take is queued.
+ *
+ * \code
+ * reactor.Add(stream.GetSocket(), IoEvent::READ, [&](BitMask<IoEvent> events) {
+ *   if (!stream.Receive()) {
+ *     // Closed
+ *   }
+ *   while (std::optional<std::string_view> message = stream.Next()) {
+ *     stream.Send(*message);  // Echo
+ *   }
+ *   stream.Flush();
+ * });
+ * \endcode
+ */
+class MessageStream {
+public:
+  /// The default capacity of each of the buffers
+  static constexpr std::size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+  /**
+   * \brief Construct a stream over a connection.
+   *
+   * \param socket           The connected socket.
+   * \param framing          The format of message sizes.
+   * \param max_message_size The largest message that can be received or sent. The buffers are
+   *                         made large enough to hold it.
+   *
+   * \throw RingBufferException if the buffers can not be allocated.
+   */
+  MessageStream(TcpSocket socket, Framing framing,
+                std::size_t max_message_size = DEFAULT_BUFFER_SIZE - 8);
+
+  /**
+   * \brief Get the socket of the stream.
+   */
+  TcpSocket& GetSocket() { return socket; }
+
+  /**
+   * \brief Read all data that is available on the socket.
+   *
+   * Views returned by Next() are invalidated.
+   *
+   * \return false if the peer closed the connection.
+   *
+   * \throw SocketException on failure.
+   */
+  bool Receive();
+
+  /**
+   * \brief Take the next complete message.
+   *
+   * \return A view of the message that is valid until the next call to Receive(), or
+   *         std::nullopt if no complete message was received.
+   *
+   * \throw MessageStreamException if the size of the message is invalid or too large.
+   */
+  std::optional<std::string_view> Next();
+
+  /**
+   * \brief Queue a message.
+   *
+   * \throw MessageStreamException if the message is too large or the send queue stays full
+   *        after a flush.
+   * \throw SocketException if the connection is broken.
+   */
+  void Send(std::string_view message);
+
+  /**
+   * \brief Send a message that consists of up to 63 parts.
+   *
+   * If nothing is queued and the message is at least 4 KiB, the parts are sent with one
+   * system call without being joined, and only the rest is queued. Otherwise the message is
+   * queued.
+   *
+   * \throw MessageStreamException if the message is too large, has too many parts or the send
+   *        queue stays full after a flush.
+   * \throw SocketException if the connection is broken.
+   */
+  void Send(std::initializer_list<std::string_view> parts);
+
+  /**
+   * \brief Send as much of the queued data as the socket takes.
+   *
+   * \return true if the queue is empty. Otherwise wait for IoEvent::WRITE and flush again.
+   *
+   * \throw SocketException if the connection is broken.
+   */
+  bool Flush();
+
+  /**
+   * \brief Check whether data is waiting to be sent.
+   */
+  bool HasPendingOutput() const { return !output.IsEmpty(); }
+
+  /**
+   * \brief Get the number of bytes waiting to be sent.
+   */
+  std::size_t GetPendingOutputSize() const { return output.GetSize(); }
+
+private:
+  TcpSocket socket;
+  Framing framing;
+  std::size_t max_message_size;
+  RingBuffer input;
+  RingBuffer output;
+
+  std::size_t EncodeHeader(uint8_t* header, std::size_t size) const;
+
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_NET_MESSAGE_STREAM_H
@@ -0,0 +1,141 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the NetworkSimulator class that delays and drops packets locally.
+ */
+
+#ifndef SDLXX_NET_NETWORK_SIMULATOR_H
+#define SDLXX_NET_NETWORK_SIMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "sdlxx/core/time.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class that carries packets in one direction like a lossy network.
+ *
+ * Packets are dropped, duplicated and delayed at random, and the jitter reorders them. Two
+ * simulators between two UdpConnection instances make a connection that can be tested in a
+ * single process with deterministic results for a seed.
+ *
+ * \code
+ * NetworkSimulator::Settings settings;
+ * settings.loss = 0.1f;
+ * settings.latency = Time::Milliseconds(50);
+ * NetworkSimulator link(settings);
+ * UdpConnection client(channels, [&](const uint8_t* data, std::size_t size) {
+ *   link.Send(data, size, now);
+ * });
+ * // Every frame
+ * link.Deliver(now, [&](const uint8_t* data, std::size_t size) {
+ *   server.ReceivePacket(data, size, now);
+ * });
+ * \endcode
+ */
+class NetworkSimulator {
+public:
+  /// A function that receives a delivered packet
+  using PacketReceiver = std::function<void(const uint8_t* data, std::size_t size)>;
+
+  /**
+   * \brief Conditions of the simulated network.
+   */
+  struct Settings {
+    float loss = 0.0f;       ///< The probability that a packet is dropped
+    float duplicate = 0.0f;  ///< The probability that a packet is delivered twice
+    Time latency;            ///< The delay of every packet
+    Time jitter;             ///< The largest random delay that is added to the latency
+  };
+
+  /**
+   * \brief Construct a simulator that delivers packets without loss or delay.
+   */
+  NetworkSimulator();
+
+  /**
+   * \brief Construct a simulator.
+   *
+   * \param settings Conditions of the network.
+   * \param seed     The seed of the random number generator.
+   */
+  explicit NetworkSimulator(const Settings& settings, uint32_t seed = 1);
+
+  /**
+   * \brief Change the conditions, which apply to packets sent afterwards.
+   */
+  void SetSettings(const Settings& settings);
+
+  /**
+   * \brief Get the conditions of the network.
+   */
+  const Settings& GetSettings() const;
+
+  /**
+   * \brief Send a packet, which is copied.
+   *
+   * \param now The current time.
+   */
+  void Send(const void* data, std::size_t size, Time now);
+
+  /**
+   * \brief Pass the packets that arrived by the given time to a receiver, oldest first.
+   */
+  void Deliver(Time now, const PacketReceiver& receiver);
+
+  /**
+   * \brief Get the number of packets in flight.
+   */
+  std::size_t GetPendingCount() const;
+
+  /**
+   * \brief Get the number of packets that were dropped.
+   */
+  uint64_t GetDroppedCount() const;
+
+private:
+  struct Packet {
+    int64_t arrival;
+    uint64_t order;
+    std::vector<uint8_t> data;
+  };
+
+  Settings settings;
+  std::mt19937 random;
+  /// A min-heap of packets by arrival time and order of sending
+  std::vector<Packet> packets;
+  uint64_t sent = 0;
+  uint64_t dropped = 0;
+
+  void Schedule(const uint8_t* data, std::size_t size, int64_t now);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_NET_NETWORK_SIMULATOR_H
@@ -0,0 +1,207 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Reactor class that dispatches socket readiness events.
+ */
+
+#ifndef SDLXX_NET_REACTOR_H
+#define SDLXX_NET_REACTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/time.h"
+#include "sdlxx/net/socket.h"
+#include "sdlxx/utils/bitmask.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for Reactor-related exceptions.
+ */
+class ReactorException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief An enumeration of socket readiness events.
+ */
+enum class IoEvent : uint32_t {
+  READ = 1U << 0U,   ///< Data or a connection can be received, or the peer closed the stream
+  WRITE = 1U << 1U,  ///< Data can be sent, or a connection attempt finished
+  ERROR = 1U << 2U   ///< The socket has an error or was hung up, always reported
+};
+
+/**
+ * \brief A class that waits for events on many sockets and calls their handlers.
+ *
+ * The reactor uses epoll on Linux and poll() on other POSIX systems. Events are
+ * level-triggered: a handler is called on every Poll() while its socket stays ready, so a
+ * handler may read only part of the available data.
+ *
+ * Sockets are registered by handle and must stay open while registered. Handlers may add,
+ * modify and remove any registration, including their own, and events of a socket that was
+ * removed during the same Poll() are dropped.
+ *
+ * All functions except Post() and Stop() must be called from the thread that runs the reactor.
+ */
+class Reactor {
+public:
+  /// A function that receives the events of a socket
+  using Handler = std::function<void(BitMask<IoEvent> events)>;
+
+  /// A function that is posted from another thread
+  using Task = std::function<void()>;
+
+  /**
+   * \brief Construct a reactor.
+   *
+   * \throw ReactorException on failure.
+   */
+  Reactor();
+
+  /**
+   * \brief Destroy the reactor without closing the registered sockets.
+   */
+  ~Reactor();
+
+  // Deleted copy constructor
+  Reactor(const Reactor&) = delete;
+
+  // Deleted copy assignment operator
+  Reactor& operator=(const Reactor&) = delete;
+
+  /**
+   * \brief Register a socket.
+   *
+   * \param socket   The socket to watch.
+   * \param events   The events to wait for, READ, WRITE or both.
+   * \param handler  The function that is called with the events that occurred.
+   *
+   * \throw ReactorException if the socket is closed or already registered.
+   */
+  void Add(const Socket& socket, BitMask<IoEvent> events, Handler handler);
+
+  /**
+   * \brief Change the events to wait for, for example to wait for WRITE while data is queued.
+   *
+   * \throw ReactorException if the socket is not registered.
+   */
+  void Modify(const Socket& socket, BitMask<IoEvent> events);
+
+  /**
+   * \brief Unregister a socket, which must be done before the socket is closed.
+   */
+  void Remove(const Socket& socket);
+
+  /**
+   * \brief Check whether a socket is registered.
+   */
+  bool Contains(const Socket& socket) const;
+
+  /**
+   * \brief Get the number of registered sockets.
+   */
+  std::size_t GetSocketCount() const { return socket_count; }
+
+  /**
+   * \brief Wait for events and call the handlers of the ready sockets and the posted tasks.
+   *
+   * \param timeout The maximum time to wait, or a negative time to wait without limit.
+   *
+   * \return The number of handlers and tasks that were called.
+   *
+   * \throw ReactorException on failure. Exceptions thrown by handlers are propagated.
+   */
+  std::size_t Poll(Time timeout = Time::Milliseconds(-1));
+
+  /**
+   * \brief Poll until Stop() is called.
+   */
+  void Run();
+
+  /**
+   * \brief Make Run() return after the current iteration. Can be called from any thread.
+   */
+  void Stop();
+
+  /**
+   * \brief Call a function on the thread of the reactor. Can be called from any thread.
+   *
+   * This wakes up a waiting Poll(), so it is also the way to hand data to the reactor.
+   */
+  void Post(Task task);
+
+private:
+  struct Registration {
+    /// Shared with Poll(), so that a handler can remove itself while it runs
+    std::shared_ptr<Handler> handler;
+    BitMask<IoEvent> events;
+    uint32_t generation = 0;
+  };
+
+  struct ReadySocket {
+    int handle;
+    uint32_t generation;
+    BitMask<IoEvent> events;
+  };
+
+  /// Registrations indexed by socket handle, which are small and reused by the system
+  std::vector<Registration> registrations;
+  std::size_t socket_count = 0;
+  uint32_t next_generation = 0;
+
+  /// The epoll instance on Linux
+  int poller = -1;
+
+  /// The pipe that wakes up Poll(), read from the first handle and written to the second
+  int wakeup[2] = {-1, -1};
+
+  std::mutex tasks_mutex;
+  std::vector<Task> tasks;
+  std::atomic<bool> stopping{false};
+
+  /// Ready sockets of the current Poll(), reused between polls
+  std::vector<ReadySocket> ready;
+
+  Registration* Find(int handle);
+
+  void Wait(int timeout_ms);
+
+  void Wake();
+
+  std::size_t RunTasks();
+};
+
+}  // namespace sdlxx
+
+ENABLE_BITMASK_OPERATORS(sdlxx::IoEvent);
+
+#endif  // SDLXX_NET_REACTOR_H
@@ -0,0 +1,144 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the RingBuffer class that queues bytes in contiguous memory.
+ */
+
+#ifndef SDLXX_NET_RING_BUFFER_H
+#define SDLXX_NET_RING_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sdlxx/core/exception.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for RingBuffer-related exceptions.
+ */
+class RingBufferException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A byte queue whose data and free space are always contiguous.
+ *
+ * On Linux the buffer is mapped twice into adjacent virtual memory, so data that wraps around
+ * the end of the buffer continues in the second mapping and can be read or written with a
+ * single pointer and no copies. Where the mirroring is not available, the buffer is linear and
+ * moves the data to the front when free space is requested.
+ */
+class RingBuffer {
+public:
+  /**
+   * \brief Construct a buffer.
+   *
+   * \param capacity The minimum capacity in bytes, rounded up to the page size.
+   *
+   * \throw RingBufferException if the memory can not be allocated.
+   */
+  explicit RingBuffer(std::size_t capacity);
+
+  /**
+   * \brief Free the memory of the buffer.
+   */
+  ~RingBuffer();
+
+  // Deleted copy constructor
+  RingBuffer(const RingBuffer&) = delete;
+
+  // Deleted copy assignment operator
+  RingBuffer& operator=(const RingBuffer&) = delete;
+
+  /**
+   * \brief Get the data in the buffer.
+   */
+  const uint8_t* GetData() const { return memory + read; }
+
+  /**
+   * \brief Get the number of bytes in the buffer.
+   */
+  std::size_t GetSize() const { return size; }
+
+  /**
+   * \brief Get the number of bytes that can be written.
+   */
+  std::size_t GetFreeSpace() const { return capacity - size; }
+
+  /**
+   * \brief Get the total number of bytes that the buffer holds.
+   */
+  std::size_t GetCapacity() const { return capacity; }
+
+  /**
+   * \brief Check whether the buffer is empty.
+   */
+  bool IsEmpty() const { return size == 0; }
+
+  /**
+   * \brief Check whether the buffer uses mirrored memory.
+   */
+  bool IsMirrored() const { return mirrored; }
+
+  /**
+   * \brief Get the memory where GetFreeSpace() bytes can be written.
+   *
+   * In a linear buffer this may move the data, which invalidates pointers from GetData().
+   */
+  uint8_t* GetWriteSpace();
+
+  /**
+   * \brief Append bytes that were written to GetWriteSpace().
+   */
+  void Commit(std::size_t count);
+
+  /**
+   * \brief Copy bytes to the end of the buffer.
+   *
+   * \throw RingBufferException if there is not enough free space.
+   */
+  void Write(const void* data, std::size_t count);
+
+  /**
+   * \brief Remove bytes from the front of the buffer.
+   */
+  void Consume(std::size_t count);
+
+  /**
+   * \brief Remove all bytes.
+   */
+  void Clear();
+
+private:
+  uint8_t* memory = nullptr;
+  std::size_t capacity = 0;
+  std::size_t read = 0;
+  std::size_t size = 0;
+  bool mirrored = false;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_NET_RING_BUFFER_H
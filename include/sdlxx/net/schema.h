@@ -0,0 +1,238 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Schema template that serializes structures field by field.
+ */
+
+#ifndef SDLXX_NET_SCHEMA_H
+#define SDLXX_NET_SCHEMA_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include "sdlxx/net/bit_stream.h"
+
+namespace sdlxx {
+
+/**
+ * \brief Codecs that encode single fields of a Schema.
+ *
+ * A codec defines the field type, writes and reads a value, and tells whether two values have
+ * the same encoding, so that a delta can skip changes that would be lost anyway. WriteDelta()
+ * and ReadDelta() encode a changed value relative to its baseline.
+ */
+namespace Codec {  // NOLINT(readability-identifier-naming)
+
+/// An unsigned integer with a fixed number of bits, of which only the low bits are written
+template <typename T, int Bits = sizeof(T) * 8>
+struct Unsigned {
+  static_assert(std::is_unsigned_v<T> && Bits > 0 && Bits <= 32);
+  using Type = T;
+  static constexpr uint32_t MASK = static_cast<uint32_t>((uint64_t{1} << Bits) - 1);
+  static void Write(BitWriter& writer, T value) {
+    writer.WriteBits(static_cast<uint32_t>(value) & MASK, Bits);
+  }
+  static T Read(BitReader& reader) { return static_cast<T>(reader.ReadBits(Bits)); }
+  static bool Equal(T a, T b) {
+    return (static_cast<uint32_t>(a) & MASK) == (static_cast<uint32_t>(b) & MASK);
+  }
+  static void WriteDelta(BitWriter& writer, T, T value) { Write(writer, value); }
+  static T ReadDelta(BitReader& reader, T) { return Read(reader); }
+};
+
+/// An integer with a variable number of bits, with deltas to the baseline
+template <typename T>
+struct VarInt {
+  static_assert(std::is_integral_v<T>);
+  using Type = T;
+  static void Write(BitWriter& writer, T value) {
+    if constexpr (std::is_signed_v<T>) {
+      writer.WriteVarInt(value);
+    } else {
+      writer.WriteVarUint(value);
+    }
+  }
+  static T Read(BitReader& reader) {
+    if constexpr (std::is_signed_v<T>) {
+      return static_cast<T>(reader.ReadVarInt());
+    } else {
+      return static_cast<T>(reader.ReadVarUint());
+    }
+  }
+  static bool Equal(T a, T b) { return a == b; }
+  static void WriteDelta(BitWriter& writer, T baseline, T value) {
+    writer.WriteVarInt(static_cast<int64_t>(value) - static_cast<int64_t>(baseline));
+  }
+  static T ReadDelta(BitReader& reader, T baseline) {
+    return static_cast<T>(static_cast<int64_t>(baseline) + reader.ReadVarInt());
+  }
+};
+
+/// A boolean in a single bit
+struct Bool {
+  using Type = bool;
+  static void Write(BitWriter& writer, bool value) { writer.WriteBool(value); }
+  static bool Read(BitReader& reader) { return reader.ReadBool(); }
+  static bool Equal(bool a, bool b) { return a == b; }
+  static void WriteDelta(BitWriter& writer, bool, bool value) { Write(writer, value); }
+  static bool ReadDelta(BitReader& reader, bool) { return Read(reader); }
+};
+
+/// A float with all 32 bits
+struct Float {
+  using Type = float;
+  static void Write(BitWriter& writer, float value) { writer.WriteFloat(value); }
+  static float Read(BitReader& reader) { return reader.ReadFloat(); }
+  static bool Equal(float a, float b) { return a == b; }
+  static void WriteDelta(BitWriter& writer, float, float value) { Write(writer, value); }
+  static float ReadDelta(BitReader& reader, float) { return Read(reader); }
+};
+
+/**
+ * \brief A float in range [Min / Scale, Max / Scale] rounded to 2^Bits steps.
+ *
+ * Deltas are written as the variable-length difference of the steps, so slow changes take
+ * fewer bits than the full value. Floats can not be template arguments, hence the scale.
+ */
+template <int Min, int Max, int Bits, int Scale = 1>
+struct Quantized {
+  static_assert(Min < Max && Bits > 0 && Bits <= 32 && Scale > 0);
+  using Type = float;
+  static constexpr float MIN = static_cast<float>(Min) / Scale;
+  static constexpr float MAX = static_cast<float>(Max) / Scale;
+
+  static void Write(BitWriter& writer, float value) {
+    writer.WriteBits(Quantize(value, MIN, MAX, Bits), Bits);
+  }
+  static float Read(BitReader& reader) { return Dequantize(reader.ReadBits(Bits), MIN, MAX, Bits); }
+  static bool Equal(float a, float b) {
+    return Quantize(a, MIN, MAX, Bits) == Quantize(b, MIN, MAX, Bits);
+  }
+  static void WriteDelta(BitWriter& writer, float baseline, float value) {
+    writer.WriteVarInt(static_cast<int64_t>(Quantize(value, MIN, MAX, Bits)) -
+                       static_cast<int64_t>(Quantize(baseline, MIN, MAX, Bits)));
+  }
+  static float ReadDelta(BitReader& reader, float baseline) {
+    int64_t steps = static_cast<int64_t>(Quantize(baseline, MIN, MAX, Bits)) + reader.ReadVarInt();
+    return Dequantize(static_cast<uint32_t>(steps), MIN, MAX, Bits);
+  }
+};
+
+}  // namespace Codec
+
+/**
+ * \brief A field of a structure and the codec that encodes it.
+ *
+ * \tparam Member    A pointer to the data member, such as &Player::health.
+ * \tparam FieldCodec A structure from the Codec namespace.
+ */
+template <auto Member, typename FieldCodec>
+struct Field {
+  using Codec = FieldCodec;
+  static constexpr auto MEMBER = Member;
+};
+
+/**
+ * \brief A description of how a structure is serialized, given as a list of fields.
+ *
+ * All functions are generated at compile time and inline the codecs, so serialization costs
+ * no more than hand-written code.
+ *
+ * \code
+ * struct Player {
+ *   float x, y;
+ *   uint8_t health;
+ * };
+ *
+ * using PlayerSchema = Schema<Player,
+ *                             Field<&Player::x, Codec::Quantized<-1024, 1024, 16>>,
+ *                             Field<&Player::y, Codec::Quantized<-1024, 1024, 16>>,
+ *                             Field<&Player::health, Codec::Unsigned<uint8_t, 7>>>;
+ * \endcode
+ *
+ * A delta against a baseline starts with one bit per field that tells whether the field
+ * changed, followed by the deltas of the changed fields.
+ */
+template <typename T, typename... Fields>
+struct Schema {
+  using Type = T;
+
+  /// The number of fields
+  static constexpr int FIELD_COUNT = sizeof...(Fields);
+
+  /**
+   * \brief Write all fields.
+   */
+  static void Write(BitWriter& writer, const T& value) {
+    (Fields::Codec::Write(writer, value.*Fields::MEMBER), ...);
+  }
+
+  /**
+   * \brief Read all fields.
+   */
+  static void Read(BitReader& reader, T& value) {
+    ((value.*Fields::MEMBER = Fields::Codec::Read(reader)), ...);
+  }
+
+  /**
+   * \brief Check whether two values have the same encoding.
+   */
+  static bool Equal(const T& a, const T& b) {
+    return (Fields::Codec::Equal(a.*Fields::MEMBER, b.*Fields::MEMBER) && ...);
+  }
+
+  /**
+   * \brief Write the fields that differ from the baseline.
+   */
+  static void WriteDelta(BitWriter& writer, const T& baseline, const T& value) {
+    (WriteFieldDelta<Fields>(writer, baseline, value), ...);
+  }
+
+  /**
+   * \brief Read a delta and apply it to a copy of the baseline.
+   */
+  static void ReadDelta(BitReader& reader, const T& baseline, T& value) {
+    (ReadFieldDelta<Fields>(reader, baseline, value), ...);
+  }
+
+private:
+  template <typename F>
+  static void WriteFieldDelta(BitWriter& writer, const T& baseline, const T& value) {
+    bool changed = !F::Codec::Equal(baseline.*F::MEMBER, value.*F::MEMBER);
+    writer.WriteBool(changed);
+    if (changed) {
+      F::Codec::WriteDelta(writer, baseline.*F::MEMBER, value.*F::MEMBER);
+    }
+  }
+
+  template <typename F>
+  static void ReadFieldDelta(BitReader& reader, const T& baseline, T& value) {
+    value.*F::MEMBER = reader.ReadBool() ? F::Codec::ReadDelta(reader, baseline.*F::MEMBER)
+                                         : baseline.*F::MEMBER;
+  }
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_NET_SCHEMA_H
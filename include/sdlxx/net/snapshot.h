@@ -0,0 +1,310 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the snapshot classes that replicate sets of entities with delta encoding.
+ */
+
+#ifndef SDLXX_NET_SNAPSHOT_H
+#define SDLXX_NET_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+#include "sdlxx/net/bit_stream.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for snapshot-related exceptions.
+ */
+class SnapshotException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief The states of a set of entities at one moment.
+ *
+ * \tparam T The state of an entity.
+ */
+template <typename T>
+struct Snapshot {
+  struct Entity {
+    uint32_t id;  ///< The identifier of the entity
+    T state;      ///< The state of the entity
+  };
+
+  /// The number of the snapshot, which increases by one for every snapshot sent
+  uint32_t sequence = 0;
+
+  /// The entities, sorted by identifier
+  std::vector<Entity> entities;
+};
+
+/**
+ * \brief A class that encodes snapshots relative to the last snapshot the receiver confirmed.
+ *
+ * Entities that did not change since the baseline take no bits, changed entities take one bit
+ * per field plus the deltas of the changed fields, and entities that are not in the baseline
+ * are written in full. Without a confirmed baseline, the whole snapshot is written.
+ *
+ * Sent snapshots are kept in a history of a fixed size, so a confirmation must arrive before
+ * that many newer snapshots are sent, or the next snapshot is written in full.
+ *
+ * \tparam S The Schema of the entity state.
+ */
+template <typename S>
+class SnapshotEncoder {
+public:
+  using State = typename S::Type;
+
+  /**
+   * \brief Construct an encoder.
+   *
+   * \param history_size The number of sent snapshots kept as possible baselines.
+   */
+  explicit SnapshotEncoder(std::size_t history_size = 64) : history(history_size) {}
+
+  /**
+   * \brief Write a snapshot and keep it as a possible baseline.
+   *
+   * \throw SnapshotException if the entities are not sorted by identifier.
+   */
+  void Encode(BitWriter& writer, const Snapshot<State>& snapshot) {
+    const Snapshot<State>* baseline = GetBaseline();
+    writer.WriteBits(snapshot.sequence, 32);
+    writer.WriteBool(baseline != nullptr);
+    static const Snapshot<State> empty;
+    if (baseline != nullptr) {
+      writer.WriteVarUint(snapshot.sequence - baseline->sequence);
+    } else {
+      baseline = &empty;
+    }
+
+    // Sort entities into removed and written ones in a single merge of the sorted lists
+    removed.clear();
+    written.clear();
+    const auto& old_entities = baseline->entities;
+    const auto& new_entities = snapshot.entities;
+    std::size_t b = 0;
+    for (std::size_t i = 0; i < new_entities.size(); ++i) {
+      uint32_t id = new_entities[i].id;
+      if (i > 0 && id <= new_entities[i - 1].id) {
+        throw SnapshotException("Entities are not sorted by identifier");
+      }
+      for (; b < old_entities.size() && old_entities[b].id < id; ++b) {
+        removed.push_back(old_entities[b].id);
+      }
+      if (b < old_entities.size() && old_entities[b].id == id) {
+        if (!S::Equal(old_entities[b].state, new_entities[i].state)) {
+          written.push_back({i, b});
+        }
+        ++b;
+      } else {
+        written.push_back({i, NONE});
+      }
+    }
+    for (; b < old_entities.size(); ++b) {
+      removed.push_back(old_entities[b].id);
+    }
+
+    // Identifiers are written as gaps to the previous one, which are small for dense ones
+    writer.WriteVarUint(removed.size());
+    for (std::size_t i = 0; i < removed.size(); ++i) {
+      writer.WriteVarUint(i == 0 ? removed[i] : removed[i] - removed[i - 1] - 1);
+    }
+    writer.WriteVarUint(written.size());
+    uint32_t previous = 0;
+    for (std::size_t i = 0; i < written.size(); ++i) {
+      const auto& entity = new_entities[written[i].current];
+      writer.WriteVarUint(i == 0 ? entity.id : entity.id - previous - 1);
+      previous = entity.id;
+      bool added = written[i].baseline == NONE;
+      writer.WriteBool(added);
+      if (added) {
+        S::Write(writer, entity.state);
+      } else {
+        S::WriteDelta(writer, old_entities[written[i].baseline].state, entity.state);
+      }
+    }
+
+    std::size_t slot = snapshot.sequence % history.size();
+    history[slot] = snapshot;
+    valid[slot] = true;
+  }
+
+  /**
+   * \brief Accept a confirmation that the receiver decoded a snapshot.
+   *
+   * Confirmations of snapshots that are older than the current baseline or no longer in the
+   * history are ignored.
+   */
+  void Acknowledge(uint32_t sequence) {
+    std::size_t slot = sequence % history.size();
+    if (valid[slot] && history[slot].sequence == sequence &&
+        (!acknowledged || static_cast<int32_t>(sequence - *acknowledged) > 0)) {
+      acknowledged = sequence;
+    }
+  }
+
+  /**
+   * \brief Get the sequence of the snapshot that the next delta is based on.
+   */
+  std::optional<uint32_t> GetBaselineSequence() const {
+    const Snapshot<State>* baseline = GetBaseline();
+    return baseline != nullptr ? std::optional<uint32_t>(baseline->sequence) : std::nullopt;
+  }
+
+private:
+  static constexpr std::size_t NONE = SIZE_MAX;
+
+  struct Written {
+    std::size_t current;
+    std::size_t baseline;
+  };
+
+  std::vector<Snapshot<State>> history;
+  std::vector<bool> valid = std::vector<bool>(history.size(), false);
+  std::optional<uint32_t> acknowledged;
+  std::vector<uint32_t> removed;
+  std::vector<Written> written;
+
+  const Snapshot<State>* GetBaseline() const {
+    if (!acknowledged) {
+      return nullptr;
+    }
+    const Snapshot<State>& entry = history[*acknowledged % history.size()];
+    return entry.sequence == *acknowledged ? &entry : nullptr;
+  }
+};
+
+/**
+ * \brief A class that decodes snapshots written by SnapshotEncoder.
+ *
+ * Decoded snapshots are kept in a history of a fixed size as baselines of later deltas. The
+ * sequence of every decoded snapshot should be sent back to the encoder as a confirmation.
+ *
+ * \tparam S The Schema of the entity state.
+ */
+template <typename S>
+class SnapshotDecoder {
+public:
+  using State = typename S::Type;
+
+  /**
+   * \brief Construct a decoder.
+   *
+   * \param history_size The number of decoded snapshots kept as baselines, at least the
+   *                     history size of the encoder.
+   */
+  explicit SnapshotDecoder(std::size_t history_size = 64) : history(history_size) {}
+
+  /**
+   * \brief Read a snapshot.
+   *
+   * \return The snapshot, valid until a snapshot with the same sequence modulo the history
+   *         size is decoded.
+   *
+   * \throw SnapshotException if the baseline of the delta is unknown or the data is invalid.
+   * \throw BitStreamException if the data is truncated.
+   */
+  const Snapshot<State>& Decode(BitReader& reader) {
+    uint32_t sequence = reader.ReadBits(32);
+    static const Snapshot<State> empty;
+    const Snapshot<State>* baseline = &empty;
+    if (reader.ReadBool()) {
+      uint32_t baseline_sequence = sequence - static_cast<uint32_t>(reader.ReadVarUint());
+      baseline = &history[baseline_sequence % history.size()];
+      if (baseline->sequence != baseline_sequence || baseline_sequence == sequence ||
+          !valid[baseline_sequence % history.size()]) {
+        throw SnapshotException("Baseline snapshot is unknown");
+      }
+    }
+
+    uint64_t removed_count = reader.ReadVarUint();
+    if (removed_count > baseline->entities.size()) {
+      throw SnapshotException("More entities are removed than the baseline has");
+    }
+    removed.clear();
+    uint64_t removed_id = 0;
+    for (uint64_t i = 0; i < removed_count; ++i) {
+      removed_id = i == 0 ? reader.ReadVarUint() : removed_id + reader.ReadVarUint() + 1;
+      removed.push_back(static_cast<uint32_t>(removed_id));
+    }
+
+    // Rebuild the snapshot in a separate buffer, since the baseline can be in the same slot
+    decoded.sequence = sequence;
+    decoded.entities.clear();
+    const auto& old_entities = baseline->entities;
+    std::size_t b = 0;
+    std::size_t r = 0;
+    auto copy_until = [&](uint64_t id) {
+      for (; b < old_entities.size() && old_entities[b].id < id; ++b) {
+        if (r < removed.size() && removed[r] == old_entities[b].id) {
+          ++r;
+        } else {
+          decoded.entities.push_back(old_entities[b]);
+        }
+      }
+    };
+    uint64_t count = reader.ReadVarUint();
+    uint64_t id = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+      id = i == 0 ? reader.ReadVarUint() : id + reader.ReadVarUint() + 1;
+      if (id > UINT32_MAX) {
+        throw SnapshotException("Entity identifier is out of range");
+      }
+      copy_until(id);
+      typename Snapshot<State>::Entity entity{static_cast<uint32_t>(id), State{}};
+      bool in_baseline = b < old_entities.size() && old_entities[b].id == id;
+      if (reader.ReadBool()) {
+        S::Read(reader, entity.state);
+      } else if (in_baseline) {
+        S::ReadDelta(reader, old_entities[b].state, entity.state);
+      } else {
+        throw SnapshotException("Changed entity is not in the baseline");
+      }
+      b += in_baseline ? 1 : 0;
+      decoded.entities.push_back(entity);
+    }
+    copy_until(uint64_t{UINT32_MAX} + 1);
+
+    std::size_t slot = sequence % history.size();
+    std::swap(history[slot], decoded);
+    valid[slot] = true;
+    return history[slot];
+  }
+
+private:
+  std::vector<Snapshot<State>> history;
+  std::vector<bool> valid = std::vector<bool>(history.size(), false);
+  Snapshot<State> decoded;
+  std::vector<uint32_t> removed;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_NET_SNAPSHOT_H
@@ -0,0 +1,323 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the non-blocking TCP and UDP socket classes.
+ */
+
+#ifndef SDLXX_NET_SOCKET_H
+#define SDLXX_NET_SOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "sdlxx/core/exception.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for Socket-related exceptions.
+ */
+class SocketException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A structure that represents an IPv4 address and a port in host byte order.
+ */
+struct Address {
+  uint32_t host = 0;  ///< The IPv4 address, 0x7F000001 for 127.0.0.1
+  uint16_t port = 0;  ///< The port, 0 to let the system choose one when binding
+
+  /**
+   * \brief Construct the address 0.0.0.0:0.
+   */
+  constexpr Address() = default;
+
+  /**
+   * \brief Construct an address from a host and a port.
+   */
+  constexpr Address(uint32_t host, uint16_t port) : host(host), port(port) {}
+
+  /**
+   * \brief Get the address that binds to all network interfaces.
+   */
+  static constexpr Address Any(uint16_t port) { return {0, port}; }
+
+  /**
+   * \brief Get the loopback address 127.0.0.1.
+   */
+  static constexpr Address Loopback(uint16_t port) { return {0x7F000001U, port}; }
+
+  /**
+   * \brief Resolve a host name or a dotted IPv4 address.
+   *
+   * This call blocks until the name is resolved.
+   *
+   * \throw SocketException if the name can not be resolved.
+   */
+  static Address Resolve(const std::string& host, uint16_t port);
+
+  /**
+   * \brief Get the string representation of the address, such as "127.0.0.1:8080".
+   */
+  std::string ToString() const;
+
+  constexpr bool operator==(const Address& other) const {
+    return host == other.host && port == other.port;
+  }
+
+  constexpr bool operator!=(const Address& other) const { return !(*this == other); }
+};
+
+/**
+ * \brief A class that owns a non-blocking socket and closes it on destruction.
+ *
+ * Operations that would block return std::nullopt or false instead, so that sockets can be
+ * driven by a Reactor from a single thread. Sockets are only supported on POSIX systems.
+ */
+class Socket {
+public:
+  /// The type of native socket handles
+  using Handle = int;
+
+  /// The handle of a closed socket
+  static constexpr Handle INVALID_HANDLE = -1;
+
+  /**
+   * \brief Construct a closed socket.
+   */
+  Socket() = default;
+
+  /**
+   * \brief Take the ownership of a native socket and make it non-blocking.
+   *
+   * \throw SocketException if the socket can not be made non-blocking.
+   */
+  explicit Socket(Handle handle);
+
+  /**
+   * \brief Close the socket.
+   */
+  virtual ~Socket();
+
+  // Deleted copy constructor
+  Socket(const Socket&) = delete;
+
+  // Deleted copy assignment operator
+  Socket& operator=(const Socket&) = delete;
+
+  Socket(Socket&& other) noexcept;
+
+  Socket& operator=(Socket&& other) noexcept;
+
+  /**
+   * \brief Get the native handle of the socket.
+   */
+  Handle GetHandle() const { return handle; }
+
+  /**
+   * \brief Check whether the socket is open.
+   */
+  bool IsOpen() const { return handle != INVALID_HANDLE; }
+
+  /**
+   * \brief Close the socket, if it is open.
+   */
+  void Close();
+
+  /**
+   * \brief Release the ownership of the native socket.
+   */
+  Handle Release();
+
+  /**
+   * \brief Get the address the socket is bound to.
+   *
+   * \throw SocketException on failure.
+   */
+  Address GetLocalAddress() const;
+
+protected:
+  Handle handle = INVALID_HANDLE;
+};
+
+/**
+ * \brief A class that represents a TCP connection.
+ */
+class TcpSocket : public Socket {
+public:
+  using Socket::Socket;
+
+  /**
+   * \brief Start connecting to an address.
+   *
+   * The connection is established in the background. The socket becomes writable when the
+   * attempt is finished, and GetError() tells whether it succeeded.
+   *
+   * \throw SocketException if the attempt can not be started.
+   */
+  static TcpSocket Connect(const Address& address);
+
+  /**
+   * \brief Send data.
+   *
+   * \return The number of bytes sent, which can be less than the size, or std::nullopt if the
+   *         send buffer is full.
+   *
+   * \throw SocketException if the connection is broken.
+   */
+  std::optional<std::size_t> Send(const void* data, std::size_t size);
+
+  /**
+   * \brief Send several buffers with one system call, without joining them first.
+   *
+   * At most 64 buffers are sent by one call.
+   *
+   * \return The total number of bytes sent, which can end in the middle of any buffer, or
+   *         std::nullopt if the send buffer is full.
+   *
+   * \throw SocketException if the connection is broken.
+   */
+  std::optional<std::size_t> Send(const std::string_view* buffers, std::size_t count);
+
+  /**
+   * \brief Receive available data.
+   *
+   * \return The number of bytes received, 0 if the peer closed or reset the connection, or
+   *         std::nullopt if no data is available.
+   *
+   * \throw SocketException on other failures.
+   */
+  std::optional<std::size_t> Receive(void* data, std::size_t size);
+
+  /**
+   * \brief Close the sending side of the connection after the sent data is delivered.
+   */
+  void ShutdownWrite();
+
+  /**
+   * \brief Enable or disable the Nagle algorithm that combines small writes.
+   *
+   * \param enabled true to send small writes immediately.
+   */
+  void SetNoDelay(bool enabled);
+
+  /**
+   * \brief Get and clear the pending error of the socket, such as a failed connection attempt.
+   *
+   * \return The errno value, or 0 if there is no error.
+   */
+  int GetError() const;
+
+  /**
+   * \brief Get the address of the peer.
+   *
+   * \throw SocketException if the socket is not connected.
+   */
+  Address GetPeerAddress() const;
+};
+
+/**
+ * \brief A class that accepts TCP connections.
+ */
+class TcpListener : public Socket {
+public:
+  /**
+   * \brief Construct a closed listener.
+   */
+  TcpListener() = default;
+
+  /**
+   * \brief Bind a socket to an address and start listening for connections.
+   *
+   * \param address The address to bind to. Port 0 picks a free port, which can be found with
+   *                GetLocalAddress().
+   * \param backlog The maximum number of connections waiting to be accepted.
+   *
+   * \throw SocketException on failure.
+   */
+  explicit TcpListener(const Address& address, int backlog = 1024);
+
+  /**
+   * \brief Accept a pending connection.
+   *
+   * Accepted connections send small writes immediately, see TcpSocket::SetNoDelay().
+   *
+   * \param peer The address of the peer is written here, if not null.
+   *
+   * \return The non-blocking connection, or std::nullopt if no connection is pending.
+   *
+   * \throw SocketException on failure.
+   */
+  std::optional<TcpSocket> Accept(Address* peer = nullptr);
+};
+
+/**
+ * \brief A class that sends and receives UDP datagrams.
+ */
+class UdpSocket : public Socket {
+public:
+  /**
+   * \brief Construct a closed socket.
+   */
+  UdpSocket() = default;
+
+  /**
+   * \brief Open a socket bound to an address.
+   *
+   * \param address The address to bind to. Port 0 lets the system choose a port.
+   *
+   * \throw SocketException on failure.
+   */
+  explicit UdpSocket(const Address& address);
+
+  /**
+   * \brief Send a datagram.
+   *
+   * \return false if the send buffer is full and the datagram was not sent.
+   *
+   * \throw SocketException on failure.
+   */
+  bool SendTo(const void* data, std::size_t size, const Address& address);
+
+  /**
+   * \brief Receive a datagram.
+   *
+   * A datagram larger than the buffer is truncated.
+   *
+   * \param sender The address of the sender is written here, if not null.
+   *
+   * \return The size of the datagram, or std::nullopt if no datagram is available.
+   *
+   * \throw SocketException on failure.
+   */
+  std::optional<std::size_t> ReceiveFrom(void* data, std::size_t size, Address* sender = nullptr);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_NET_SOCKET_H
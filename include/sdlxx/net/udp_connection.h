@@ -0,0 +1,282 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the UdpConnection class that delivers messages over UDP on channels.
+ */
+
+#ifndef SDLXX_NET_UDP_CONNECTION_H
+#define SDLXX_NET_UDP_CONNECTION_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/time.h"
+
+namespace sdlxx {
+
+/**
+ * \brief A class for UdpConnection-related exceptions.
+ */
+class UdpConnectionException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief An enumeration of delivery guarantees of a channel.
+ */
+enum class Delivery {
+  UNRELIABLE,            ///< Messages may be lost, duplicated packets are dropped
+  UNRELIABLE_SEQUENCED,  ///< Messages may be lost, and older messages than the last are dropped
+  RELIABLE_ORDERED       ///< All messages arrive in the order they were sent
+};
+
+/**
+ * \brief A class that sends messages over an unreliable datagram transport, such as UDP.
+ *
+ * Every channel has its own delivery guarantee, so that lost position updates on an
+ * unreliable channel do not delay reliable events on another one. The connection does no
+ * input or output itself: it gives packets to a sender function and takes received packets
+ * from the caller, so it works with a UdpSocket, a NetworkSimulator or both.
+ *
+ * Every packet carries a sequence number and acknowledges the last 33 received packets with a
+ * sequence and a bitfield, so a single lost acknowledgement does not cause a resend. Packets sent
+ * before anything was received are marked as carrying no acknowledgements. Round-trip times are
+ * measured from acknowledged packets as in RFC 6298, and reliable messages are sent again when
+ * their packet is not acknowledged within the retransmission timeout.
+ *
+ * Messages queued between calls to Update() are coalesced into packets of at most the MTU.
+ * Larger messages are split into fragments, which are resent individually on reliable channels
+ * and reassembled by the receiver.
+ *
+ * \code
+ * UdpConnection connection({Delivery::UNRELIABLE_SEQUENCED, Delivery::RELIABLE_ORDERED},
+ *                          [&](const uint8_t* data, std::size_t size) {
+ *                            socket.SendTo(data, size, peer);
+ *                          });
+ * connection.Send(1, "chat message");
+ * // Every frame
+ * while (std::optional<std::size_t> size = socket.ReceiveFrom(buffer, sizeof(buffer))) {
+ *   connection.ReceivePacket(buffer, *size, now);
+ * }
+ * while (std::optional<UdpConnection::Message> message = connection.Receive()) {
+ *   // Handle message->data
+ * }
+ * connection.Update(now);
+ * \endcode
+ */
+class UdpConnection {
+public:
+  /// A function that sends a packet to the peer
+  using PacketSender = std::function<void(const uint8_t* data, std::size_t size)>;
+
+  /// The default maximum packet size, which fits in the MTU of almost all networks
+  static constexpr std::size_t DEFAULT_MTU = 1200;
+
+  /// The largest supported packet size, limited by the 15-bit size field of a message
+  static constexpr std::size_t MAX_MTU = 32768;
+
+  /// The maximum number of fragments of a message
+  static constexpr std::size_t MAX_FRAGMENTS = 255;
+
+  /**
+   * \brief A received message.
+   */
+  struct Message {
+    std::size_t channel;  ///< The index of the channel
+    std::string data;     ///< The contents of the message
+  };
+
+  /**
+   * \brief Counters of the connection.
+   */
+  struct Statistics {
+    uint64_t packets_sent = 0;      ///< Packets given to the sender
+    uint64_t packets_received = 0;  ///< Valid packets received, excluding duplicates
+    uint64_t packets_acked = 0;     ///< Sent packets that the peer acknowledged
+    uint64_t packets_lost = 0;      ///< Sent packets that were not acknowledged in time
+    uint64_t bytes_sent = 0;        ///< Bytes of all packets sent
+    uint64_t resent_fragments = 0;  ///< Reliable fragments sent more than once
+  };
+
+  /**
+   * \brief Construct a connection.
+   *
+   * \param channels The delivery guarantee of every channel. Both peers must use the same.
+   * \param sender   The function that sends packets.
+   * \param mtu      The maximum size of a packet.
+   *
+   * \throw UdpConnectionException if there are no channels or more than 256, or the MTU is
+   *        less than 64 bytes or more than MAX_MTU.
+   */
+  UdpConnection(std::vector<Delivery> channels, PacketSender sender,
+                std::size_t mtu = DEFAULT_MTU);
+
+  /**
+   * \brief Queue a message, which is sent by the next Update().
+   *
+   * \throw UdpConnectionException if the channel does not exist or the message needs more than
+   *        MAX_FRAGMENTS fragments.
+   */
+  void Send(std::size_t channel, std::string_view message);
+
+  /**
+   * \brief Process a packet received from the peer.
+   *
+   * Malformed and duplicated packets are ignored.
+   *
+   * \param now The current time, used to measure round trips.
+   */
+  void ReceivePacket(const void* data, std::size_t size, Time now);
+
+  /**
+   * \brief Take the next received message, in order of arrival across the channels.
+   */
+  std::optional<Message> Receive();
+
+  /**
+   * \brief Send queued messages, resend unacknowledged reliable messages and acknowledge
+   *        received packets.
+   *
+   * \param now The current time, which must not decrease between calls.
+   */
+  void Update(Time now);
+
+  /**
+   * \brief Get the smoothed round-trip time.
+   */
+  Time GetRoundTripTime() const { return Time::Microseconds(smoothed_rtt); }
+
+  /**
+   * \brief Get the time after which an unacknowledged reliable message is sent again.
+   */
+  Time GetRetransmissionTimeout() const { return Time::Microseconds(rto); }
+
+  /**
+   * \brief Get the counters of the connection.
+   */
+  const Statistics& GetStatistics() const { return statistics; }
+
+  /**
+   * \brief Check whether reliable messages are waiting to be sent or acknowledged.
+   */
+  bool HasPendingReliable() const;
+
+private:
+  /// The number of sent packets remembered for acknowledgements
+  static constexpr std::size_t SENT_PACKETS = 1024;
+
+  /// The number of reliable messages that can be sent before the oldest is acknowledged
+  static constexpr uint32_t RELIABLE_WINDOW = 256;
+
+  /// A message or a fragment of one, as queued for sending
+  struct Fragment {
+    uint32_t sequence;
+    uint8_t index;
+    uint8_t count;
+    std::string data;
+    int64_t last_sent = -1;
+  };
+
+  /// A message being reassembled from fragments
+  struct Assembly {
+    std::vector<std::string> fragments;
+    std::bitset<MAX_FRAGMENTS> present;
+    std::size_t received = 0;
+  };
+
+  struct Channel {
+    Delivery delivery;
+    uint32_t next_sequence = 0;
+    /// Unreliable fragments waiting for the next Update()
+    std::deque<Fragment> queued;
+    /// Reliable fragments by sequence and index, until they are acknowledged
+    std::map<uint64_t, Fragment> unacked;
+    /// The oldest sequence that may be delivered next or, for sequenced channels, the newest
+    /// delivered sequence plus one
+    uint32_t receive_sequence = 0;
+    std::map<uint32_t, Assembly> assemblies;
+  };
+
+  struct SentPacket {
+    uint16_t sequence = 0;
+    bool valid = false;
+    bool acked = false;
+    int64_t time = 0;
+    /// Reliable fragments carried by the packet, as channel and unacked key
+    std::vector<std::pair<uint8_t, uint64_t>> fragments;
+  };
+
+  std::vector<Channel> channels;
+  PacketSender sender;
+  std::size_t mtu;
+
+  uint16_t local_sequence = 0;
+  std::vector<SentPacket> sent_packets;
+  /// The oldest sent packet that is not known to be acknowledged or lost
+  uint16_t loss_sequence = 0;
+
+  uint16_t remote_sequence = 0;
+  uint32_t received_bits = 0;
+  bool received_any = false;
+  bool ack_pending = false;
+
+  int64_t smoothed_rtt = 0;
+  int64_t rtt_variance = 0;
+  int64_t rto = 0;
+  bool has_rtt_sample = false;
+
+  std::deque<Message> received;
+  Statistics statistics;
+  std::vector<uint8_t> packet;
+
+  void ProcessAcks(uint16_t ack, uint32_t ack_bits, int64_t now);
+
+  void OnAcked(SentPacket& sent, int64_t now);
+
+  void ReceiveFragment(Channel& channel, std::size_t index, uint16_t sequence,
+                       uint8_t fragment_index, uint8_t fragment_count, std::string_view data);
+
+  void Deliver(std::size_t channel, std::string data);
+
+  void BeginPacket();
+
+  bool Fits(const Fragment& fragment) const;
+
+  void Append(std::size_t channel, const Fragment& fragment);
+
+  void FinishPacket(int64_t now, std::vector<std::pair<uint8_t, uint64_t>> fragments);
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_NET_UDP_CONNECTION_H
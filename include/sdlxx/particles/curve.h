@@ -0,0 +1,122 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the curves that describe particle properties over their lifetime.
+ */
+
+#ifndef SDLXX_PARTICLES_CURVE_H
+#define SDLXX_PARTICLES_CURVE_H
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+#include "sdlxx/core/color.h"
+
+namespace sdlxx {
+
+/// Number of samples of a baked curve
+constexpr std::size_t CURVE_SAMPLES = 64;
+
+/**
+ * \brief A piecewise linear function of the normalized age of a particle.
+ *
+ * The keys are baked into a table of CURVE_SAMPLES values when the curve is created, so the
+ * evaluation for every particle is a single table lookup.
+ */
+class Curve {
+public:
+  /**
+   * \brief Create a constant curve.
+   */
+  Curve(float value = 1.0F);  // NOLINT(google-explicit-constructor)
+
+  /**
+   * \brief Create a curve through keys.
+   *
+   * \param keys Pairs of an age in range [0, 1] and a value, in any order. The first and the
+   *             last value extend to the ends of the range.
+   */
+  Curve(std::initializer_list<std::pair<float, float>> keys);
+
+  /**
+   * \brief Get the value at an age in range [0, 1].
+   */
+  float Evaluate(float age) const { return table[GetIndex(age)]; }
+
+  /**
+   * \brief Get the table of values at ages i / (CURVE_SAMPLES - 1).
+   */
+  const std::array<float, CURVE_SAMPLES>& GetTable() const { return table; }
+
+  /**
+   * \brief Get the index of the table sample nearest to an age.
+   */
+  static std::size_t GetIndex(float age) {
+    float position = age * static_cast<float>(CURVE_SAMPLES - 1) + 0.5F;
+    return position <= 0.0F ? 0
+           : position >= static_cast<float>(CURVE_SAMPLES - 1)
+               ? CURVE_SAMPLES - 1
+               : static_cast<std::size_t>(position);
+  }
+
+private:
+  std::array<float, CURVE_SAMPLES> table;
+};
+
+/**
+ * \brief A piecewise linear color gradient over the normalized age of a particle.
+ *
+ * Like Curve, the gradient is baked into a table of CURVE_SAMPLES colors.
+ */
+class Gradient {
+public:
+  /**
+   * \brief Create a constant gradient.
+   */
+  Gradient(Color color = Color::WHITE);  // NOLINT(google-explicit-constructor)
+
+  /**
+   * \brief Create a gradient through keys of an age in range [0, 1] and a color.
+   */
+  Gradient(std::initializer_list<std::pair<float, Color>> keys);
+
+  /**
+   * \brief Get the color at an age in range [0, 1].
+   */
+  Color Evaluate(float age) const { return table[Curve::GetIndex(age)]; }
+
+  /**
+   * \brief Get the table of colors at ages i / (CURVE_SAMPLES - 1).
+   */
+  const std::array<Color, CURVE_SAMPLES>& GetTable() const { return table; }
+
+private:
+  std::array<Color, CURVE_SAMPLES> table;
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_PARTICLES_CURVE_H
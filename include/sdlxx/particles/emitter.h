@@ -0,0 +1,238 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the Emitter class that simulates and draws a group of particles.
+ */
+
+#ifndef SDLXX_PARTICLES_EMITTER_H
+#define SDLXX_PARTICLES_EMITTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sdlxx/core/exception.h"
+#include "sdlxx/core/rectangle.h"
+#include "sdlxx/core/renderer.h"
+#include "sdlxx/particles/curve.h"
+
+namespace sdlxx {
+
+class Texture;
+class ThreadPool;
+
+namespace GL {  // NOLINT(readability-identifier-naming)
+class Renderer;
+class Texture;
+}  // namespace GL
+
+/**
+ * \brief A class for particle-related exceptions.
+ */
+class ParticleException : public Exception {
+  using Exception::Exception;
+};
+
+/**
+ * \brief A structure that describes how an emitter spawns and moves its particles.
+ *
+ * Angles are in degrees, clockwise from the positive X axis, distances are in pixels and times
+ * are in seconds.
+ */
+struct EmitterSettings {
+  std::size_t capacity = 10000;  ///< The maximum number of live particles
+  float rate = 100.0F;           ///< Particles spawned per second while emitting
+  float life_min = 1.0F;         ///< The minimum lifetime of a particle
+  float life_max = 1.0F;         ///< The maximum lifetime of a particle
+  float direction = -90.0F;      ///< The direction of the initial velocity
+  float spread = 360.0F;         ///< The width of the cone of initial directions
+  float speed_min = 50.0F;       ///< The minimum initial speed
+  float speed_max = 100.0F;      ///< The maximum initial speed
+  float spawn_width = 0.0F;      ///< The width of the spawn area centered at the emitter
+  float spawn_height = 0.0F;     ///< The height of the spawn area centered at the emitter
+  float gravity_x = 0.0F;        ///< Horizontal acceleration
+  float gravity_y = 0.0F;        ///< Vertical acceleration
+  float drag = 0.0F;             ///< The fraction of the velocity that is lost per second
+  Curve size = 8.0F;             ///< The size of a particle over its life
+  Gradient color;                ///< The color of a particle over its life
+  Rectangle source;              ///< The rectangle of the particle image in the texture
+};
+
+/**
+ * \brief A class that simulates and draws a group of particles with the same settings.
+ *
+ * The particles are stored as a structure of arrays, so the integration step runs over
+ * contiguous floats with SIMD instructions, and can be split between the workers of a thread
+ * pool. Every particle is drawn as a quad, and the quads of an emitter are submitted to the
+ * renderer as a single batch.
+ */
+class Emitter {
+public:
+  /**
+   * \brief Create an emitter.
+   *
+   * \param settings The settings of the emitter.
+   * \param seed     The seed of the random generator of the emitter.
+   *
+   * \throw ParticleException if the settings are invalid.
+   */
+  explicit Emitter(const EmitterSettings& settings, uint32_t seed = 1);
+
+  /**
+   * \brief Get the settings of the emitter.
+   */
+  const EmitterSettings& GetSettings() const { return settings; }
+
+  /**
+   * \brief Set the position of the emitter.
+   *
+   * Already spawned particles are not moved.
+   */
+  void SetPosition(float x, float y);
+
+  /**
+   * \brief Start or stop spawning particles at the rate from the settings.
+   */
+  void SetEmitting(bool emitting);
+
+  /**
+   * \brief Check if the emitter spawns particles at the rate from the settings.
+   */
+  bool IsEmitting() const { return emitting; }
+
+  /**
+   * \brief Spawn a number of particles at once.
+   *
+   * Particles that do not fit into the capacity are dropped.
+   */
+  void Burst(std::size_t count);
+
+  /**
+   * \brief Advance the simulation.
+   *
+   * Moves and ages live particles, removes the dead ones and spawns new ones.
+   *
+   * \param delta The time step in seconds.
+   * \param pool  An optional thread pool to split the particles between.
+   */
+  void Update(float delta, ThreadPool* pool = nullptr);
+
+  /**
+   * \brief Draw the particles with a single call to Renderer::RenderGeometry().
+   *
+   * Falls back to a call per particle if the renderer does not support geometry. The fallback
+   * applies the color of each particle as the color and alpha modulation of the texture, and
+   * restores the modulation of the texture afterwards.
+   *
+   * \param renderer The renderer to draw with.
+   * \param texture  The texture of the particles, or nullptr to draw solid quads.
+   * \param pool     An optional thread pool to build the vertices with.
+   */
+  void Render(Renderer& renderer, Texture* texture, ThreadPool* pool = nullptr);
+
+  /**
+   * \brief Add the particles to the sprite batch of an OpenGL renderer.
+   *
+   * All particles share the texture, so the renderer draws them with a single instanced call.
+   *
+   * \param renderer The renderer to draw with.
+   * \param texture  The texture of the particles.
+   * \param layer    The layer of the texture.
+   */
+  void Render(GL::Renderer& renderer, const GL::Texture& texture, int layer = 0);
+
+  /**
+   * \brief Remove all particles.
+   */
+  void Clear();
+
+  /**
+   * \brief Get the number of live particles.
+   */
+  std::size_t GetCount() const { return count; }
+
+  /**
+   * \brief Get the number of particles dropped because the emitter was full.
+   */
+  std::size_t GetDroppedCount() const { return dropped; }
+
+  /**
+   * \brief Get the X coordinate of the center of a particle.
+   */
+  float GetX(std::size_t index) const { return x[index]; }
+
+  /**
+   * \brief Get the Y coordinate of the center of a particle.
+   */
+  float GetY(std::size_t index) const { return y[index]; }
+
+  /**
+   * \brief Get the size of a particle as of the last update.
+   */
+  float GetSize(std::size_t index) const { return size[index]; }
+
+  /**
+   * \brief Get the color of a particle as of the last update.
+   */
+  Color GetColor(std::size_t index) const { return color[index]; }
+
+private:
+  EmitterSettings settings;
+
+  // Simulation state, one element per particle
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> velocity_x;
+  std::vector<float> velocity_y;
+  std::vector<float> age;
+  std::vector<float> inverse_life;
+
+  // Appearance, evaluated from the curves during the update
+  std::vector<float> size;
+  std::vector<Color> color;
+
+  std::vector<Renderer::Vertex> vertices;
+  std::vector<int> indices;
+
+  std::size_t count = 0;
+  std::size_t dropped = 0;
+  float position_x = 0.0F;
+  float position_y = 0.0F;
+  float spawn_accumulator = 0.0F;
+  bool emitting = true;
+  uint32_t random_state;
+
+  void Spawn(std::size_t spawn_count);
+
+  void Simulate(std::size_t begin, std::size_t end, float delta);
+
+  void BuildVertices(std::size_t begin, std::size_t end, float inverse_width,
+                     float inverse_height);
+
+  float Random();
+};
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_PARTICLES_EMITTER_H
@@ -0,0 +1,38 @@
+/*
+  SDLXX - Modern C++ wrapper for Simple DirectMedia Layer (SDL2)
+
+  Copyright (C) 2019-2021 Egor Makarenko <egormkn@yandex.ru>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ * \file
+ * \brief Header for the constants that convert angles between degrees and radians.
+ */
+
+#ifndef SDLXX_CORE_UTILS_ANGLE_H
+#define SDLXX_CORE_UTILS_ANGLE_H
+
+namespace sdlxx {
+
+/// The number of radians in a degree. Angles in the API are in degrees, clockwise.
+constexpr float DEGREES_TO_RADIANS = 3.14159265358979323846F / 180.0F;
+
+}  // namespace sdlxx
+
+#endif  // SDLXX_CORE_UTILS_ANGLE_H
@@ -0,0 +1,25 @@
+#include "sdlxx/core/channel.h"
+
+#include <SDL_events.h>
+
+using namespace sdlxx;
+
+void ChannelWaker::Wake() {
+  if (pending.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  SDL_Event event{};
+  event.type = GetEventType();
+  event.user.data1 = this;
+  if (SDL_PushEvent(&event) < 0) {
+    // The SDL queue is full, so the main loop is awake anyway; allow a retry on the next push
+    pending.store(false, std::memory_order_release);
+  }
+}
+
+bool ChannelWaker::IsWakeEvent(const Event& event) { return event.type == GetEventType(); }
+
+uint32_t ChannelWaker::GetEventType() {
+  static const uint32_t type = Events::Register();
+  return type;
+}
@@ -0,0 +1,80 @@
+#include "sdlxx/core/event_batch.h"
+
+using namespace sdlxx;
+
+namespace {
+
+bool IsResizeEvent(const Event& event) {
+  return event.type == SDL_WINDOWEVENT && (event.window.event == SDL_WINDOWEVENT_RESIZED ||
+                                           event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED);
+}
+
+}  // namespace
+
+EventBatch::EventBatch(std::size_t capacity) : events(capacity > 0 ? capacity : 1) {}
+
+std::size_t EventBatch::Drain(bool coalesce) {
+  count = 0;
+  coalesced = 0;
+  Events::Pump();
+  while (true) {
+    auto free_space = static_cast<int>(events.size() - count);
+    int num_got = SDL_PeepEvents(events.data() + count, free_space, SDL_GETEVENT, SDL_FIRSTEVENT,
+                                 SDL_LASTEVENT);
+    if (num_got < 0) {
+      throw EventException("Failed to get events from the event queue");
+    }
+    count += static_cast<std::size_t>(num_got);
+    if (num_got < free_space) {
+      break;
+    }
+    // The buffer is full and there may be more events, so grow it geometrically
+    events.resize(events.size() * 2);
+  }
+  if (coalesce) {
+    Coalesce();
+  }
+  return count;
+}
+
+void EventBatch::Coalesce() {
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    const Event& event = events[i];
+    if (event.type == SDL_MOUSEMOTION && kept > 0) {
+      Event& last = events[kept - 1];
+      if (last.type == SDL_MOUSEMOTION && last.motion.windowID == event.motion.windowID &&
+          last.motion.which == event.motion.which && last.motion.state == event.motion.state) {
+        int32_t xrel = last.motion.xrel + event.motion.xrel;
+        int32_t yrel = last.motion.yrel + event.motion.yrel;
+        last.motion = event.motion;
+        last.motion.xrel = xrel;
+        last.motion.yrel = yrel;
+        ++coalesced;
+        continue;
+      }
+    }
+    if (IsResizeEvent(event)) {
+      // Look back through the run of resize events for the same window and kind of resize
+      bool merged = false;
+      for (std::size_t j = kept; j > 0 && IsResizeEvent(events[j - 1]); --j) {
+        Event& previous = events[j - 1];
+        if (previous.window.windowID == event.window.windowID &&
+            previous.window.event == event.window.event) {
+          previous.window = event.window;
+          merged = true;
+          break;
+        }
+      }
+      if (merged) {
+        ++coalesced;
+        continue;
+      }
+    }
+    if (kept != i) {
+      events[kept] = event;
+    }
+    ++kept;
+  }
+  count = kept;
+}
@@ -25,24 +25,32 @@ int Events::Add(std::vector<Event> events) {
 
 std::vector<Event> Events::Peek(int numevents, Type min_type, Type max_type) {
   std::vector<Event> events(numevents);
-  int num_peeked = SDL_PeepEvents(events.data(), events.size(), SDL_PEEKEVENT,
-                                  static_cast<Uint32>(min_type), static_cast<Uint32>(max_type));
+  events.resize(Peek(events.data(), numevents, min_type, max_type));
+  return events;
+}
+
+int Events::Peek(Event* events, int numevents, Type min_type, Type max_type) {
+  int num_peeked = SDL_PeepEvents(events, numevents, SDL_PEEKEVENT, static_cast<Uint32>(min_type),
+                                  static_cast<Uint32>(max_type));
   if (num_peeked < 0) {
     throw EventException("Failed to peek events from the event queue");
   }
-  events.resize(num_peeked);
-  return events;
+  return num_peeked;
 }
 
 std::vector<Event> Events::Get(int numevents, Type min_type, Type max_type) {
   std::vector<Event> events(numevents);
-  int num_got = SDL_PeepEvents(events.data(), events.size(), SDL_GETEVENT,
-                               static_cast<Uint32>(min_type), static_cast<Uint32>(max_type));
+  events.resize(Get(events.data(), numevents, min_type, max_type));
+  return events;
+}
+
+int Events::Get(Event* events, int numevents, Type min_type, Type max_type) {
+  int num_got = SDL_PeepEvents(events, numevents, SDL_GETEVENT, static_cast<Uint32>(min_type),
+                               static_cast<Uint32>(max_type));
   if (num_got < 0) {
-    throw EventException("Failed to geek events from the event queue");
+    throw EventException("Failed to get events from the event queue");
   }
-  events.resize(num_got);
-  return events;
+  return num_got;
 }
 
 bool Events::InQueue(Type type) { return SDL_HasEvent(static_cast<Uint32>(type)) == SDL_TRUE; }
@@ -84,3 +92,11 @@ bool Events::Push(SDL_Event* event) {
   }
   return return_code != 0;
 }
+
+uint32_t Events::Register(int numevents) {
+  Uint32 type = SDL_RegisterEvents(numevents);
+  if (type == static_cast<Uint32>(-1)) {
+    throw EventException("Failed to register user-defined events");
+  }
+  return type;
+}
@@ -0,0 +1,147 @@
+#include "sdlxx/core/gl_effects.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace sdlxx;
+
+namespace {
+
+const char* const COLOR_GRADING_SHADER = R"(
+layout(std140) uniform Parameters {
+  vec4 u_adjust;  // brightness, contrast, saturation, gamma
+  vec4 u_tint;
+};
+void main() {
+  vec4 color = texture(u_input0, v_texcoord);
+  vec3 rgb = color.rgb * u_tint.rgb + u_adjust.x;
+  rgb = (rgb - 0.5) * u_adjust.y + 0.5;
+  float luma = dot(rgb, vec3(0.2126, 0.7152, 0.0722));
+  rgb = mix(vec3(luma), rgb, u_adjust.z);
+  rgb = pow(clamp(rgb, 0.0, 1.0), vec3(1.0 / u_adjust.w));
+  fragment_color = vec4(rgb, color.a * u_tint.a);
+}
+)";
+
+const char* const CRT_SHADER = R"(
+layout(std140) uniform Parameters {
+  vec4 u_crt;  // curvature, scanlines, vignette, aberration
+};
+void main() {
+  vec2 centered = v_texcoord * 2.0 - 1.0;
+  centered *= 1.0 + u_crt.x * dot(centered, centered) * 0.25;
+  vec2 texcoord = centered * 0.5 + 0.5;
+  if (any(lessThan(texcoord, vec2(0.0))) || any(greaterThan(texcoord, vec2(1.0)))) {
+    fragment_color = vec4(0.0, 0.0, 0.0, 1.0);
+    return;
+  }
+  vec2 shift = vec2(u_crt.w * u_input_size.z, 0.0);
+  vec4 color = texture(u_input0, texcoord);
+  color.r = texture(u_input0, texcoord + shift).r;
+  color.b = texture(u_input0, texcoord - shift).b;
+  float scanline = 1.0 - u_crt.y * (0.5 - 0.5 * cos(gl_FragCoord.y * 3.14159265));
+  float vignette = 1.0 - u_crt.z * dot(centered, centered) * 0.5;
+  fragment_color = vec4(color.rgb * scanline * clamp(vignette, 0.0, 1.0), color.a);
+}
+)";
+
+const char* const BLOOM_THRESHOLD_SHADER = R"(
+layout(std140) uniform Parameters {
+  vec4 u_bloom;  // threshold, intensity, spread
+};
+void main() {
+  // Four bilinear taps average the 4x4 input pixels under each output pixel
+  vec2 texel = u_input_size.zw;
+  vec3 rgb = 0.25 * (texture(u_input0, v_texcoord + vec2(-texel.x, -texel.y)).rgb +
+                     texture(u_input0, v_texcoord + vec2(texel.x, -texel.y)).rgb +
+                     texture(u_input0, v_texcoord + vec2(-texel.x, texel.y)).rgb +
+                     texture(u_input0, v_texcoord + vec2(texel.x, texel.y)).rgb);
+  float luma = dot(rgb, vec3(0.2126, 0.7152, 0.0722));
+  fragment_color = vec4(rgb * (max(luma - u_bloom.x, 0.0) / max(luma, 1e-4)), 1.0);
+}
+)";
+
+// A 9-tap Gaussian blur in 5 bilinear taps, the direction is prepended to the source
+const char* const BLOOM_BLUR_SHADER = R"(
+layout(std140) uniform Parameters {
+  vec4 u_bloom;  // threshold, intensity, spread
+};
+void main() {
+  vec2 offset = DIRECTION * u_input_size.zw * u_bloom.z;
+  vec3 sum = texture(u_input0, v_texcoord).rgb * 0.2270270270;
+  sum += texture(u_input0, v_texcoord + offset * 1.3846153846).rgb * 0.3162162162;
+  sum += texture(u_input0, v_texcoord - offset * 1.3846153846).rgb * 0.3162162162;
+  sum += texture(u_input0, v_texcoord + offset * 3.2307692308).rgb * 0.0702702703;
+  sum += texture(u_input0, v_texcoord - offset * 3.2307692308).rgb * 0.0702702703;
+  fragment_color = vec4(sum, 1.0);
+}
+)";
+
+const char* const BLOOM_COMBINE_SHADER = R"(
+layout(std140) uniform Parameters {
+  vec4 u_bloom;  // threshold, intensity, spread
+};
+void main() {
+  vec4 color = texture(u_input0, v_texcoord);
+  vec3 glow = texture(u_input1, v_texcoord).rgb * u_bloom.y;
+  fragment_color = vec4(min(color.rgb + glow, 1.0), color.a);
+}
+)";
+
+// Layout of the Parameters block of the bloom shaders
+struct BloomBlock {
+  float threshold;
+  float intensity;
+  float spread;
+  float padding;
+};
+
+std::string BlurShader(const char* direction) {
+  return std::string("const vec2 DIRECTION = vec2(") + direction + ");\n" + BLOOM_BLUR_SHADER;
+}
+
+}  // namespace
+
+static_assert(sizeof(GL::ColorGradingSettings) == 32, "Settings must match the std140 block");
+static_assert(sizeof(GL::CrtSettings) == 16, "Settings must match the std140 block");
+
+GL::ColorGrading::ColorGrading(PostProcessor& processor, const ColorGradingSettings& settings)
+    : ShaderEffect(processor, COLOR_GRADING_SHADER, sizeof(ColorGradingSettings)) {
+  SetSettings(settings);
+}
+
+GL::CrtEffect::CrtEffect(PostProcessor& processor, const CrtSettings& settings)
+    : ShaderEffect(processor, CRT_SHADER, sizeof(CrtSettings)) {
+  SetSettings(settings);
+}
+
+GL::Bloom::Bloom(PostProcessor& processor, const BloomSettings& settings)
+    : threshold_program(processor.GetProgram(BLOOM_THRESHOLD_SHADER)),
+      horizontal_program(processor.GetProgram(BlurShader("1.0, 0.0"))),
+      vertical_program(processor.GetProgram(BlurShader("0.0, 1.0"))),
+      combine_program(processor.GetProgram(BLOOM_COMBINE_SHADER)),
+      parameters(processor.GetRenderer().GetFunctions(), sizeof(BloomBlock)) {
+  SetSettings(settings);
+}
+
+void GL::Bloom::SetSettings(const BloomSettings& settings) {
+  parameters.Update(BloomBlock{settings.threshold, settings.intensity, settings.spread, 0.0F});
+  iterations = std::max(settings.iterations, 0);
+}
+
+void GL::Bloom::Apply(PostProcessor& processor, const RenderTarget& input, RenderTarget* output) {
+  Dimensions size = input.GetSize();
+  Dimensions half{std::max(size.width / 2, 1), std::max(size.height / 2, 1)};
+  RenderTarget* glow = &processor.AcquireTarget(half);
+  processor.DrawPass(threshold_program, {&input}, glow, &parameters);
+  for (int i = 0; i < iterations; ++i) {
+    RenderTarget& horizontal = processor.AcquireTarget(half);
+    processor.DrawPass(horizontal_program, {glow}, &horizontal, &parameters);
+    processor.ReleaseTarget(*glow);
+    glow = &processor.AcquireTarget(half);
+    processor.DrawPass(vertical_program, {&horizontal}, glow, &parameters);
+    processor.ReleaseTarget(horizontal);
+  }
+  processor.DrawPass(combine_program, {&input, glow}, output, &parameters);
+  processor.ReleaseTarget(*glow);
+}
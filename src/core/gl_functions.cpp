@@ -0,0 +1,173 @@
+#include "sdlxx/core/gl_functions.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "sdlxx/core/gl.h"
+
+using namespace sdlxx;
+
+namespace {
+
+template <typename Function>
+void Load(Function& function, const char* name) {
+  function = reinterpret_cast<Function>(GL::GetProcAddress(name));
+  if (function == nullptr) {
+    throw GlException(std::string("Failed to load OpenGL function ") + name);
+  }
+}
+
+GLuint CompileShader(const GL::Functions& gl, GLenum type, const char* source) {
+  const char* header = gl.es ? "#version 300 es\nprecision highp float;\n"
+                               "precision mediump sampler2DArray;\n"
+                             : "#version 330 core\n";
+  const char* sources[] = {header, source};
+  GLuint shader = gl.CreateShader(type);
+  gl.ShaderSource(shader, 2, sources, nullptr);
+  gl.CompileShader(shader);
+  GLint status = GL_FALSE;
+  gl.GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[1024] = {};
+    gl.GetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    gl.DeleteShader(shader);
+    throw GlException(std::string("Failed to compile shader: ") + log);
+  }
+  return shader;
+}
+
+}  // namespace
+
+GL::Functions::Functions() {
+  Load(GetString, "glGetString");
+  const auto* version = reinterpret_cast<const char*>(GetString(GL_VERSION));
+  if (version == nullptr) {
+    throw GlException("No current OpenGL context");
+  }
+  const char* es_prefix = "OpenGL ES ";
+  es = std::strncmp(version, es_prefix, std::strlen(es_prefix)) == 0;
+  if (std::sscanf(es ? version + std::strlen(es_prefix) : version, "%d.%d", &major_version,
+                  &minor_version) != 2) {
+    throw GlException(std::string("Unknown OpenGL version: ") + version);
+  }
+  int version_number = major_version * 10 + minor_version;
+  if (version_number < (es ? 30 : 33)) {
+    throw GlException(std::string("OpenGL 3.3 or OpenGL ES 3.0 is required, got ") + version);
+  }
+
+  Load(BindTexture, "glBindTexture");
+  Load(Clear, "glClear");
+  Load(ClearColor, "glClearColor");
+  Load(DeleteTextures, "glDeleteTextures");
+  Load(Disable, "glDisable");
+  Load(DrawArrays, "glDrawArrays");
+  Load(Enable, "glEnable");
+  Load(Finish, "glFinish");
+  Load(GenTextures, "glGenTextures");
+  Load(GetError, "glGetError");
+  Load(GetIntegerv, "glGetIntegerv");
+  Load(PixelStorei, "glPixelStorei");
+  Load(ReadPixels, "glReadPixels");
+  Load(Scissor, "glScissor");
+  Load(TexImage2D, "glTexImage2D");
+  Load(TexParameteri, "glTexParameteri");
+  Load(Viewport, "glViewport");
+
+  Load(ActiveTexture, "glActiveTexture");
+  Load(AttachShader, "glAttachShader");
+  Load(BindBuffer, "glBindBuffer");
+  Load(BindBufferBase, "glBindBufferBase");
+  Load(BindFramebuffer, "glBindFramebuffer");
+  Load(BindVertexArray, "glBindVertexArray");
+  Load(BlendEquation, "glBlendEquation");
+  Load(BlendFuncSeparate, "glBlendFuncSeparate");
+  Load(BufferData, "glBufferData");
+  Load(BufferSubData, "glBufferSubData");
+  Load(CheckFramebufferStatus, "glCheckFramebufferStatus");
+  Load(ClientWaitSync, "glClientWaitSync");
+  Load(CompileShader, "glCompileShader");
+  Load(CreateProgram, "glCreateProgram");
+  Load(CreateShader, "glCreateShader");
+  Load(DeleteBuffers, "glDeleteBuffers");
+  Load(DeleteFramebuffers, "glDeleteFramebuffers");
+  Load(DeleteProgram, "glDeleteProgram");
+  Load(DeleteShader, "glDeleteShader");
+  Load(DeleteSync, "glDeleteSync");
+  Load(DeleteVertexArrays, "glDeleteVertexArrays");
+  Load(DrawArraysInstanced, "glDrawArraysInstanced");
+  Load(EnableVertexAttribArray, "glEnableVertexAttribArray");
+  Load(FenceSync, "glFenceSync");
+  Load(FramebufferTexture2D, "glFramebufferTexture2D");
+  Load(GenBuffers, "glGenBuffers");
+  Load(GenFramebuffers, "glGenFramebuffers");
+  Load(GenVertexArrays, "glGenVertexArrays");
+  Load(GetProgramInfoLog, "glGetProgramInfoLog");
+  Load(GetProgramiv, "glGetProgramiv");
+  Load(GetShaderInfoLog, "glGetShaderInfoLog");
+  Load(GetShaderiv, "glGetShaderiv");
+  Load(GetStringi, "glGetStringi");
+  Load(GetUniformBlockIndex, "glGetUniformBlockIndex");
+  Load(GetUniformLocation, "glGetUniformLocation");
+  Load(LinkProgram, "glLinkProgram");
+  Load(MapBufferRange, "glMapBufferRange");
+  Load(ShaderSource, "glShaderSource");
+  Load(TexImage3D, "glTexImage3D");
+  Load(TexSubImage3D, "glTexSubImage3D");
+  Load(Uniform1i, "glUniform1i");
+  Load(Uniform2f, "glUniform2f");
+  Load(UniformBlockBinding, "glUniformBlockBinding");
+  Load(UnmapBuffer, "glUnmapBuffer");
+  Load(UseProgram, "glUseProgram");
+  Load(VertexAttribDivisor, "glVertexAttribDivisor");
+  Load(VertexAttribPointer, "glVertexAttribPointer");
+
+  // Persistent mapping is core in OpenGL 4.4 and an extension before that and on OpenGL ES
+  if (!es && (version_number >= 44 || HasExtension("GL_ARB_buffer_storage"))) {
+    BufferStorage = reinterpret_cast<PFNGLBUFFERSTORAGEPROC>(GL::GetProcAddress("glBufferStorage"));
+  } else if (es && HasExtension("GL_EXT_buffer_storage")) {
+    BufferStorage =
+        reinterpret_cast<PFNGLBUFFERSTORAGEPROC>(GL::GetProcAddress("glBufferStorageEXT"));
+  }
+  buffer_storage = BufferStorage != nullptr;
+}
+
+bool GL::Functions::HasExtension(const char* extension) const {
+  GLint count = 0;
+  GetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; ++i) {
+    const auto* name = reinterpret_cast<const char*>(GetStringi(GL_EXTENSIONS, i));
+    if (name != nullptr && std::strcmp(name, extension) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+GLuint GL::CreateProgram(const Functions& gl, const char* vertex_source,
+                         const char* fragment_source) {
+  GLuint vertex_shader = CompileShader(gl, GL_VERTEX_SHADER, vertex_source);
+  GLuint fragment_shader = 0;
+  try {
+    fragment_shader = CompileShader(gl, GL_FRAGMENT_SHADER, fragment_source);
+  } catch (...) {
+    gl.DeleteShader(vertex_shader);
+    throw;
+  }
+  GLuint program = gl.CreateProgram();
+  gl.AttachShader(program, vertex_shader);
+  gl.AttachShader(program, fragment_shader);
+  gl.LinkProgram(program);
+  // Shaders are only flagged for deletion while they are attached to the program
+  gl.DeleteShader(vertex_shader);
+  gl.DeleteShader(fragment_shader);
+  GLint status = GL_FALSE;
+  gl.GetProgramiv(program, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[1024] = {};
+    gl.GetProgramInfoLog(program, sizeof(log), nullptr, log);
+    gl.DeleteProgram(program);
+    throw GlException(std::string("Failed to link shader program: ") + log);
+  }
+  return program;
+}
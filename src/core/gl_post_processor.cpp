@@ -0,0 +1,261 @@
+#include "sdlxx/core/gl_post_processor.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace sdlxx;
+
+namespace {
+
+// Uniform block binding points shared by all post-processing programs
+constexpr GLuint FRAME_BINDING = 0;
+constexpr GLuint PARAMETERS_BINDING = 1;
+constexpr int MAX_INPUTS = 4;
+
+// A triangle that covers the viewport, with texture coordinates from 0 to 1 over the viewport
+const char* const FULLSCREEN_VERTEX_SHADER = R"(
+out vec2 v_texcoord;
+void main() {
+  vec2 position = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+  v_texcoord = position;
+  gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+const char* const FRAGMENT_PRELUDE = R"(
+in vec2 v_texcoord;
+out vec4 fragment_color;
+uniform sampler2D u_input0;
+uniform sampler2D u_input1;
+uniform sampler2D u_input2;
+uniform sampler2D u_input3;
+layout(std140) uniform Frame {
+  vec4 u_output_size;
+  vec4 u_input_size;
+  float u_time;
+};
+)";
+
+const char* const COPY_SHADER = R"(
+void main() {
+  fragment_color = texture(u_input0, v_texcoord);
+}
+)";
+
+}  // namespace
+
+GL::UniformBuffer::UniformBuffer(const Functions& gl, std::size_t size) : gl(gl), size(size) {
+  std::vector<uint8_t> zeros(size);
+  gl.GenBuffers(1, &buffer);
+  gl.BindBuffer(GL_UNIFORM_BUFFER, buffer);
+  gl.BufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), zeros.data(), GL_DYNAMIC_DRAW);
+}
+
+GL::UniformBuffer::~UniformBuffer() { gl.DeleteBuffers(1, &buffer); }
+
+void GL::UniformBuffer::Update(const void* data, std::size_t size) {
+  if (size > this->size) {
+    throw GlException("Uniform data is larger than the buffer");
+  }
+  gl.BindBuffer(GL_UNIFORM_BUFFER, buffer);
+  gl.BufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+}
+
+void GL::UniformBuffer::Bind(GLuint binding) const {
+  gl.BindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+}
+
+GL::ShaderCache::~ShaderCache() {
+  for (const auto& [hash, program] : programs) {
+    gl.DeleteProgram(program);
+  }
+}
+
+uint64_t GL::ShaderCache::Hash(std::string_view data, uint64_t seed) {
+  uint64_t hash = seed;
+  for (char c : data) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+GLuint GL::ShaderCache::Get(std::string_view vertex_source, std::string_view fragment_source,
+                            const std::function<void(GLuint)>& setup) {
+  // The separator keeps a source boundary from hashing like a different split of the same text
+  const uint64_t hash = Hash(fragment_source, Hash(std::string_view("\0", 1), Hash(vertex_source)));
+  auto it = programs.find(hash);
+  if (it != programs.end()) {
+    return it->second;
+  }
+  GLuint program = CreateProgram(gl, std::string(vertex_source).c_str(),
+                                 std::string(fragment_source).c_str());
+  if (setup) {
+    try {
+      setup(program);
+    } catch (...) {
+      gl.DeleteProgram(program);
+      throw;
+    }
+  }
+  programs.emplace(hash, program);
+  return program;
+}
+
+GL::ShaderEffect::ShaderEffect(PostProcessor& processor, std::string_view fragment_source,
+                               std::size_t parameters_size)
+    : program(processor.GetProgram(fragment_source)),
+      parameters(processor.GetRenderer().GetFunctions(), parameters_size) {}
+
+void GL::ShaderEffect::Apply(PostProcessor& processor, const RenderTarget& input,
+                             RenderTarget* output) {
+  processor.DrawPass(program, {&input}, output, parameters.GetSize() > 0 ? &parameters : nullptr);
+}
+
+GL::PostProcessor::PostProcessor(Renderer& renderer)
+    : renderer(renderer),
+      gl(renderer.GetFunctions()),
+      shaders(gl),
+      frame(gl, sizeof(FrameBlock)) {
+  // Core profiles can not draw without a vertex array, even if it has no attributes
+  gl.GenVertexArrays(1, &vertex_array);
+  try {
+    copy_program = GetProgram(COPY_SHADER);
+  } catch (...) {
+    gl.DeleteVertexArrays(1, &vertex_array);
+    throw;
+  }
+}
+
+GL::PostProcessor::~PostProcessor() { gl.DeleteVertexArrays(1, &vertex_array); }
+
+GLuint GL::PostProcessor::GetProgram(std::string_view fragment_source) {
+  std::string source = FRAGMENT_PRELUDE;
+  source += fragment_source;
+  return shaders.Get(FULLSCREEN_VERTEX_SHADER, source, [this](GLuint program) {
+    GLuint frame_index = gl.GetUniformBlockIndex(program, "Frame");
+    if (frame_index != GL_INVALID_INDEX) {
+      gl.UniformBlockBinding(program, frame_index, FRAME_BINDING);
+    }
+    GLuint parameters_index = gl.GetUniformBlockIndex(program, "Parameters");
+    if (parameters_index != GL_INVALID_INDEX) {
+      gl.UniformBlockBinding(program, parameters_index, PARAMETERS_BINDING);
+    }
+    gl.UseProgram(program);
+    for (int i = 0; i < MAX_INPUTS; ++i) {
+      std::string name = "u_input" + std::to_string(i);
+      gl.Uniform1i(gl.GetUniformLocation(program, name.c_str()), i);
+    }
+  });
+}
+
+void GL::PostProcessor::Begin() {
+  if (scene != nullptr) {
+    throw GlException("PostProcessor::Begin() called twice");
+  }
+  Dimensions size = renderer.GetOutputSize();
+  bool resized = std::any_of(pool.begin(), pool.end(), [size](const PooledTarget& pooled) {
+    Dimensions pooled_size = pooled.target->GetSize();
+    return pooled_size.width != size.width || pooled_size.height != size.height;
+  });
+  if (resized) {
+    TrimPool();
+  }
+  scene = &AcquireTarget(size);
+  renderer.SetRenderTarget(*scene);
+}
+
+void GL::PostProcessor::End(RenderTarget* output) {
+  if (scene == nullptr) {
+    throw GlException("PostProcessor::End() called without Begin()");
+  }
+  renderer.SetRenderTargetDefault();
+  RenderTarget* input = scene;
+  scene = nullptr;
+  Apply(*input, output);
+  ReleaseTarget(*input);
+}
+
+void GL::PostProcessor::Apply(const RenderTarget& input, RenderTarget* output) {
+  renderer.Flush();
+  if (effects.empty()) {
+    DrawPass(copy_program, {&input}, output);
+    return;
+  }
+  const RenderTarget* current = &input;
+  for (std::size_t i = 0; i < effects.size(); ++i) {
+    const bool last = i + 1 == effects.size();
+    RenderTarget* next = last ? output : &AcquireTarget(input.GetSize());
+    effects[i]->Apply(*this, *current, next);
+    if (current != &input) {
+      ReleaseTarget(*current);
+    }
+    current = next;
+  }
+}
+
+void GL::PostProcessor::DrawPass(GLuint program, std::initializer_list<const RenderTarget*> inputs,
+                                 RenderTarget* output, const UniformBuffer* parameters) {
+  if (inputs.size() > MAX_INPUTS) {
+    throw GlException("Too many inputs of a post-processing pass");
+  }
+  Dimensions output_size = output != nullptr ? output->GetSize() : renderer.GetOutputSize();
+  Dimensions input_size = inputs.size() > 0 ? (*inputs.begin())->GetSize() : output_size;
+  FrameBlock block{};
+  block.output_size[0] = static_cast<float>(output_size.width);
+  block.output_size[1] = static_cast<float>(output_size.height);
+  block.output_size[2] = 1.0F / static_cast<float>(output_size.width);
+  block.output_size[3] = 1.0F / static_cast<float>(output_size.height);
+  block.input_size[0] = static_cast<float>(input_size.width);
+  block.input_size[1] = static_cast<float>(input_size.height);
+  block.input_size[2] = 1.0F / static_cast<float>(input_size.width);
+  block.input_size[3] = 1.0F / static_cast<float>(input_size.height);
+  block.time = time;
+  frame.Update(block);
+  frame.Bind(FRAME_BINDING);
+  if (parameters != nullptr) {
+    parameters->Bind(PARAMETERS_BINDING);
+  }
+
+  gl.BindFramebuffer(GL_FRAMEBUFFER, output != nullptr ? output->GetFramebuffer() : 0);
+  gl.Viewport(0, 0, output_size.width, output_size.height);
+  gl.Disable(GL_BLEND);
+  gl.Disable(GL_SCISSOR_TEST);
+  GLenum unit = GL_TEXTURE0;
+  for (const RenderTarget* input : inputs) {
+    gl.ActiveTexture(unit++);
+    gl.BindTexture(GL_TEXTURE_2D, input->GetTexture());
+  }
+  gl.ActiveTexture(GL_TEXTURE0);
+  gl.UseProgram(program);
+  gl.BindVertexArray(vertex_array);
+  gl.DrawArrays(GL_TRIANGLES, 0, 3);
+  ++pass_count;
+}
+
+GL::RenderTarget& GL::PostProcessor::AcquireTarget(Dimensions size) {
+  for (PooledTarget& pooled : pool) {
+    Dimensions pooled_size = pooled.target->GetSize();
+    if (!pooled.in_use && pooled_size.width == size.width && pooled_size.height == size.height) {
+      pooled.in_use = true;
+      return *pooled.target;
+    }
+  }
+  pool.push_back({std::make_unique<RenderTarget>(renderer, size), true});
+  return *pool.back().target;
+}
+
+void GL::PostProcessor::ReleaseTarget(const RenderTarget& target) {
+  for (PooledTarget& pooled : pool) {
+    if (pooled.target.get() == &target) {
+      pooled.in_use = false;
+      return;
+    }
+  }
+}
+
+void GL::PostProcessor::TrimPool() {
+  pool.erase(std::remove_if(pool.begin(), pool.end(),
+                            [](const PooledTarget& pooled) { return !pooled.in_use; }),
+             pool.end());
+}
@@ -0,0 +1,519 @@
+#include "sdlxx/core/gl_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include <SDL_pixels.h>
+
+#include "sdlxx/core/surface.h"
+#include "sdlxx/utils/angle.h"
+
+using namespace sdlxx;
+
+namespace {
+
+// Corners of the quad come from gl_VertexID, so only per-instance attributes are stored
+const char* const VERTEX_SHADER = R"(
+layout(location = 0) in vec4 a_rect;
+layout(location = 1) in vec4 a_source;
+layout(location = 2) in vec2 a_transform;
+layout(location = 3) in vec4 a_color;
+uniform vec2 u_scale;
+out vec3 v_texcoord;
+out vec4 v_color;
+void main() {
+  vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+  vec2 offset = (corner - 0.5) * a_rect.zw;
+  vec2 position = a_rect.xy + 0.5 * a_rect.zw;
+  if (a_transform.x != 0.0) {
+    float c = cos(a_transform.x);
+    float s = sin(a_transform.x);
+    offset = vec2(offset.x * c - offset.y * s, offset.x * s + offset.y * c);
+  }
+  gl_Position = vec4((position + offset) * u_scale + vec2(-1.0, 1.0), 0.0, 1.0);
+  v_texcoord = vec3(mix(a_source.xy, a_source.zw, corner), a_transform.y);
+  v_color = a_color;
+}
+)";
+
+const char* const FRAGMENT_SHADER = R"(
+uniform sampler2DArray u_texture;
+in vec3 v_texcoord;
+in vec4 v_color;
+out vec4 fragment_color;
+void main() {
+  fragment_color = v_texcoord.z < 0.0 ? v_color : texture(u_texture, v_texcoord) * v_color;
+}
+)";
+
+Dimensions GetLayerSize(const std::vector<Surface>& surfaces) {
+  if (surfaces.empty()) {
+    throw GlException("Texture array must have at least one layer");
+  }
+  Dimensions size = surfaces.front().GetSize();
+  for (const Surface& surface : surfaces) {
+    Dimensions layer_size = surface.GetSize();
+    if (layer_size.width != size.width || layer_size.height != size.height) {
+      throw GlException("Texture array layers must have the same size");
+    }
+  }
+  return size;
+}
+
+}  // namespace
+
+GL::Texture::Texture(Renderer& renderer, int width, int height, int layers)
+    : gl(renderer.GetFunctions()),
+      size{width, height},
+      layers(layers),
+      inverse_width(width > 0 ? 1.0F / static_cast<float>(width) : 0.0F),
+      inverse_height(height > 0 ? 1.0F / static_cast<float>(height) : 0.0F) {
+  if (width <= 0 || height <= 0 || layers <= 0) {
+    throw GlException("Invalid texture size");
+  }
+  while (gl.GetError() != GL_NO_ERROR) {
+  }
+  gl.GenTextures(1, &texture);
+  gl.BindTexture(GL_TEXTURE_2D_ARRAY, texture);
+  gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  gl.TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  gl.TexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA,
+                GL_UNSIGNED_BYTE, nullptr);
+  if (gl.GetError() != GL_NO_ERROR) {
+    gl.DeleteTextures(1, &texture);
+    throw GlException("Failed to create texture array");
+  }
+}
+
+GL::Texture::Texture(Renderer& renderer, const Surface& surface)
+    : Texture(renderer, surface.GetSize().width, surface.GetSize().height) {
+  Update(0, surface);
+}
+
+GL::Texture::Texture(Renderer& renderer, const std::vector<Surface>& surfaces)
+    : Texture(renderer, GetLayerSize(surfaces).width, GetLayerSize(surfaces).height,
+              static_cast<int>(surfaces.size())) {
+  for (std::size_t i = 0; i < surfaces.size(); ++i) {
+    Update(static_cast<int>(i), surfaces[i]);
+  }
+}
+
+GL::Texture::~Texture() { gl.DeleteTextures(1, &texture); }
+
+void GL::Texture::Update(int layer, const Surface& surface) {
+  Dimensions surface_size = surface.GetSize();
+  if (surface_size.width != size.width || surface_size.height != size.height) {
+    throw GlException("Surface size does not match the texture size");
+  }
+  if (surface.GetFormat()->format == SDL_PIXELFORMAT_RGBA32) {
+    Update(layer, surface.GetPixels(), surface.GetPitch());
+    return;
+  }
+  Surface copy = surface;
+  std::optional<Surface> converted = copy.ConvertFormat(SDL_PIXELFORMAT_RGBA32, 0);
+  if (!converted) {
+    throw GlException("Failed to convert surface to RGBA32");
+  }
+  Update(layer, converted->GetPixels(), converted->GetPitch());
+}
+
+void GL::Texture::Update(int layer, const void* pixels, int pitch) {
+  if (layer < 0 || layer >= layers) {
+    throw GlException("Texture layer is out of range");
+  }
+  gl.BindTexture(GL_TEXTURE_2D_ARRAY, texture);
+  gl.PixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  gl.PixelStorei(GL_UNPACK_ROW_LENGTH, pitch / 4);
+  gl.TexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, size.width, size.height, 1, GL_RGBA,
+                   GL_UNSIGNED_BYTE, pixels);
+  gl.PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+GL::RenderTarget::RenderTarget(Renderer& renderer, Dimensions size)
+    : gl(renderer.GetFunctions()), size(size) {
+  if (size.width <= 0 || size.height <= 0) {
+    throw GlException("Invalid render target size");
+  }
+  gl.GenTextures(1, &texture);
+  gl.BindTexture(GL_TEXTURE_2D, texture);
+  gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  gl.TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.width, size.height, 0, GL_RGBA,
+                GL_UNSIGNED_BYTE, nullptr);
+  gl.GenFramebuffers(1, &framebuffer);
+  gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  gl.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+  GLenum status = gl.CheckFramebufferStatus(GL_FRAMEBUFFER);
+  gl.BindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    gl.DeleteFramebuffers(1, &framebuffer);
+    gl.DeleteTextures(1, &texture);
+    throw GlException("Render target framebuffer is not complete");
+  }
+}
+
+GL::RenderTarget::~RenderTarget() {
+  gl.DeleteFramebuffers(1, &framebuffer);
+  gl.DeleteTextures(1, &texture);
+}
+
+GL::Renderer::Renderer(Context& context, Dimensions size, std::size_t capacity,
+                       bool persistent_mapping)
+    : context(context), capacity(std::max<std::size_t>(capacity, 1)) {
+  try {
+    program = CreateProgram(gl, VERTEX_SHADER, FRAGMENT_SHADER);
+    scale_location = gl.GetUniformLocation(program, "u_scale");
+    gl.UseProgram(program);
+    gl.Uniform1i(gl.GetUniformLocation(program, "u_texture"), 0);
+
+    gl.GenVertexArrays(1, &vertex_array);
+    gl.BindVertexArray(vertex_array);
+    gl.GenBuffers(1, &buffer);
+    gl.BindBuffer(GL_ARRAY_BUFFER, buffer);
+    const auto bytes = static_cast<GLsizeiptr>(this->capacity * SEGMENTS * sizeof(Instance));
+    persistent = persistent_mapping && gl.buffer_storage;
+    if (persistent) {
+      const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+      gl.BufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+      mapped = static_cast<Instance*>(gl.MapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags));
+      if (mapped == nullptr) {
+        throw GlException("Failed to map the streaming buffer");
+      }
+    } else {
+      gl.BufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+      staging.resize(this->capacity);
+    }
+    for (GLuint attribute = 0; attribute < 4; ++attribute) {
+      gl.EnableVertexAttribArray(attribute);
+      gl.VertexAttribDivisor(attribute, 1);
+    }
+  } catch (...) {
+    Destroy();
+    throw;
+  }
+  SetOutputSize(size);
+}
+
+GL::Renderer::~Renderer() { Destroy(); }
+
+void GL::Renderer::Destroy() {
+  for (GLsync& fence : fences) {
+    if (fence != nullptr) {
+      gl.DeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+  if (mapped != nullptr) {
+    gl.BindBuffer(GL_ARRAY_BUFFER, buffer);
+    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    mapped = nullptr;
+  }
+  gl.DeleteBuffers(1, &buffer);
+  gl.DeleteVertexArrays(1, &vertex_array);
+  gl.DeleteProgram(program);
+  buffer = vertex_array = program = 0;
+}
+
+void GL::Renderer::SetOutputSize(Dimensions size) {
+  Flush();
+  output_size = size;
+  if (framebuffer == 0) {
+    this->size = size;
+    clip_enabled = false;
+  }
+}
+
+void GL::Renderer::SetRenderTarget(RenderTarget& target) {
+  Flush();
+  framebuffer = target.GetFramebuffer();
+  size = target.GetSize();
+  clip_enabled = false;
+}
+
+void GL::Renderer::SetRenderTargetDefault() {
+  Flush();
+  framebuffer = 0;
+  size = output_size;
+  clip_enabled = false;
+}
+
+void GL::Renderer::BindTarget() {
+  gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  gl.Viewport(0, 0, size.width, size.height);
+}
+
+void GL::Renderer::SetClipRectangle(const Rectangle& rectangle) {
+  Flush();
+  clip_enabled = true;
+  clip = rectangle;
+}
+
+void GL::Renderer::ResetClipRectangle() {
+  Flush();
+  clip_enabled = false;
+}
+
+void GL::Renderer::Clear() {
+  Flush();
+  BindTarget();
+  gl.Disable(GL_SCISSOR_TEST);
+  gl.ClearColor(draw_color.r / 255.0F, draw_color.g / 255.0F, draw_color.b / 255.0F,
+                draw_color.a / 255.0F);
+  gl.Clear(GL_COLOR_BUFFER_BIT);
+}
+
+void GL::Renderer::DrawPoint(Point point) {
+  AppendRectangle(static_cast<float>(point.x), static_cast<float>(point.y), 1.0F, 1.0F);
+}
+
+void GL::Renderer::DrawPoints(const std::vector<Point>& points) {
+  for (Point point : points) {
+    DrawPoint(point);
+  }
+}
+
+void GL::Renderer::DrawLine(Point line_start, Point line_end) {
+  const int dx = line_end.x - line_start.x;
+  const int dy = line_end.y - line_start.y;
+  if (dx == 0 || dy == 0) {
+    // Axis-aligned lines are exact rectangles, so they match the software renderer
+    FillRectangle({std::min(line_start.x, line_end.x), std::min(line_start.y, line_end.y),
+                   std::abs(dx) + 1, std::abs(dy) + 1});
+    return;
+  }
+  // A one pixel thick quad through the pixel centers, extended by half a pixel at both ends
+  const float length = std::sqrt(static_cast<float>(dx * dx + dy * dy)) + 1.0F;
+  const float center_x = static_cast<float>(line_start.x + line_end.x) * 0.5F + 0.5F;
+  const float center_y = static_cast<float>(line_start.y + line_end.y) * 0.5F + 0.5F;
+  AppendRectangle(center_x - length * 0.5F, center_y - 0.5F, length, 1.0F,
+                  std::atan2(static_cast<float>(dy), static_cast<float>(dx)));
+}
+
+void GL::Renderer::DrawLines(const std::vector<Point>& points) {
+  for (std::size_t i = 1; i < points.size(); ++i) {
+    DrawLine(points[i - 1], points[i]);
+  }
+}
+
+void GL::Renderer::DrawRectangle(const Rectangle& rectangle) {
+  const int x = rectangle.x;
+  const int y = rectangle.y;
+  const int width = rectangle.width;
+  const int height = rectangle.height;
+  if (width <= 2 || height <= 2) {
+    FillRectangle(rectangle);
+    return;
+  }
+  // Edges do not overlap, so blended outlines have no darker corners
+  FillRectangle({x, y, width, 1});
+  FillRectangle({x, y + height - 1, width, 1});
+  FillRectangle({x, y + 1, 1, height - 2});
+  FillRectangle({x + width - 1, y + 1, 1, height - 2});
+}
+
+void GL::Renderer::DrawRectangles(const std::vector<Rectangle>& rectangles) {
+  for (const Rectangle& rectangle : rectangles) {
+    DrawRectangle(rectangle);
+  }
+}
+
+void GL::Renderer::FillRectangle(const Rectangle& rectangle) {
+  if (rectangle.width <= 0 || rectangle.height <= 0) {
+    return;
+  }
+  AppendRectangle(static_cast<float>(rectangle.x), static_cast<float>(rectangle.y),
+                  static_cast<float>(rectangle.width), static_cast<float>(rectangle.height));
+}
+
+void GL::Renderer::FillRectangles(const std::vector<Rectangle>& rectangles) {
+  for (const Rectangle& rectangle : rectangles) {
+    FillRectangle(rectangle);
+  }
+}
+
+void GL::Renderer::Copy(const Texture& texture, const Rectangle& dest) {
+  Copy(texture, {0, 0, texture.size.width, texture.size.height}, dest);
+}
+
+void GL::Renderer::Copy(const Texture& texture, const Rectangle& source, const Rectangle& dest) {
+  Draw(texture, 0, source, static_cast<float>(dest.x), static_cast<float>(dest.y),
+       static_cast<float>(dest.width), static_cast<float>(dest.height));
+}
+
+void GL::Renderer::Draw(const Texture& texture, int layer, const Rectangle& source, float x,
+                        float y, float width, float height, float angle, Color color) {
+  if (layer < 0 || layer >= texture.layers) {
+    throw GlException("Texture layer is out of range");
+  }
+  Append(texture.texture, texture.blend_mode) = {
+      x,
+      y,
+      width,
+      height,
+      static_cast<float>(source.x) * texture.inverse_width,
+      static_cast<float>(source.y) * texture.inverse_height,
+      static_cast<float>(source.x + source.width) * texture.inverse_width,
+      static_cast<float>(source.y + source.height) * texture.inverse_height,
+      angle * DEGREES_TO_RADIANS,
+      static_cast<float>(layer),
+      color};
+}
+
+void GL::Renderer::AppendRectangle(float x, float y, float width, float height, float angle) {
+  Append(0, draw_blend_mode) = {x,    y,    width, height, 0.0F,       0.0F,
+                                0.0F, 0.0F, angle, -1.0F,  draw_color};
+}
+
+GL::Renderer::Instance& GL::Renderer::Append(GLuint texture, BlendMode blend_mode) {
+  // Untextured primitives join any batch with the same blend mode
+  if (segment_used > batch_start &&
+      (blend_mode != batch_blend_mode ||
+       (texture != 0 && batch_texture != 0 && texture != batch_texture))) {
+    Flush();
+  }
+  if (segment_used == capacity) {
+    Flush();
+    NextSegment();
+  }
+  if (segment_used == batch_start) {
+    batch_blend_mode = blend_mode;
+    batch_texture = 0;
+  }
+  if (texture != 0) {
+    batch_texture = texture;
+  }
+  Instance* instances = persistent ? mapped + segment * capacity : staging.data();
+  return instances[segment_used++];
+}
+
+void GL::Renderer::Flush() {
+  const std::size_t count = segment_used - batch_start;
+  if (count == 0) {
+    return;
+  }
+  const std::size_t first = segment * capacity + batch_start;
+  batch_start = segment_used;
+
+  gl.UseProgram(program);
+  gl.BindVertexArray(vertex_array);
+  gl.BindBuffer(GL_ARRAY_BUFFER, buffer);
+  const auto offset = static_cast<GLintptr>(first * sizeof(Instance));
+  if (!persistent) {
+    // Fences already keep the GPU away from this range, so the mapping needs no synchronization
+    const auto bytes = static_cast<GLsizeiptr>(count * sizeof(Instance));
+    void* data = gl.MapBufferRange(GL_ARRAY_BUFFER, offset, bytes,
+                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                       GL_MAP_UNSYNCHRONIZED_BIT);
+    if (data == nullptr) {
+      throw GlException("Failed to map the streaming buffer");
+    }
+    std::memcpy(data, staging.data() + (first - segment * capacity), bytes);
+    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+  }
+
+  const auto stride = static_cast<GLsizei>(sizeof(Instance));
+  auto pointer = [offset](std::size_t member) {
+    return reinterpret_cast<const void*>(static_cast<std::uintptr_t>(offset) + member);
+  };
+  gl.VertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, pointer(offsetof(Instance, x)));
+  gl.VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, pointer(offsetof(Instance, u0)));
+  gl.VertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, pointer(offsetof(Instance, angle)));
+  gl.VertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                         pointer(offsetof(Instance, color)));
+  gl.Uniform2f(scale_location, 2.0F / static_cast<float>(size.width),
+               -2.0F / static_cast<float>(size.height));
+  BindTarget();
+  ApplyBlendMode(batch_blend_mode);
+  ApplyClip();
+  gl.ActiveTexture(GL_TEXTURE0);
+  gl.BindTexture(GL_TEXTURE_2D_ARRAY, batch_texture);
+  gl.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+  ++render_calls;
+  sprite_count += count;
+}
+
+void GL::Renderer::NextSegment() {
+  fences[segment] = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  segment = (segment + 1) % SEGMENTS;
+  segment_used = 0;
+  batch_start = 0;
+  GLsync& fence = fences[segment];
+  if (fence == nullptr) {
+    return;
+  }
+  GLenum status = gl.ClientWaitSync(fence, 0, 0);
+  if (status == GL_TIMEOUT_EXPIRED) {
+    ++stall_count;
+    do {
+      status = gl.ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    } while (status == GL_TIMEOUT_EXPIRED);
+  }
+  gl.DeleteSync(fence);
+  fence = nullptr;
+  if (status == GL_WAIT_FAILED) {
+    throw GlException("Failed to wait for the streaming buffer");
+  }
+}
+
+void GL::Renderer::ApplyBlendMode(BlendMode blend_mode) {
+  if (blend_mode == BlendMode::NONE) {
+    gl.Disable(GL_BLEND);
+    return;
+  }
+  gl.Enable(GL_BLEND);
+  gl.BlendEquation(GL_FUNC_ADD);
+  switch (blend_mode) {
+    case BlendMode::ADD:
+      gl.BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE, GL_ZERO, GL_ONE);
+      break;
+    case BlendMode::MOD:
+      gl.BlendFuncSeparate(GL_ZERO, GL_SRC_COLOR, GL_ZERO, GL_ONE);
+      break;
+    case BlendMode::MUL:
+      gl.BlendFuncSeparate(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+      break;
+    default:
+      gl.BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+      break;
+  }
+}
+
+void GL::Renderer::ApplyClip() {
+  if (!clip_enabled) {
+    gl.Disable(GL_SCISSOR_TEST);
+    return;
+  }
+  gl.Enable(GL_SCISSOR_TEST);
+  gl.Scissor(clip.x, size.height - clip.y - clip.height, std::max(clip.width, 0),
+             std::max(clip.height, 0));
+}
+
+void GL::Renderer::ReadPixels(const Rectangle& rectangle, void* pixels, int pitch) {
+  Flush();
+  BindTarget();
+  const int row_bytes = rectangle.width * 4;
+  std::vector<uint8_t> rows(static_cast<std::size_t>(row_bytes) * rectangle.height);
+  gl.PixelStorei(GL_PACK_ALIGNMENT, 1);
+  gl.ReadPixels(rectangle.x, size.height - rectangle.y - rectangle.height, rectangle.width,
+                rectangle.height, GL_RGBA, GL_UNSIGNED_BYTE, rows.data());
+  // OpenGL returns rows from bottom to top
+  auto* destination = static_cast<uint8_t*>(pixels);
+  for (int y = 0; y < rectangle.height; ++y) {
+    std::memcpy(destination + static_cast<std::ptrdiff_t>(y) * pitch,
+                rows.data() + static_cast<std::size_t>(rectangle.height - 1 - y) * row_bytes,
+                row_bytes);
+  }
+}
+
+void GL::Renderer::ResetStatistics() {
+  render_calls = 0;
+  sprite_count = 0;
+  stall_count = 0;
+}
@@ -0,0 +1,361 @@
+#include "sdlxx/core/image_processor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <SDL_pixels.h>
+#include <SDL_surface.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "sdlxx/core/thread_pool.h"
+
+using namespace sdlxx;
+
+namespace {
+
+// The number of output rows filtered by one iteration of the parallel loop
+constexpr int BAND_HEIGHT = 16;
+
+constexpr float PI = 3.14159265358979323846F;
+
+/**
+ * Filter weights along one axis.
+ *
+ * Every output pixel i is the sum of weights[i * taps + k] times input pixel starts[i] + k.
+ * Windows are shifted inside the input and the weights of pixels beyond the edges are added to
+ * the edge pixels, so the inner loops never check bounds.
+ */
+struct Axis {
+  int taps = 0;
+  std::vector<int> starts;
+  std::vector<float> weights;
+};
+
+/**
+ * Build the weights of a filter for every output pixel.
+ *
+ * \param input   The number of input pixels.
+ * \param output  The number of output pixels.
+ * \param support The radius of the filter in input pixels.
+ * \param scale   The factor that converts distances in input pixels to the filter argument.
+ * \param kernel  The filter function.
+ */
+template <typename Kernel>
+Axis MakeAxis(int input, int output, float support, float scale, Kernel kernel) {
+  Axis axis;
+  // The most input pixels that can lie within the support around a center
+  int taps = static_cast<int>(std::floor(2.0F * support)) + 1;
+  axis.taps = std::min(taps, input);
+  axis.starts.resize(output);
+  axis.weights.assign(static_cast<std::size_t>(output) * axis.taps, 0.0F);
+  float ratio = static_cast<float>(input) / static_cast<float>(output);
+  std::vector<float> raw(taps);
+  for (int i = 0; i < output; ++i) {
+    // The center of the output pixel in input coordinates
+    float center = (static_cast<float>(i) + 0.5F) * ratio - 0.5F;
+    int first = static_cast<int>(std::ceil(center - support));
+    float sum = 0.0F;
+    for (int k = 0; k < taps; ++k) {
+      raw[k] = kernel((static_cast<float>(first + k) - center) * scale);
+      sum += raw[k];
+    }
+    int start = std::clamp(first, 0, input - axis.taps);
+    axis.starts[i] = start;
+    float* weights = &axis.weights[static_cast<std::size_t>(i) * axis.taps];
+    for (int k = 0; k < taps; ++k) {
+      int index = std::clamp(first + k, 0, input - 1);
+      weights[index - start] += sum != 0.0F ? raw[k] / sum : 0.0F;
+    }
+  }
+  return axis;
+}
+
+float Sinc(float x) { return x == 0.0F ? 1.0F : std::sin(PI * x) / (PI * x); }
+
+Axis MakeResizeAxis(int input, int output, ResizeFilter filter) {
+  // Widen the filter when downscaling, so that it averages all covered input pixels
+  float scale = std::min(static_cast<float>(output) / static_cast<float>(input), 1.0F);
+  switch (filter) {
+    case ResizeFilter::BILINEAR:
+      return MakeAxis(input, output, 1.0F / scale, scale,
+                      [](float x) { return std::max(1.0F - std::abs(x), 0.0F); });
+    case ResizeFilter::BICUBIC:
+      return MakeAxis(input, output, 2.0F / scale, scale, [](float x) {
+        x = std::abs(x);
+        if (x < 1.0F) {
+          return (1.5F * x - 2.5F) * x * x + 1.0F;
+        }
+        if (x < 2.0F) {
+          return ((-0.5F * x + 2.5F) * x - 4.0F) * x + 2.0F;
+        }
+        return 0.0F;
+      });
+    case ResizeFilter::LANCZOS:
+      return MakeAxis(input, output, 3.0F / scale, scale, [](float x) {
+        return std::abs(x) < 3.0F ? Sinc(x) * Sinc(x / 3.0F) : 0.0F;
+      });
+  }
+  throw ImageProcessorException("Unknown resize filter");
+}
+
+Axis MakeBoxAxis(int size, int radius) {
+  return MakeAxis(size, size, static_cast<float>(radius), 1.0F,
+                  [radius](float x) { return std::abs(x) <= radius + 0.5F ? 1.0F : 0.0F; });
+}
+
+Axis MakeGaussianAxis(int size, float sigma) {
+  if (sigma == 0.0F) {
+    return MakeBoxAxis(size, 0);
+  }
+  float factor = -0.5F / (sigma * sigma);
+  return MakeAxis(size, size, std::ceil(3.0F * sigma), 1.0F,
+                  [factor](float x) { return std::exp(x * x * factor); });
+}
+
+void CheckFormat(const Surface& surface) {
+  const SDL_PixelFormat* format = surface.GetFormat();
+  if (format->BytesPerPixel != 4 || format->Rloss != 0 || format->Gloss != 0 ||
+      format->Bloss != 0 || (format->Amask != 0 && format->Aloss != 0)) {
+    throw ImageProcessorException("Only 32-bit surfaces with 8-bit channels are supported");
+  }
+}
+
+void CheckFormats(const Surface& source, const Surface& dest) {
+  CheckFormat(source);
+  if (source.GetFormat()->format != dest.GetFormat()->format) {
+    throw ImageProcessorException("Surfaces have different pixel formats");
+  }
+}
+
+// Add the weighted channels of a row of pixels to a row of floats
+void AccumulateRow(float* sums, const uint8_t* pixels, int width, float weight) {
+  int i = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 w = _mm_set1_ps(weight);
+  for (; i + 4 <= width; i += 4) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4));
+    __m128i low = _mm_unpacklo_epi8(bytes, zero);
+    __m128i high = _mm_unpackhi_epi8(bytes, zero);
+    __m128i channels[4] = {_mm_unpacklo_epi16(low, zero), _mm_unpackhi_epi16(low, zero),
+                           _mm_unpacklo_epi16(high, zero), _mm_unpackhi_epi16(high, zero)};
+    for (int j = 0; j < 4; ++j) {
+      float* sum = sums + (i + j) * 4;
+      _mm_storeu_ps(sum, _mm_add_ps(_mm_loadu_ps(sum),
+                                    _mm_mul_ps(_mm_cvtepi32_ps(channels[j]), w)));
+    }
+  }
+#endif
+  for (int c = i * 4; c < width * 4; ++c) {
+    sums[c] += static_cast<float>(pixels[c]) * weight;
+  }
+}
+
+// Filter a row of floats horizontally and store the rounded and clamped result
+void FilterRow(uint8_t* pixels, const float* sums, const Axis& axis, int width) {
+  for (int x = 0; x < width; ++x) {
+    const float* weights = &axis.weights[static_cast<std::size_t>(x) * axis.taps];
+    const float* source = sums + static_cast<std::ptrdiff_t>(axis.starts[x]) * 4;
+#if defined(__SSE2__)
+    __m128 sum = _mm_setzero_ps();
+    for (int k = 0; k < axis.taps; ++k) {
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source + k * 4), _mm_set1_ps(weights[k])));
+    }
+    // Conversion rounds to nearest, and saturating packs clamp to [0, 255]
+    __m128i values = _mm_cvtps_epi32(sum);
+    values = _mm_packs_epi32(values, values);
+    values = _mm_packus_epi16(values, values);
+    uint32_t pixel = static_cast<uint32_t>(_mm_cvtsi128_si32(values));
+    std::memcpy(pixels + x * 4, &pixel, sizeof(pixel));
+#else
+    float sum[4] = {0.0F, 0.0F, 0.0F, 0.0F};
+    for (int k = 0; k < axis.taps; ++k) {
+      for (int c = 0; c < 4; ++c) {
+        sum[c] += source[k * 4 + c] * weights[k];
+      }
+    }
+    for (int c = 0; c < 4; ++c) {
+      pixels[x * 4 + c] = static_cast<uint8_t>(std::clamp(std::nearbyint(sum[c]), 0.0F, 255.0F));
+    }
+#endif
+  }
+}
+
+/**
+ * Lock a surface while its pixels are accessed.
+ *
+ * Unlike SurfaceLock, this does not pin the surface, so results of the processor stay
+ * copy-on-write. The pixels are only accessed until the lock is released.
+ */
+class PixelLock {
+public:
+  explicit PixelLock(SDL_Surface* surface) : surface(surface) {
+    if (SDL_LockSurface(surface) != 0) {
+      throw ImageProcessorException("Failed to lock a surface");
+    }
+  }
+
+  ~PixelLock() { SDL_UnlockSurface(surface); }
+
+  PixelLock(const PixelLock&) = delete;
+
+  PixelLock& operator=(const PixelLock&) = delete;
+
+private:
+  SDL_Surface* surface;
+};
+
+/**
+ * Filter the source into the destination with separable weights.
+ *
+ * The vertical axis maps destination rows to source rows and the horizontal axis maps
+ * destination columns to source columns. The destination must be detached from its copies.
+ */
+void Filter(ThreadPool& pool, SDL_Surface* source, SDL_Surface* dest, const Axis& horizontal,
+            const Axis& vertical) {
+  PixelLock source_lock(source);
+  PixelLock dest_lock(dest);
+  const int source_width = source->w;
+  const auto* source_pixels = static_cast<const uint8_t*>(source->pixels);
+  const int source_pitch = source->pitch;
+  const int dest_width = dest->w;
+  const int dest_height = dest->h;
+  auto* dest_pixels = static_cast<uint8_t*>(dest->pixels);
+  const int dest_pitch = dest->pitch;
+  const int bands = (dest_height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+  pool.ParallelFor(bands, [&](std::size_t band) {
+    std::vector<float> sums(static_cast<std::size_t>(source_width) * 4);
+    int first = static_cast<int>(band) * BAND_HEIGHT;
+    int last = std::min(first + BAND_HEIGHT, dest_height);
+    for (int y = first; y < last; ++y) {
+      std::fill(sums.begin(), sums.end(), 0.0F);
+      const float* weights = &vertical.weights[static_cast<std::size_t>(y) * vertical.taps];
+      for (int k = 0; k < vertical.taps; ++k) {
+        if (weights[k] != 0.0F) {
+          const uint8_t* row =
+              source_pixels + static_cast<std::ptrdiff_t>(vertical.starts[y] + k) * source_pitch;
+          AccumulateRow(sums.data(), row, source_width, weights[k]);
+        }
+      }
+      FilterRow(dest_pixels + static_cast<std::ptrdiff_t>(y) * dest_pitch, sums.data(),
+                horizontal, dest_width);
+    }
+  });
+}
+
+Surface MakeSurface(const Surface& like, const Dimensions& size) {
+  if (size.width <= 0 || size.height <= 0) {
+    throw ImageProcessorException("Size must be positive");
+  }
+  return Surface(size.width, size.height, 32, like.GetFormat()->format);
+}
+
+// Write the pixels of a surface of the same size and format into a detached surface
+void CopyPixels(SDL_Surface* source, SDL_Surface* dest) {
+  PixelLock source_lock(source);
+  PixelLock dest_lock(dest);
+  const auto* source_pixels = static_cast<const uint8_t*>(source->pixels);
+  auto* dest_pixels = static_cast<uint8_t*>(dest->pixels);
+  for (int y = 0; y < source->h; ++y) {
+    std::memcpy(dest_pixels + static_cast<std::ptrdiff_t>(y) * dest->pitch,
+                source_pixels + static_cast<std::ptrdiff_t>(y) * source->pitch,
+                static_cast<std::size_t>(source->w) * 4);
+  }
+}
+
+}  // namespace
+
+ImageProcessor::ImageProcessor(ThreadPool& pool) : pool(pool) {}
+
+Surface ImageProcessor::Resize(const Surface& source, const Dimensions& size,
+                               ResizeFilter filter) {
+  CheckFormat(source);
+  Surface dest = MakeSurface(source, size);
+  Resize(source, dest, filter);
+  return dest;
+}
+
+void ImageProcessor::Resize(const Surface& source, Surface& dest, ResizeFilter filter) {
+  CheckFormats(source, dest);
+  Dimensions source_size = source.GetSize();
+  Dimensions dest_size = dest.GetSize();
+  if (source_size.width <= 0 || source_size.height <= 0) {
+    throw ImageProcessorException("Source surface is empty");
+  }
+  SDL_Surface* dest_ptr = dest.GetForWriting();
+  Filter(pool, source.Get(), dest_ptr, MakeResizeAxis(source_size.width, dest_size.width, filter),
+         MakeResizeAxis(source_size.height, dest_size.height, filter));
+}
+
+void ImageProcessor::ResizeInPlace(Surface& surface, const Dimensions& size,
+                                   ResizeFilter filter) {
+  surface = Resize(static_cast<const Surface&>(surface), size, filter);
+}
+
+void ImageProcessor::BoxBlur(const Surface& source, Surface& dest, int radius) {
+  CheckFormats(source, dest);
+  Dimensions size = source.GetSize();
+  if (size != dest.GetSize()) {
+    throw ImageProcessorException("Surfaces have different sizes");
+  }
+  if (radius < 0) {
+    throw ImageProcessorException("Radius must not be negative");
+  }
+  if (size.width <= 0 || size.height <= 0) {
+    return;
+  }
+  SDL_Surface* dest_ptr = dest.GetForWriting();
+  Filter(pool, source.Get(), dest_ptr, MakeBoxAxis(size.width, radius),
+         MakeBoxAxis(size.height, radius));
+}
+
+void ImageProcessor::BoxBlur(Surface& surface, int radius) {
+  CheckFormat(surface);
+  Surface result = MakeSurface(surface, surface.GetSize());
+  BoxBlur(surface, result, radius);
+  CopyPixels(result.Get(), surface.GetForWriting());
+}
+
+void ImageProcessor::GaussianBlur(const Surface& source, Surface& dest, float sigma) {
+  CheckFormats(source, dest);
+  Dimensions size = source.GetSize();
+  if (size != dest.GetSize()) {
+    throw ImageProcessorException("Surfaces have different sizes");
+  }
+  if (!(sigma >= 0.0F)) {
+    throw ImageProcessorException("Sigma must not be negative");
+  }
+  if (size.width <= 0 || size.height <= 0) {
+    return;
+  }
+  SDL_Surface* dest_ptr = dest.GetForWriting();
+  Filter(pool, source.Get(), dest_ptr, MakeGaussianAxis(size.width, sigma),
+         MakeGaussianAxis(size.height, sigma));
+}
+
+void ImageProcessor::GaussianBlur(Surface& surface, float sigma) {
+  CheckFormat(surface);
+  Surface result = MakeSurface(surface, surface.GetSize());
+  GaussianBlur(surface, result, sigma);
+  CopyPixels(result.Get(), surface.GetForWriting());
+}
+
+std::vector<Surface> ImageProcessor::GenerateMipmaps(const Surface& source, ResizeFilter filter,
+                                                     int levels) {
+  CheckFormat(source);
+  std::vector<Surface> chain;
+  chain.push_back(source);
+  Dimensions size = source.GetSize();
+  while ((levels == 0 || static_cast<int>(chain.size()) < levels) &&
+         (size.width > 1 || size.height > 1)) {
+    size = {std::max(size.width / 2, 1), std::max(size.height / 2, 1)};
+    chain.push_back(Resize(chain.back(), size, filter));
+  }
+  return chain;
+}
@@ -0,0 +1,317 @@
+#include "sdlxx/core/offscreen.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include <SDL.h>
+#include <SDL_hints.h>
+#include <SDL_pixels.h>
+
+#include "sdlxx/core/core_api.h"
+
+using namespace sdlxx;
+
+namespace {
+
+void AppendBigEndian(std::vector<uint8_t>& output, uint32_t value) {
+  output.push_back(static_cast<uint8_t>(value >> 24U));
+  output.push_back(static_cast<uint8_t>(value >> 16U));
+  output.push_back(static_cast<uint8_t>(value >> 8U));
+  output.push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t Crc32(const uint8_t* data, std::size_t length, uint32_t crc = 0) {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> result{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t value = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        value = (value & 1U) != 0 ? 0xEDB88320U ^ (value >> 1U) : value >> 1U;
+      }
+      result[i] = value;
+    }
+    return result;
+  }();
+  crc = ~crc;
+  for (std::size_t i = 0; i < length; ++i) {
+    crc = table[(crc ^ data[i]) & 0xFFU] ^ (crc >> 8U);
+  }
+  return ~crc;
+}
+
+void AppendChunk(std::vector<uint8_t>& output, const char* type, const std::vector<uint8_t>& data) {
+  AppendBigEndian(output, static_cast<uint32_t>(data.size()));
+  std::size_t start = output.size();
+  output.insert(output.end(), type, type + 4);
+  output.insert(output.end(), data.begin(), data.end());
+  AppendBigEndian(output, Crc32(output.data() + start, output.size() - start));
+}
+
+const char* GetExtension(OffscreenContext::ImageFormat format) {
+  return format == OffscreenContext::ImageFormat::PNG ? ".png" : ".qoi";
+}
+
+// Set a hint back to a value saved before it was replaced, with the priority of the replacement.
+// An empty value is an unset hint, which makes SDL fall back to the environment again.
+void RestoreHint(const char* name, const std::string& value, SDL_HintPriority priority) {
+  SDL_SetHintWithPriority(name, value.empty() ? nullptr : value.c_str(), priority);
+}
+
+}  // namespace
+
+OffscreenContext::OffscreenContext(Dimensions size, bool deterministic, Time frame_step)
+    : size(size),
+      deterministic(deterministic),
+      frame_step(frame_step),
+      surface(size.width, size.height, 32, SDL_PIXELFORMAT_RGBA32),
+      renderer(surface),
+      start_time(std::chrono::steady_clock::now()) {
+  // An explicit SDL_VIDEODRIVER environment variable still takes precedence
+  video_driver = CoreApi::GetHint(SDL_HINT_VIDEODRIVER).value_or("");
+  CoreApi::SetHint(SDL_HINT_VIDEODRIVER, "dummy", CoreApi::HintPriority::NORMAL);
+  if (deterministic) {
+    scale_quality = CoreApi::GetHint(SDL_HINT_RENDER_SCALE_QUALITY).value_or("");
+    CoreApi::SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest", CoreApi::HintPriority::OVERRIDE);
+  }
+  if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+    // The destructor is not called, so the hints are restored here
+    RestoreHints();
+    throw OffscreenContextException("Failed to initialize the video subsystem");
+  }
+  encoder = std::thread([this] { Encode(); });
+}
+
+OffscreenContext::~OffscreenContext() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  queue_changed.notify_all();
+  encoder.join();
+  SDL_QuitSubSystem(SDL_INIT_VIDEO);
+  RestoreHints();
+}
+
+Time OffscreenContext::GetTime() const {
+  if (deterministic) {
+    return Time::Microseconds(frame_step.AsMicroseconds() * static_cast<int64_t>(frame_count));
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start_time;
+  return Time::Microseconds(
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+OffscreenContext::Frame OffscreenContext::GetFrame() {
+  renderer.Flush();
+  return {static_cast<const uint8_t*>(surface.GetPixels()), size.width, size.height,
+          surface.GetPitch()};
+}
+
+void OffscreenContext::EndFrame() {
+  renderer.RenderPresent();
+  if (capture_remaining > 0) {
+    std::string index = std::to_string(capture_index);
+    if (index.size() < 6) {
+      index.insert(0, 6 - index.size(), '0');
+    }
+    Capture(capture_prefix + index + GetExtension(capture_format), capture_format);
+    ++capture_index;
+    --capture_remaining;
+  }
+  ++frame_count;
+}
+
+void OffscreenContext::Capture(const std::string& path, ImageFormat format) {
+  RethrowError();
+  Frame frame = GetFrame();
+  std::size_t row_size = static_cast<std::size_t>(frame.width) * 4;
+  Job job{path, format, frame.width, frame.height,
+          std::vector<uint8_t>(row_size * frame.height)};
+  for (int y = 0; y < frame.height; ++y) {
+    std::memcpy(job.pixels.data() + row_size * y, frame.pixels + frame.pitch * y, row_size);
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  queue_changed.wait(lock, [this] { return jobs.size() < MAX_PENDING_JOBS; });
+  jobs.push_back(std::move(job));
+  lock.unlock();
+  queue_changed.notify_all();
+}
+
+void OffscreenContext::CaptureFrames(const std::string& path_prefix, std::size_t frames,
+                                     ImageFormat format) {
+  capture_prefix = path_prefix;
+  capture_format = format;
+  capture_remaining = frames;
+  capture_index = 0;
+}
+
+void OffscreenContext::WaitForEncoder() {
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    queue_changed.wait(lock, [this] { return jobs.empty() && !encoding; });
+  }
+  RethrowError();
+}
+
+std::vector<uint8_t> OffscreenContext::EncodeQoi(const Frame& frame) {
+  std::vector<uint8_t> output;
+  output.reserve(14 + static_cast<std::size_t>(frame.width) * frame.height + 8);
+  output.insert(output.end(), {'q', 'o', 'i', 'f'});
+  AppendBigEndian(output, static_cast<uint32_t>(frame.width));
+  AppendBigEndian(output, static_cast<uint32_t>(frame.height));
+  output.push_back(4);  // RGBA channels
+  output.push_back(0);  // sRGB with linear alpha
+
+  std::array<std::array<uint8_t, 4>, 64> seen{};
+  std::array<uint8_t, 4> previous{0, 0, 0, 255};
+  int run = 0;
+  for (int y = 0; y < frame.height; ++y) {
+    const uint8_t* row = frame.pixels + static_cast<std::ptrdiff_t>(frame.pitch) * y;
+    for (int x = 0; x < frame.width; ++x) {
+      std::array<uint8_t, 4> pixel{row[4 * x], row[4 * x + 1], row[4 * x + 2], row[4 * x + 3]};
+      if (pixel == previous) {
+        if (++run == 62) {
+          output.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+          run = 0;
+        }
+        continue;
+      }
+      if (run > 0) {
+        output.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+        run = 0;
+      }
+      int hash = (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+      if (seen[hash] == pixel) {
+        output.push_back(static_cast<uint8_t>(hash));
+      } else {
+        seen[hash] = pixel;
+        if (pixel[3] == previous[3]) {
+          auto dr = static_cast<int8_t>(pixel[0] - previous[0]);
+          auto dg = static_cast<int8_t>(pixel[1] - previous[1]);
+          auto db = static_cast<int8_t>(pixel[2] - previous[2]);
+          int dr_dg = dr - dg;
+          int db_dg = db - dg;
+          if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+            output.push_back(static_cast<uint8_t>(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+          } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 &&
+                     db_dg <= 7) {
+            output.push_back(static_cast<uint8_t>(0x80 | (dg + 32)));
+            output.push_back(static_cast<uint8_t>((dr_dg + 8) << 4 | (db_dg + 8)));
+          } else {
+            output.insert(output.end(), {0xFE, pixel[0], pixel[1], pixel[2]});
+          }
+        } else {
+          output.insert(output.end(), {0xFF, pixel[0], pixel[1], pixel[2], pixel[3]});
+        }
+      }
+      previous = pixel;
+    }
+  }
+  if (run > 0) {
+    output.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+  }
+  output.insert(output.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+  return output;
+}
+
+std::vector<uint8_t> OffscreenContext::EncodePng(const Frame& frame) {
+  std::vector<uint8_t> output{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+  std::vector<uint8_t> header;
+  AppendBigEndian(header, static_cast<uint32_t>(frame.width));
+  AppendBigEndian(header, static_cast<uint32_t>(frame.height));
+  header.insert(header.end(), {8, 6, 0, 0, 0});  // 8-bit RGBA, deflate, no filter, no interlace
+  AppendChunk(output, "IHDR", header);
+
+  // Scanlines without filtering, stored in uncompressed deflate blocks of at most 65535 bytes
+  std::size_t row_size = static_cast<std::size_t>(frame.width) * 4;
+  std::vector<uint8_t> raw;
+  raw.reserve((row_size + 1) * frame.height);
+  for (int y = 0; y < frame.height; ++y) {
+    const uint8_t* row = frame.pixels + static_cast<std::ptrdiff_t>(frame.pitch) * y;
+    raw.push_back(0);
+    raw.insert(raw.end(), row, row + row_size);
+  }
+  std::vector<uint8_t> data{0x78, 0x01};
+  data.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+  std::size_t offset = 0;
+  do {
+    std::size_t length = std::min<std::size_t>(raw.size() - offset, 65535);
+    bool last = offset + length == raw.size();
+    data.push_back(last ? 1 : 0);
+    data.push_back(static_cast<uint8_t>(length));
+    data.push_back(static_cast<uint8_t>(length >> 8U));
+    data.push_back(static_cast<uint8_t>(~length));
+    data.push_back(static_cast<uint8_t>(~length >> 8U));
+    data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + length);
+    offset += length;
+  } while (offset < raw.size());
+  uint32_t a = 1;
+  uint32_t b = 0;
+  for (uint8_t byte : raw) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  AppendBigEndian(data, b << 16U | a);
+  AppendChunk(output, "IDAT", data);
+  AppendChunk(output, "IEND", {});
+  return output;
+}
+
+void OffscreenContext::Encode() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex);
+    queue_changed.wait(lock, [this] { return stopping || !jobs.empty(); });
+    if (jobs.empty()) {
+      return;
+    }
+    Job job = std::move(jobs.front());
+    jobs.pop_front();
+    encoding = true;
+    lock.unlock();
+    queue_changed.notify_all();
+
+    try {
+      Frame frame{job.pixels.data(), job.width, job.height, job.width * 4};
+      std::vector<uint8_t> file =
+          job.format == ImageFormat::PNG ? EncodePng(frame) : EncodeQoi(frame);
+      std::ofstream stream(job.path, std::ios::binary);
+      stream.write(reinterpret_cast<const char*>(file.data()),
+                   static_cast<std::streamsize>(file.size()));
+      if (!stream) {
+        throw OffscreenContextException("Failed to write " + job.path);
+      }
+    } catch (...) {
+      lock.lock();
+      if (!error) {
+        error = std::current_exception();
+      }
+      lock.unlock();
+    }
+
+    lock.lock();
+    encoding = false;
+    lock.unlock();
+    queue_changed.notify_all();
+  }
+}
+
+void OffscreenContext::RethrowError() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (error) {
+    std::rethrow_exception(std::exchange(error, nullptr));
+  }
+}
+
+void OffscreenContext::RestoreHints() {
+  if (video_driver) {
+    RestoreHint(SDL_HINT_VIDEODRIVER, *video_driver, SDL_HINT_NORMAL);
+  }
+  if (scale_quality) {
+    RestoreHint(SDL_HINT_RENDER_SCALE_QUALITY, *scale_quality, SDL_HINT_OVERRIDE);
+  }
+}
@@ -0,0 +1,49 @@
+#include "sdlxx/core/pixel_view.h"
+
+#include <cstddef>
+
+#include <SDL_pixels.h>
+#include <SDL_surface.h>
+
+using namespace sdlxx;
+
+static_assert(PixelFormat::RGBA8888::FORMAT == SDL_PIXELFORMAT_RGBA8888);
+static_assert(PixelFormat::ARGB8888::FORMAT == SDL_PIXELFORMAT_ARGB8888);
+static_assert(PixelFormat::RGB565::FORMAT == SDL_PIXELFORMAT_RGB565);
+static_assert(PixelFormat::INDEX8::FORMAT == SDL_PIXELFORMAT_INDEX8);
+
+// Palette colors are passed to the views without copying
+static_assert(sizeof(Color) == sizeof(SDL_Color));
+static_assert(offsetof(Color, r) == offsetof(SDL_Color, r));
+static_assert(offsetof(Color, g) == offsetof(SDL_Color, g));
+static_assert(offsetof(Color, b) == offsetof(SDL_Color, b));
+static_assert(offsetof(Color, a) == offsetof(SDL_Color, a));
+
+namespace {
+
+PixelLayout MakeLayout(void* pixels, const Surface& surface) {
+  PixelLayout layout;
+  layout.pixels = pixels;
+  Dimensions size = surface.GetSize();
+  layout.width = size.width;
+  layout.height = size.height;
+  layout.pitch = surface.GetPitch();
+  SDL_PixelFormat* format = surface.GetFormat();
+  layout.format = format->format;
+  if (format->palette != nullptr) {
+    layout.palette = reinterpret_cast<const Color*>(format->palette->colors);
+    layout.palette_size = format->palette->ncolors;
+  }
+  return layout;
+}
+
+}  // namespace
+
+PixelLayout sdlxx::GetPixelLayout(Surface& surface) {
+  void* pixels = surface.GetPixels();
+  return MakeLayout(pixels, surface);
+}
+
+PixelLayout sdlxx::GetPixelLayout(const Surface& surface) {
+  return MakeLayout(const_cast<void*>(surface.GetPixels()), surface);
+}
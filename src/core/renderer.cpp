@@ -6,6 +6,7 @@
 #include <SDL_rect.h>
 #include <SDL_render.h>
 #include <SDL_stdinc.h>
+#include <SDL_version.h>
 
 #include "sdlxx/core/point.h"
 #include "sdlxx/core/rectangle.h"
@@ -85,7 +86,7 @@ Renderer::Renderer(Window& window, Renderer::Driver driver, BitMask<Flag> flags)
 }
 
 Renderer::Renderer(Surface& surface)
-    : renderer_ptr(SDL_CreateSoftwareRenderer(surface.surface_ptr.get())) {
+    : renderer_ptr(SDL_CreateSoftwareRenderer(surface.Pin())) {
   if (renderer_ptr == nullptr) {
     throw RendererException("Failed to create a 2D rendering context for a surface");
   }
@@ -407,6 +408,37 @@ void Renderer::Copy(const Texture& texture, const Rectangle& source, const Recta
   }
 }
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+static_assert(sizeof(Renderer::Vertex) == sizeof(SDL_Vertex) &&
+                  offsetof(Renderer::Vertex, color) == offsetof(SDL_Vertex, color) &&
+                  offsetof(Renderer::Vertex, u) == offsetof(SDL_Vertex, tex_coord),
+              "Renderer::Vertex must be layout-compatible with SDL_Vertex");
+#endif
+
+bool Renderer::IsGeometrySupported() {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  SDL_version linked;
+  SDL_GetVersion(&linked);
+  return SDL_VERSIONNUM(linked.major, linked.minor, linked.patch) >= SDL_VERSIONNUM(2, 0, 18);
+#else
+  return false;
+#endif
+}
+
+void Renderer::RenderGeometry(const Texture* texture, const Vertex* vertices, int num_vertices,
+                              const int* indices, int num_indices) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  int return_code = SDL_RenderGeometry(
+      renderer_ptr.get(), texture != nullptr ? texture->texture_ptr.get() : nullptr,
+      reinterpret_cast<const SDL_Vertex*>(vertices), num_vertices, indices, num_indices);
+  if (return_code != 0) {
+    throw RendererException("Failed to render geometry");
+  }
+#else
+  throw RendererException("Geometry rendering requires SDL 2.0.18 or newer");
+#endif
+}
+
 void Renderer::ReadPixels(uint32_t format, void* pixels, int pitch) {
   int return_code =
       SDL_RenderReadPixels(renderer_ptr.get(), nullptr, static_cast<Uint32>(format), pixels, pitch);
@@ -426,6 +458,13 @@ void Renderer::ReadPixels(const Rectangle& rectangle, uint32_t format, void* pix
 
 void Renderer::RenderPresent() { SDL_RenderPresent(renderer_ptr.get()); }
 
+void Renderer::Flush() {
+  int return_code = SDL_RenderFlush(renderer_ptr.get());
+  if (return_code != 0) {
+    throw RendererException("Failed to flush the rendering commands");
+  }
+}
+
 void Renderer::Render(Renderable& renderable) { renderable.Render(*this); }
 
 SDL_Renderer* Renderer::Release() { return renderer_ptr.release(); }
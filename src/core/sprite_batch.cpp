@@ -0,0 +1,117 @@
+#include "sdlxx/core/sprite_batch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sdlxx/core/texture.h"
+#include "sdlxx/utils/angle.h"
+
+using namespace sdlxx;
+
+namespace {
+
+// Keep the index buffer small enough for all backends
+constexpr std::size_t MAX_SPRITES_PER_CALL = 16384;
+
+}  // namespace
+
+SpriteBatch::SpriteBatch(Renderer& renderer, std::size_t capacity)
+    : renderer(renderer), geometry(Renderer::IsGeometrySupported()) {
+  capacity = std::min(capacity, MAX_SPRITES_PER_CALL);
+  if (geometry) {
+    vertices.reserve(capacity * 4);
+    indices.reserve(capacity * 6);
+  } else {
+    sprites.reserve(capacity);
+  }
+}
+
+void SpriteBatch::Draw(const Texture& texture, const Rectangle& source, float x, float y,
+                       float width, float height, float angle, Color color) {
+  if (&texture != this->texture) {
+    Flush();
+    this->texture = &texture;
+    Dimensions dimensions = texture.Query().dimensions;
+    inverse_width = dimensions.width > 0 ? 1.0F / static_cast<float>(dimensions.width) : 0.0F;
+    inverse_height = dimensions.height > 0 ? 1.0F / static_cast<float>(dimensions.height) : 0.0F;
+  }
+
+  if (!geometry) {
+    Rectangle dest{static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)),
+                   static_cast<int>(std::lround(width)), static_cast<int>(std::lround(height))};
+    sprites.push_back({source, dest, angle});
+    return;
+  }
+
+  const float half_width = width * 0.5F;
+  const float half_height = height * 0.5F;
+  const float center_x = x + half_width;
+  const float center_y = y + half_height;
+  float cos = 1.0F;
+  float sin = 0.0F;
+  if (angle != 0.0F) {
+    cos = std::cos(angle * DEGREES_TO_RADIANS);
+    sin = std::sin(angle * DEGREES_TO_RADIANS);
+  }
+  // Rotated half-axes of the quad
+  const float ax = half_width * cos;
+  const float ay = half_width * sin;
+  const float bx = -half_height * sin;
+  const float by = half_height * cos;
+
+  const float u0 = static_cast<float>(source.x) * inverse_width;
+  const float v0 = static_cast<float>(source.y) * inverse_height;
+  const float u1 = static_cast<float>(source.x + source.width) * inverse_width;
+  const float v1 = static_cast<float>(source.y + source.height) * inverse_height;
+
+  vertices.push_back({center_x - ax - bx, center_y - ay - by, color, u0, v0});
+  vertices.push_back({center_x + ax - bx, center_y + ay - by, color, u1, v0});
+  vertices.push_back({center_x + ax + bx, center_y + ay + by, color, u1, v1});
+  vertices.push_back({center_x - ax + bx, center_y - ay + by, color, u0, v1});
+
+  if (vertices.size() >= MAX_SPRITES_PER_CALL * 4) {
+    Flush();
+  }
+}
+
+void SpriteBatch::Flush() {
+  if (!geometry) {
+    for (const Sprite& sprite : sprites) {
+      if (sprite.angle != 0.0F) {
+        renderer.Copy(*texture, sprite.source, sprite.dest, sprite.angle);
+      } else {
+        renderer.Copy(*texture, sprite.source, sprite.dest);
+      }
+    }
+    render_calls += sprites.size();
+    sprite_count += sprites.size();
+    sprites.clear();
+    return;
+  }
+
+  if (vertices.empty()) {
+    return;
+  }
+  const std::size_t count = vertices.size() / 4;
+  // Index pattern is the same for every batch, so it is only extended when needed
+  for (auto quad = static_cast<int>(indices.size() / 6); quad < static_cast<int>(count); ++quad) {
+    int first = quad * 4;
+    indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+  }
+  try {
+    renderer.RenderGeometry(texture, vertices.data(), static_cast<int>(vertices.size()),
+                            indices.data(), static_cast<int>(count * 6));
+  } catch (...) {
+    // Drop the batch, so that a failed call is not repeated with the next one
+    vertices.clear();
+    throw;
+  }
+  vertices.clear();
+  ++render_calls;
+  sprite_count += count;
+}
+
+void SpriteBatch::ResetStatistics() {
+  render_calls = 0;
+  sprite_count = 0;
+}
@@ -1,11 +1,29 @@
 #include "sdlxx/core/surface.h"
 
+#include <atomic>
+#include <utility>
+
 #include <SDL_surface.h>
 
 #include "sdlxx/core/color.h"
 
 using namespace sdlxx;
 
+namespace {
+
+std::atomic<std::size_t> deep_copy_count{0};
+
+SDL_Surface* Duplicate(SDL_Surface* ptr) {
+  SDL_Surface* copy = SDL_DuplicateSurface(ptr);
+  if (copy == nullptr) {
+    throw SurfaceException("Failed to duplicate a surface");
+  }
+  deep_copy_count.fetch_add(1, std::memory_order_relaxed);
+  return copy;
+}
+
+}  // namespace
+
 Surface::Surface(int width, int height, int depth, uint32_t r_mask, uint32_t g_mask,
                  uint32_t b_mask, uint32_t a_mask)
     : Surface(SDL_CreateRGBSurface(0, width, height, depth, r_mask, g_mask, b_mask, a_mask)) {}
@@ -21,25 +39,52 @@ Surface::Surface(void* pixels, int width, int height, int depth, int pitch, uint
 Surface::Surface(void* pixels, int width, int height, int depth, int pitch, uint32_t format)
     : Surface(SDL_CreateRGBSurfaceWithFormatFrom(pixels, width, height, depth, pitch, format)) {}
 
-Surface::Surface(SDL_Surface* ptr) : surface_ptr(ptr) {
-  if (!surface_ptr) {
+Surface::Surface(SDL_Surface* ptr) {
+  if (ptr == nullptr) {
     throw SurfaceException("Failed to allocate a surface");
   }
+  buffer = std::make_shared<Buffer>(ptr);
+  // Pixels owned by a window or by the user must be modified in place
+  pinned = (ptr->flags & static_cast<Uint32>(SDL_DONTFREE | SDL_PREALLOC)) != 0;
 }
 
-Surface::Surface(const Surface& other) : Surface(SDL_DuplicateSurface(other.surface_ptr.get())) {}
+Surface::Surface(const Surface& other) : buffer(other.buffer) {
+  if (other.pinned) {
+    buffer = std::make_shared<Buffer>(Duplicate(other.Get()));
+  }
+}
 
 Surface& Surface::operator=(const Surface& other) {
   if (this != &other) {
     Surface temp(other);
-    std::swap(temp.surface_ptr, surface_ptr);
+    std::swap(temp.buffer, buffer);
+    pinned = false;
   }
   return *this;
 }
 
-bool Surface::Lock() { return SDL_LockSurface(surface_ptr.get()) == 0; }
+Surface Surface::Clone() const { return Surface(Duplicate(Get())); }
+
+void Surface::Detach() {
+  if (buffer && buffer.use_count() > 1) {
+    buffer = std::make_shared<Buffer>(Duplicate(buffer->ptr));
+  }
+}
+
+bool Surface::IsShared() const { return buffer && buffer.use_count() > 1; }
+
+std::size_t Surface::GetDeepCopyCount() {
+  return deep_copy_count.load(std::memory_order_relaxed);
+}
+
+void Surface::ResetDeepCopyCount() { deep_copy_count.store(0, std::memory_order_relaxed); }
+
+bool Surface::Lock() {
+  // The pixels may be written through GetPixels() until Unlock(), which copies can not see
+  return SDL_LockSurface(Pin()) == 0;
+}
 
-void Surface::Unlock() { SDL_UnlockSurface(surface_ptr.get()); }
+void Surface::Unlock() { SDL_UnlockSurface(Get()); }
 
 Surface Surface::LoadBMP(const std::string& file) {
   SDL_Surface* ptr = SDL_LoadBMP(file.c_str());
@@ -47,45 +92,45 @@ Surface Surface::LoadBMP(const std::string& file) {
 }
 
 void Surface::SaveBMP(const std::string& file) const {
-  int return_code = SDL_SaveBMP(surface_ptr.get(), file.c_str());
+  int return_code = SDL_SaveBMP(Get(), file.c_str());
   if (return_code != 0) {
     throw SurfaceException("Failed to save surface to " + file);
   }
 }
 
 void Surface::SetColorKey(Color color) {
-  Uint32 key = SDL_MapRGB(surface_ptr->format, color.r, color.g, color.b);
-  int return_code = SDL_SetColorKey(surface_ptr.get(), 1, key);
+  Uint32 key = SDL_MapRGB(Get()->format, color.r, color.g, color.b);
+  int return_code = SDL_SetColorKey(GetForWriting(), 1, key);
   if (return_code != 0) {
     throw SurfaceException("Failed to set color key for the surface");
   }
 }
 
 void Surface::ResetColorKey() {
-  Uint32 key = SDL_MapRGB(surface_ptr->format, 0, 0, 0);
-  int return_code = SDL_SetColorKey(surface_ptr.get(), 0, key);
+  Uint32 key = SDL_MapRGB(Get()->format, 0, 0, 0);
+  int return_code = SDL_SetColorKey(GetForWriting(), 0, key);
   if (return_code != 0) {
     throw SurfaceException("Failed to reset color key for the surface");
   }
 }
 
-bool Surface::HasColorKey() const { return SDL_HasColorKey(surface_ptr.get()) == SDL_TRUE; }
+bool Surface::HasColorKey() const { return SDL_HasColorKey(Get()) == SDL_TRUE; }
 
 bool Surface::SetClipRectangle(const Rectangle& rectangle) {
   SDL_Rect rect{rectangle.x, rectangle.y, rectangle.width, rectangle.height};
-  return SDL_SetClipRect(surface_ptr.get(), &rect) == SDL_TRUE;
+  return SDL_SetClipRect(GetForWriting(), &rect) == SDL_TRUE;
 }
 
-void Surface::DisableClipRectangle() { SDL_SetClipRect(surface_ptr.get(), nullptr); }
+void Surface::DisableClipRectangle() { SDL_SetClipRect(GetForWriting(), nullptr); }
 
 Rectangle Surface::GetClipRectangle() const {
   SDL_Rect rect;
-  SDL_GetClipRect(surface_ptr.get(), &rect);
+  SDL_GetClipRect(Get(), &rect);
   return {rect.x, rect.y, rect.w, rect.h};
 }
 
 std::optional<Surface> Surface::Convert(const SDL_PixelFormat* fmt, uint32_t flags) {
-  SDL_Surface* result = SDL_ConvertSurface(surface_ptr.get(), fmt, flags);
+  SDL_Surface* result = SDL_ConvertSurface(Get(), fmt, flags);
   if (result != nullptr) {
     return Surface(result);
   }
@@ -93,7 +138,7 @@ std::optional<Surface> Surface::Convert(const SDL_PixelFormat* fmt, uint32_t fla
 }
 
 std::optional<Surface> Surface::ConvertFormat(uint32_t pixel_format, uint32_t flags) {
-  SDL_Surface* result = SDL_ConvertSurfaceFormat(surface_ptr.get(), pixel_format, flags);
+  SDL_Surface* result = SDL_ConvertSurfaceFormat(Get(), pixel_format, flags);
   if (result != nullptr) {
     return Surface(result);
   }
@@ -110,37 +155,37 @@ void Surface::ConvertPixels(int width, int height, uint32_t src_format, const vo
 }
 
 void Surface::Fill(const Color& color) {
-  uint32_t rgb_color = SDL_MapRGB(surface_ptr->format, color.r, color.g, color.b);
-  int return_code = SDL_FillRect(surface_ptr.get(), nullptr, rgb_color);
+  uint32_t rgb_color = SDL_MapRGB(Get()->format, color.r, color.g, color.b);
+  int return_code = SDL_FillRect(GetForWriting(), nullptr, rgb_color);
   if (return_code != 0) {
     throw SurfaceException("Failed to fill a surface with color");
   }
 }
 
 void Surface::FillRectangle(const Rectangle& rectangle, const Color& color) {
-  uint32_t rgb_color = SDL_MapRGB(surface_ptr->format, color.r, color.g, color.b);
+  uint32_t rgb_color = SDL_MapRGB(Get()->format, color.r, color.g, color.b);
   SDL_Rect rect{rectangle.x, rectangle.y, rectangle.width, rectangle.height};
-  int return_code = SDL_FillRect(surface_ptr.get(), &rect, rgb_color);
+  int return_code = SDL_FillRect(GetForWriting(), &rect, rgb_color);
   if (return_code != 0) {
     throw SurfaceException("Failed to fill a surface rectangle with color");
   }
 }
 
 void Surface::FillRectangles(const std::vector<Rectangle>& rectangles, const Color& color) {
-  uint32_t rgb_color = SDL_MapRGB(surface_ptr->format, color.r, color.g, color.b);
+  uint32_t rgb_color = SDL_MapRGB(Get()->format, color.r, color.g, color.b);
   std::vector<SDL_Rect> rects;
   rects.reserve(rectangles.size());
   for (const Rectangle& rectangle : rectangles) {
     rects.push_back({rectangle.x, rectangle.y, rectangle.width, rectangle.height});
   }
-  int return_code = SDL_FillRects(surface_ptr.get(), rects.data(), rects.size(), rgb_color);
+  int return_code = SDL_FillRects(GetForWriting(), rects.data(), rects.size(), rgb_color);
   if (return_code != 0) {
     throw SurfaceException("Failed to fill a surface rectangles with color");
   }
 }
 
 void Surface::Blit(const Surface& source) {
-  int return_code = SDL_BlitSurface(source.surface_ptr.get(), nullptr, surface_ptr.get(), nullptr);
+  int return_code = SDL_BlitSurface(source.Get(), nullptr, GetForWriting(), nullptr);
   if (return_code != 0) {
     throw SurfaceException("Failed to perform a blit of a surface");
   }
@@ -150,15 +195,14 @@ void Surface::Blit(const Surface& source, const Rectangle& source_rect,
                    const Rectangle& dest_rect) {
   SDL_Rect srcrect{source_rect.x, source_rect.y, source_rect.width, source_rect.height};
   SDL_Rect dstrect{dest_rect.x, dest_rect.y, dest_rect.width, dest_rect.height};
-  int return_code =
-      SDL_BlitSurface(source.surface_ptr.get(), &srcrect, surface_ptr.get(), &dstrect);
+  int return_code = SDL_BlitSurface(source.Get(), &srcrect, GetForWriting(), &dstrect);
   if (return_code != 0) {
     throw SurfaceException("Failed to perform a blit of a surface");
   }
 }
 
 void Surface::BlitScaled(const Surface& source) {
-  int return_code = SDL_BlitScaled(source.surface_ptr.get(), nullptr, surface_ptr.get(), nullptr);
+  int return_code = SDL_BlitScaled(source.Get(), nullptr, GetForWriting(), nullptr);
   if (return_code == -1) {
     throw SurfaceException("Failed to perform scaled blit of a surface");
   }
@@ -168,21 +212,48 @@ void Surface::BlitScaled(const Surface& source, const Rectangle& source_rect,
                          const Rectangle& dest_rect) {
   SDL_Rect srcrect{source_rect.x, source_rect.y, source_rect.width, source_rect.height};
   SDL_Rect dstrect{dest_rect.x, dest_rect.y, dest_rect.width, dest_rect.height};
-  int return_code = SDL_BlitScaled(source.surface_ptr.get(), &srcrect, surface_ptr.get(), &dstrect);
+  int return_code = SDL_BlitScaled(source.Get(), &srcrect, GetForWriting(), &dstrect);
   if (return_code == -1) {
     throw SurfaceException("Failed to perform scaled blit of a surface");
   }
 }
 
-Dimensions Surface::GetSize() const { return {surface_ptr->w, surface_ptr->h}; }
+Dimensions Surface::GetSize() const { return {Get()->w, Get()->h}; }
+
+void* Surface::GetPixels() {
+  // The returned pointer may be written through at any later time, so copies must not share it
+  return Pin()->pixels;
+}
+
+const void* Surface::GetPixels() const { return Get()->pixels; }
+
+int Surface::GetPitch() const { return Get()->pitch; }
 
-void* Surface::GetPixels() const { return surface_ptr->pixels; }
+SDL_PixelFormat* Surface::GetFormat() const { return Get()->format; }
 
-SDL_PixelFormat* Surface::GetFormat() const { return surface_ptr->format; }
+SDL_Surface* Surface::Release() {
+  if (!buffer) {
+    return nullptr;
+  }
+  Detach();
+  SDL_Surface* ptr = std::exchange(buffer->ptr, nullptr);
+  buffer.reset();
+  pinned = false;
+  return ptr;
+}
 
-SDL_Surface* Surface::Release() { return surface_ptr.release(); }
+SDL_Surface* Surface::GetForWriting() {
+  Detach();
+  return Get();
+}
+
+SDL_Surface* Surface::Pin() {
+  Detach();
+  pinned = true;
+  return Get();
+}
 
-void Surface::Deleter::operator()(SDL_Surface* ptr) const {
+Surface::Buffer::~Buffer() {
   if (ptr != nullptr && (ptr->flags & static_cast<Uint32>(SDL_DONTFREE)) == 0) {
     SDL_FreeSurface(ptr);
   }
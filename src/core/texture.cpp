@@ -16,7 +16,7 @@ Texture::Texture(Renderer& renderer, Dimensions dimensions, Texture::Format form
 
 Texture::Texture(Renderer& renderer, const Surface& surface)
     : texture_ptr(
-          SDL_CreateTextureFromSurface(GetRendererPtr(renderer), surface.surface_ptr.get())) {}
+          SDL_CreateTextureFromSurface(GetRendererPtr(renderer), surface.Get())) {}
 
 Texture::Texture(SDL_Texture* ptr) : texture_ptr(ptr) {
   if (!texture_ptr) {
@@ -0,0 +1,94 @@
+#include "sdlxx/core/thread_pool.h"
+
+#include <utility>
+
+using namespace sdlxx;
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  workers.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers.emplace_back([this] { Work(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  start.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::ParallelFor(std::size_t count, const std::function<void(std::size_t)>& function) {
+  if (count == 0) {
+    return;
+  }
+  if (workers.empty() || count == 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->function = &function;
+    this->count = count;
+    next.store(0, std::memory_order_relaxed);
+    error = nullptr;
+    active = workers.size();
+    ++job;
+  }
+  start.notify_all();
+
+  RunIterations();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  finish.wait(lock, [this] { return active == 0; });
+  this->function = nullptr;
+  if (error) {
+    std::rethrow_exception(std::exchange(error, nullptr));
+  }
+}
+
+std::size_t ThreadPool::GetDefaultThreadCount() {
+  unsigned cores = std::thread::hardware_concurrency();
+  return cores > 1 ? cores - 1 : 0;
+}
+
+void ThreadPool::Work() {
+  uint64_t last_job = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      start.wait(lock, [this, last_job] { return stopping || job != last_job; });
+      if (stopping) {
+        return;
+      }
+      last_job = job;
+    }
+    RunIterations();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      --active;
+    }
+    finish.notify_one();
+  }
+}
+
+void ThreadPool::RunIterations() {
+  for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+       i = next.fetch_add(1, std::memory_order_relaxed)) {
+    try {
+      (*function)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+}
@@ -0,0 +1,504 @@
+#include "sdlxx/core/tile_renderer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+
+#include <SDL_pixels.h>
+#include <SDL_surface.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "sdlxx/core/surface.h"
+#include "sdlxx/core/thread_pool.h"
+
+using namespace sdlxx;
+
+namespace {
+
+Rectangle Intersect(const Rectangle& a, const Rectangle& b) {
+  int x1 = std::max(a.x, b.x);
+  int y1 = std::max(a.y, b.y);
+  int x2 = std::min(a.x + a.width, b.x + b.width);
+  int y2 = std::min(a.y + a.height, b.y + b.height);
+  return {x1, y1, std::max(x2 - x1, 0), std::max(y2 - y1, 0)};
+}
+
+bool IsEmpty(const Rectangle& rectangle) { return rectangle.width <= 0 || rectangle.height <= 0; }
+
+bool IsSupported(BlendMode mode) {
+  return mode == BlendMode::NONE || mode == BlendMode::BLEND || mode == BlendMode::ADD ||
+         mode == BlendMode::MOD;
+}
+
+// Rounded division by 255, exact for all products of two 8-bit values
+inline uint32_t Div255(uint32_t x) {
+  x += 128;
+  return (x + (x >> 8U)) >> 8U;
+}
+
+/**
+ * The offsets from start along an axis, in the given direction, of the coordinates in
+ * [low, high).
+ */
+void GetAxisRange(int start, int step, int low, int high, int64_t& first, int64_t& last) {
+  if (step > 0) {
+    first = static_cast<int64_t>(low) - start;
+    last = static_cast<int64_t>(high) - 1 - start;
+  } else {
+    first = static_cast<int64_t>(start) - (high - 1);
+    last = static_cast<int64_t>(start) - low;
+  }
+}
+
+/**
+ * Step k of Bresenham's algorithm along a line of `major` steps over the longer axis and
+ * `minor` steps over the shorter one moves round(k * minor / major) steps over the shorter axis,
+ * rounding halves up.
+ */
+int64_t GetMinorSteps(int64_t k, int64_t major, int64_t minor) {
+  return major == 0 ? 0 : (2 * k * minor + major) / (2 * major);
+}
+
+/**
+ * Find the steps of a line with end points (x, y, x2, y2) whose pixels are inside the area.
+ *
+ * The line takes one step over its longer axis per pixel and the steps over the shorter axis
+ * are monotonic, so the pixels inside the area are the steps in [first, last].
+ *
+ * \return false if no pixel of the line is inside the area.
+ */
+bool ClipLine(const Rectangle& line, const Rectangle& area, int& first, int& last) {
+  int64_t dx = std::abs(line.width - line.x);
+  int64_t dy = std::abs(line.height - line.y);
+  int64_t first_x = 0;
+  int64_t last_x = 0;
+  int64_t first_y = 0;
+  int64_t last_y = 0;
+  GetAxisRange(line.x, line.x < line.width ? 1 : -1, area.x, area.x + area.width, first_x,
+               last_x);
+  GetAxisRange(line.y, line.y < line.height ? 1 : -1, area.y, area.y + area.height, first_y,
+               last_y);
+  bool x_major = dx >= dy;
+  int64_t major = x_major ? dx : dy;
+  int64_t minor = x_major ? dy : dx;
+  int64_t first_major = x_major ? first_x : first_y;
+  int64_t last_major = x_major ? last_x : last_y;
+  int64_t first_minor = x_major ? first_y : first_x;
+  int64_t last_minor = x_major ? last_y : last_x;
+
+  int64_t begin = std::max<int64_t>(first_major, 0);
+  int64_t end = std::min(last_major, major);
+  if (last_minor < 0 || first_minor > minor) {
+    return false;
+  }
+  if (minor > 0) {
+    // Invert GetMinorSteps() for the first step at or after first_minor and the last step at
+    // or before last_minor
+    if (first_minor > 0) {
+      int64_t numerator = 2 * major * first_minor - major;
+      begin = std::max(begin, (numerator + 2 * minor - 1) / (2 * minor));
+    }
+    end = std::min(end, (2 * major * last_minor + major - 1) / (2 * minor));
+  }
+  if (begin > end) {
+    return false;
+  }
+  first = static_cast<int>(begin);
+  last = static_cast<int>(end);
+  return true;
+}
+
+struct LineStart {
+  int x;
+  int y;
+  int error;
+};
+
+/**
+ * The state of Bresenham's algorithm at a step of a line, equal to the state reached by
+ * stepping from the first end point.
+ */
+LineStart GetLineStart(const Rectangle& line, int step) {
+  int64_t dx = std::abs(line.width - line.x);
+  int64_t dy = std::abs(line.height - line.y);
+  bool x_major = dx >= dy;
+  int64_t minor_steps = x_major ? GetMinorSteps(step, dx, dy) : GetMinorSteps(step, dy, dx);
+  int64_t steps_x = x_major ? step : minor_steps;
+  int64_t steps_y = x_major ? minor_steps : step;
+  int x = line.x + static_cast<int>(line.x < line.width ? steps_x : -steps_x);
+  int y = line.y + static_cast<int>(line.y < line.height ? steps_y : -steps_y);
+  // Every step over x adds -dy to the error and every step over y adds dx
+  int64_t error = dx - dy - steps_x * dy + steps_y * dx;
+  return {x, y, static_cast<int>(error)};
+}
+
+/**
+ * Combine a span of source pixels with the destination.
+ *
+ * The alpha byte of the source is replaced so that the same per-byte formula produces the
+ * alpha result of BlendMode: 255 for BLEND and MOD, 0 for ADD. Without an alpha channel, all
+ * source pixels have the given alpha.
+ */
+void ComposeScalar(uint32_t* dst, const uint32_t* src, int count, BlendMode mode,
+                   uint32_t alpha_mask, uint32_t alpha_shift, uint32_t alpha) {
+  for (int i = 0; i < count; ++i) {
+    uint32_t s = src[i];
+    uint32_t d = dst[i];
+    uint32_t a = alpha_mask != 0 ? (s >> alpha_shift) & 0xFFU : alpha;
+    uint32_t result = 0;
+    switch (mode) {
+      case BlendMode::BLEND:
+        s |= alpha_mask;
+        for (uint32_t shift = 0; shift < 32; shift += 8) {
+          uint32_t sc = (s >> shift) & 0xFFU;
+          uint32_t dc = (d >> shift) & 0xFFU;
+          result |= Div255(sc * a + dc * (255 - a)) << shift;
+        }
+        break;
+      case BlendMode::ADD:
+        s &= ~alpha_mask;
+        for (uint32_t shift = 0; shift < 32; shift += 8) {
+          uint32_t sc = (s >> shift) & 0xFFU;
+          uint32_t dc = (d >> shift) & 0xFFU;
+          result |= std::min(dc + Div255(sc * a), 255U) << shift;
+        }
+        break;
+      case BlendMode::MOD:
+        s |= alpha_mask;
+        for (uint32_t shift = 0; shift < 32; shift += 8) {
+          uint32_t sc = (s >> shift) & 0xFFU;
+          uint32_t dc = (d >> shift) & 0xFFU;
+          result |= Div255(sc * dc) << shift;
+        }
+        break;
+      default:
+        result = s;
+        break;
+    }
+    dst[i] = result;
+  }
+}
+
+#if defined(__SSE2__)
+
+inline __m128i Div255(__m128i x) {
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+void Compose(uint32_t* dst, const uint32_t* src, int count, BlendMode mode, uint32_t alpha_mask,
+             uint32_t alpha_shift, uint32_t alpha) {
+  if (mode == BlendMode::NONE) {
+    std::copy(src, src + count, dst);
+    return;
+  }
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i full = _mm_set1_epi16(255);
+  const __m128i mask = _mm_set1_epi32(static_cast<int>(alpha_mask));
+  const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(alpha_shift));
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+
+    // Broadcast the source alpha of every pixel to its four bytes
+    __m128i a = _mm_set1_epi32(static_cast<int>(alpha * 0x01010101U));
+    if (alpha_mask != 0) {
+      a = _mm_and_si128(_mm_srl_epi32(s, shift), _mm_set1_epi32(0xFF));
+      a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+      a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+    }
+    __m128i a_lo = _mm_unpacklo_epi8(a, zero);
+    __m128i a_hi = _mm_unpackhi_epi8(a, zero);
+    __m128i d_lo = _mm_unpacklo_epi8(d, zero);
+    __m128i d_hi = _mm_unpackhi_epi8(d, zero);
+
+    __m128i result;
+    if (mode == BlendMode::BLEND) {
+      s = _mm_or_si128(s, mask);
+      __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+      __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+      __m128i lo = _mm_add_epi16(_mm_mullo_epi16(s_lo, a_lo),
+                                 _mm_mullo_epi16(d_lo, _mm_sub_epi16(full, a_lo)));
+      __m128i hi = _mm_add_epi16(_mm_mullo_epi16(s_hi, a_hi),
+                                 _mm_mullo_epi16(d_hi, _mm_sub_epi16(full, a_hi)));
+      result = _mm_packus_epi16(Div255(lo), Div255(hi));
+    } else if (mode == BlendMode::ADD) {
+      s = _mm_andnot_si128(mask, s);
+      __m128i lo = Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), a_lo));
+      __m128i hi = Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), a_hi));
+      result = _mm_adds_epu8(d, _mm_packus_epi16(lo, hi));
+    } else {
+      s = _mm_or_si128(s, mask);
+      __m128i lo = Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), d_lo));
+      __m128i hi = Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), d_hi));
+      result = _mm_packus_epi16(lo, hi);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+  }
+  ComposeScalar(dst + i, src + i, count - i, mode, alpha_mask, alpha_shift, alpha);
+}
+
+#else
+
+void Compose(uint32_t* dst, const uint32_t* src, int count, BlendMode mode, uint32_t alpha_mask,
+             uint32_t alpha_shift, uint32_t alpha) {
+  ComposeScalar(dst, src, count, mode, alpha_mask, alpha_shift, alpha);
+}
+
+#endif
+
+// Map a destination coordinate to the source coordinate sampled at the pixel center
+inline int Sample(int offset, int src_size, int dst_size) {
+  return static_cast<int>((2 * static_cast<int64_t>(offset) + 1) * src_size / (2 * dst_size));
+}
+
+}  // namespace
+
+TileRenderer::TileRenderer(Surface& target, ThreadPool& pool) : target(target), pool(pool) {
+  const SDL_PixelFormat* format = target.GetFormat();
+  if (format->BytesPerPixel != 4 || format->Rloss != 0 || format->Gloss != 0 ||
+      format->Bloss != 0 || (format->Amask != 0 && format->Aloss != 0)) {
+    throw TileRendererException("Only 32-bit surfaces with 8-bit channels are supported");
+  }
+  alpha_mask = format->Amask;
+  alpha_shift = format->Ashift;
+  Dimensions size = target.GetSize();
+  width = size.width;
+  height = size.height;
+  columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+  rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+  bins.resize(static_cast<std::size_t>(columns) * rows);
+}
+
+void TileRenderer::SetDrawColor(const Color& color) { this->color = color; }
+
+void TileRenderer::SetDrawBlendMode(BlendMode mode) {
+  if (!IsSupported(mode)) {
+    throw TileRendererException("Unsupported blend mode");
+  }
+  blend_mode = mode;
+}
+
+void TileRenderer::SetClipRectangle(const Rectangle& rectangle) {
+  clip = rectangle;
+  clipping = true;
+}
+
+void TileRenderer::DisableClipping() { clipping = false; }
+
+void TileRenderer::Clear() {
+  Rectangle all{0, 0, width, height};
+  commands.push_back({CommandType::FILL, BlendMode::NONE,
+                      SDL_MapRGBA(target.GetFormat(), color.r, color.g, color.b, color.a),
+                      color.a, all, all, {}, nullptr});
+}
+
+void TileRenderer::DrawPoint(const Point& point) {
+  Rectangle pixel{point.x, point.y, 1, 1};
+  Record(CommandType::FILL, pixel, pixel, blend_mode);
+}
+
+void TileRenderer::DrawPoints(const std::vector<Point>& points) {
+  for (const Point& point : points) {
+    DrawPoint(point);
+  }
+}
+
+void TileRenderer::DrawLine(const Point& first, const Point& second) {
+  Rectangle bounds{std::min(first.x, second.x), std::min(first.y, second.y),
+                   std::abs(second.x - first.x) + 1, std::abs(second.y - first.y) + 1};
+  Record(CommandType::LINE, bounds, {first.x, first.y, second.x, second.y}, blend_mode);
+}
+
+void TileRenderer::DrawLines(const std::vector<Point>& points) {
+  for (std::size_t i = 1; i < points.size(); ++i) {
+    DrawLine(points[i - 1], points[i]);
+  }
+}
+
+void TileRenderer::DrawRectangle(const Rectangle& rectangle) {
+  if (IsEmpty(rectangle)) {
+    return;
+  }
+  // Edges do not overlap, so the corners are blended only once
+  const Rectangle& r = rectangle;
+  FillRectangle({r.x, r.y, r.width, 1});
+  if (r.height > 1) {
+    FillRectangle({r.x, r.y + r.height - 1, r.width, 1});
+  }
+  if (r.height > 2) {
+    FillRectangle({r.x, r.y + 1, 1, r.height - 2});
+    if (r.width > 1) {
+      FillRectangle({r.x + r.width - 1, r.y + 1, 1, r.height - 2});
+    }
+  }
+}
+
+void TileRenderer::FillRectangle(const Rectangle& rectangle) {
+  Record(CommandType::FILL, rectangle, rectangle, blend_mode);
+}
+
+void TileRenderer::FillRectangles(const std::vector<Rectangle>& rectangles) {
+  for (const Rectangle& rectangle : rectangles) {
+    FillRectangle(rectangle);
+  }
+}
+
+void TileRenderer::Copy(const Surface& source, const Rectangle& src, const Rectangle& dst,
+                        BlendMode mode) {
+  if (source.GetFormat()->format != target.GetFormat()->format) {
+    throw TileRendererException("Source surface has a different pixel format");
+  }
+  if (!IsSupported(mode)) {
+    throw TileRendererException("Unsupported blend mode");
+  }
+  Dimensions size = source.GetSize();
+  Rectangle source_rectangle = Intersect(src, {0, 0, size.width, size.height});
+  if (IsEmpty(source_rectangle) || source_rectangle.width != src.width ||
+      source_rectangle.height != src.height) {
+    throw TileRendererException("Source rectangle is out of the source surface");
+  }
+  Record(CommandType::COPY, dst, dst, mode, src, &source);
+}
+
+void TileRenderer::Present() {
+  if (commands.empty()) {
+    return;
+  }
+  try {
+    for (std::vector<uint32_t>& bin : bins) {
+      bin.clear();
+    }
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+      const Rectangle& bounds = commands[i].bounds;
+      int first_column = bounds.x / TILE_SIZE;
+      int last_column = (bounds.x + bounds.width - 1) / TILE_SIZE;
+      int first_row = bounds.y / TILE_SIZE;
+      int last_row = (bounds.y + bounds.height - 1) / TILE_SIZE;
+      for (int row = first_row; row <= last_row; ++row) {
+        for (int column = first_column; column <= last_column; ++column) {
+          bins[static_cast<std::size_t>(row) * columns + column].push_back(
+              static_cast<uint32_t>(i));
+        }
+      }
+    }
+
+    SurfaceLock lock(target);
+    auto* pixels = static_cast<uint8_t*>(target.GetPixels());
+    int pitch = target.GetPitch();
+    pool.ParallelFor(bins.size(), [this, pixels, pitch](std::size_t tile) {
+      if (!bins[tile].empty()) {
+        RasterizeTile(tile, pixels, pitch);
+      }
+    });
+  } catch (...) {
+    commands.clear();
+    throw;
+  }
+  commands.clear();
+}
+
+void TileRenderer::Record(CommandType type, const Rectangle& bounds, const Rectangle& shape,
+                          BlendMode mode, const Rectangle& src, const Surface* source) {
+  Rectangle visible = Intersect(bounds, {0, 0, width, height});
+  if (clipping) {
+    visible = Intersect(visible, clip);
+  }
+  if (IsEmpty(visible)) {
+    return;
+  }
+  uint32_t pixel = SDL_MapRGBA(target.GetFormat(), color.r, color.g, color.b, color.a);
+  // Sources of copies have the format of the target, so without an alpha channel they are opaque
+  uint8_t alpha = type == CommandType::COPY ? 255 : color.a;
+  commands.push_back({type, mode, pixel, alpha, visible, shape, src, source});
+}
+
+void TileRenderer::RasterizeTile(std::size_t tile, uint8_t* pixels, int pitch) const {
+  int tile_x = static_cast<int>(tile % columns) * TILE_SIZE;
+  int tile_y = static_cast<int>(tile / columns) * TILE_SIZE;
+  Rectangle tile_rectangle{tile_x, tile_y, std::min(TILE_SIZE, width - tile_x),
+                           std::min(TILE_SIZE, height - tile_y)};
+  uint32_t row[TILE_SIZE];
+
+  for (uint32_t index : bins[tile]) {
+    const Command& command = commands[index];
+    Rectangle area = Intersect(command.bounds, tile_rectangle);
+    if (IsEmpty(area)) {
+      continue;
+    }
+    auto row_at = [pixels, pitch, &area](int y) {
+      return reinterpret_cast<uint32_t*>(pixels + static_cast<std::ptrdiff_t>(y) * pitch) +
+             area.x;
+    };
+
+    switch (command.type) {
+      case CommandType::FILL: {
+        std::fill(row, row + area.width, command.pixel);
+        for (int y = area.y; y < area.y + area.height; ++y) {
+          Compose(row_at(y), row, area.width, command.mode, alpha_mask, alpha_shift,
+                  command.alpha);
+        }
+        break;
+      }
+      case CommandType::LINE: {
+        int first = 0;
+        int last = 0;
+        if (!ClipLine(command.shape, area, first, last)) {
+          break;
+        }
+        // Bresenham's algorithm from the first step of the line inside this tile
+        LineStart start = GetLineStart(command.shape, first);
+        int x = start.x;
+        int y = start.y;
+        int x2 = command.shape.width;
+        int y2 = command.shape.height;
+        int dx = std::abs(x2 - command.shape.x);
+        int dy = -std::abs(y2 - command.shape.y);
+        int step_x = command.shape.x < x2 ? 1 : -1;
+        int step_y = command.shape.y < y2 ? 1 : -1;
+        int error = start.error;
+        for (int step = first; step <= last; ++step) {
+          uint32_t* destination = row_at(y) + (x - area.x);
+          Compose(destination, &command.pixel, 1, command.mode, alpha_mask, alpha_shift,
+                  command.alpha);
+          int error2 = 2 * error;
+          if (error2 >= dy) {
+            error += dy;
+            x += step_x;
+          }
+          if (error2 <= dx) {
+            error += dx;
+            y += step_y;
+          }
+        }
+        break;
+      }
+      case CommandType::COPY: {
+        const Rectangle& src = command.src;
+        const Rectangle& dst = command.shape;
+        const auto* source_pixels = static_cast<const uint8_t*>(command.source->GetPixels());
+        int source_pitch = command.source->GetPitch();
+        int source_x[TILE_SIZE];
+        for (int x = 0; x < area.width; ++x) {
+          source_x[x] = src.x + Sample(area.x + x - dst.x, src.width, dst.width);
+        }
+        for (int y = area.y; y < area.y + area.height; ++y) {
+          int source_y = src.y + Sample(y - dst.y, src.height, dst.height);
+          const auto* source_row = reinterpret_cast<const uint32_t*>(
+              source_pixels + static_cast<std::ptrdiff_t>(source_y) * source_pitch);
+          for (int x = 0; x < area.width; ++x) {
+            row[x] = source_row[source_x[x]];
+          }
+          Compose(row_at(y), row, area.width, command.mode, alpha_mask, alpha_shift,
+                  command.alpha);
+        }
+        break;
+      }
+    }
+  }
+}
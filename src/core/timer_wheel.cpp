@@ -0,0 +1,224 @@
+#include "sdlxx/core/timer_wheel.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace sdlxx;
+
+TimerWheel::TimerWheel(Time resolution, std::size_t capacity)
+    : resolution(resolution.AsMicroseconds()), last_counter(Timer::GetPerformanceCounter()) {
+  if (this->resolution <= 0) {
+    throw std::invalid_argument("Timer wheel resolution must be positive");
+  }
+  for (auto& level : wheel) { level.fill(NONE); }
+  entries.resize(capacity);
+  for (std::size_t i = capacity; i > 0; --i) {
+    Free(static_cast<uint32_t>(i - 1));
+  }
+}
+
+TimerWheel::Handle TimerWheel::Schedule(Time delay, Callback callback, Time period) {
+  if (!callback) {
+    throw std::invalid_argument("Timer callback must not be empty");
+  }
+  uint32_t index = Allocate();
+  Entry& entry = entries[index];
+  // Round up, so that a timer never fires earlier than requested
+  auto delay_ticks = static_cast<uint64_t>(
+      (std::max<int64_t>(delay.AsMicroseconds(), 0) + remainder + resolution - 1) / resolution);
+  entry.expiry = current_tick + std::max<uint64_t>(delay_ticks, 1);
+  entry.period = 0;
+  if (period.AsMicroseconds() > 0) {
+    auto period_ticks =
+        static_cast<uint64_t>((period.AsMicroseconds() + resolution - 1) / resolution);
+    entry.period = std::max<uint64_t>(period_ticks, 1);
+  }
+  entry.callback = std::move(callback);
+  Insert(index);
+  ++size;
+  return {index, entry.generation};
+}
+
+bool TimerWheel::Cancel(Handle handle) {
+  if (!IsScheduled(handle)) {
+    return false;
+  }
+  Entry& entry = entries[handle.index];
+  if (entry.state == State::RUNNING) {
+    // The callback is being executed, so the entry is released after it returns
+    ++entry.generation;
+  } else {
+    Unlink(handle.index);
+    Free(handle.index);
+  }
+  --size;
+  return true;
+}
+
+bool TimerWheel::IsScheduled(Handle handle) const {
+  return handle.index < entries.size() && entries[handle.index].generation == handle.generation &&
+         entries[handle.index].state != State::FREE;
+}
+
+std::size_t TimerWheel::Advance() {
+  uint64_t counter = Timer::GetPerformanceCounter();
+  uint64_t frequency = Timer::GetPerformanceFrequency();
+  uint64_t delta = counter - last_counter;
+  last_counter = counter;
+  // Split the conversion to avoid overflow with nanosecond counters
+  auto elapsed = static_cast<int64_t>(delta / frequency * 1000000 +
+                                      delta % frequency * 1000000 / frequency);
+  return Advance(Time::Microseconds(elapsed));
+}
+
+std::size_t TimerWheel::Advance(Time elapsed) {
+  remainder += std::max<int64_t>(elapsed.AsMicroseconds(), 0);
+  std::size_t fired = 0;
+  while (remainder >= resolution) {
+    remainder -= resolution;
+    if (size == 0) {
+      // Nothing to fire or cascade, so skip the remaining whole ticks at once
+      current_tick += static_cast<uint64_t>(remainder / resolution) + 1;
+      remainder %= resolution;
+      break;
+    }
+    fired += Tick();
+  }
+  return fired;
+}
+
+uint32_t TimerWheel::Allocate() {
+  if (free_list == NONE) {
+    entries.emplace_back();
+    return static_cast<uint32_t>(entries.size() - 1);
+  }
+  uint32_t index = free_list;
+  free_list = entries[index].next;
+  return index;
+}
+
+void TimerWheel::Free(uint32_t index) {
+  Entry& entry = entries[index];
+  entry.callback = nullptr;
+  entry.state = State::FREE;
+  ++entry.generation;
+  entry.previous = NONE;
+  entry.next = free_list;
+  free_list = index;
+}
+
+uint32_t& TimerWheel::GetHead(uint16_t list) {
+  if (list == FIRING_LIST) {
+    return firing;
+  }
+  return wheel[list / SLOTS][list % SLOTS];
+}
+
+void TimerWheel::Link(uint32_t index, uint16_t list) {
+  Entry& entry = entries[index];
+  uint32_t& head = GetHead(list);
+  entry.list = list;
+  entry.state = list == FIRING_LIST ? State::FIRING : State::WHEEL;
+  entry.previous = NONE;
+  entry.next = head;
+  if (head != NONE) {
+    entries[head].previous = index;
+  }
+  head = index;
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+  Entry& entry = entries[index];
+  if (entry.previous != NONE) {
+    entries[entry.previous].next = entry.next;
+  } else {
+    GetHead(entry.list) = entry.next;
+  }
+  if (entry.next != NONE) {
+    entries[entry.next].previous = entry.previous;
+  }
+  entry.previous = NONE;
+  entry.next = NONE;
+}
+
+void TimerWheel::Insert(uint32_t index) {
+  uint64_t expiry = entries[index].expiry;
+  uint64_t delta = expiry > current_tick ? expiry - current_tick : 0;
+  for (int level = 0; level < LEVELS; ++level) {
+    uint64_t range = uint64_t{1} << (SLOT_BITS * (level + 1));
+    if (delta < range || level == LEVELS - 1) {
+      if (delta >= range) {
+        // Too far in the future: park in the farthest slot and cascade again later
+        expiry = current_tick + range - 1;
+      }
+      auto slot = static_cast<uint16_t>((expiry >> (SLOT_BITS * level)) & SLOT_MASK);
+      Link(index, static_cast<uint16_t>(level * SLOTS + slot));
+      return;
+    }
+  }
+}
+
+void TimerWheel::Cascade(int level) {
+  auto slot = static_cast<uint32_t>((current_tick >> (SLOT_BITS * level)) & SLOT_MASK);
+  uint32_t index = wheel[level][slot];
+  wheel[level][slot] = NONE;
+  while (index != NONE) {
+    uint32_t next = entries[index].next;
+    Insert(index);
+    index = next;
+  }
+}
+
+std::size_t TimerWheel::Tick() {
+  ++current_tick;
+  // When a lower level wraps around, timers from the next slot of the upper level move down
+  for (int level = 1; level < LEVELS; ++level) {
+    if (((current_tick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0) {
+      break;
+    }
+    Cascade(level);
+  }
+
+  // Move the expired timers to a separate list, so that callbacks can schedule and cancel timers
+  uint32_t& slot = wheel[0][current_tick & SLOT_MASK];
+  while (slot != NONE) {
+    uint32_t index = slot;
+    Unlink(index);
+    Link(index, FIRING_LIST);
+  }
+
+  std::size_t fired = 0;
+  while (firing != NONE) {
+    uint32_t index = firing;
+    Unlink(index);
+    Entry& entry = entries[index];
+    entry.state = State::RUNNING;
+    uint32_t generation = entry.generation;
+    try {
+      entry.callback();
+    } catch (...) {
+      // The remaining expired timers stay in the firing list and fire on the next tick
+      Finish(index, generation);
+      throw;
+    }
+    ++fired;
+    Finish(index, generation);
+  }
+  return fired;
+}
+
+void TimerWheel::Finish(uint32_t index, uint32_t generation) {
+  Entry& entry = entries[index];
+  if (entry.generation != generation) {
+    // Cancelled by the callback: release without invalidating handles once more
+    --entry.generation;
+    Free(index);
+  } else if (entry.period > 0) {
+    entry.expiry = current_tick + entry.period;
+    Insert(index);
+  } else {
+    Free(index);
+    --size;
+  }
+}
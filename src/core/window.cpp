@@ -110,7 +110,7 @@ void Window::SetTitle(const std::string& title) {
 std::string Window::GetTitle() const { return SDL_GetWindowTitle(window_ptr.get()); }
 
 void Window::SetIcon(const Surface& icon) {
-  SDL_SetWindowIcon(window_ptr.get(), icon.surface_ptr.get());
+  SDL_SetWindowIcon(window_ptr.get(), icon.Get());
 }
 
 void* Window::SetData(const std::string& name, void* userdata) {
@@ -0,0 +1,107 @@
+#include "sdlxx/ecs/archetype.h"
+
+#include <algorithm>
+
+using namespace sdlxx;
+using namespace sdlxx::ECS;
+
+namespace {
+
+constexpr std::size_t CHUNK_ALIGNMENT = 64;
+
+std::size_t AlignUp(std::size_t value, std::size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// Compute the offsets of all columns for the given capacity, and return the total size
+std::size_t Layout(const std::vector<ComponentInfo>& infos, std::size_t capacity,
+                   std::vector<std::size_t>& offsets) {
+  std::size_t size = capacity * sizeof(Entity);
+  offsets.clear();
+  for (const ComponentInfo& info : infos) {
+    size = AlignUp(size, info.alignment);
+    offsets.push_back(size);
+    size += capacity * info.size;
+  }
+  return size;
+}
+
+}  // namespace
+
+void Archetype::Chunk::Deleter::operator()(std::byte* data) const {
+  operator delete[](data, std::align_val_t{CHUNK_ALIGNMENT});
+}
+
+Archetype::Archetype(std::vector<ComponentId> components) : components(std::move(components)) {
+  std::size_t row_size = sizeof(Entity);
+  for (ComponentId id : this->components) {
+    infos.push_back(ECS::GetComponentInfo(id));
+    if (infos.back().alignment > CHUNK_ALIGNMENT) {
+      throw EcsException("Component alignment exceeds the chunk alignment");
+    }
+    row_size += infos.back().size;
+  }
+
+  // Start from an estimate and shrink until the padding fits into the chunk
+  std::size_t capacity = std::max<std::size_t>(CHUNK_SIZE / row_size, 1);
+  while (capacity > 1 && Layout(infos, capacity, offsets) > CHUNK_SIZE) {
+    --capacity;
+  }
+  chunk_bytes = std::max(AlignUp(Layout(infos, capacity, offsets), CHUNK_ALIGNMENT), CHUNK_SIZE);
+  chunk_capacity = static_cast<uint32_t>(capacity);
+}
+
+Archetype::~Archetype() { Clear(); }
+
+int Archetype::GetColumn(ComponentId id) const {
+  auto it = std::lower_bound(components.begin(), components.end(), id);
+  if (it == components.end() || *it != id) {
+    return -1;
+  }
+  return static_cast<int>(it - components.begin());
+}
+
+void Archetype::Append(Entity entity, uint32_t& chunk, uint32_t& row) {
+  if (chunks.empty() || chunks.back().size == chunk_capacity) {
+    Chunk new_chunk;
+    new_chunk.data.reset(
+        static_cast<std::byte*>(operator new[](chunk_bytes, std::align_val_t{CHUNK_ALIGNMENT})));
+    chunks.push_back(std::move(new_chunk));
+  }
+  chunk = static_cast<uint32_t>(chunks.size() - 1);
+  row = chunks.back().size++;
+  GetEntities(chunk)[row] = entity;
+}
+
+Entity Archetype::Remove(uint32_t chunk, uint32_t row) {
+  auto last_chunk = static_cast<uint32_t>(chunks.size() - 1);
+  uint32_t last_row = chunks.back().size - 1;
+  Entity moved;
+  if (chunk != last_chunk || row != last_row) {
+    moved = GetEntities(last_chunk)[last_row];
+    GetEntities(chunk)[row] = moved;
+    for (std::size_t column = 0; column < infos.size(); ++column) {
+      infos[column].relocate(GetComponent(chunk, row, static_cast<int>(column)),
+                             GetComponent(last_chunk, last_row, static_cast<int>(column)));
+    }
+  }
+  if (--chunks.back().size == 0) {
+    chunks.pop_back();
+  }
+  return moved;
+}
+
+void Archetype::Destroy(uint32_t chunk, uint32_t row) {
+  for (std::size_t column = 0; column < infos.size(); ++column) {
+    infos[column].destroy(GetComponent(chunk, row, static_cast<int>(column)));
+  }
+}
+
+void Archetype::Clear() {
+  for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+    for (uint32_t row = 0; row < chunks[chunk].size; ++row) {
+      Destroy(static_cast<uint32_t>(chunk), row);
+    }
+  }
+  chunks.clear();
+}
@@ -0,0 +1,38 @@
+#include "sdlxx/ecs/component.h"
+
+#include <deque>
+#include <mutex>
+#include <string>
+
+using namespace sdlxx;
+using namespace sdlxx::ECS;
+
+namespace {
+
+struct Registry {
+  std::mutex mutex;
+  std::deque<ComponentInfo> components;
+};
+
+Registry& GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+}  // namespace
+
+ComponentId ECS::RegisterComponent(const ComponentInfo& info) {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.components.push_back(info);
+  return static_cast<ComponentId>(registry.components.size() - 1);
+}
+
+ComponentInfo ECS::GetComponentInfo(ComponentId id) {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  if (id >= registry.components.size()) {
+    throw EcsException("Component type " + std::to_string(id) + " is not registered");
+  }
+  return registry.components[id];
+}
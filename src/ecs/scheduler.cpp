@@ -0,0 +1,56 @@
+#include "sdlxx/ecs/scheduler.h"
+
+#include <algorithm>
+
+using namespace sdlxx;
+using namespace sdlxx::ECS;
+
+void Scheduler::Add(std::string name, System system, Stage stage) {
+  auto it = std::find_if(systems.begin(), systems.end(),
+                         [&name](const Entry& entry) { return entry.name == name; });
+  if (it != systems.end()) {
+    throw EcsException("System " + name + " already exists");
+  }
+  systems.push_back({std::move(name), std::move(system), stage, true});
+}
+
+bool Scheduler::Remove(const std::string& name) {
+  auto it = std::find_if(systems.begin(), systems.end(),
+                         [&name](const Entry& entry) { return entry.name == name; });
+  if (it == systems.end()) {
+    return false;
+  }
+  systems.erase(it);
+  return true;
+}
+
+void Scheduler::SetEnabled(const std::string& name, bool enabled) {
+  auto it = std::find_if(systems.begin(), systems.end(),
+                         [&name](const Entry& entry) { return entry.name == name; });
+  if (it == systems.end()) {
+    throw EcsException("System " + name + " does not exist");
+  }
+  it->enabled = enabled;
+}
+
+bool Scheduler::IsEnabled(const std::string& name) const {
+  auto it = std::find_if(systems.begin(), systems.end(),
+                         [&name](const Entry& entry) { return entry.name == name; });
+  return it != systems.end() && it->enabled;
+}
+
+void Scheduler::Run(World& world, Stage stage, Time dt) {
+  // Index-based loop, so that systems may add other systems
+  for (std::size_t i = 0; i < systems.size(); ++i) {
+    if (systems[i].stage == stage && systems[i].enabled) {
+      System system = systems[i].system;
+      system(world, dt);
+      world.FlushDeferred();
+    }
+  }
+}
+
+void Scheduler::Update(World& world, Time dt) {
+  Run(world, Stage::PHYSICS, dt);
+  Run(world, Stage::UPDATE, dt);
+}
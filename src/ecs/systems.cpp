@@ -0,0 +1,31 @@
+#include "sdlxx/ecs/systems.h"
+
+#include "sdlxx/core/sprite_batch.h"
+
+using namespace sdlxx;
+using namespace sdlxx::ECS;
+
+Scheduler::System ECS::MakeMovementSystem() {
+  return [](World& world, Time dt) {
+    const float seconds = dt.AsSeconds();
+    world.Each<Position, const Velocity>([seconds](Position& position, const Velocity& velocity) {
+      position.x += velocity.x * seconds;
+      position.y += velocity.y * seconds;
+    });
+  };
+}
+
+Scheduler::System ECS::MakeRenderSystem(SpriteBatch& batch) {
+  return [&batch](World& world, Time /* dt */) {
+    world.Each<const Position, const Sprite, const Rotation*>(
+        [&batch](const Position& position, const Sprite& sprite, const Rotation* rotation) {
+          if (sprite.texture == nullptr) {
+            return;
+          }
+          batch.Draw(*sprite.texture, sprite.source, position.x - sprite.width * 0.5F,
+                     position.y - sprite.height * 0.5F, sprite.width, sprite.height,
+                     rotation != nullptr ? rotation->angle : 0.0F, sprite.color);
+        });
+    batch.Flush();
+  };
+}
@@ -0,0 +1,124 @@
+#include "sdlxx/ecs/world.h"
+
+using namespace sdlxx;
+using namespace sdlxx::ECS;
+
+bool World::Destroy(Entity entity) {
+  CheckNotIterating();
+  if (!IsAlive(entity)) {
+    return false;
+  }
+  Record& record = records[entity.index];
+  Archetype& archetype = *archetypes[record.archetype];
+  archetype.Destroy(record.chunk, record.row);
+  Entity moved = archetype.Remove(record.chunk, record.row);
+  if (moved.index != NONE) {
+    records[moved.index].chunk = record.chunk;
+    records[moved.index].row = record.row;
+  }
+  record.archetype = NONE;
+  ++record.generation;
+  free_records.push_back(entity.index);
+  --size;
+  return true;
+}
+
+void World::FlushDeferred() {
+  CheckNotIterating();
+  // Deferred changes may defer further changes, which are applied in the same call
+  for (std::size_t i = 0; i < deferred.size(); ++i) {
+    std::function<void(World&)> change = std::move(deferred[i]);
+    change(*this);
+  }
+  deferred.clear();
+}
+
+void World::Clear() {
+  CheckNotIterating();
+  for (const auto& archetype : archetypes) {
+    archetype->Clear();
+  }
+  for (uint32_t index = 0; index < records.size(); ++index) {
+    if (records[index].archetype != NONE) {
+      records[index].archetype = NONE;
+      ++records[index].generation;
+      free_records.push_back(index);
+    }
+  }
+  size = 0;
+}
+
+uint32_t World::GetArchetype(std::vector<ComponentId> components) {
+  auto it = archetype_index.find(components);
+  if (it != archetype_index.end()) {
+    return it->second;
+  }
+  auto index = static_cast<uint32_t>(archetypes.size());
+  archetypes.push_back(std::make_unique<Archetype>(components));
+  archetype_index.emplace(std::move(components), index);
+  return index;
+}
+
+Entity World::Allocate(uint32_t archetype) {
+  uint32_t index;
+  if (free_records.empty()) {
+    index = static_cast<uint32_t>(records.size());
+    records.emplace_back();
+  } else {
+    index = free_records.back();
+    free_records.pop_back();
+  }
+  Record& record = records[index];
+  Entity entity{index, record.generation};
+  record.archetype = archetype;
+  archetypes[archetype]->Append(entity, record.chunk, record.row);
+  ++size;
+  return entity;
+}
+
+void World::Move(Entity entity, uint32_t archetype) {
+  Record& record = records[entity.index];
+  Archetype& source = *archetypes[record.archetype];
+  Archetype& target = *archetypes[archetype];
+  uint32_t chunk = 0;
+  uint32_t row = 0;
+  target.Append(entity, chunk, row);
+
+  // Shared components are relocated, and the rest is destroyed
+  const std::vector<ComponentId>& components = source.GetComponents();
+  for (std::size_t column = 0; column < components.size(); ++column) {
+    void* component = source.GetComponent(record.chunk, record.row, static_cast<int>(column));
+    const ComponentInfo& info = source.GetComponentInfo(static_cast<int>(column));
+    int target_column = target.GetColumn(components[column]);
+    if (target_column >= 0) {
+      info.relocate(target.GetComponent(chunk, row, target_column), component);
+    } else {
+      info.destroy(component);
+    }
+  }
+
+  Entity moved = source.Remove(record.chunk, record.row);
+  if (moved.index != NONE) {
+    records[moved.index].chunk = record.chunk;
+    records[moved.index].row = record.row;
+  }
+  record.archetype = archetype;
+  record.chunk = chunk;
+  record.row = row;
+}
+
+void* World::Find(Entity entity, ComponentId id) const {
+  if (!IsAlive(entity)) {
+    return nullptr;
+  }
+  const Record& record = records[entity.index];
+  const Archetype& archetype = *archetypes[record.archetype];
+  int column = archetype.GetColumn(id);
+  return column >= 0 ? archetype.GetComponent(record.chunk, record.row, column) : nullptr;
+}
+
+void World::CheckNotIterating() const {
+  if (iterating > 0) {
+    throw EcsException("World can not be changed while a query is running, use Defer()");
+  }
+}
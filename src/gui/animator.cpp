@@ -0,0 +1,422 @@
+#include "sdlxx/gui/animator.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "sdlxx/gui/node.h"
+
+using namespace sdlxx;
+
+namespace {
+
+// Easing curves are stateless function objects, so that each of them is inlined into its own
+// evaluation loop. The in-out curves use a select instead of a branch to keep the loops
+// vectorizable.
+
+constexpr float BACK_OVERSHOOT = 1.70158F;
+
+struct Linear {
+  float operator()(float t) const { return t; }
+};
+
+struct QuadIn {
+  float operator()(float t) const { return t * t; }
+};
+
+struct QuadOut {
+  float operator()(float t) const {
+    float u = 1.0F - t;
+    return 1.0F - u * u;
+  }
+};
+
+struct QuadInOut {
+  float operator()(float t) const {
+    float u = 1.0F - t;
+    return t < 0.5F ? 2.0F * t * t : 1.0F - 2.0F * u * u;
+  }
+};
+
+struct CubicIn {
+  float operator()(float t) const { return t * t * t; }
+};
+
+struct CubicOut {
+  float operator()(float t) const {
+    float u = 1.0F - t;
+    return 1.0F - u * u * u;
+  }
+};
+
+struct CubicInOut {
+  float operator()(float t) const {
+    float u = 1.0F - t;
+    return t < 0.5F ? 4.0F * t * t * t : 1.0F - 4.0F * u * u * u;
+  }
+};
+
+struct QuartIn {
+  float operator()(float t) const { return t * t * t * t; }
+};
+
+struct QuartOut {
+  float operator()(float t) const {
+    float u = 1.0F - t;
+    return 1.0F - u * u * u * u;
+  }
+};
+
+struct QuartInOut {
+  float operator()(float t) const {
+    float u = 1.0F - t;
+    return t < 0.5F ? 8.0F * t * t * t * t : 1.0F - 8.0F * u * u * u * u;
+  }
+};
+
+struct Smoothstep {
+  float operator()(float t) const { return t * t * (3.0F - 2.0F * t); }
+};
+
+struct BackIn {
+  float operator()(float t) const {
+    return t * t * ((BACK_OVERSHOOT + 1.0F) * t - BACK_OVERSHOOT);
+  }
+};
+
+struct BackOut {
+  float operator()(float t) const {
+    float u = t - 1.0F;
+    return 1.0F + u * u * ((BACK_OVERSHOOT + 1.0F) * u + BACK_OVERSHOOT);
+  }
+};
+
+template <typename Function>
+auto WithCurve(Easing easing, Function&& function) {
+  switch (easing) {
+    case Easing::QUAD_IN:
+      return function(QuadIn{});
+    case Easing::QUAD_OUT:
+      return function(QuadOut{});
+    case Easing::QUAD_IN_OUT:
+      return function(QuadInOut{});
+    case Easing::CUBIC_IN:
+      return function(CubicIn{});
+    case Easing::CUBIC_OUT:
+      return function(CubicOut{});
+    case Easing::CUBIC_IN_OUT:
+      return function(CubicInOut{});
+    case Easing::QUART_IN:
+      return function(QuartIn{});
+    case Easing::QUART_OUT:
+      return function(QuartOut{});
+    case Easing::QUART_IN_OUT:
+      return function(QuartInOut{});
+    case Easing::SMOOTHSTEP:
+      return function(Smoothstep{});
+    case Easing::BACK_IN:
+      return function(BackIn{});
+    case Easing::BACK_OUT:
+      return function(BackOut{});
+    case Easing::LINEAR:
+    default:
+      return function(Linear{});
+  }
+}
+
+template <typename Curve>
+void Evaluate(std::size_t count, float dt, const float* from, const float* to, float* progress,
+              const float* rate, float* value, Curve curve) {
+  for (std::size_t i = 0; i < count; ++i) {
+    float t = std::min(progress[i] + dt * rate[i], 1.0F);
+    float e = curve(t);
+    progress[i] = t;
+    // Exact at both ends, so that the final value is written without rounding errors
+    value[i] = from[i] * (1.0F - e) + to[i] * e;
+  }
+}
+
+void Store(float* target, float value) { *target = value; }
+
+void Store(uint8_t* target, float value) {
+  *target = static_cast<uint8_t>(std::clamp(value, 0.0F, 255.0F) + 0.5F);
+}
+
+}  // namespace
+
+Animator::Animator(std::size_t capacity) {
+  slots.reserve(capacity);
+  free_slots.reserve(capacity);
+  completed.reserve(capacity);
+  callbacks.reserve(capacity);
+}
+
+Animator::Handle Animator::Animate(float& value, float to, Time duration, Easing easing,
+                                   Callback on_complete) {
+  uint32_t index = Allocate(easing, std::move(on_complete));
+  AddLane(index, value, to, duration);
+  return {index, slots[index].generation};
+}
+
+Animator::Handle Animator::Animate(uint8_t& value, uint8_t to, Time duration, Easing easing,
+                                   Callback on_complete) {
+  uint32_t index = Allocate(easing, std::move(on_complete));
+  AddLane(index, value, to, duration);
+  return {index, slots[index].generation};
+}
+
+Animator::Handle Animator::Animate(Color& value, Color to, Time duration, Easing easing,
+                                   Callback on_complete) {
+  uint32_t index = Allocate(easing, std::move(on_complete));
+  AddLane(index, value.r, to.r, duration);
+  AddLane(index, value.g, to.g, duration);
+  AddLane(index, value.b, to.b, duration);
+  AddLane(index, value.a, to.a, duration);
+  return {index, slots[index].generation};
+}
+
+Animator::Handle Animator::MoveTo(Node& node, float x, float y, Time duration, Easing easing,
+                                  Callback on_complete) {
+  Transform& transform = node.GetTransform();
+  uint32_t index = Allocate(easing, std::move(on_complete));
+  BindNode(index, node);
+  AddLane(index, transform.x, x, duration);
+  AddLane(index, transform.y, y, duration);
+  return {index, slots[index].generation};
+}
+
+Animator::Handle Animator::ScaleTo(Node& node, float scale_x, float scale_y, Time duration,
+                                   Easing easing, Callback on_complete) {
+  Transform& transform = node.GetTransform();
+  uint32_t index = Allocate(easing, std::move(on_complete));
+  BindNode(index, node);
+  AddLane(index, transform.scale_x, scale_x, duration);
+  AddLane(index, transform.scale_y, scale_y, duration);
+  return {index, slots[index].generation};
+}
+
+Animator::Handle Animator::RotateTo(Node& node, float angle, Time duration, Easing easing,
+                                    Callback on_complete) {
+  uint32_t index = Allocate(easing, std::move(on_complete));
+  BindNode(index, node);
+  AddLane(index, node.GetTransform().angle, angle, duration);
+  return {index, slots[index].generation};
+}
+
+bool Animator::Cancel(Handle handle) {
+  if (!IsAnimating(handle)) {
+    return false;
+  }
+  Slot& slot = slots[handle.index];
+  Group& group = groups[static_cast<std::size_t>(slot.easing)];
+  for (uint8_t component = 0; component < slot.components; ++component) {
+    // Location is read on every iteration, as removing a lane may move another lane of the slot
+    Location location = slot.lanes[component];
+    if (location.is_byte) {
+      RemoveLane(group.bytes, location.lane);
+    } else {
+      RemoveLane(group.floats, location.lane);
+    }
+  }
+  Release(handle.index);
+  return true;
+}
+
+bool Animator::IsAnimating(Handle handle) const {
+  return handle.index < slots.size() && slots[handle.index].active &&
+         slots[handle.index].generation == handle.generation;
+}
+
+std::size_t Animator::Update(Time dt) {
+  const float seconds = std::max(dt.AsSeconds(), 0.0F);
+  CancelDestroyedNodes();
+  completed.clear();
+  for (std::size_t easing = 0; easing < EASING_COUNT; ++easing) {
+    Step(groups[easing].floats, static_cast<Easing>(easing), seconds);
+    Step(groups[easing].bytes, static_cast<Easing>(easing), seconds);
+  }
+
+  // Callbacks are called after the animator is in a consistent state, so that they may start
+  // or cancel animations, or even update the animator again
+  std::vector<Callback> pending;
+  pending.swap(callbacks);
+  for (uint32_t index : completed) {
+    if (slots[index].on_complete) {
+      pending.push_back(std::move(slots[index].on_complete));
+    }
+    Release(index);
+  }
+  std::size_t count = completed.size();
+  for (Callback& callback : pending) {
+    callback();
+  }
+  pending.clear();
+  if (callbacks.empty()) {
+    pending.swap(callbacks);
+  }
+  return count;
+}
+
+void Animator::Clear() {
+  for (Group& group : groups) {
+    group.floats.Clear();
+    group.bytes.Clear();
+  }
+  for (uint32_t index = 0; index < slots.size(); ++index) {
+    if (slots[index].active) {
+      Release(index);
+    }
+  }
+}
+
+float Animator::Ease(Easing easing, float progress) {
+  float t = std::clamp(progress, 0.0F, 1.0F);
+  return WithCurve(easing, [t](auto curve) { return curve(t); });
+}
+
+uint32_t Animator::Allocate(Easing easing, Callback on_complete) {
+  uint32_t index;
+  if (free_slots.empty()) {
+    index = static_cast<uint32_t>(slots.size());
+    slots.emplace_back();
+  } else {
+    index = free_slots.back();
+    free_slots.pop_back();
+  }
+  Slot& slot = slots[index];
+  slot.active = true;
+  slot.easing = easing;
+  slot.components = 0;
+  slot.remaining = 0;
+  slot.on_complete = std::move(on_complete);
+  ++size;
+  return index;
+}
+
+void Animator::Release(uint32_t index) {
+  Slot& slot = slots[index];
+  slot.active = false;
+  ++slot.generation;
+  slot.on_complete = nullptr;
+  if (slot.node != NO_NODE) {
+    // Move the last animation of a node into the released position
+    uint32_t last = node_slots.back();
+    node_slots[slot.node] = last;
+    node_handles[slot.node] = node_handles.back();
+    slots[last].node = slot.node;
+    node_slots.pop_back();
+    node_handles.pop_back();
+    slot.node = NO_NODE;
+  }
+  free_slots.push_back(index);
+  --size;
+}
+
+void Animator::BindNode(uint32_t index, const Node& node) {
+  slots[index].node = static_cast<uint32_t>(node_slots.size());
+  node_slots.push_back(index);
+  node_handles.push_back(node.GetHandle());
+}
+
+void Animator::CancelDestroyedNodes() {
+  if (node_slots.empty()) {
+    return;
+  }
+  NodePool::GetInstance().Resolve(node_handles, resolved_nodes);
+  // Cancelling moves the last animation of a node into the cancelled position, which has already
+  // been checked when iterating from the end
+  for (std::size_t i = resolved_nodes.size(); i-- > 0;) {
+    if (resolved_nodes[i] == nullptr) {
+      uint32_t index = node_slots[i];
+      Cancel({index, slots[index].generation});
+    }
+  }
+}
+
+template <typename T>
+void Animator::AddLane(uint32_t index, T& target, float to, Time duration) {
+  Slot& slot = slots[index];
+  Group& group = groups[static_cast<std::size_t>(slot.easing)];
+  Lanes<T>* lanes;
+  if constexpr (std::is_same_v<T, uint8_t>) {
+    lanes = &group.bytes;
+  } else {
+    lanes = &group.floats;
+  }
+  auto lane = static_cast<uint32_t>(lanes->GetSize());
+  const float seconds = duration.AsSeconds();
+  const auto from = static_cast<float>(target);
+
+  lanes->from.push_back(from);
+  lanes->to.push_back(to);
+  // Animations without duration complete on the next update
+  lanes->progress.push_back(seconds > 0.0F ? 0.0F : 1.0F);
+  lanes->rate.push_back(seconds > 0.0F ? 1.0F / seconds : 0.0F);
+  lanes->value.push_back(from);
+  lanes->target.push_back(&target);
+  lanes->owner.push_back(index);
+  lanes->component.push_back(slot.components);
+
+  slot.lanes[slot.components] = {std::is_same_v<T, uint8_t>, lane};
+  ++slot.components;
+  ++slot.remaining;
+}
+
+template <typename T>
+void Animator::RemoveLane(Lanes<T>& lanes, uint32_t lane) {
+  auto last = static_cast<uint32_t>(lanes.GetSize() - 1);
+  if (lane != last) {
+    lanes.from[lane] = lanes.from[last];
+    lanes.to[lane] = lanes.to[last];
+    lanes.progress[lane] = lanes.progress[last];
+    lanes.rate[lane] = lanes.rate[last];
+    lanes.value[lane] = lanes.value[last];
+    lanes.target[lane] = lanes.target[last];
+    lanes.owner[lane] = lanes.owner[last];
+    lanes.component[lane] = lanes.component[last];
+    slots[lanes.owner[lane]].lanes[lanes.component[lane]].lane = lane;
+  }
+  lanes.from.pop_back();
+  lanes.to.pop_back();
+  lanes.progress.pop_back();
+  lanes.rate.pop_back();
+  lanes.value.pop_back();
+  lanes.target.pop_back();
+  lanes.owner.pop_back();
+  lanes.component.pop_back();
+}
+
+template <typename T>
+void Animator::Step(Lanes<T>& lanes, Easing easing, float dt) {
+  const std::size_t count = lanes.GetSize();
+  if (count == 0) {
+    return;
+  }
+
+  WithCurve(easing, [&](auto curve) {
+    Evaluate(count, dt, lanes.from.data(), lanes.to.data(), lanes.progress.data(),
+             lanes.rate.data(), lanes.value.data(), curve);
+  });
+
+  // Scattering to the properties can not be vectorized, so it is done in a separate pass
+  for (std::size_t i = 0; i < count; ++i) {
+    Store(lanes.target[i], lanes.value[i]);
+  }
+
+  finished.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (lanes.progress[i] >= 1.0F) {
+      finished.push_back(static_cast<uint32_t>(i));
+    }
+  }
+
+  // Lanes are removed from the end, so that a lane moved into the removed position has already
+  // been checked
+  for (auto it = finished.rbegin(); it != finished.rend(); ++it) {
+    uint32_t owner = lanes.owner[*it];
+    RemoveLane(lanes, *it);
+    if (--slots[owner].remaining == 0) {
+      completed.push_back(owner);
+    }
+  }
+}
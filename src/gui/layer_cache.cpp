@@ -0,0 +1,128 @@
+#include "sdlxx/gui/layer_cache.h"
+
+#include <utility>
+
+#include <SDL_pixels.h>
+
+using namespace sdlxx;
+
+namespace {
+
+// A format with alpha, so that transparent parts of a layer stay transparent
+constexpr Texture::Format LAYER_FORMAT = SDL_PIXELFORMAT_RGBA8888;
+
+constexpr std::size_t BYTES_PER_PIXEL = 4;
+
+}  // namespace
+
+LayerCache::LayerCache(Renderer& renderer, std::size_t budget)
+    : renderer(renderer), budget(budget) {}
+
+Texture* LayerCache::Find(NodePool::Handle node, Dimensions size) {
+  auto it = layers.find(node.index);
+  if (it == layers.end() || it->second.generation != node.generation ||
+      it->second.size != size) {
+    return nullptr;
+  }
+  recently_used.splice(recently_used.begin(), recently_used, it->second.position);
+  return it->second.texture.get();
+}
+
+Texture* LayerCache::Create(NodePool::Handle node, Dimensions size) {
+  const std::size_t bytes =
+      static_cast<std::size_t>(size.width) * static_cast<std::size_t>(size.height) *
+      BYTES_PER_PIXEL;
+  if (size.width <= 0 || size.height <= 0 || bytes > budget ||
+      !renderer.RenderTargetSupported()) {
+    Release(node);
+    return nullptr;
+  }
+
+  auto it = layers.find(node.index);
+  if (it != layers.end() && it->second.generation != node.generation) {
+    // The layer belongs to a destroyed node with the same index
+    Release({node.index, it->second.generation});
+    it = layers.end();
+  }
+  if (it != layers.end() && it->second.size == size) {
+    recently_used.splice(recently_used.begin(), recently_used, it->second.position);
+    return it->second.texture.get();
+  }
+
+  const std::size_t current = it != layers.end() ? it->second.bytes : 0;
+  Evict(usage - current + bytes, node.index);
+
+  auto texture = std::make_unique<Texture>(renderer, size, LAYER_FORMAT, Texture::Access::TARGET);
+  texture->SetBlendMode(BlendMode::BLEND);
+
+  if (it == layers.end()) {
+    recently_used.push_front(node.index);
+    it = layers.emplace(node.index, Layer{node.generation, nullptr, size, 0, recently_used.begin()})
+             .first;
+  } else {
+    recently_used.splice(recently_used.begin(), recently_used, it->second.position);
+  }
+  usage = usage - it->second.bytes + bytes;
+  it->second.texture = std::move(texture);
+  it->second.size = size;
+  it->second.bytes = bytes;
+  return it->second.texture.get();
+}
+
+void LayerCache::Release(NodePool::Handle node) {
+  auto it = layers.find(node.index);
+  if (it == layers.end() || it->second.generation != node.generation) {
+    return;
+  }
+  usage -= it->second.bytes;
+  recently_used.erase(it->second.position);
+  layers.erase(it);
+}
+
+void LayerCache::BeginLayer(Texture& layer) {
+  renderer.SetRenderTarget(layer);
+  targets.push_back(&layer);
+  renderer.SetDrawColor(Color::TRANSPARENT);
+  renderer.Clear();
+}
+
+void LayerCache::EndLayer() {
+  targets.pop_back();
+  if (targets.empty()) {
+    renderer.SetRenderTargetDefault();
+  } else {
+    renderer.SetRenderTarget(*targets.back());
+  }
+}
+
+void LayerCache::SetBudget(std::size_t new_budget) {
+  budget = new_budget;
+  Evict(0, UINT32_MAX);
+}
+
+void LayerCache::Clear() {
+  layers.clear();
+  recently_used.clear();
+  usage = 0;
+}
+
+void LayerCache::Evict(std::size_t required, uint32_t keep) {
+  auto it = recently_used.end();
+  while (required > budget && it != recently_used.begin()) {
+    --it;
+    uint32_t index = *it;
+    // Layers that are being rendered into can not be evicted
+    Layer& layer = layers.at(index);
+    bool is_target = false;
+    for (Texture* target : targets) {
+      is_target = is_target || target == layer.texture.get();
+    }
+    if (index == keep || is_target) {
+      continue;
+    }
+    required -= layer.bytes;
+    usage -= layer.bytes;
+    it = recently_used.erase(it);
+    layers.erase(index);
+  }
+}
@@ -1 +1,101 @@
 #include "sdlxx/gui/node.h"
+
+#include "sdlxx/gui/layer_cache.h"
+#include "sdlxx/gui/parent_node.h"
+
+using namespace sdlxx;
+
+Node::~Node() {
+  ReleaseLayer();
+  NodePool::GetInstance().Unregister(handle);
+}
+
+void Node::Draw(Renderer& renderer) const {
+  if (!cache_as_bitmap || context == nullptr || context->layers == nullptr) {
+    Render(renderer);
+    return;
+  }
+
+  LayerCache& layers = *context->layers;
+  Rectangle viewport = renderer.GetViewport();
+  Dimensions layer_size{viewport.width, viewport.height};
+
+  Texture* layer = layers.Find(handle, layer_size);
+  if (layer == nullptr || !layer_valid) {
+    if (layer == nullptr) {
+      layer = layers.Create(handle, layer_size);
+    }
+    if (layer == nullptr) {
+      // Layer does not fit into the budget
+      Render(renderer);
+      return;
+    }
+    // Changing the target resets the viewport to the whole layer
+    layers.BeginLayer(*layer);
+    try {
+      Render(renderer);
+    } catch (...) {
+      layers.EndLayer();
+      renderer.SetViewport(viewport);
+      throw;
+    }
+    layers.EndLayer();
+    renderer.SetViewport(viewport);
+    layer_valid = true;
+  }
+  renderer.Copy(*layer);
+}
+
+void Node::SetCacheAsBitmap(bool enabled) {
+  if (!enabled) {
+    ReleaseLayer();
+  }
+  cache_as_bitmap = enabled;
+  Invalidate();
+}
+
+void Node::Invalidate() {
+  for (Node* node = this; node != nullptr; node = node->parent) {
+    node->layer_valid = false;
+  }
+}
+
+bool Node::ReceivesEvents(EventKind kind) const {
+  BitMask<EventKind> mask =
+      is_parent ? static_cast<const ParentNode*>(this)->GetSubtreeEventMask() : event_mask;
+  return (mask & kind).value != 0;
+}
+
+void Node::SetEventMask(BitMask<EventKind> mask) {
+  event_mask = mask;
+  if (is_parent) {
+    static_cast<ParentNode*>(this)->InvalidateDescendants();
+  } else if (parent != nullptr) {
+    parent->InvalidateDescendants();
+  }
+}
+
+void Node::SetSize(Dimensions new_size) {
+  size = new_size;
+  Invalidate();
+}
+
+void Node::SetStyle(Style new_style) {
+  style = std::move(new_style);
+  Invalidate();
+}
+
+void Node::SetContext(Context* new_context) {
+  if (new_context != context) {
+    ReleaseLayer();
+  }
+  context = new_context;
+  Invalidate();
+}
+
+void Node::ReleaseLayer() {
+  layer_valid = false;
+  if (cache_as_bitmap && context != nullptr && context->layers != nullptr) {
+    context->layers->Release(handle);
+  }
+}
@@ -0,0 +1,129 @@
+#include "sdlxx/gui/node_pool.h"
+
+#include <algorithm>
+#include <new>
+
+using namespace sdlxx;
+
+NodePool& NodePool::GetInstance() {
+  // Never destroyed, so that static nodes can be deleted during the program termination
+  static NodePool* instance = new NodePool();
+  return *instance;
+}
+
+void* NodePool::Allocate(std::size_t size) {
+  if (size == 0 || size > MAX_POOLED_SIZE) {
+    return operator new(size);
+  }
+  const std::size_t size_class = (size - 1) / GRANULARITY;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (free_lists[size_class] == nullptr) {
+    Grow(size_class, 0);
+  }
+  FreeBlock* block = free_lists[size_class];
+  free_lists[size_class] = block->next;
+  pooled_bytes += (size_class + 1) * GRANULARITY;
+  return block;
+}
+
+void NodePool::Deallocate(void* block, std::size_t size) noexcept {
+  if (block == nullptr) {
+    return;
+  }
+  if (size == 0 || size > MAX_POOLED_SIZE) {
+    operator delete(block);
+    return;
+  }
+  const std::size_t size_class = (size - 1) / GRANULARITY;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto* free_block = static_cast<FreeBlock*>(block);
+  free_block->next = free_lists[size_class];
+  free_lists[size_class] = free_block;
+  pooled_bytes -= (size_class + 1) * GRANULARITY;
+}
+
+void NodePool::Reserve(std::size_t size, std::size_t count) {
+  if (size == 0 || size > MAX_POOLED_SIZE) {
+    return;
+  }
+  const std::size_t size_class = (size - 1) / GRANULARITY;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::size_t available = 0;
+  for (FreeBlock* block = free_lists[size_class]; block != nullptr && available < count;
+       block = block->next) {
+    ++available;
+  }
+  if (available < count) {
+    Grow(size_class, count - available);
+  }
+  slots.reserve(slots.size() + count);
+}
+
+NodePool::Handle NodePool::Register(Node* node) {
+  std::lock_guard<std::mutex> lock(mutex);
+  uint32_t index;
+  if (free_slots.empty()) {
+    index = static_cast<uint32_t>(slots.size());
+    slots.emplace_back();
+    free_slots.reserve(slots.capacity());
+  } else {
+    index = free_slots.back();
+    free_slots.pop_back();
+  }
+  slots[index].node = node;
+  ++nodes;
+  return {index, slots[index].generation};
+}
+
+void NodePool::Unregister(Handle handle) noexcept {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (handle.index >= slots.size() || slots[handle.index].generation != handle.generation) {
+    return;
+  }
+  slots[handle.index].node = nullptr;
+  ++slots[handle.index].generation;
+  // Reserved in Register(), so push_back does not allocate and can not throw
+  free_slots.push_back(handle.index);
+  --nodes;
+}
+
+Node* NodePool::Resolve(Handle handle) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (handle.index >= slots.size() || slots[handle.index].generation != handle.generation) {
+    return nullptr;
+  }
+  return slots[handle.index].node;
+}
+
+void NodePool::Resolve(const std::vector<Handle>& handles, std::vector<Node*>& nodes) const {
+  nodes.resize(handles.size());
+  std::lock_guard<std::mutex> lock(mutex);
+  for (std::size_t i = 0; i < handles.size(); ++i) {
+    const Handle& handle = handles[i];
+    nodes[i] = handle.index < slots.size() && slots[handle.index].generation == handle.generation
+                   ? slots[handle.index].node
+                   : nullptr;
+  }
+}
+
+NodePool::Statistics NodePool::GetStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return {nodes, pooled_bytes, slabs.size() * SLAB_SIZE, slabs.size()};
+}
+
+void NodePool::Grow(std::size_t size_class, std::size_t count) {
+  const std::size_t block_size = (size_class + 1) * GRANULARITY;
+  const std::size_t blocks_per_slab = SLAB_SIZE / block_size;
+  const std::size_t slab_count =
+      std::max<std::size_t>((count + blocks_per_slab - 1) / blocks_per_slab, 1);
+  for (std::size_t i = 0; i < slab_count; ++i) {
+    slabs.emplace_back(new std::byte[SLAB_SIZE]);
+    std::byte* data = slabs.back().get();
+    // Blocks are linked in address order, so that consecutive nodes are adjacent in memory
+    for (std::size_t block = blocks_per_slab; block-- > 0;) {
+      auto* free_block = reinterpret_cast<FreeBlock*>(data + block * block_size);
+      free_block->next = free_lists[size_class];
+      free_lists[size_class] = free_block;
+    }
+  }
+}
@@ -0,0 +1,675 @@
+#include "sdlxx/mixer/audio_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SDLXX_MIXER_MMAP
+#endif
+
+using namespace sdlxx;
+
+namespace {
+
+constexpr uint16_t FORMAT_PCM = 0x0001;
+constexpr uint16_t FORMAT_FLOAT = 0x0003;
+constexpr uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t Read16(const uint8_t* data) { return static_cast<uint16_t>(data[0] | data[1] << 8U); }
+
+uint32_t Read32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8U |
+         static_cast<uint32_t>(data[2]) << 16U | static_cast<uint32_t>(data[3]) << 24U;
+}
+
+// Convert interleaved samples of some channels of each frame with the given function
+template <typename Convert>
+void DecodeFrames(const uint8_t* frame, std::size_t frame_size, std::size_t sample_size,
+                  std::size_t channels, std::size_t count, float* output, Convert convert) {
+  for (std::size_t i = 0; i < count; ++i, frame += frame_size) {
+    for (std::size_t c = 0; c < channels; ++c) {
+      *output++ = convert(frame + c * sample_size);
+    }
+  }
+}
+
+float DecodeUint8(const uint8_t* sample) {
+  return static_cast<float>(sample[0] - 128) * (1.0f / 128);
+}
+
+float DecodeInt16(const uint8_t* sample) {
+  return static_cast<float>(static_cast<int16_t>(Read16(sample))) * (1.0f / 32768);
+}
+
+float DecodeInt24(const uint8_t* sample) {
+  // Shift the 24 bits to the top, so that the sign is extended
+  uint32_t value = static_cast<uint32_t>(sample[0]) << 8U |
+                   static_cast<uint32_t>(sample[1]) << 16U |
+                   static_cast<uint32_t>(sample[2]) << 24U;
+  return static_cast<float>(static_cast<int32_t>(value)) * (1.0f / 2147483648.0f);
+}
+
+float DecodeInt32(const uint8_t* sample) {
+  return static_cast<float>(static_cast<int32_t>(Read32(sample))) * (1.0f / 2147483648.0f);
+}
+
+float DecodeFloat32(const uint8_t* sample) {
+  float value = 0;
+  uint32_t bits = Read32(sample);
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Map a file, or read it into the contents where memory mapping is not available
+const uint8_t* MapFile(const std::string& path, std::size_t& size,
+                       [[maybe_unused]] std::vector<uint8_t>& contents) {
+#ifdef SDLXX_MIXER_MMAP
+  int descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor == -1) {
+    throw AudioDecoderException("Failed to open " + path);
+  }
+  const uint8_t* file = nullptr;
+  struct stat status {};
+  if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+    size = static_cast<std::size_t>(status.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    file = address == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(address);
+  }
+  // The mapping stays valid after the descriptor is closed
+  close(descriptor);
+  if (file == nullptr) {
+    throw AudioDecoderException("Failed to map " + path);
+  }
+  madvise(const_cast<uint8_t*>(file), size, MADV_SEQUENTIAL);
+  return file;
+#else
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    throw AudioDecoderException("Failed to open " + path);
+  }
+  contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  size = contents.size();
+  return contents.data();
+#endif
+}
+
+void UnmapFile([[maybe_unused]] const uint8_t* file, [[maybe_unused]] std::size_t size) {
+#ifdef SDLXX_MIXER_MMAP
+  munmap(const_cast<uint8_t*>(file), size);
+#endif
+}
+
+constexpr uint8_t FLAC_STREAMINFO = 0;
+constexpr uint8_t FLAC_SEEKTABLE = 3;
+constexpr uint64_t FLAC_PLACEHOLDER = ~uint64_t{0};
+
+uint32_t ReadBigEndian16(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) << 8U | static_cast<uint32_t>(data[1]);
+}
+
+uint32_t ReadBigEndian24(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) << 16U | ReadBigEndian16(data + 1);
+}
+
+uint32_t ReadBigEndian32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) << 24U | ReadBigEndian24(data + 1);
+}
+
+uint64_t ReadBigEndian64(const uint8_t* data) {
+  return static_cast<uint64_t>(ReadBigEndian32(data)) << 32U | ReadBigEndian32(data + 4);
+}
+
+int CountLeadingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(value);
+#else
+  int count = 0;
+  for (; (value & (uint64_t{1} << 63U)) == 0; value <<= 1U) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// Reads the big-endian bit fields of FLAC frames, and throws at the end of the data
+class BitReader {
+public:
+  BitReader(const uint8_t* data, const uint8_t* end) : data(data), end(end) {}
+
+  uint32_t Read(int count) {
+    if (count == 0) {
+      return 0;
+    }
+    Require(count);
+    auto value = static_cast<uint32_t>(cache >> (64 - count));
+    cache <<= count;
+    cached -= count;
+    return value;
+  }
+
+  int32_t ReadSigned(int count) {
+    if (count == 0) {
+      return 0;
+    }
+    int64_t value = Read(count);
+    int64_t sign = int64_t{1} << (count - 1);
+    return static_cast<int32_t>(value >= sign ? value - 2 * sign : value);
+  }
+
+  // Count the zero bits before the next one bit
+  uint32_t ReadUnary() {
+    uint32_t count = 0;
+    while (true) {
+      Require(1);
+      if (cache == 0) {
+        count += static_cast<uint32_t>(cached);
+        cached = 0;
+        continue;
+      }
+      int zeros = CountLeadingZeros(cache);
+      count += static_cast<uint32_t>(zeros);
+      cache = cache << zeros << 1;
+      cached -= zeros + 1;
+      return count;
+    }
+  }
+
+  // Read a Rice code, which maps unsigned values to signed as 0, -1, 1, -2, ...
+  int32_t ReadRice(int parameter) {
+    uint32_t value = ReadUnary() << parameter | Read(parameter);
+    return static_cast<int32_t>(value >> 1U) ^ -static_cast<int32_t>(value & 1U);
+  }
+
+  void AlignToByte() {
+    int padding = cached % 8;
+    cache <<= padding;
+    cached -= padding;
+  }
+
+  // Get the next byte, which is only meaningful at byte boundaries
+  const uint8_t* GetPosition() const { return data - cached / 8; }
+
+private:
+  const uint8_t* data;
+  const uint8_t* end;
+  // The next bits, starting at the most significant bit
+  uint64_t cache = 0;
+  int cached = 0;
+
+  void Require(int count) {
+    for (; cached <= 56 && data != end; cached += 8) {
+      cache |= static_cast<uint64_t>(*data++) << (56 - cached);
+    }
+    if (cached < count) {
+      throw AudioDecoderException("FLAC frame is truncated");
+    }
+  }
+};
+
+uint8_t GetCrc8(const uint8_t* data, std::size_t size) {
+  uint8_t crc = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = static_cast<uint8_t>((crc & 0x80U) != 0 ? (crc << 1U) ^ 0x07U : crc << 1U);
+    }
+  }
+  return crc;
+}
+
+// Decode the residual of a prediction into the samples after the warm-up samples
+void DecodeResidual(BitReader& reader, int32_t* output, std::size_t count, std::size_t order) {
+  uint32_t method = reader.Read(2);
+  if (method > 1) {
+    throw AudioDecoderException("FLAC residual has an unsupported coding method");
+  }
+  int parameter_bits = method == 0 ? 4 : 5;
+  uint32_t escape = method == 0 ? 15 : 31;
+  uint32_t partition_order = reader.Read(4);
+  std::size_t partition_size = count >> partition_order;
+  if (partition_size << partition_order != count || partition_size < order) {
+    throw AudioDecoderException("FLAC residual has an invalid partition order");
+  }
+  output += order;
+  for (std::size_t partition = 0; partition < std::size_t{1} << partition_order; ++partition) {
+    std::size_t size = partition == 0 ? partition_size - order : partition_size;
+    uint32_t parameter = reader.Read(parameter_bits);
+    if (parameter == escape) {
+      // Escaped partitions store unencoded samples of the given size
+      auto sample_bits = static_cast<int>(reader.Read(5));
+      for (std::size_t i = 0; i < size; ++i) {
+        *output++ = reader.ReadSigned(sample_bits);
+      }
+    } else {
+      for (std::size_t i = 0; i < size; ++i) {
+        *output++ = reader.ReadRice(static_cast<int>(parameter));
+      }
+    }
+  }
+}
+
+// Add the predictions of the fixed polynomial predictors to the residual
+void PredictFixed(int32_t* output, std::size_t count, std::size_t order) {
+  for (std::size_t i = order; i < count; ++i) {
+    int64_t prediction = 0;
+    switch (order) {
+      case 1:
+        prediction = output[i - 1];
+        break;
+      case 2:
+        prediction = 2 * int64_t{output[i - 1]} - output[i - 2];
+        break;
+      case 3:
+        prediction = 3 * (int64_t{output[i - 1]} - output[i - 2]) + output[i - 3];
+        break;
+      case 4:
+        prediction = 4 * (int64_t{output[i - 1]} + output[i - 3]) - 6 * int64_t{output[i - 2]} -
+                     output[i - 4];
+        break;
+      default:
+        break;
+    }
+    output[i] = static_cast<int32_t>(output[i] + prediction);
+  }
+}
+
+// Add the predictions of the linear predictor with the given coefficients to the residual
+void PredictLinear(int32_t* output, std::size_t count, const int32_t* coefficients,
+                   std::size_t order, int shift) {
+  for (std::size_t i = order; i < count; ++i) {
+    int64_t prediction = 0;
+    for (std::size_t j = 0; j < order; ++j) {
+      prediction += int64_t{coefficients[j]} * output[i - j - 1];
+    }
+    output[i] = static_cast<int32_t>(output[i] + (prediction >> shift));
+  }
+}
+
+// Decode the samples of one channel of a frame
+void DecodeSubframe(BitReader& reader, int32_t* output, std::size_t count, int sample_bits) {
+  if (reader.Read(1) != 0) {
+    throw AudioDecoderException("FLAC subframe has an invalid header");
+  }
+  uint32_t type = reader.Read(6);
+  // Samples with wasted bits are stored without their low zero bits
+  int wasted = 0;
+  if (reader.Read(1) != 0) {
+    wasted = static_cast<int>(reader.ReadUnary()) + 1;
+  }
+  if (wasted >= sample_bits) {
+    throw AudioDecoderException("FLAC subframe has an invalid number of wasted bits");
+  }
+  sample_bits -= wasted;
+  if (type == 0) {
+    std::fill_n(output, count, reader.ReadSigned(sample_bits));
+  } else if (type == 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      output[i] = reader.ReadSigned(sample_bits);
+    }
+  } else if (type >= 8 && type <= 12) {
+    std::size_t order = type - 8;
+    if (order > count) {
+      throw AudioDecoderException("FLAC subframe has an invalid predictor order");
+    }
+    for (std::size_t i = 0; i < order; ++i) {
+      output[i] = reader.ReadSigned(sample_bits);
+    }
+    DecodeResidual(reader, output, count, order);
+    PredictFixed(output, count, order);
+  } else if (type >= 32) {
+    std::size_t order = type - 31;
+    if (order > count) {
+      throw AudioDecoderException("FLAC subframe has an invalid predictor order");
+    }
+    for (std::size_t i = 0; i < order; ++i) {
+      output[i] = reader.ReadSigned(sample_bits);
+    }
+    auto precision = static_cast<int>(reader.Read(4)) + 1;
+    int shift = reader.ReadSigned(5);
+    if (precision == 16 || shift < 0) {
+      throw AudioDecoderException("FLAC subframe has invalid predictor coefficients");
+    }
+    int32_t coefficients[32];
+    for (std::size_t i = 0; i < order; ++i) {
+      coefficients[i] = reader.ReadSigned(precision);
+    }
+    DecodeResidual(reader, output, count, order);
+    PredictLinear(output, count, coefficients, order, shift);
+  } else {
+    throw AudioDecoderException("FLAC subframe has a reserved type " + std::to_string(type));
+  }
+  if (wasted != 0) {
+    for (std::size_t i = 0; i < count; ++i) {
+      output[i] = static_cast<int32_t>(static_cast<uint32_t>(output[i]) << wasted);
+    }
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<AudioDecoder> AudioDecoder::Open(const std::string& path) {
+  char signature[4] = {};
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream.read(signature, sizeof(signature))) {
+    throw AudioDecoderException("Failed to read " + path);
+  }
+  if (std::memcmp(signature, "fLaC", sizeof(signature)) == 0) {
+    return std::make_unique<FlacDecoder>(path);
+  }
+  return std::make_unique<WavDecoder>(path);
+}
+
+WavDecoder::WavDecoder(const std::string& path) {
+  file = MapFile(path, file_size, contents);
+  try {
+    Parse(path);
+  } catch (...) {
+    UnmapFile(file, file_size);
+    throw;
+  }
+}
+
+WavDecoder::~WavDecoder() { UnmapFile(file, file_size); }
+
+std::size_t WavDecoder::Decode(float* output, std::size_t count) {
+  count = std::min(count, frames - position);
+  const uint8_t* frame = data + position * frame_size;
+  auto output_channels = static_cast<std::size_t>(channels);
+  switch (encoding) {
+    case Encoding::UINT8:
+      DecodeFrames(frame, frame_size, sample_size, output_channels, count, output, DecodeUint8);
+      break;
+    case Encoding::INT16:
+      DecodeFrames(frame, frame_size, sample_size, output_channels, count, output, DecodeInt16);
+      break;
+    case Encoding::INT24:
+      DecodeFrames(frame, frame_size, sample_size, output_channels, count, output, DecodeInt24);
+      break;
+    case Encoding::INT32:
+      DecodeFrames(frame, frame_size, sample_size, output_channels, count, output, DecodeInt32);
+      break;
+    case Encoding::FLOAT32:
+      DecodeFrames(frame, frame_size, sample_size, output_channels, count, output,
+                   DecodeFloat32);
+      break;
+  }
+  position += count;
+  return count;
+}
+
+void WavDecoder::Seek(std::size_t frame) { position = std::min(frame, frames); }
+
+void WavDecoder::Parse(const std::string& path) {
+  if (file_size < 12 || std::memcmp(file, "RIFF", 4) != 0 ||
+      std::memcmp(file + 8, "WAVE", 4) != 0) {
+    throw AudioDecoderException(path + " is not a WAV file");
+  }
+  const uint8_t* format = nullptr;
+  std::size_t data_size = 0;
+  // Chunks are padded to an even size
+  for (std::size_t offset = 12; offset + 8 <= file_size;) {
+    std::size_t size = Read32(file + offset + 4);
+    const uint8_t* body = file + offset + 8;
+    std::size_t available = file_size - offset - 8;
+    if (std::memcmp(file + offset, "fmt ", 4) == 0 && size >= 16 && size <= available) {
+      format = body;
+    } else if (std::memcmp(file + offset, "data", 4) == 0) {
+      // Truncated files are played up to their end
+      data = body;
+      data_size = std::min(size, available);
+      break;
+    }
+    offset += 8 + size + (size & 1U);
+  }
+  if (format == nullptr || data == nullptr) {
+    throw AudioDecoderException(path + " has no format or data chunk");
+  }
+
+  uint16_t tag = Read16(format);
+  int file_channels = Read16(format + 2);
+  frequency = static_cast<int>(Read32(format + 4));
+  frame_size = Read16(format + 12);
+  std::size_t bits = Read16(format + 14);
+  if (tag == FORMAT_EXTENSIBLE && Read16(format + 16) >= 22) {
+    // The sub-format GUID starts with the format tag
+    tag = Read16(format + 24);
+  }
+  sample_size = bits / 8;
+  if (tag == FORMAT_PCM && bits == 8) {
+    encoding = Encoding::UINT8;
+  } else if (tag == FORMAT_PCM && bits == 16) {
+    encoding = Encoding::INT16;
+  } else if (tag == FORMAT_PCM && bits == 24) {
+    encoding = Encoding::INT24;
+  } else if (tag == FORMAT_PCM && bits == 32) {
+    encoding = Encoding::INT32;
+  } else if (tag == FORMAT_FLOAT && bits == 32) {
+    encoding = Encoding::FLOAT32;
+  } else {
+    throw AudioDecoderException(path + " has an unsupported format " + std::to_string(tag) +
+                                " with " + std::to_string(bits) + " bits");
+  }
+  if (file_channels < 1 || frequency <= 0 ||
+      frame_size < sample_size * static_cast<std::size_t>(file_channels)) {
+    throw AudioDecoderException(path + " has an invalid format");
+  }
+  channels = std::min(file_channels, 2);
+  frames = data_size / frame_size;
+}
+
+FlacDecoder::FlacDecoder(const std::string& path) {
+  file = MapFile(path, file_size, contents);
+  try {
+    Parse(path);
+  } catch (...) {
+    UnmapFile(file, file_size);
+    throw;
+  }
+}
+
+FlacDecoder::~FlacDecoder() { UnmapFile(file, file_size); }
+
+std::size_t FlacDecoder::Decode(float* output, std::size_t count) {
+  float scale = 1.0f / static_cast<float>(uint32_t{1} << static_cast<uint32_t>(bits - 1));
+  auto output_channels = static_cast<std::size_t>(channels);
+  std::size_t decoded = 0;
+  while (decoded < count && position < frames) {
+    if (position == block_start + block_size && !DecodeFrame()) {
+      // Truncated and corrupt files are played up to the last valid frame
+      frames = position;
+      break;
+    }
+    std::size_t offset = position - block_start;
+    std::size_t available = std::min({count - decoded, block_size - offset, frames - position});
+    for (std::size_t i = offset; i < offset + available; ++i) {
+      for (std::size_t c = 0; c < output_channels; ++c) {
+        *output++ = static_cast<float>(samples[c * capacity + i]) * scale;
+      }
+    }
+    decoded += available;
+    position += available;
+  }
+  return decoded;
+}
+
+void FlacDecoder::Seek(std::size_t frame) {
+  frame = std::min(frame, frames);
+  // Start at the last seek point before the frame, unless the current block is after it
+  SeekPoint start{0, first_frame};
+  for (const SeekPoint& point : seek_points) {
+    if (point.frame <= frame && point.frame >= start.frame) {
+      start = point;
+    }
+  }
+  if (frame < block_start || block_start < start.frame) {
+    block_start = start.frame;
+    block_size = 0;
+    next_frame = start.offset;
+  }
+  while (frame >= block_start + block_size && frame < frames) {
+    if (!DecodeFrame()) {
+      frames = block_start + block_size;
+      break;
+    }
+  }
+  position = std::min(frame, frames);
+}
+
+void FlacDecoder::Parse(const std::string& path) {
+  if (file_size < 4 || std::memcmp(file, "fLaC", 4) != 0) {
+    throw AudioDecoderException(path + " is not a FLAC file");
+  }
+  std::size_t max_block_size = 0;
+  std::vector<SeekPoint> points;
+  std::size_t offset = 4;
+  for (bool last = false; !last;) {
+    if (file_size - offset < 4) {
+      throw AudioDecoderException(path + " has truncated metadata");
+    }
+    last = (file[offset] & 0x80U) != 0;
+    uint8_t type = file[offset] & 0x7FU;
+    std::size_t size = ReadBigEndian24(file + offset + 1);
+    const uint8_t* body = file + offset + 4;
+    offset += 4;
+    if (file_size - offset < size) {
+      throw AudioDecoderException(path + " has truncated metadata");
+    }
+    if (type == FLAC_STREAMINFO && size >= 34) {
+      max_block_size = ReadBigEndian16(body + 2);
+      frequency = static_cast<int>(ReadBigEndian24(body + 10) >> 4U);
+      file_channels = static_cast<int>((body[12] >> 1U) & 0x07U) + 1;
+      bits = static_cast<int>(((body[12] & 0x01U) << 4U | body[13] >> 4U) + 1);
+      frames = static_cast<std::size_t>(static_cast<uint64_t>(body[13] & 0x0FU) << 32U |
+                                        ReadBigEndian32(body + 14));
+    } else if (type == FLAC_SEEKTABLE) {
+      for (std::size_t i = 0; i + 18 <= size; i += 18) {
+        uint64_t frame = ReadBigEndian64(body + i);
+        if (frame != FLAC_PLACEHOLDER) {
+          points.push_back({static_cast<std::size_t>(frame),
+                            static_cast<std::size_t>(ReadBigEndian64(body + i + 8))});
+        }
+      }
+    }
+    offset += size;
+  }
+  if (frequency <= 0 || max_block_size < 16) {
+    throw AudioDecoderException(path + " has no valid stream information");
+  }
+  if (bits < 4 || bits > 24) {
+    throw AudioDecoderException(path + " has an unsupported sample size of " +
+                                std::to_string(bits) + " bits");
+  }
+  if (frames == 0) {
+    throw AudioDecoderException(path + " has an unknown length");
+  }
+  // Seek points are offsets from the first frame
+  first_frame = offset;
+  for (const SeekPoint& point : points) {
+    if (point.frame < frames && point.offset < file_size - first_frame) {
+      seek_points.push_back({point.frame, first_frame + point.offset});
+    }
+  }
+  channels = std::min(file_channels, 2);
+  capacity = max_block_size;
+  samples.resize(capacity * static_cast<std::size_t>(file_channels));
+  next_frame = first_frame;
+}
+
+bool FlacDecoder::DecodeFrame() {
+  const uint8_t* frame = file + next_frame;
+  BitReader reader(frame, file + file_size);
+  std::size_t size = 0;
+  uint32_t assignment = 0;
+  try {
+    // The sync code is followed by a reserved zero bit and the blocking strategy
+    if (reader.Read(15) != 0x7FFC) {
+      return false;
+    }
+    reader.Read(1);
+    uint32_t size_code = reader.Read(4);
+    uint32_t frequency_code = reader.Read(4);
+    assignment = reader.Read(4);
+    uint32_t bits_code = reader.Read(3);
+    reader.Read(1);
+    // The number of the frame or sample is coded like UTF-8, and is not needed
+    uint32_t first = reader.Read(8);
+    int length = 0;
+    for (uint32_t mask = 0x80; (first & mask) != 0 && mask != 0; mask >>= 1U) {
+      ++length;
+    }
+    if (length == 1 || length > 7) {
+      return false;
+    }
+    for (int i = 1; i < length; ++i) {
+      reader.Read(8);
+    }
+    if (size_code == 1) {
+      size = 192;
+    } else if (size_code >= 2 && size_code <= 5) {
+      size = std::size_t{576} << (size_code - 2);
+    } else if (size_code == 6) {
+      size = reader.Read(8) + 1;
+    } else if (size_code == 7) {
+      size = reader.Read(16) + 1;
+    } else if (size_code >= 8) {
+      size = std::size_t{256} << (size_code - 8);
+    }
+    if (frequency_code == 12) {
+      reader.Read(8);
+    } else if (frequency_code == 13 || frequency_code == 14) {
+      reader.Read(16);
+    }
+    constexpr int BITS[8] = {0, 8, 12, 0, 16, 20, 24, 32};
+    int frame_bits = bits_code == 0 ? bits : BITS[bits_code];
+    int frame_channels = assignment < 8 ? static_cast<int>(assignment) + 1 : 2;
+    const uint8_t* crc = reader.GetPosition();
+    if (size == 0 || frame_bits != bits || frame_channels != file_channels || assignment > 10 ||
+        frequency_code == 15 || reader.Read(8) != GetCrc8(frame, crc - frame)) {
+      return false;
+    }
+
+    if (size > capacity) {
+      capacity = size;
+      samples.resize(capacity * static_cast<std::size_t>(file_channels));
+    }
+    for (std::size_t c = 0; c < static_cast<std::size_t>(file_channels); ++c) {
+      // The side channel has an extra bit
+      bool side = (assignment == 8 && c == 1) || (assignment == 9 && c == 0) ||
+                  (assignment == 10 && c == 1);
+      DecodeSubframe(reader, samples.data() + c * capacity, size, bits + (side ? 1 : 0));
+    }
+    // The frame ends with padding to a byte and a CRC-16 of the frame
+    reader.AlignToByte();
+    reader.Read(16);
+    next_frame = static_cast<std::size_t>(reader.GetPosition() - file);
+  } catch (const AudioDecoderException&) {
+    return false;
+  }
+
+  // Restore the left and right channels from their sum or difference. The sums are computed in
+  // 64 bits, so that corrupt frames do not overflow
+  int32_t* left = samples.data();
+  int32_t* right = samples.data() + capacity;
+  for (std::size_t i = 0; i < size && assignment >= 8; ++i) {
+    int64_t first = left[i];
+    int64_t second = right[i];
+    if (assignment == 8) {
+      right[i] = static_cast<int32_t>(first - second);
+    } else if (assignment == 9) {
+      left[i] = static_cast<int32_t>(first + second);
+    } else {
+      int64_t mid = first * 2 + (second & 1);
+      left[i] = static_cast<int32_t>((mid + second) / 2);
+      right[i] = static_cast<int32_t>((mid - second) / 2);
+    }
+  }
+  block_start += block_size;
+  block_size = size;
+  return true;
+}
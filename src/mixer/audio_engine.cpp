@@ -0,0 +1,565 @@
+#include "sdlxx/mixer/audio_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <SDL_audio.h>
+
+#include "sdlxx/core/timer.h"
+
+using namespace sdlxx;
+
+namespace {
+
+constexpr uint64_t ONE = uint64_t{1} << 32U;
+constexpr uint64_t FRACTION_MASK = ONE - 1;
+constexpr float MIN_PITCH = 1.0f / 16;
+constexpr float MAX_PITCH = 16.0f;
+constexpr float QUARTER_PI = 0.78539816f;
+
+uint64_t PitchToStep(float pitch) {
+  return static_cast<uint64_t>(std::clamp(pitch, MIN_PITCH, MAX_PITCH) * static_cast<float>(ONE));
+}
+
+// Constant-power panning for mono sounds, and balance for stereo sounds that are already panned
+void GetGains(float volume, float pan, int channels, float* gains) {
+  pan = std::clamp(pan, -1.0f, 1.0f);
+  if (channels == 1) {
+    float angle = (pan + 1.0f) * QUARTER_PI;
+    gains[0] = volume * std::cos(angle);
+    gains[1] = volume * std::sin(angle);
+  } else {
+    gains[0] = volume * std::min(1.0f, 1.0f - pan);
+    gains[1] = volume * std::min(1.0f, 1.0f + pan);
+  }
+}
+
+// Add frames to a stereo buffer with gains that change by the deltas every frame
+void Accumulate(const float* source, int channels, float* destination, std::size_t frames,
+                float left, float right, float delta_left, float delta_right) {
+  std::size_t i = 0;
+#ifdef __SSE2__
+  __m128 gains = _mm_setr_ps(left, right, left + delta_left, right + delta_right);
+  __m128 deltas = _mm_setr_ps(delta_left, delta_right, delta_left, delta_right);
+  __m128 step2 = _mm_add_ps(deltas, deltas);
+  __m128 step4 = _mm_add_ps(step2, step2);
+  for (; i + 4 <= frames; i += 4) {
+    __m128 first;
+    __m128 second;
+    if (channels == 1) {
+      __m128 samples = _mm_loadu_ps(source + i);
+      first = _mm_unpacklo_ps(samples, samples);
+      second = _mm_unpackhi_ps(samples, samples);
+    } else {
+      first = _mm_loadu_ps(source + i * 2);
+      second = _mm_loadu_ps(source + i * 2 + 4);
+    }
+    float* output = destination + i * 2;
+    _mm_storeu_ps(output, _mm_add_ps(_mm_loadu_ps(output), _mm_mul_ps(first, gains)));
+    _mm_storeu_ps(output + 4, _mm_add_ps(_mm_loadu_ps(output + 4),
+                                         _mm_mul_ps(second, _mm_add_ps(gains, step2))));
+    gains = _mm_add_ps(gains, step4);
+  }
+#endif
+  for (; i < frames; ++i) {
+    float gain_left = left + delta_left * static_cast<float>(i);
+    float gain_right = right + delta_right * static_cast<float>(i);
+    if (channels == 1) {
+      destination[i * 2] += source[i] * gain_left;
+      destination[i * 2 + 1] += source[i] * gain_right;
+    } else {
+      destination[i * 2] += source[i * 2] * gain_left;
+      destination[i * 2 + 1] += source[i * 2 + 1] * gain_right;
+    }
+  }
+}
+
+// Add a scaled buffer to another
+void AddScaled(const float* source, float* destination, std::size_t count, float gain) {
+  std::size_t i = 0;
+#ifdef __SSE2__
+  __m128 gains = _mm_set1_ps(gain);
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i),
+                                              _mm_mul_ps(_mm_loadu_ps(source + i), gains)));
+  }
+#endif
+  for (; i < count; ++i) {
+    destination[i] += source[i] * gain;
+  }
+}
+
+void Clip(float* samples, std::size_t count) {
+  std::size_t i = 0;
+#ifdef __SSE2__
+  __m128 low = _mm_set1_ps(-1.0f);
+  __m128 high = _mm_set1_ps(1.0f);
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(samples + i), low), high));
+  }
+#endif
+  for (; i < count; ++i) {
+    samples[i] = std::clamp(samples[i], -1.0f, 1.0f);
+  }
+}
+
+// Interpolate frames while the position stays before the end, and advance the position
+template <std::size_t Channels, typename Voice>
+void Resample(Voice& voice, float* output, std::size_t count) {
+  const float* samples = voice.samples;
+  std::size_t last = voice.frames - 1;
+  uint64_t position = voice.position;
+  for (std::size_t i = 0; i < count; ++i, position += voice.step) {
+    std::size_t index = position >> 32U;
+    std::size_t next = index < last ? index + 1 : (voice.loop ? 0 : index);
+    float fraction = static_cast<float>(position & FRACTION_MASK) * (1.0f / ONE);
+    for (std::size_t c = 0; c < Channels; ++c) {
+      float current = samples[index * Channels + c];
+      output[i * Channels + c] = current + (samples[next * Channels + c] - current) * fraction;
+    }
+  }
+  voice.position = position;
+}
+
+int64_t CounterToNanoseconds(uint64_t ticks) {
+  static const uint64_t frequency = Timer::GetPerformanceFrequency();
+  return static_cast<int64_t>(ticks / frequency * 1000000000 +
+                              ticks % frequency * 1000000000 / frequency);
+}
+
+}  // namespace
+
+AudioEngine::AudioEngine(const AudioEngineSettings& settings)
+    : frequency(settings.frequency),
+      block_frames(settings.buffer_frames),
+      max_cached_duration(settings.max_cached_duration),
+      commands(settings.command_capacity, false),
+      finished(std::max<std::size_t>(settings.voices, 1), false) {
+  if (settings.voices == 0 || settings.voices > UINT16_MAX) {
+    throw AudioEngineException("Number of voices must be from 1 to 65535");
+  }
+  if (settings.buses == 0 || settings.buses > UINT16_MAX) {
+    throw AudioEngineException("Number of buses must be from 1 to 65535");
+  }
+
+  SDL_AudioSpec obtained{};
+  if (settings.open_device) {
+    SDL_AudioSpec desired{};
+    desired.freq = settings.frequency;
+    desired.format = AUDIO_F32SYS;
+    desired.channels = 2;
+    desired.samples = settings.buffer_frames;
+    desired.callback = Callback;
+    desired.userdata = this;
+    // The format and channels are converted by SDL if needed, but a different frequency or
+    // buffer size is cheaper to accept than to convert
+    device = SDL_OpenAudioDevice(settings.device.empty() ? nullptr : settings.device.c_str(), 0,
+                                 &desired, &obtained,
+                                 SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+    if (device == 0) {
+      throw AudioEngineException("Failed to open audio device");
+    }
+    frequency = obtained.freq;
+    block_frames = obtained.samples;
+  }
+  if (block_frames == 0) {
+    block_frames = 512;
+  }
+
+  slots.resize(settings.voices);
+  free_slots.reserve(settings.voices);
+  for (std::size_t i = settings.voices; i-- > 0;) {
+    free_slots.push_back(static_cast<uint16_t>(i));
+  }
+  voices.resize(settings.voices);
+  bus_volumes.assign(settings.buses, 1.0f);
+  bus_buffers.resize(settings.buses * block_frames * 2);
+  bus_used.resize(settings.buses);
+  scratch.resize(block_frames * 2);
+
+  if (device != 0) {
+    SDL_PauseAudioDevice(device, 0);
+  }
+}
+
+AudioEngine::~AudioEngine() {
+  if (device != 0) {
+    SDL_CloseAudioDevice(device);
+  }
+}
+
+Sound AudioEngine::LoadSound(const std::string& path) {
+  auto it = cache.find(path);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  Sound sound = Sound::LoadWav(path, frequency);
+  if (sound.GetDuration(frequency).AsMicroseconds() <= max_cached_duration.AsMicroseconds()) {
+    cache.emplace(path, sound);
+  }
+  return sound;
+}
+
+void AudioEngine::ClearCache() { cache.clear(); }
+
+AudioEngine::VoiceId AudioEngine::Play(const Sound& sound, const VoiceParameters& parameters) {
+  if (sound.IsEmpty()) {
+    return INVALID_VOICE;
+  }
+  Command command{Command::Type::PLAY};
+  command.samples = sound.GetSamples();
+  command.frames = sound.GetFrameCount();
+  command.channels = sound.GetChannels();
+  return Start(command, parameters, sound, nullptr);
+}
+
+AudioEngine::VoiceId AudioEngine::PlayStream(std::shared_ptr<StreamBuffer> stream,
+                                             const VoiceParameters& parameters) {
+  Command command{Command::Type::PLAY};
+  command.channels = stream->GetChannels();
+  command.stream = stream.get();
+  return Start(command, parameters, Sound(), std::move(stream));
+}
+
+void AudioEngine::Stop(VoiceId voice, Time fade) {
+  uint16_t index = 0;
+  if (Find(voice, index)) {
+    Command command{Command::Type::STOP, index, slots[index].generation};
+    command.fade_frames = ToFrames(fade);
+    Send(command);
+  }
+}
+
+void AudioEngine::StopAll() { Send(Command{Command::Type::STOP_ALL}); }
+
+void AudioEngine::SetVolume(VoiceId voice, float volume, Time fade) {
+  uint16_t index = 0;
+  if (Find(voice, index)) {
+    Command command{Command::Type::VOLUME, index, slots[index].generation};
+    command.volume = volume;
+    command.fade_frames = ToFrames(fade);
+    Send(command);
+  }
+}
+
+void AudioEngine::SetPan(VoiceId voice, float pan) {
+  uint16_t index = 0;
+  if (Find(voice, index)) {
+    Command command{Command::Type::PAN, index, slots[index].generation};
+    command.pan = pan;
+    Send(command);
+  }
+}
+
+void AudioEngine::SetPitch(VoiceId voice, float pitch) {
+  uint16_t index = 0;
+  if (Find(voice, index)) {
+    Command command{Command::Type::PITCH, index, slots[index].generation};
+    command.pitch = pitch;
+    Send(command);
+  }
+}
+
+bool AudioEngine::IsPlaying(VoiceId voice) const {
+  uint16_t index = 0;
+  return Find(voice, index);
+}
+
+void AudioEngine::SetBusVolume(std::size_t bus, float volume) {
+  if (bus >= bus_volumes.size()) {
+    throw AudioEngineException("Bus " + std::to_string(bus) + " does not exist");
+  }
+  Command command{Command::Type::BUS_VOLUME};
+  command.bus = static_cast<uint16_t>(bus);
+  command.volume = volume;
+  Send(command);
+}
+
+void AudioEngine::SetMasterVolume(float volume) {
+  Command command{Command::Type::MASTER_VOLUME};
+  command.volume = volume;
+  Send(command);
+}
+
+void AudioEngine::Update() {
+  finished.Drain([this](uint16_t index) {
+    Slot& slot = slots[index];
+    slot.playing = false;
+    slot.sound = Sound();
+    slot.stream.reset();
+    free_slots.push_back(index);
+  });
+}
+
+void AudioEngine::Mix(float* output, std::size_t frames) {
+  uint64_t start = Timer::GetPerformanceCounter();
+
+  commands.Drain([this](Command&& command) { Execute(command); });
+  for (std::size_t offset = 0; offset < frames; offset += block_frames) {
+    MixBlock(output + offset * 2, std::min(block_frames, frames - offset));
+  }
+  active_voices.store(
+      std::count_if(voices.begin(), voices.end(), [](const Voice& voice) { return voice.active; }),
+      std::memory_order_relaxed);
+
+  int64_t elapsed = CounterToNanoseconds(Timer::GetPerformanceCounter() - start);
+  last_mix_ns.store(elapsed, std::memory_order_relaxed);
+  total_mix_ns.fetch_add(elapsed, std::memory_order_relaxed);
+  if (elapsed > max_mix_ns.load(std::memory_order_relaxed)) {
+    max_mix_ns.store(elapsed, std::memory_order_relaxed);
+  }
+  buffers.fetch_add(1, std::memory_order_relaxed);
+}
+
+AudioStatistics AudioEngine::GetStatistics() const {
+  AudioStatistics statistics;
+  int64_t last = last_mix_ns.load(std::memory_order_relaxed);
+  uint64_t count = buffers.load(std::memory_order_relaxed);
+  int64_t buffer_ns = static_cast<int64_t>(block_frames) * 1000000000 / frequency;
+  statistics.last_mix_time = Time::Microseconds(last / 1000);
+  statistics.average_mix_time = Time::Microseconds(
+      count == 0 ? 0 : total_mix_ns.load(std::memory_order_relaxed) / 1000 /
+                           static_cast<int64_t>(count));
+  statistics.max_mix_time = Time::Microseconds(max_mix_ns.load(std::memory_order_relaxed) / 1000);
+  statistics.buffer_duration = Time::Microseconds(buffer_ns / 1000);
+  statistics.load = static_cast<float>(last) / static_cast<float>(buffer_ns);
+  statistics.active_voices = active_voices.load(std::memory_order_relaxed);
+  statistics.buffers = count;
+  statistics.rejected_voices = rejected_voices;
+  statistics.dropped_commands = dropped_commands;
+  return statistics;
+}
+
+void AudioEngine::ResetStatistics() { max_mix_ns.store(0, std::memory_order_relaxed); }
+
+void AudioEngine::Callback(void* userdata, uint8_t* stream, int length) {
+#ifdef __SSE2__
+  // Flush denormals to zero, which are slow and inaudible in decaying sounds
+  _mm_setcsr(_mm_getcsr() | 0x8040U);
+#endif
+  static_cast<AudioEngine*>(userdata)->Mix(
+      reinterpret_cast<float*>(stream),
+      static_cast<std::size_t>(length) / (2 * sizeof(float)));
+}
+
+AudioEngine::VoiceId AudioEngine::Start(Command& command, const VoiceParameters& parameters,
+                                        const Sound& sound, std::shared_ptr<StreamBuffer> stream) {
+  if (parameters.bus >= bus_volumes.size()) {
+    throw AudioEngineException("Bus " + std::to_string(parameters.bus) + " does not exist");
+  }
+  if (free_slots.empty()) {
+    Update();
+    if (free_slots.empty()) {
+      ++rejected_voices;
+      return INVALID_VOICE;
+    }
+  }
+  uint16_t index = free_slots.back();
+  Slot& slot = slots[index];
+  // Generation 0 is never used, so that no identifier equals INVALID_VOICE
+  uint16_t generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+  command.index = index;
+  command.generation = generation;
+  command.bus = static_cast<uint16_t>(parameters.bus);
+  command.loop = parameters.loop;
+  command.volume = parameters.volume;
+  command.pan = parameters.pan;
+  command.pitch = parameters.pitch;
+  if (!Send(command)) {
+    return INVALID_VOICE;
+  }
+  free_slots.pop_back();
+  slot.sound = sound;
+  slot.stream = std::move(stream);
+  slot.generation = generation;
+  slot.playing = true;
+  return static_cast<VoiceId>(generation) << 16U | index;
+}
+
+bool AudioEngine::Send(const Command& command) {
+  if (!commands.TryPush(command)) {
+    ++dropped_commands;
+    return false;
+  }
+  return true;
+}
+
+bool AudioEngine::Find(VoiceId voice, uint16_t& index) const {
+  index = static_cast<uint16_t>(voice & 0xFFFFU);
+  return index < slots.size() && slots[index].playing &&
+         slots[index].generation == static_cast<uint16_t>(voice >> 16U);
+}
+
+uint32_t AudioEngine::ToFrames(Time duration) const {
+  return static_cast<uint32_t>(std::max<int64_t>(duration.AsMicroseconds(), 0) * frequency /
+                               1000000);
+}
+
+void AudioEngine::SetFade(Voice& voice, float target, uint32_t frames) {
+  voice.target_volume = target;
+  voice.fade_step =
+      frames == 0 ? 0.0f : std::abs(target - voice.volume) / static_cast<float>(frames);
+}
+
+void AudioEngine::Execute(const Command& command) {
+  if (command.type == Command::Type::STOP_ALL) {
+    for (Voice& voice : voices) {
+      voice.stopping = true;
+      SetFade(voice, 0.0f, 0);
+    }
+    return;
+  }
+  if (command.type == Command::Type::BUS_VOLUME) {
+    bus_volumes[command.bus] = command.volume;
+    return;
+  }
+  if (command.type == Command::Type::MASTER_VOLUME) {
+    master_volume = command.volume;
+    return;
+  }
+
+  Voice& voice = voices[command.index];
+  if (command.type == Command::Type::PLAY) {
+    voice.samples = command.samples;
+    voice.frames = command.frames;
+    voice.channels = command.channels;
+    voice.stream = command.stream;
+    voice.position = 0;
+    voice.step = PitchToStep(command.pitch);
+    voice.volume = command.volume;
+    voice.target_volume = command.volume;
+    voice.fade_step = 0.0f;
+    voice.pan = command.pan;
+    // Start at full gain, so that attacks are not softened
+    GetGains(voice.volume, voice.pan, voice.channels, voice.gains);
+    voice.generation = command.generation;
+    voice.bus = command.bus;
+    voice.loop = command.loop;
+    voice.stopping = false;
+    voice.active = true;
+    return;
+  }
+  if (!voice.active || voice.generation != command.generation) {
+    return;
+  }
+  switch (command.type) {
+    case Command::Type::STOP:
+      voice.stopping = true;
+      SetFade(voice, 0.0f, command.fade_frames);
+      break;
+    case Command::Type::VOLUME:
+      SetFade(voice, command.volume, command.fade_frames);
+      break;
+    case Command::Type::PAN:
+      voice.pan = command.pan;
+      break;
+    case Command::Type::PITCH:
+      voice.step = PitchToStep(command.pitch);
+      break;
+    default:
+      break;
+  }
+}
+
+void AudioEngine::MixBlock(float* output, std::size_t frames) {
+  std::fill(bus_used.begin(), bus_used.end(), false);
+  for (std::size_t i = 0; i < voices.size(); ++i) {
+    Voice& voice = voices[i];
+    if (!voice.active) {
+      continue;
+    }
+    if (!bus_used[voice.bus]) {
+      bus_used[voice.bus] = true;
+      std::fill_n(bus_buffers.begin() + voice.bus * block_frames * 2, frames * 2, 0.0f);
+    }
+    if (!MixVoice(voice, frames)) {
+      voice.active = false;
+      if (voice.stream != nullptr) {
+        voice.stream->Close();
+      }
+      finished.TryPush(static_cast<uint16_t>(i));
+    }
+  }
+
+  std::fill_n(output, frames * 2, 0.0f);
+  for (std::size_t bus = 0; bus < bus_used.size(); ++bus) {
+    if (bus_used[bus]) {
+      AddScaled(&bus_buffers[bus * block_frames * 2], output, frames * 2,
+                bus_volumes[bus] * master_volume);
+    }
+  }
+  Clip(output, frames * 2);
+}
+
+bool AudioEngine::MixVoice(Voice& voice, std::size_t frames) {
+  if (voice.fade_step == 0.0f) {
+    voice.volume = voice.target_volume;
+  } else if (voice.volume < voice.target_volume) {
+    voice.volume =
+        std::min(voice.volume + voice.fade_step * static_cast<float>(frames), voice.target_volume);
+  } else {
+    voice.volume =
+        std::max(voice.volume - voice.fade_step * static_cast<float>(frames), voice.target_volume);
+  }
+  bool silenced = voice.stopping && voice.volume == 0.0f;
+
+  float* bus = &bus_buffers[voice.bus * block_frames * 2];
+  float targets[2];
+  GetGains(voice.volume, voice.pan, voice.channels, targets);
+  float delta_left = (targets[0] - voice.gains[0]) / static_cast<float>(frames);
+  float delta_right = (targets[1] - voice.gains[1]) / static_cast<float>(frames);
+  auto channels = static_cast<std::size_t>(voice.channels);
+  uint64_t end = static_cast<uint64_t>(voice.frames) << 32U;
+
+  bool ended = false;
+  if (voice.stream != nullptr) {
+    // Frames missing from the stream are left silent, and the voice goes on
+    std::size_t count = voice.stream->Read(scratch.data(), frames);
+    Accumulate(scratch.data(), voice.channels, bus, count, voice.gains[0], voice.gains[1],
+               delta_left, delta_right);
+    ended = count < frames && voice.stream->IsFinished();
+  } else {
+    std::size_t done = 0;
+    while (done < frames) {
+      if (voice.position >= end) {
+        if (!voice.loop) {
+          break;
+        }
+        voice.position -= end;
+      }
+      const float* source = nullptr;
+      std::size_t count = 0;
+      if (voice.step == ONE && (voice.position & FRACTION_MASK) == 0) {
+        // Mix directly from the sound at the original pitch
+        std::size_t index = voice.position >> 32U;
+        count = std::min(frames - done, voice.frames - index);
+        source = voice.samples + index * channels;
+        voice.position += static_cast<uint64_t>(count) << 32U;
+      } else {
+        // Resample with linear interpolation into the scratch buffer
+        count = std::min<uint64_t>(frames - done,
+                                   (end - voice.position + voice.step - 1) / voice.step);
+        if (channels == 1) {
+          Resample<1>(voice, scratch.data(), count);
+        } else {
+          Resample<2>(voice, scratch.data(), count);
+        }
+        source = scratch.data();
+      }
+      auto offset = static_cast<float>(done);
+      Accumulate(source, voice.channels, bus + done * 2, count,
+                 voice.gains[0] + delta_left * offset, voice.gains[1] + delta_right * offset,
+                 delta_left, delta_right);
+      done += count;
+    }
+    ended = done < frames;
+  }
+  voice.gains[0] = targets[0];
+  voice.gains[1] = targets[1];
+  return !ended && !silenced;
+}
@@ -0,0 +1,210 @@
+#include "sdlxx/mixer/music_player.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include <SDL_audio.h>
+
+using namespace sdlxx;
+
+struct MusicPlayer::Track {
+  std::unique_ptr<AudioDecoder> decoder;
+  std::shared_ptr<StreamBuffer> stream;
+  std::unique_ptr<SDL_AudioStream, decltype(&SDL_FreeAudioStream)> resampler{nullptr,
+                                                                             SDL_FreeAudioStream};
+  std::vector<float> chunk;
+  std::size_t chunk_frames = 0;
+  bool loop = false;
+  bool flushed = false;
+  bool done = false;
+};
+
+namespace {
+
+// Decode frames and start over at the end of a looping track, so that there is no gap
+template <typename Track>
+std::size_t Decode(Track& track, float* output, std::size_t frames) {
+  auto channels = static_cast<std::size_t>(track.decoder->GetChannels());
+  std::size_t total = 0;
+  while (total < frames) {
+    total += track.decoder->Decode(output + total * channels, frames - total);
+    if (total < frames) {
+      if (!track.loop || track.decoder->GetFrameCount() == 0) {
+        break;
+      }
+      track.decoder->Seek(0);
+    }
+  }
+  return total;
+}
+
+std::size_t ToFrames(int64_t microseconds, int frequency) {
+  return static_cast<std::size_t>(std::max<int64_t>(microseconds, 0) * frequency / 1000000);
+}
+
+}  // namespace
+
+MusicPlayer::MusicPlayer(AudioEngine& engine, const MusicPlayerSettings& settings)
+    : engine(engine),
+      read_ahead_frames(std::max<std::size_t>(
+          ToFrames(settings.read_ahead.AsMicroseconds(), engine.GetFrequency()), 1)),
+      chunk_frames(std::max<std::size_t>(settings.chunk_frames, 1)),
+      bus(settings.bus),
+      // Wake up four times per read-ahead, so that the buffers stay mostly full
+      poll_interval(Time::Microseconds(
+          std::clamp<int64_t>(settings.read_ahead.AsMicroseconds() / 4, 2000, 50000))) {
+  worker = std::thread(&MusicPlayer::Run, this);
+}
+
+MusicPlayer::~MusicPlayer() {
+  Stop();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_one();
+  worker.join();
+}
+
+bool MusicPlayer::Play(std::unique_ptr<AudioDecoder> decoder, Time crossfade, bool loop) {
+  int channels = decoder->GetChannels();
+  if ((channels != 1 && channels != 2) || decoder->GetFrequency() <= 0) {
+    throw MusicPlayerException("Music with " + std::to_string(channels) + " channels at " +
+                               std::to_string(decoder->GetFrequency()) +
+                               " Hz is not supported");
+  }
+  auto track = std::make_shared<Track>();
+  if (decoder->GetFrequency() != engine.GetFrequency()) {
+    track->resampler.reset(SDL_NewAudioStream(AUDIO_F32SYS, static_cast<Uint8>(channels),
+                                              decoder->GetFrequency(), AUDIO_F32SYS,
+                                              static_cast<Uint8>(channels),
+                                              engine.GetFrequency()));
+    if (!track->resampler) {
+      throw MusicPlayerException("Failed to create a resampler");
+    }
+  }
+  track->decoder = std::move(decoder);
+  track->stream = std::make_shared<StreamBuffer>(read_ahead_frames, channels);
+  track->chunk.resize(chunk_frames * static_cast<std::size_t>(channels));
+  track->chunk_frames = chunk_frames;
+  track->loop = loop;
+
+  bool fade = crossfade.AsMicroseconds() > 0;
+  VoiceParameters parameters;
+  parameters.volume = fade ? 0.0f : volume;
+  parameters.bus = bus;
+  // The voice plays silence until the worker thread decodes the first frames
+  AudioEngine::VoiceId started = engine.PlayStream(track->stream, parameters);
+  if (started == AudioEngine::INVALID_VOICE) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tracks.push_back(track);
+  }
+  condition.notify_one();
+
+  if (fade) {
+    engine.SetVolume(started, volume, crossfade);
+  }
+  if (voice != AudioEngine::INVALID_VOICE) {
+    engine.Stop(voice, crossfade);
+  }
+  voice = started;
+  current = std::move(track);
+  return true;
+}
+
+bool MusicPlayer::Play(const std::string& path, Time crossfade, bool loop) {
+  return Play(AudioDecoder::Open(path), crossfade, loop);
+}
+
+void MusicPlayer::Stop(Time fade) {
+  if (voice != AudioEngine::INVALID_VOICE) {
+    engine.Stop(voice, fade);
+    voice = AudioEngine::INVALID_VOICE;
+    current.reset();
+  }
+}
+
+void MusicPlayer::SetVolume(float volume, Time fade) {
+  this->volume = volume;
+  if (voice != AudioEngine::INVALID_VOICE) {
+    engine.SetVolume(voice, volume, fade);
+  }
+}
+
+bool MusicPlayer::IsPlaying() const { return engine.IsPlaying(voice); }
+
+MusicStatistics MusicPlayer::GetStatistics() const {
+  MusicStatistics statistics;
+  if (current) {
+    statistics.buffered = Time::Microseconds(
+        static_cast<int64_t>(current->stream->GetAvailable()) * 1000000 / engine.GetFrequency());
+    statistics.underruns = current->stream->GetUnderruns();
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  statistics.tracks = tracks.size();
+  return statistics;
+}
+
+void MusicPlayer::Run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping) {
+    std::vector<std::shared_ptr<Track>> active = tracks;
+    lock.unlock();
+    for (const std::shared_ptr<Track>& track : active) {
+      if (!track->stream->IsClosed()) {
+        Fill(*track);
+      }
+    }
+    lock.lock();
+    // Voices close their streams when they stop, after a fade or at the end of a track
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(),
+                                [](const std::shared_ptr<Track>& track) {
+                                  return track->stream->IsClosed();
+                                }),
+                 tracks.end());
+    condition.wait_for(lock, std::chrono::microseconds(poll_interval.AsMicroseconds()));
+  }
+}
+
+void MusicPlayer::Fill(Track& track) {
+  StreamBuffer& stream = *track.stream;
+  auto frame_size = static_cast<int>(stream.GetChannels() * sizeof(float));
+  while (!track.done) {
+    std::size_t space = std::min(stream.GetWriteSpace(), track.chunk_frames);
+    if (space == 0) {
+      return;
+    }
+    if (!track.resampler) {
+      std::size_t decoded = Decode(track, track.chunk.data(), space);
+      stream.Write(track.chunk.data(), decoded);
+      if (decoded < space) {
+        stream.Finish();
+        track.done = true;
+      }
+      continue;
+    }
+    // Take resampled frames first, and decode more when there are none
+    int size = SDL_AudioStreamGet(track.resampler.get(), track.chunk.data(),
+                                  static_cast<int>(space) * frame_size);
+    if (size > 0) {
+      stream.Write(track.chunk.data(), static_cast<std::size_t>(size / frame_size));
+    } else if (size < 0 || track.flushed) {
+      stream.Finish();
+      track.done = true;
+    } else {
+      std::size_t decoded = Decode(track, track.chunk.data(), track.chunk_frames);
+      if (decoded > 0) {
+        SDL_AudioStreamPut(track.resampler.get(), track.chunk.data(),
+                           static_cast<int>(decoded) * frame_size);
+      }
+      if (decoded < track.chunk_frames) {
+        SDL_AudioStreamFlush(track.resampler.get());
+        track.flushed = true;
+      }
+    }
+  }
+}
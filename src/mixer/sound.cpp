@@ -0,0 +1,64 @@
+#include "sdlxx/mixer/sound.h"
+
+#include <utility>
+
+#include <SDL_audio.h>
+
+using namespace sdlxx;
+
+namespace {
+
+void CheckChannels(int channels) {
+  if (channels != 1 && channels != 2) {
+    throw SoundException("Sounds with " + std::to_string(channels) +
+                         " channels are not supported");
+  }
+}
+
+}  // namespace
+
+Sound::Sound(std::vector<float> samples, int channels) : channels(channels) {
+  CheckChannels(channels);
+  frames = samples.size() / static_cast<std::size_t>(channels);
+  auto owner = std::make_shared<std::vector<float>>(std::move(samples));
+  this->samples = std::shared_ptr<const float>(owner, owner->data());
+}
+
+Sound::Sound(std::shared_ptr<const float> samples, std::size_t frames, int channels)
+    : samples(std::move(samples)), frames(frames), channels(channels) {
+  CheckChannels(channels);
+}
+
+Sound Sound::LoadWav(const std::string& path, int frequency) {
+  SDL_AudioSpec spec;
+  Uint8* buffer = nullptr;
+  Uint32 length = 0;
+  if (SDL_LoadWAV(path.c_str(), &spec, &buffer, &length) == nullptr) {
+    throw SoundException("Failed to load sound " + path);
+  }
+  std::unique_ptr<Uint8, decltype(&SDL_FreeWAV)> wav(buffer, SDL_FreeWAV);
+
+  int channels = spec.channels == 1 ? 1 : 2;
+  std::unique_ptr<SDL_AudioStream, decltype(&SDL_FreeAudioStream)> stream(
+      SDL_NewAudioStream(spec.format, spec.channels, spec.freq, AUDIO_F32SYS,
+                         static_cast<Uint8>(channels), frequency),
+      SDL_FreeAudioStream);
+  if (!stream) {
+    throw SoundException("Failed to convert sound " + path);
+  }
+  if (SDL_AudioStreamPut(stream.get(), buffer, static_cast<int>(length)) != 0 ||
+      SDL_AudioStreamFlush(stream.get()) != 0) {
+    throw SoundException("Failed to convert sound " + path);
+  }
+  std::vector<float> samples(static_cast<std::size_t>(SDL_AudioStreamAvailable(stream.get())) /
+                             sizeof(float));
+  int size = static_cast<int>(samples.size() * sizeof(float));
+  if (SDL_AudioStreamGet(stream.get(), samples.data(), size) != size) {
+    throw SoundException("Failed to convert sound " + path);
+  }
+  return Sound(std::move(samples), channels);
+}
+
+Time Sound::GetDuration(int frequency) const {
+  return Time::Microseconds(static_cast<int64_t>(frames) * 1000000 / frequency);
+}
@@ -0,0 +1,210 @@
+#include "sdlxx/mixer/sound_bank.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+using namespace sdlxx;
+
+namespace {
+
+constexpr char MAGIC[8] = {'S', 'D', 'L', 'X', 'X', 'S', 'B', '1'};
+
+// Written in the byte order of the machine, so that caches from other machines are rejected
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Sounds start at cache line boundaries of the arena, which is allocated at one
+constexpr uint64_t ALIGNMENT = 64 / sizeof(float);
+
+// Names and paths in a cache that are longer are considered corrupt
+constexpr uint32_t MAX_STRING_SIZE = 4096;
+
+uint64_t AlignUp(uint64_t value) { return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+bool GetSourceStatus(const std::string& path, uint64_t& size, int64_t& time) {
+  std::error_code error;
+  size = std::filesystem::file_size(path, error);
+  if (error) {
+    return false;
+  }
+  time = static_cast<int64_t>(
+      std::filesystem::last_write_time(path, error).time_since_epoch().count());
+  return !error;
+}
+
+template <typename T>
+void WriteValue(std::ofstream& stream, const T& value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::ofstream& stream, const std::string& value) {
+  WriteValue(stream, static_cast<uint32_t>(value.size()));
+  stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+template <typename T>
+bool ReadValue(std::ifstream& stream, T& value) {
+  return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool ReadString(std::ifstream& stream, std::string& value) {
+  uint32_t size = 0;
+  if (!ReadValue(stream, size) || size > MAX_STRING_SIZE) {
+    return false;
+  }
+  value.resize(size);
+  return static_cast<bool>(stream.read(value.data(), size));
+}
+
+}  // namespace
+
+SoundBank::SoundBank(int frequency) : frequency(frequency) {}
+
+void SoundBank::Add(const std::string& name, const std::string& path) {
+  if (indices.count(name) != 0) {
+    throw SoundBankException("Sound " + name + " is already in the bank");
+  }
+  Entry entry;
+  entry.name = name;
+  entry.path = path;
+  indices.emplace(name, entries.size());
+  entries.push_back(std::move(entry));
+}
+
+void SoundBank::Load(const std::string& cache_path) {
+  std::vector<Entry> updated = entries;
+  bool sources_found = true;
+  for (Entry& entry : updated) {
+    sources_found &= GetSourceStatus(entry.path, entry.source_size, entry.source_time);
+  }
+  if (!cache_path.empty() && sources_found && ReadCache(cache_path, updated)) {
+    entries = std::move(updated);
+    loaded_from_cache = true;
+    return;
+  }
+
+  // Convert every sound before the arena is allocated, so that its size is known
+  std::vector<Sound> sounds;
+  sounds.reserve(updated.size());
+  uint64_t size = 0;
+  for (Entry& entry : updated) {
+    sounds.push_back(Sound::LoadWav(entry.path, frequency));
+    entry.offset = size;
+    entry.frames = sounds.back().GetFrameCount();
+    entry.channels = static_cast<uint32_t>(sounds.back().GetChannels());
+    entry.loaded = true;
+    size += AlignUp(entry.frames * entry.channels);
+  }
+  auto converted = std::make_shared<Arena>(size);
+  for (std::size_t i = 0; i < sounds.size(); ++i) {
+    std::copy_n(sounds[i].GetSamples(), updated[i].frames * updated[i].channels,
+                converted->data() + updated[i].offset);
+  }
+  arena = std::move(converted);
+  entries = std::move(updated);
+  loaded_from_cache = false;
+  sounds.clear();
+
+  if (!cache_path.empty()) {
+    WriteCache(cache_path);
+  }
+}
+
+Sound SoundBank::Get(const std::string& name) const {
+  auto it = indices.find(name);
+  if (it == indices.end() || !entries[it->second].loaded) {
+    throw SoundBankException("Sound " + name + " is not loaded");
+  }
+  const Entry& entry = entries[it->second];
+  return Sound(std::shared_ptr<const float>(arena, arena->data() + entry.offset), entry.frames,
+               static_cast<int>(entry.channels));
+}
+
+bool SoundBank::Contains(const std::string& name) const {
+  auto it = indices.find(name);
+  return it != indices.end() && entries[it->second].loaded;
+}
+
+std::size_t SoundBank::GetCount() const {
+  return std::count_if(entries.begin(), entries.end(),
+                       [](const Entry& entry) { return entry.loaded; });
+}
+
+bool SoundBank::ReadCache(const std::string& path, std::vector<Entry>& loaded) {
+  std::ifstream stream(path, std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  uint32_t byte_order_mark = 0;
+  int32_t cached_frequency = 0;
+  uint32_t count = 0;
+  uint64_t size = 0;
+  if (!stream.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      !ReadValue(stream, byte_order_mark) || byte_order_mark != BYTE_ORDER_MARK ||
+      !ReadValue(stream, cached_frequency) || cached_frequency != frequency ||
+      !ReadValue(stream, count) || count != loaded.size() || !ReadValue(stream, size)) {
+    return false;
+  }
+  std::error_code error;
+  if (size > std::filesystem::file_size(path, error) / sizeof(float) || error) {
+    return false;
+  }
+  for (Entry& entry : loaded) {
+    // The cache is outdated if any sound was added, removed, reordered or modified
+    std::string name;
+    std::string source;
+    uint64_t source_size = 0;
+    int64_t source_time = 0;
+    if (!ReadString(stream, name) || name != entry.name || !ReadString(stream, source) ||
+        source != entry.path || !ReadValue(stream, source_size) ||
+        source_size != entry.source_size || !ReadValue(stream, source_time) ||
+        source_time != entry.source_time) {
+      return false;
+    }
+    if (!ReadValue(stream, entry.offset) || !ReadValue(stream, entry.frames) ||
+        !ReadValue(stream, entry.channels) || (entry.channels != 1 && entry.channels != 2) ||
+        entry.offset > size || entry.frames > (size - entry.offset) / entry.channels) {
+      return false;
+    }
+    entry.loaded = true;
+  }
+  auto cached = std::make_shared<Arena>(size);
+  if (!stream.read(reinterpret_cast<char*>(cached->data()),
+                   static_cast<std::streamsize>(size * sizeof(float)))) {
+    return false;
+  }
+  arena = std::move(cached);
+  return true;
+}
+
+void SoundBank::WriteCache(const std::string& path) const {
+  // Write to another file first, so that a crash never leaves a partial cache
+  std::string temporary = path + ".tmp";
+  {
+    std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+    stream.write(MAGIC, sizeof(MAGIC));
+    WriteValue(stream, BYTE_ORDER_MARK);
+    WriteValue(stream, static_cast<int32_t>(frequency));
+    WriteValue(stream, static_cast<uint32_t>(entries.size()));
+    WriteValue(stream, static_cast<uint64_t>(arena->size()));
+    for (const Entry& entry : entries) {
+      WriteString(stream, entry.name);
+      WriteString(stream, entry.path);
+      WriteValue(stream, entry.source_size);
+      WriteValue(stream, entry.source_time);
+      WriteValue(stream, entry.offset);
+      WriteValue(stream, entry.frames);
+      WriteValue(stream, entry.channels);
+    }
+    stream.write(reinterpret_cast<const char*>(arena->data()),
+                 static_cast<std::streamsize>(arena->size() * sizeof(float)));
+    if (!stream.flush()) {
+      throw SoundBankException("Failed to write sound cache " + temporary);
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    throw SoundBankException("Failed to replace sound cache " + path + ": " + error.message());
+  }
+}
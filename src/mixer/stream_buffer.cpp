@@ -0,0 +1,65 @@
+#include "sdlxx/mixer/stream_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace sdlxx;
+
+StreamBuffer::StreamBuffer(std::size_t frames, int channels) : mask(0), channels(channels) {
+  if (channels != 1 && channels != 2) {
+    throw StreamBufferException("Streams with " + std::to_string(channels) +
+                                " channels are not supported");
+  }
+  std::size_t capacity = 1;
+  while (capacity < frames) {
+    capacity <<= 1U;
+  }
+  mask = capacity - 1;
+  samples = std::make_unique<float[]>(capacity * static_cast<std::size_t>(channels));
+}
+
+std::size_t StreamBuffer::GetWriteSpace() const {
+  return GetCapacity() - static_cast<std::size_t>(write_position.load(std::memory_order_relaxed) -
+                                                  read_position.load(std::memory_order_acquire));
+}
+
+std::size_t StreamBuffer::Write(const float* source, std::size_t frames) {
+  uint64_t position = write_position.load(std::memory_order_relaxed);
+  frames = std::min(frames, GetWriteSpace());
+  auto start = static_cast<std::size_t>(position & mask);
+  std::size_t first = std::min(frames, GetCapacity() - start);
+  auto stride = static_cast<std::size_t>(channels);
+  std::memcpy(&samples[start * stride], source, first * stride * sizeof(float));
+  std::memcpy(&samples[0], source + first * stride, (frames - first) * stride * sizeof(float));
+  write_position.store(position + frames, std::memory_order_release);
+  return frames;
+}
+
+std::size_t StreamBuffer::GetAvailable() const {
+  return static_cast<std::size_t>(write_position.load(std::memory_order_acquire) -
+                                  read_position.load(std::memory_order_relaxed));
+}
+
+std::size_t StreamBuffer::Read(float* destination, std::size_t frames) {
+  uint64_t position = read_position.load(std::memory_order_relaxed);
+  uint64_t end = write_position.load(std::memory_order_acquire);
+  auto available = static_cast<std::size_t>(end - position);
+  if (available < frames && end != 0 && !finished.load(std::memory_order_acquire)) {
+    underruns.fetch_add(1, std::memory_order_relaxed);
+  }
+  frames = std::min(frames, available);
+  auto start = static_cast<std::size_t>(position & mask);
+  std::size_t first = std::min(frames, GetCapacity() - start);
+  auto stride = static_cast<std::size_t>(channels);
+  std::memcpy(destination, &samples[start * stride], first * stride * sizeof(float));
+  std::memcpy(destination + first * stride, &samples[0],
+              (frames - first) * stride * sizeof(float));
+  read_position.store(position + frames, std::memory_order_release);
+  return frames;
+}
+
+bool StreamBuffer::IsFinished() const {
+  // The end flag is read first, so that frames written before it are not missed
+  return finished.load(std::memory_order_acquire) && GetAvailable() == 0;
+}
@@ -0,0 +1,99 @@
+#include "sdlxx/net/bit_stream.h"
+
+#include <cstring>
+
+using namespace sdlxx;
+
+void BitWriter::WriteVarUint(uint64_t value) {
+  while (value >= 0x80U) {
+    WriteBits(static_cast<uint32_t>(value & 0x7FU) | 0x80U, 8);
+    value >>= 7U;
+  }
+  WriteBits(static_cast<uint32_t>(value), 8);
+}
+
+void BitWriter::WriteVarInt(int64_t value) {
+  // Zigzag: 0, -1, 1, -2, 2... map to 0, 1, 2, 3, 4...
+  WriteVarUint((static_cast<uint64_t>(value) << 1U) ^ static_cast<uint64_t>(value >> 63U));
+}
+
+void BitWriter::WriteFloat(float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  WriteBits(bits, 32);
+}
+
+void BitWriter::WriteQuantized(float value, float min, float max, int bits) {
+  WriteBits(Quantize(value, min, max, bits), bits);
+}
+
+void BitWriter::AlignToByte() { WriteBits(0, (8 - scratch_bits % 8) % 8); }
+
+const std::vector<uint8_t>& BitWriter::GetData() {
+  // Append the pending bits, which the next complete word overwrites
+  buffer.resize(stored);
+  for (int bits = 0; bits < scratch_bits; bits += 8) {
+    buffer.push_back(static_cast<uint8_t>(scratch >> static_cast<unsigned>(bits)));
+  }
+  return buffer;
+}
+
+void BitWriter::Clear() {
+  buffer.clear();
+  stored = 0;
+  scratch = 0;
+  scratch_bits = 0;
+  bit_count = 0;
+}
+
+void BitWriter::StoreWord(uint32_t word) {
+  buffer.resize(stored + 4);
+  buffer[stored] = static_cast<uint8_t>(word);
+  buffer[stored + 1] = static_cast<uint8_t>(word >> 8U);
+  buffer[stored + 2] = static_cast<uint8_t>(word >> 16U);
+  buffer[stored + 3] = static_cast<uint8_t>(word >> 24U);
+  stored += 4;
+}
+
+BitReader::BitReader(const void* data, std::size_t size)
+    : data(static_cast<const uint8_t*>(data)), size(size) {}
+
+uint64_t BitReader::ReadVarUint() {
+  uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    uint32_t group = ReadBits(8);
+    value |= static_cast<uint64_t>(group & 0x7FU) << shift;
+    if ((group & 0x80U) == 0) {
+      return value;
+    }
+  }
+  throw BitStreamException("Variable-length integer is too long");
+}
+
+int64_t BitReader::ReadVarInt() {
+  uint64_t value = ReadVarUint();
+  return static_cast<int64_t>((value >> 1U) ^ (~(value & 1U) + 1));
+}
+
+float BitReader::ReadFloat() {
+  uint32_t bits = ReadBits(32);
+  float value = 0;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+float BitReader::ReadQuantized(float min, float max, int bits) {
+  return Dequantize(ReadBits(bits), min, max, bits);
+}
+
+void BitReader::AlignToByte() { ReadBits(scratch_bits % 8); }
+
+void BitReader::Refill(int count) {
+  while (scratch_bits <= 56 && position < size) {
+    scratch |= static_cast<uint64_t>(data[position++]) << static_cast<unsigned>(scratch_bits);
+    scratch_bits += 8;
+  }
+  if (scratch_bits < count) {
+    throw BitStreamException("Read past the end of the data");
+  }
+}
@@ -0,0 +1,156 @@
+#include "sdlxx/net/message_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+using namespace sdlxx;
+
+namespace {
+
+// The largest header of both framings
+constexpr std::size_t MAX_HEADER_SIZE = 5;
+
+// The most parts of a message, which leaves one more buffer of a gather send for the header
+constexpr std::size_t MAX_PARTS = 63;
+
+// Smaller messages are always queued, because copying them is cheaper than a system call
+constexpr std::size_t DIRECT_SEND_SIZE = 4096;
+
+}  // namespace
+
+MessageStream::MessageStream(TcpSocket socket, Framing framing, std::size_t max_message_size)
+    : socket(std::move(socket)),
+      framing(framing),
+      max_message_size(std::min<std::size_t>(max_message_size, UINT32_MAX)),
+      input(std::max(DEFAULT_BUFFER_SIZE, this->max_message_size + MAX_HEADER_SIZE)),
+      output(std::max(DEFAULT_BUFFER_SIZE, this->max_message_size + MAX_HEADER_SIZE)) {}
+
+bool MessageStream::Receive() {
+  while (input.GetFreeSpace() > 0) {
+    std::size_t space = input.GetFreeSpace();
+    std::optional<std::size_t> received = socket.Receive(input.GetWriteSpace(), space);
+    if (!received) {
+      return true;
+    }
+    if (*received == 0) {
+      return false;
+    }
+    input.Commit(*received);
+    // A short read means that the socket is drained, which saves a call that would block
+    if (*received < space) {
+      return true;
+    }
+  }
+  // A full buffer holds at least one complete message, which has to be taken first
+  return true;
+}
+
+std::optional<std::string_view> MessageStream::Next() {
+  const uint8_t* data = input.GetData();
+  std::size_t available = input.GetSize();
+  std::size_t header = 0;
+  uint64_t size = 0;
+  if (framing == Framing::LENGTH_PREFIX) {
+    if (available < 4) {
+      return std::nullopt;
+    }
+    size = static_cast<uint64_t>(data[0]) << 24U | static_cast<uint64_t>(data[1]) << 16U |
+           static_cast<uint64_t>(data[2]) << 8U | data[3];
+    header = 4;
+  } else {
+    for (;; ++header) {
+      if (header == available) {
+        return std::nullopt;
+      }
+      if (header == MAX_HEADER_SIZE) {
+        throw MessageStreamException("Message size is too long");
+      }
+      size |= static_cast<uint64_t>(data[header] & 0x7FU) << (7 * header);
+      if ((data[header] & 0x80U) == 0) {
+        ++header;
+        break;
+      }
+    }
+  }
+  if (size > max_message_size) {
+    throw MessageStreamException("Message of " + std::to_string(size) +
+                                 " bytes exceeds the limit of " +
+                                 std::to_string(max_message_size) + " bytes");
+  }
+  if (available - header < size) {
+    return std::nullopt;
+  }
+  // Consumed bytes stay in place until the next Receive() writes over them
+  input.Consume(header + size);
+  return std::string_view(reinterpret_cast<const char*>(data + header), size);
+}
+
+void MessageStream::Send(std::string_view message) { Send({message}); }
+
+void MessageStream::Send(std::initializer_list<std::string_view> parts) {
+  if (parts.size() > MAX_PARTS) {
+    throw MessageStreamException("Message has more than " + std::to_string(MAX_PARTS) +
+                                 " parts");
+  }
+  std::size_t size = 0;
+  for (std::string_view part : parts) {
+    size += part.size();
+  }
+  if (size > max_message_size) {
+    throw MessageStreamException("Message of " + std::to_string(size) +
+                                 " bytes exceeds the limit of " +
+                                 std::to_string(max_message_size) + " bytes");
+  }
+  uint8_t header[MAX_HEADER_SIZE];
+  std::string_view buffers[MAX_PARTS + 1];
+  buffers[0] = std::string_view(reinterpret_cast<const char*>(header), EncodeHeader(header, size));
+  std::copy(parts.begin(), parts.end(), buffers + 1);
+  std::size_t count = parts.size() + 1;
+  std::size_t total = buffers[0].size() + size;
+
+  std::size_t sent = 0;
+  if (output.IsEmpty() && size >= DIRECT_SEND_SIZE) {
+    // The socket takes as much as it can straight from the parts
+    sent = socket.Send(buffers, count).value_or(0);
+  } else if (output.GetFreeSpace() < total) {
+    Flush();
+    if (output.GetFreeSpace() < total) {
+      throw MessageStreamException("Send queue is full");
+    }
+  }
+  for (std::size_t i = 0; i < count && sent < total; ++i) {
+    std::size_t skip = std::min(sent, buffers[i].size());
+    output.Write(buffers[i].data() + skip, buffers[i].size() - skip);
+    sent -= skip;
+    total -= buffers[i].size();
+  }
+}
+
+bool MessageStream::Flush() {
+  while (!output.IsEmpty()) {
+    std::optional<std::size_t> sent = socket.Send(output.GetData(), output.GetSize());
+    if (!sent) {
+      return false;
+    }
+    output.Consume(*sent);
+  }
+  return true;
+}
+
+std::size_t MessageStream::EncodeHeader(uint8_t* header, std::size_t size) const {
+  if (framing == Framing::LENGTH_PREFIX) {
+    header[0] = static_cast<uint8_t>(size >> 24U);
+    header[1] = static_cast<uint8_t>(size >> 16U);
+    header[2] = static_cast<uint8_t>(size >> 8U);
+    header[3] = static_cast<uint8_t>(size);
+    return 4;
+  }
+  std::size_t length = 0;
+  do {
+    uint8_t byte = size & 0x7FU;
+    size >>= 7U;
+    header[length++] = size != 0 ? (byte | 0x80U) : byte;
+  } while (size != 0);
+  return length;
+}
@@ -0,0 +1,59 @@
+#include "sdlxx/net/network_simulator.h"
+
+#include <algorithm>
+
+using namespace sdlxx;
+
+namespace {
+
+struct ArrivesLater {
+  template <typename Packet>
+  bool operator()(const Packet& a, const Packet& b) const {
+    return a.arrival != b.arrival ? a.arrival > b.arrival : a.order > b.order;
+  }
+};
+
+}  // namespace
+
+NetworkSimulator::NetworkSimulator() : NetworkSimulator(Settings{}) {}
+
+NetworkSimulator::NetworkSimulator(const Settings& settings, uint32_t seed)
+    : settings(settings), random(seed) {}
+
+void NetworkSimulator::SetSettings(const Settings& settings) { this->settings = settings; }
+
+const NetworkSimulator::Settings& NetworkSimulator::GetSettings() const { return settings; }
+
+void NetworkSimulator::Send(const void* data, std::size_t size, Time now) {
+  std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+  if (chance(random) < settings.loss) {
+    ++dropped;
+    return;
+  }
+  Schedule(static_cast<const uint8_t*>(data), size, now.AsMicroseconds());
+  if (chance(random) < settings.duplicate) {
+    Schedule(static_cast<const uint8_t*>(data), size, now.AsMicroseconds());
+  }
+}
+
+void NetworkSimulator::Deliver(Time now, const PacketReceiver& receiver) {
+  while (!packets.empty() && packets.front().arrival <= now.AsMicroseconds()) {
+    std::pop_heap(packets.begin(), packets.end(), ArrivesLater());
+    Packet packet = std::move(packets.back());
+    packets.pop_back();
+    receiver(packet.data.data(), packet.data.size());
+  }
+}
+
+std::size_t NetworkSimulator::GetPendingCount() const { return packets.size(); }
+
+uint64_t NetworkSimulator::GetDroppedCount() const { return dropped; }
+
+void NetworkSimulator::Schedule(const uint8_t* data, std::size_t size, int64_t now) {
+  int64_t delay = settings.latency.AsMicroseconds();
+  if (settings.jitter.AsMicroseconds() > 0) {
+    delay += std::uniform_int_distribution<int64_t>(0, settings.jitter.AsMicroseconds())(random);
+  }
+  packets.push_back(Packet{now + delay, sent++, std::vector<uint8_t>(data, data + size)});
+  std::push_heap(packets.begin(), packets.end(), ArrivesLater());
+}
@@ -0,0 +1,296 @@
+#include "sdlxx/net/reactor.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+using namespace sdlxx;
+
+namespace {
+
+// The maximum number of events taken from the kernel by one wait
+constexpr int MAX_EVENTS = 256;
+
+std::string GetErrorString(const std::string& message) {
+  return message + ": " + std::strerror(errno);
+}
+
+#if defined(__linux__)
+
+uint32_t ToNative(BitMask<IoEvent> events) {
+  return (events.IsSet(IoEvent::READ) ? EPOLLIN : 0U) |
+         (events.IsSet(IoEvent::WRITE) ? EPOLLOUT : 0U);
+}
+
+BitMask<IoEvent> FromNative(uint32_t events) {
+  BitMask<IoEvent> result;
+  if ((events & EPOLLIN) != 0U) {
+    result = result | IoEvent::READ;
+  }
+  if ((events & EPOLLOUT) != 0U) {
+    result = result | IoEvent::WRITE;
+  }
+  if ((events & (EPOLLERR | EPOLLHUP)) != 0U) {
+    result = result | IoEvent::ERROR;
+  }
+  return result;
+}
+
+epoll_event MakeEvent(BitMask<IoEvent> events, int handle, uint32_t generation) {
+  epoll_event event{};
+  event.events = ToNative(events);
+  event.data.u64 = static_cast<uint64_t>(generation) << 32U | static_cast<uint32_t>(handle);
+  return event;
+}
+
+#else
+
+short ToNative(BitMask<IoEvent> events) {  // NOLINT(google-runtime-int)
+  return static_cast<short>((events.IsSet(IoEvent::READ) ? POLLIN : 0) |  // NOLINT
+                            (events.IsSet(IoEvent::WRITE) ? POLLOUT : 0));
+}
+
+BitMask<IoEvent> FromNative(short events) {  // NOLINT(google-runtime-int)
+  BitMask<IoEvent> result;
+  if ((events & POLLIN) != 0) {
+    result = result | IoEvent::READ;
+  }
+  if ((events & POLLOUT) != 0) {
+    result = result | IoEvent::WRITE;
+  }
+  if ((events & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+    result = result | IoEvent::ERROR;
+  }
+  return result;
+}
+
+#endif
+
+}  // namespace
+
+Reactor::Reactor() {
+  if (pipe(wakeup) == -1) {
+    throw ReactorException(GetErrorString("Failed to create a wakeup pipe"));
+  }
+  for (int handle : wakeup) {
+    fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+    fcntl(handle, F_SETFD, FD_CLOEXEC);
+  }
+#if defined(__linux__)
+  poller = epoll_create1(EPOLL_CLOEXEC);
+  if (poller == -1) {
+    std::string message = GetErrorString("Failed to create an epoll instance");
+    close(wakeup[0]);
+    close(wakeup[1]);
+    throw ReactorException(message);
+  }
+  // The wakeup pipe has generation 0, which sockets never get
+  epoll_event event = MakeEvent(IoEvent::READ, wakeup[0], 0);
+  epoll_ctl(poller, EPOLL_CTL_ADD, wakeup[0], &event);
+#endif
+}
+
+Reactor::~Reactor() {
+  if (poller != -1) {
+    close(poller);
+  }
+  close(wakeup[0]);
+  close(wakeup[1]);
+}
+
+void Reactor::Add(const Socket& socket, BitMask<IoEvent> events, Handler handler) {
+  int handle = socket.GetHandle();
+  if (handle < 0) {
+    throw ReactorException("Socket is closed");
+  }
+  if (Find(handle) != nullptr) {
+    throw ReactorException("Socket is already registered");
+  }
+  if (static_cast<std::size_t>(handle) >= registrations.size()) {
+    registrations.resize(static_cast<std::size_t>(handle) + 1);
+  }
+  // Generation 0 is reserved for the wakeup pipe
+  if (++next_generation == 0) {
+    ++next_generation;
+  }
+#if defined(__linux__)
+  epoll_event event = MakeEvent(events, handle, next_generation);
+  if (epoll_ctl(poller, EPOLL_CTL_ADD, handle, &event) == -1) {
+    throw ReactorException(GetErrorString("Failed to register a socket"));
+  }
+#endif
+  Registration& registration = registrations[handle];
+  registration.handler = std::make_shared<Handler>(std::move(handler));
+  registration.events = events;
+  registration.generation = next_generation;
+  ++socket_count;
+}
+
+void Reactor::Modify(const Socket& socket, BitMask<IoEvent> events) {
+  Registration* registration = Find(socket.GetHandle());
+  if (registration == nullptr) {
+    throw ReactorException("Socket is not registered");
+  }
+  if (registration->events.value == events.value) {
+    return;
+  }
+#if defined(__linux__)
+  epoll_event event = MakeEvent(events, socket.GetHandle(), registration->generation);
+  if (epoll_ctl(poller, EPOLL_CTL_MOD, socket.GetHandle(), &event) == -1) {
+    throw ReactorException(GetErrorString("Failed to modify a socket"));
+  }
+#endif
+  registration->events = events;
+}
+
+void Reactor::Remove(const Socket& socket) {
+  Registration* registration = Find(socket.GetHandle());
+  if (registration == nullptr) {
+    return;
+  }
+#if defined(__linux__)
+  // Fails harmlessly if the socket was already closed, which removes it from epoll
+  epoll_ctl(poller, EPOLL_CTL_DEL, socket.GetHandle(), nullptr);
+#endif
+  *registration = Registration();
+  --socket_count;
+}
+
+bool Reactor::Contains(const Socket& socket) const {
+  int handle = socket.GetHandle();
+  return handle >= 0 && static_cast<std::size_t>(handle) < registrations.size() &&
+         registrations[handle].handler != nullptr;
+}
+
+std::size_t Reactor::Poll(Time timeout) {
+  int64_t microseconds = timeout.AsMicroseconds();
+  int timeout_ms = microseconds < 0 ? -1 : static_cast<int>((microseconds + 999) / 1000);
+  Wait(timeout_ms);
+  std::size_t calls = 0;
+  for (const ReadySocket& socket : ready) {
+    Registration* registration = Find(socket.handle);
+    // Skip sockets that an earlier handler removed, even if the handle was reused since
+    if (registration == nullptr || registration->generation != socket.generation) {
+      continue;
+    }
+    BitMask<IoEvent> events{socket.events.value &
+                            (registration->events | IoEvent::ERROR).value};
+    if (events.value == 0) {
+      continue;
+    }
+    std::shared_ptr<Handler> handler = registration->handler;
+    (*handler)(events);
+    ++calls;
+  }
+  return calls + RunTasks();
+}
+
+void Reactor::Run() {
+  // Poll at least once, so that tasks posted before an early Stop() still run
+  do {
+    Poll();
+  } while (!stopping.exchange(false));
+}
+
+void Reactor::Stop() {
+  stopping = true;
+  Wake();
+}
+
+void Reactor::Post(Task task) {
+  {
+    std::lock_guard lock(tasks_mutex);
+    tasks.push_back(std::move(task));
+  }
+  Wake();
+}
+
+Reactor::Registration* Reactor::Find(int handle) {
+  if (handle < 0 || static_cast<std::size_t>(handle) >= registrations.size() ||
+      registrations[handle].handler == nullptr) {
+    return nullptr;
+  }
+  return &registrations[handle];
+}
+
+void Reactor::Wait(int timeout_ms) {
+  ready.clear();
+  bool woken = false;
+#if defined(__linux__)
+  epoll_event events[MAX_EVENTS];
+  int count = epoll_wait(poller, events, MAX_EVENTS, timeout_ms);
+  if (count == -1) {
+    if (errno == EINTR) {
+      return;
+    }
+    throw ReactorException(GetErrorString("Failed to wait for events"));
+  }
+  for (int i = 0; i < count; ++i) {
+    auto generation = static_cast<uint32_t>(events[i].data.u64 >> 32U);
+    auto handle = static_cast<int>(events[i].data.u64 & 0xFFFFFFFFU);
+    if (generation == 0) {
+      woken = true;
+    } else {
+      ready.push_back({handle, generation, FromNative(events[i].events)});
+    }
+  }
+#else
+  std::vector<pollfd> descriptors;
+  descriptors.reserve(socket_count + 1);
+  descriptors.push_back({wakeup[0], POLLIN, 0});
+  for (std::size_t handle = 0; handle < registrations.size(); ++handle) {
+    if (registrations[handle].handler != nullptr) {
+      descriptors.push_back(
+          {static_cast<int>(handle), ToNative(registrations[handle].events), 0});
+    }
+  }
+  int count = poll(descriptors.data(), descriptors.size(), timeout_ms);
+  if (count == -1) {
+    if (errno == EINTR) {
+      return;
+    }
+    throw ReactorException(GetErrorString("Failed to wait for events"));
+  }
+  woken = descriptors[0].revents != 0;
+  for (std::size_t i = 1; i < descriptors.size(); ++i) {
+    if (descriptors[i].revents != 0) {
+      int handle = descriptors[i].fd;
+      ready.push_back({handle, registrations[handle].generation,
+                       FromNative(descriptors[i].revents)});
+    }
+  }
+#endif
+  if (woken) {
+    char buffer[64];
+    while (read(wakeup[0], buffer, sizeof(buffer)) > 0) {
+    }
+  }
+}
+
+void Reactor::Wake() {
+  char byte = 0;
+  // A full pipe already wakes up the reactor
+  [[maybe_unused]] ssize_t written = write(wakeup[1], &byte, 1);
+}
+
+std::size_t Reactor::RunTasks() {
+  std::vector<Task> pending;
+  {
+    std::lock_guard lock(tasks_mutex);
+    pending.swap(tasks);
+  }
+  for (Task& task : pending) {
+    task();
+  }
+  return pending.size();
+}
@@ -0,0 +1,120 @@
+#include "sdlxx/net/ring_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+using namespace sdlxx;
+
+namespace {
+
+std::size_t RoundToPages(std::size_t size) {
+  long page = sysconf(_SC_PAGESIZE);  // NOLINT(google-runtime-int)
+  auto page_size = static_cast<std::size_t>(page > 0 ? page : 4096);
+  return (std::max<std::size_t>(size, 1) + page_size - 1) / page_size * page_size;
+}
+
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+
+/**
+ * Map a memory file twice into adjacent addresses.
+ *
+ * \return The start of the first mapping, or nullptr if the system does not support it.
+ */
+uint8_t* MapMirrored(std::size_t capacity) {
+  int file = memfd_create("sdlxx-ring-buffer", MFD_CLOEXEC);
+  if (file == -1) {
+    return nullptr;
+  }
+  void* address = MAP_FAILED;
+  if (ftruncate(file, static_cast<off_t>(capacity)) == 0) {
+    // Reserve the whole range first, so that no other mapping can take the second half
+    address = mmap(nullptr, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (address != MAP_FAILED) {
+    auto* base = static_cast<uint8_t*>(address);
+    if (mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file, 0) ==
+            MAP_FAILED ||
+        mmap(base + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file,
+             0) == MAP_FAILED) {
+      munmap(base, capacity * 2);
+      address = MAP_FAILED;
+    }
+  }
+  // The mappings keep the memory alive
+  close(file);
+  return address != MAP_FAILED ? static_cast<uint8_t*>(address) : nullptr;
+}
+
+#else
+
+uint8_t* MapMirrored(std::size_t /* capacity */) { return nullptr; }
+
+#endif
+
+}  // namespace
+
+RingBuffer::RingBuffer(std::size_t capacity) : capacity(RoundToPages(capacity)) {
+  memory = MapMirrored(this->capacity);
+  mirrored = memory != nullptr;
+  if (!mirrored) {
+    memory = new (std::nothrow) uint8_t[this->capacity];
+    if (memory == nullptr) {
+      throw RingBufferException("Failed to allocate a ring buffer");
+    }
+  }
+}
+
+RingBuffer::~RingBuffer() {
+#if defined(__linux__)
+  if (mirrored) {
+    munmap(memory, capacity * 2);
+    return;
+  }
+#endif
+  delete[] memory;
+}
+
+uint8_t* RingBuffer::GetWriteSpace() {
+  if (mirrored) {
+    return memory + (read + size) % capacity;
+  }
+  if (read != 0) {
+    std::memmove(memory, memory + read, size);
+    read = 0;
+  }
+  return memory + size;
+}
+
+void RingBuffer::Commit(std::size_t count) { size += count; }
+
+void RingBuffer::Write(const void* data, std::size_t count) {
+  if (count > GetFreeSpace()) {
+    throw RingBufferException("Ring buffer is full");
+  }
+  std::memcpy(GetWriteSpace(), data, count);
+  Commit(count);
+}
+
+void RingBuffer::Consume(std::size_t count) {
+  size -= count;
+  if (size == 0) {
+    // An empty buffer starts over, which saves moving data in a linear buffer
+    read = 0;
+  } else if (mirrored) {
+    read = (read + count) % capacity;
+  } else {
+    read += count;
+  }
+}
+
+void RingBuffer::Clear() {
+  read = 0;
+  size = 0;
+}
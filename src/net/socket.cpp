@@ -0,0 +1,295 @@
+#include "sdlxx/net/socket.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace sdlxx;
+
+namespace {
+
+#if defined(MSG_NOSIGNAL)
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+std::string GetErrorString(const std::string& message, int error = errno) {
+  return message + ": " + std::strerror(error);
+}
+
+bool WouldBlock(int error) { return error == EAGAIN || error == EWOULDBLOCK; }
+
+sockaddr_in ToNative(const Address& address) {
+  sockaddr_in native{};
+  native.sin_family = AF_INET;
+  native.sin_addr.s_addr = htonl(address.host);
+  native.sin_port = htons(address.port);
+  return native;
+}
+
+Address FromNative(const sockaddr_in& native) {
+  return {ntohl(native.sin_addr.s_addr), ntohs(native.sin_port)};
+}
+
+void SetNonBlocking(int handle) {
+  int flags = fcntl(handle, F_GETFL, 0);
+  if (flags == -1 || fcntl(handle, F_SETFL, flags | O_NONBLOCK) == -1) {
+    throw SocketException(GetErrorString("Failed to make a socket non-blocking"));
+  }
+  fcntl(handle, F_SETFD, FD_CLOEXEC);
+#if defined(SO_NOSIGPIPE)
+  int enabled = 1;
+  setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+}
+
+Socket CreateSocket(int type) {
+#if defined(SOCK_CLOEXEC)
+  type |= SOCK_CLOEXEC;
+#endif
+  int handle = socket(AF_INET, type, 0);
+  if (handle == -1) {
+    throw SocketException(GetErrorString("Failed to create a socket"));
+  }
+  return Socket(handle);
+}
+
+void Bind(const Socket& socket, const Address& address) {
+  sockaddr_in native = ToNative(address);
+  if (bind(socket.GetHandle(), reinterpret_cast<sockaddr*>(&native), sizeof(native)) == -1) {
+    throw SocketException(GetErrorString("Failed to bind to " + address.ToString()));
+  }
+}
+
+}  // namespace
+
+Address Address::Resolve(const std::string& host, uint16_t port) {
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  addrinfo* result = nullptr;
+  int error = getaddrinfo(host.c_str(), nullptr, &hints, &result);
+  if (error != 0 || result == nullptr) {
+    throw SocketException("Failed to resolve " + host + ": " + gai_strerror(error));
+  }
+  Address address = FromNative(*reinterpret_cast<const sockaddr_in*>(result->ai_addr));
+  freeaddrinfo(result);
+  address.port = port;
+  return address;
+}
+
+std::string Address::ToString() const {
+  return std::to_string(host >> 24U) + "." + std::to_string((host >> 16U) & 0xFFU) + "." +
+         std::to_string((host >> 8U) & 0xFFU) + "." + std::to_string(host & 0xFFU) + ":" +
+         std::to_string(port);
+}
+
+Socket::Socket(Handle handle) : handle(handle) {
+  if (handle != INVALID_HANDLE) {
+    try {
+      SetNonBlocking(handle);
+    } catch (...) {
+      close(handle);
+      throw;
+    }
+  }
+}
+
+Socket::~Socket() { Close(); }
+
+Socket::Socket(Socket&& other) noexcept : handle(std::exchange(other.handle, INVALID_HANDLE)) {}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+  if (this != &other) {
+    Close();
+    handle = std::exchange(other.handle, INVALID_HANDLE);
+  }
+  return *this;
+}
+
+void Socket::Close() {
+  if (handle != INVALID_HANDLE) {
+    close(handle);
+    handle = INVALID_HANDLE;
+  }
+}
+
+Socket::Handle Socket::Release() { return std::exchange(handle, INVALID_HANDLE); }
+
+Address Socket::GetLocalAddress() const {
+  sockaddr_in native{};
+  socklen_t length = sizeof(native);
+  if (getsockname(handle, reinterpret_cast<sockaddr*>(&native), &length) == -1) {
+    throw SocketException(GetErrorString("Failed to get the local address"));
+  }
+  return FromNative(native);
+}
+
+TcpSocket TcpSocket::Connect(const Address& address) {
+  TcpSocket socket(CreateSocket(SOCK_STREAM).Release());
+  sockaddr_in native = ToNative(address);
+  if (connect(socket.handle, reinterpret_cast<sockaddr*>(&native), sizeof(native)) == -1 &&
+      errno != EINPROGRESS) {
+    throw SocketException(GetErrorString("Failed to connect to " + address.ToString()));
+  }
+  return socket;
+}
+
+std::optional<std::size_t> TcpSocket::Send(const void* data, std::size_t size) {
+  ssize_t sent = send(handle, data, size, SEND_FLAGS);
+  if (sent == -1) {
+    if (WouldBlock(errno)) {
+      return std::nullopt;
+    }
+    throw SocketException(GetErrorString("Failed to send data"));
+  }
+  return static_cast<std::size_t>(sent);
+}
+
+std::optional<std::size_t> TcpSocket::Send(const std::string_view* buffers, std::size_t count) {
+  constexpr std::size_t MAX_BUFFERS = 64;
+  iovec vectors[MAX_BUFFERS];
+  count = std::min(count, MAX_BUFFERS);
+  for (std::size_t i = 0; i < count; ++i) {
+    vectors[i].iov_base = const_cast<char*>(buffers[i].data());
+    vectors[i].iov_len = buffers[i].size();
+  }
+  // sendmsg() is used instead of writev(), which can not suppress SIGPIPE
+  msghdr message{};
+  message.msg_iov = vectors;
+  message.msg_iovlen = count;
+  ssize_t sent = sendmsg(handle, &message, SEND_FLAGS);
+  if (sent == -1) {
+    if (WouldBlock(errno)) {
+      return std::nullopt;
+    }
+    throw SocketException(GetErrorString("Failed to send data"));
+  }
+  return static_cast<std::size_t>(sent);
+}
+
+std::optional<std::size_t> TcpSocket::Receive(void* data, std::size_t size) {
+  ssize_t received = recv(handle, data, size, 0);
+  if (received == -1) {
+    if (WouldBlock(errno)) {
+      return std::nullopt;
+    }
+    if (errno == ECONNRESET) {
+      return 0;
+    }
+    throw SocketException(GetErrorString("Failed to receive data"));
+  }
+  return static_cast<std::size_t>(received);
+}
+
+void TcpSocket::ShutdownWrite() { shutdown(handle, SHUT_WR); }
+
+void TcpSocket::SetNoDelay(bool enabled) {
+  int value = enabled ? 1 : 0;
+  if (setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) == -1) {
+    throw SocketException(GetErrorString("Failed to set TCP_NODELAY"));
+  }
+}
+
+int TcpSocket::GetError() const {
+  int error = 0;
+  socklen_t length = sizeof(error);
+  if (getsockopt(handle, SOL_SOCKET, SO_ERROR, &error, &length) == -1) {
+    return errno;
+  }
+  return error;
+}
+
+Address TcpSocket::GetPeerAddress() const {
+  sockaddr_in native{};
+  socklen_t length = sizeof(native);
+  if (getpeername(handle, reinterpret_cast<sockaddr*>(&native), &length) == -1) {
+    throw SocketException(GetErrorString("Failed to get the peer address"));
+  }
+  return FromNative(native);
+}
+
+TcpListener::TcpListener(const Address& address, int backlog) {
+  handle = CreateSocket(SOCK_STREAM).Release();
+  int enabled = 1;
+  setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+  try {
+    Bind(*this, address);
+    if (listen(handle, backlog) == -1) {
+      throw SocketException(GetErrorString("Failed to listen on " + address.ToString()));
+    }
+  } catch (...) {
+    Close();
+    throw;
+  }
+}
+
+std::optional<TcpSocket> TcpListener::Accept(Address* peer) {
+  sockaddr_in native{};
+  socklen_t length = sizeof(native);
+  int accepted = accept(handle, reinterpret_cast<sockaddr*>(&native), &length);
+  if (accepted == -1) {
+    // A connection that was reset before it was accepted is not an error of the listener
+    if (WouldBlock(errno) || errno == ECONNABORTED || errno == EINTR) {
+      return std::nullopt;
+    }
+    throw SocketException(GetErrorString("Failed to accept a connection"));
+  }
+  if (peer != nullptr) {
+    *peer = FromNative(native);
+  }
+  TcpSocket socket(accepted);
+  socket.SetNoDelay(true);
+  return socket;
+}
+
+UdpSocket::UdpSocket(const Address& address) {
+  handle = CreateSocket(SOCK_DGRAM).Release();
+  try {
+    Bind(*this, address);
+  } catch (...) {
+    Close();
+    throw;
+  }
+}
+
+bool UdpSocket::SendTo(const void* data, std::size_t size, const Address& address) {
+  sockaddr_in native = ToNative(address);
+  ssize_t sent = sendto(handle, data, size, SEND_FLAGS, reinterpret_cast<sockaddr*>(&native),
+                        sizeof(native));
+  if (sent == -1) {
+    if (WouldBlock(errno)) {
+      return false;
+    }
+    throw SocketException(GetErrorString("Failed to send a datagram to " + address.ToString()));
+  }
+  return true;
+}
+
+std::optional<std::size_t> UdpSocket::ReceiveFrom(void* data, std::size_t size, Address* sender) {
+  sockaddr_in native{};
+  socklen_t length = sizeof(native);
+  ssize_t received =
+      recvfrom(handle, data, size, 0, reinterpret_cast<sockaddr*>(&native), &length);
+  if (received == -1) {
+    // ECONNREFUSED reports an ICMP error for an earlier datagram, which is not fatal for UDP
+    if (WouldBlock(errno) || errno == ECONNREFUSED) {
+      return std::nullopt;
+    }
+    throw SocketException(GetErrorString("Failed to receive a datagram"));
+  }
+  if (sender != nullptr) {
+    *sender = FromNative(native);
+  }
+  return static_cast<std::size_t>(received);
+}
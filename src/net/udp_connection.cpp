@@ -0,0 +1,432 @@
+#include "sdlxx/net/udp_connection.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+using namespace sdlxx;
+
+namespace {
+
+// Sequence, acknowledged sequence, acknowledgement bits and flags
+constexpr std::size_t PACKET_HEADER_SIZE = 9;
+
+// The acknowledgement fields are valid, which they are not until a packet was received
+constexpr uint8_t ACK_VALID_FLAG = 0x01;
+
+// Channel, sequence and size of a whole message
+constexpr std::size_t MESSAGE_HEADER_SIZE = 5;
+
+// The same, followed by the index and the count of a fragment
+constexpr std::size_t FRAGMENT_HEADER_SIZE = 7;
+
+// The size field of a fragment has the highest bit set
+constexpr uint16_t FRAGMENT_FLAG = 0x8000;
+
+// The largest message that fits in a packet must not reach the fragment flag
+static_assert(UdpConnection::MAX_MTU - PACKET_HEADER_SIZE - MESSAGE_HEADER_SIZE < FRAGMENT_FLAG);
+
+// Incomplete unreliable messages that are kept before the oldest is dropped
+constexpr std::size_t MAX_UNRELIABLE_ASSEMBLIES = 16;
+
+constexpr int64_t INITIAL_RTO = 200000;
+constexpr int64_t MIN_RTO = 20000;
+constexpr int64_t MAX_RTO = 1000000;
+
+// Compare sequence numbers that wrap around
+bool SequenceGreater(uint16_t a, uint16_t b) {
+  return a != b && static_cast<uint16_t>(a - b) < 0x8000;
+}
+
+// Get the full sequence number nearest to the reference from its lower 16 bits
+uint32_t Unwrap(uint16_t sequence, uint32_t reference) {
+  return reference + static_cast<int16_t>(sequence - static_cast<uint16_t>(reference));
+}
+
+uint64_t FragmentKey(uint32_t sequence, uint8_t index) {
+  return static_cast<uint64_t>(sequence) << 8U | index;
+}
+
+void Put16(std::vector<uint8_t>& buffer, uint16_t value) {
+  buffer.push_back(static_cast<uint8_t>(value >> 8U));
+  buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void Put16(uint8_t* data, uint16_t value) {
+  data[0] = static_cast<uint8_t>(value >> 8U);
+  data[1] = static_cast<uint8_t>(value);
+}
+
+uint16_t Get16(const uint8_t* data) { return static_cast<uint16_t>(data[0] << 8U | data[1]); }
+
+uint32_t Get32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) << 24U | static_cast<uint32_t>(data[1]) << 16U |
+         static_cast<uint32_t>(data[2]) << 8U | data[3];
+}
+
+std::string Join(const std::vector<std::string>& fragments) {
+  std::size_t size = 0;
+  for (const std::string& fragment : fragments) {
+    size += fragment.size();
+  }
+  std::string message;
+  message.reserve(size);
+  for (const std::string& fragment : fragments) {
+    message += fragment;
+  }
+  return message;
+}
+
+// A message entry of a received packet
+struct Entry {
+  uint8_t channel;
+  uint16_t sequence;
+  uint8_t index;
+  uint8_t count;
+  std::string_view data;
+};
+
+// Parse the next entry of a packet, or return false if the rest of the packet is malformed
+bool ParseEntry(const uint8_t*& data, const uint8_t* end, Entry& entry) {
+  if (end - data < static_cast<std::ptrdiff_t>(MESSAGE_HEADER_SIZE)) {
+    return false;
+  }
+  entry.channel = data[0];
+  entry.sequence = Get16(data + 1);
+  uint16_t size = Get16(data + 3);
+  data += MESSAGE_HEADER_SIZE;
+  entry.index = 0;
+  entry.count = 1;
+  if ((size & FRAGMENT_FLAG) != 0) {
+    size &= ~FRAGMENT_FLAG;
+    if (end - data < 2) {
+      return false;
+    }
+    entry.index = data[0];
+    entry.count = data[1];
+    data += 2;
+    if (entry.count == 0 || entry.index >= entry.count) {
+      return false;
+    }
+  }
+  if (end - data < size) {
+    return false;
+  }
+  entry.data = std::string_view(reinterpret_cast<const char*>(data), size);
+  data += size;
+  return true;
+}
+
+}  // namespace
+
+UdpConnection::UdpConnection(std::vector<Delivery> channels, PacketSender sender,
+                             std::size_t mtu)
+    : sender(std::move(sender)), mtu(mtu), sent_packets(SENT_PACKETS), rto(INITIAL_RTO) {
+  if (channels.empty() || channels.size() > 256) {
+    throw UdpConnectionException("Connection must have from 1 to 256 channels");
+  }
+  if (mtu < 64 || mtu > MAX_MTU) {
+    throw UdpConnectionException("MTU of " + std::to_string(mtu) + " bytes is not supported");
+  }
+  for (Delivery delivery : channels) {
+    this->channels.emplace_back().delivery = delivery;
+  }
+  packet.reserve(mtu);
+}
+
+void UdpConnection::Send(std::size_t channel, std::string_view message) {
+  if (channel >= channels.size()) {
+    throw UdpConnectionException("Channel " + std::to_string(channel) + " does not exist");
+  }
+  std::size_t count = 1;
+  std::size_t fragment_size = mtu - PACKET_HEADER_SIZE - FRAGMENT_HEADER_SIZE;
+  if (message.size() > mtu - PACKET_HEADER_SIZE - MESSAGE_HEADER_SIZE) {
+    count = (message.size() + fragment_size - 1) / fragment_size;
+    if (count > MAX_FRAGMENTS) {
+      throw UdpConnectionException("Message of " + std::to_string(message.size()) +
+                                   " bytes needs more than " + std::to_string(MAX_FRAGMENTS) +
+                                   " fragments");
+    }
+  }
+  Channel& target = channels[channel];
+  uint32_t sequence = target.next_sequence++;
+  for (std::size_t i = 0; i < count; ++i) {
+    Fragment fragment{sequence, static_cast<uint8_t>(i), static_cast<uint8_t>(count),
+                      std::string(count == 1 ? message : message.substr(i * fragment_size,
+                                                                        fragment_size))};
+    if (target.delivery == Delivery::RELIABLE_ORDERED) {
+      target.unacked.emplace(FragmentKey(sequence, fragment.index), std::move(fragment));
+    } else {
+      target.queued.push_back(std::move(fragment));
+    }
+  }
+}
+
+void UdpConnection::ReceivePacket(const void* data, std::size_t size, Time now) {
+  const auto* begin = static_cast<const uint8_t*>(data);
+  const uint8_t* end = begin + size;
+  if (size < PACKET_HEADER_SIZE) {
+    return;
+  }
+  // Check the whole packet first, so that a malformed one has no effect
+  Entry entry{};
+  for (const uint8_t* cursor = begin + PACKET_HEADER_SIZE; cursor != end;) {
+    if (!ParseEntry(cursor, end, entry) || entry.channel >= channels.size()) {
+      return;
+    }
+  }
+
+  uint16_t sequence = Get16(begin);
+  if (!received_any) {
+    received_any = true;
+    remote_sequence = sequence;
+    received_bits = 0;
+  } else if (SequenceGreater(sequence, remote_sequence)) {
+    uint16_t shift = sequence - remote_sequence;
+    // The previous newest packet becomes bit shift - 1
+    received_bits = shift > 32 ? 0 : static_cast<uint32_t>(
+        ((static_cast<uint64_t>(received_bits) << 1U) | 1U) << (shift - 1U));
+    remote_sequence = sequence;
+  } else {
+    uint16_t age = remote_sequence - sequence;
+    // Packets that are too old to be acknowledged are dropped, reliable messages in them are
+    // sent again anyway
+    if (age == 0 || age > 32 || (received_bits & (1U << (age - 1U))) != 0) {
+      return;
+    }
+    received_bits |= 1U << (age - 1U);
+  }
+  ack_pending = true;
+  ++statistics.packets_received;
+
+  if ((begin[8] & ACK_VALID_FLAG) != 0) {
+    ProcessAcks(Get16(begin + 2), Get32(begin + 4), now.AsMicroseconds());
+  }
+
+  for (const uint8_t* cursor = begin + PACKET_HEADER_SIZE; cursor != end;) {
+    ParseEntry(cursor, end, entry);
+    ReceiveFragment(channels[entry.channel], entry.channel, entry.sequence, entry.index,
+                    entry.count, entry.data);
+  }
+}
+
+std::optional<UdpConnection::Message> UdpConnection::Receive() {
+  if (received.empty()) {
+    return std::nullopt;
+  }
+  Message message = std::move(received.front());
+  received.pop_front();
+  return message;
+}
+
+void UdpConnection::Update(Time now) {
+  int64_t time = now.AsMicroseconds();
+  std::vector<std::pair<uint8_t, uint64_t>> fragments;
+  BeginPacket();
+  for (std::size_t index = 0; index < channels.size(); ++index) {
+    Channel& channel = channels[index];
+    if (channel.delivery == Delivery::RELIABLE_ORDERED) {
+      if (channel.unacked.empty()) {
+        continue;
+      }
+      // The receiver buffers at most a window of messages after the oldest unacknowledged one
+      uint32_t window_end = channel.unacked.begin()->second.sequence + RELIABLE_WINDOW;
+      for (auto& [key, fragment] : channel.unacked) {
+        if (fragment.sequence - window_end < 0x80000000U) {
+          break;
+        }
+        if (fragment.last_sent >= 0 && time - fragment.last_sent < rto) {
+          continue;
+        }
+        if (!Fits(fragment)) {
+          FinishPacket(time, std::move(fragments));
+          fragments.clear();
+          BeginPacket();
+        }
+        Append(index, fragment);
+        if (fragment.last_sent >= 0) {
+          ++statistics.resent_fragments;
+        }
+        fragment.last_sent = time;
+        fragments.emplace_back(static_cast<uint8_t>(index), key);
+      }
+    } else {
+      for (const Fragment& fragment : channel.queued) {
+        if (!Fits(fragment)) {
+          FinishPacket(time, std::move(fragments));
+          fragments.clear();
+          BeginPacket();
+        }
+        Append(index, fragment);
+      }
+      channel.queued.clear();
+    }
+  }
+  if (packet.size() > PACKET_HEADER_SIZE || ack_pending) {
+    FinishPacket(time, std::move(fragments));
+  }
+}
+
+bool UdpConnection::HasPendingReliable() const {
+  return std::any_of(channels.begin(), channels.end(),
+                     [](const Channel& channel) { return !channel.unacked.empty(); });
+}
+
+void UdpConnection::ProcessAcks(uint16_t ack, uint32_t ack_bits, int64_t now) {
+  // Ignore acknowledgements of packets that were not sent yet
+  if (!SequenceGreater(local_sequence, ack)) {
+    return;
+  }
+  for (int i = -1; i < 32; ++i) {
+    if (i >= 0 && (ack_bits & (1U << static_cast<unsigned>(i))) == 0) {
+      continue;
+    }
+    auto sequence = static_cast<uint16_t>(ack - 1 - i);
+    SentPacket& sent = sent_packets[sequence % SENT_PACKETS];
+    if (sent.valid && sent.sequence == sequence && !sent.acked) {
+      OnAcked(sent, now);
+    }
+  }
+  // Packets that fell out of the acknowledged range will never be acknowledged
+  auto oldest = static_cast<uint16_t>(ack - 32);
+  while (SequenceGreater(oldest, loss_sequence)) {
+    SentPacket& sent = sent_packets[loss_sequence % SENT_PACKETS];
+    if (sent.valid && sent.sequence == loss_sequence && !sent.acked) {
+      ++statistics.packets_lost;
+      sent.valid = false;
+    }
+    ++loss_sequence;
+  }
+}
+
+void UdpConnection::OnAcked(SentPacket& sent, int64_t now) {
+  sent.acked = true;
+  ++statistics.packets_acked;
+  // Every packet has its own sequence, so resends do not make samples ambiguous
+  int64_t sample = std::max<int64_t>(now - sent.time, 0);
+  if (!has_rtt_sample) {
+    has_rtt_sample = true;
+    smoothed_rtt = sample;
+    rtt_variance = sample / 2;
+  } else {
+    rtt_variance = (3 * rtt_variance + std::abs(smoothed_rtt - sample)) / 4;
+    smoothed_rtt = (7 * smoothed_rtt + sample) / 8;
+  }
+  rto = std::clamp(smoothed_rtt + 4 * rtt_variance, MIN_RTO, MAX_RTO);
+  for (const auto& [channel, key] : sent.fragments) {
+    channels[channel].unacked.erase(key);
+  }
+  sent.fragments.clear();
+}
+
+void UdpConnection::ReceiveFragment(Channel& channel, std::size_t index, uint16_t sequence,
+                                    uint8_t fragment_index, uint8_t fragment_count,
+                                    std::string_view data) {
+  uint32_t full_sequence = Unwrap(sequence, channel.receive_sequence);
+  auto offset = static_cast<int32_t>(full_sequence - channel.receive_sequence);
+  bool reliable = channel.delivery == Delivery::RELIABLE_ORDERED;
+  if (channel.delivery != Delivery::UNRELIABLE && offset < 0) {
+    // Already delivered, or older than a delivered message
+    return;
+  }
+  if (reliable && offset >= static_cast<int32_t>(RELIABLE_WINDOW)) {
+    return;
+  }
+
+  if (fragment_count == 1 && (!reliable || offset == 0)) {
+    Deliver(index, std::string(data));
+  } else {
+    Assembly& assembly = channel.assemblies[full_sequence];
+    if (assembly.fragments.empty()) {
+      assembly.fragments.resize(fragment_count);
+    }
+    if (assembly.fragments.size() != fragment_count || assembly.present[fragment_index]) {
+      return;
+    }
+    assembly.fragments[fragment_index] = data;
+    assembly.present[fragment_index] = true;
+    if (++assembly.received != fragment_count) {
+      if (!reliable && channel.assemblies.size() > MAX_UNRELIABLE_ASSEMBLIES) {
+        channel.assemblies.erase(channel.assemblies.begin());
+      }
+      return;
+    }
+    if (!reliable) {
+      Deliver(index, Join(assembly.fragments));
+    }
+  }
+
+  switch (channel.delivery) {
+    case Delivery::UNRELIABLE:
+      channel.assemblies.erase(full_sequence);
+      if (offset >= 0) {
+        channel.receive_sequence = full_sequence + 1;
+      }
+      break;
+    case Delivery::UNRELIABLE_SEQUENCED:
+      // Incomplete older messages can not be delivered anymore
+      channel.assemblies.erase(channel.assemblies.begin(),
+                               channel.assemblies.upper_bound(full_sequence));
+      channel.receive_sequence = full_sequence + 1;
+      break;
+    case Delivery::RELIABLE_ORDERED:
+      if (offset == 0 && fragment_count == 1) {
+        ++channel.receive_sequence;
+      }
+      // Deliver the buffered messages that are complete and next in order
+      for (auto it = channel.assemblies.begin();
+           it != channel.assemblies.end() && it->first == channel.receive_sequence &&
+           it->second.received == it->second.fragments.size();
+           it = channel.assemblies.erase(it)) {
+        Deliver(index, Join(it->second.fragments));
+        ++channel.receive_sequence;
+      }
+      break;
+  }
+}
+
+void UdpConnection::Deliver(std::size_t channel, std::string data) {
+  received.push_back(Message{channel, std::move(data)});
+}
+
+void UdpConnection::BeginPacket() { packet.assign(PACKET_HEADER_SIZE, 0); }
+
+bool UdpConnection::Fits(const Fragment& fragment) const {
+  std::size_t header = fragment.count == 1 ? MESSAGE_HEADER_SIZE : FRAGMENT_HEADER_SIZE;
+  return packet.size() + header + fragment.data.size() <= mtu;
+}
+
+void UdpConnection::Append(std::size_t channel, const Fragment& fragment) {
+  packet.push_back(static_cast<uint8_t>(channel));
+  Put16(packet, static_cast<uint16_t>(fragment.sequence));
+  if (fragment.count == 1) {
+    Put16(packet, static_cast<uint16_t>(fragment.data.size()));
+  } else {
+    Put16(packet, static_cast<uint16_t>(fragment.data.size() | FRAGMENT_FLAG));
+    packet.push_back(fragment.index);
+    packet.push_back(fragment.count);
+  }
+  packet.insert(packet.end(), fragment.data.begin(), fragment.data.end());
+}
+
+void UdpConnection::FinishPacket(int64_t now,
+                                 std::vector<std::pair<uint8_t, uint64_t>> fragments) {
+  Put16(packet.data(), local_sequence);
+  Put16(packet.data() + 2, remote_sequence);
+  Put16(packet.data() + 4, static_cast<uint16_t>(received_bits >> 16U));
+  Put16(packet.data() + 6, static_cast<uint16_t>(received_bits));
+  packet[8] = received_any ? ACK_VALID_FLAG : 0;
+
+  SentPacket& sent = sent_packets[local_sequence % SENT_PACKETS];
+  sent.sequence = local_sequence;
+  sent.valid = true;
+  sent.acked = false;
+  sent.time = now;
+  sent.fragments = std::move(fragments);
+
+  ++local_sequence;
+  ++statistics.packets_sent;
+  statistics.bytes_sent += packet.size();
+  ack_pending = false;
+  sender(packet.data(), packet.size());
+}
@@ -0,0 +1,59 @@
+#include "sdlxx/particles/curve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace sdlxx;
+
+namespace {
+
+// Sample piecewise linear keys sorted by age at the ages of the table
+template <typename T, typename Lerp>
+void Bake(std::vector<std::pair<float, T>> keys, std::array<T, CURVE_SAMPLES>& table, Lerp lerp) {
+  std::sort(keys.begin(), keys.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  std::size_t key = 0;
+  for (std::size_t i = 0; i < CURVE_SAMPLES; ++i) {
+    float age = static_cast<float>(i) / static_cast<float>(CURVE_SAMPLES - 1);
+    while (key + 1 < keys.size() && keys[key + 1].first <= age) {
+      ++key;
+    }
+    if (age <= keys[key].first || key + 1 == keys.size()) {
+      table[i] = keys[key].second;
+    } else {
+      const auto& [start_age, start] = keys[key];
+      const auto& [end_age, end] = keys[key + 1];
+      table[i] = lerp(start, end, (age - start_age) / (end_age - start_age));
+    }
+  }
+}
+
+uint8_t LerpChannel(uint8_t a, uint8_t b, float t) {
+  return static_cast<uint8_t>(std::lround(a + (b - a) * t));
+}
+
+}  // namespace
+
+Curve::Curve(float value) { table.fill(value); }
+
+Curve::Curve(std::initializer_list<std::pair<float, float>> keys) {
+  if (keys.size() == 0) {
+    table.fill(1.0F);
+    return;
+  }
+  Bake<float>(keys, table, [](float a, float b, float t) { return a + (b - a) * t; });
+}
+
+Gradient::Gradient(Color color) { table.fill(color); }
+
+Gradient::Gradient(std::initializer_list<std::pair<float, Color>> keys) {
+  if (keys.size() == 0) {
+    table.fill(Color::WHITE);
+    return;
+  }
+  Bake<Color>(keys, table, [](Color a, Color b, float t) {
+    return Color(LerpChannel(a.r, b.r, t), LerpChannel(a.g, b.g, t), LerpChannel(a.b, b.b, t),
+                 LerpChannel(a.a, b.a, t));
+  });
+}
@@ -0,0 +1,277 @@
+#include "sdlxx/particles/emitter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "sdlxx/core/gl_renderer.h"
+#include "sdlxx/core/texture.h"
+#include "sdlxx/core/thread_pool.h"
+#include "sdlxx/utils/angle.h"
+
+using namespace sdlxx;
+
+namespace {
+
+// Particles per task of a thread pool, large enough to hide the cost of scheduling
+constexpr std::size_t CHUNK_SIZE = 8192;
+
+template <typename Function>
+void ForEachChunk(ThreadPool* pool, std::size_t count, const Function& function) {
+  const std::size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  auto run = [&](std::size_t chunk) {
+    function(chunk * CHUNK_SIZE, std::min(count, (chunk + 1) * CHUNK_SIZE));
+  };
+  if (pool != nullptr && chunks > 1) {
+    pool->ParallelFor(chunks, run);
+  } else {
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+      run(chunk);
+    }
+  }
+}
+
+}  // namespace
+
+Emitter::Emitter(const EmitterSettings& settings, uint32_t seed)
+    : settings(settings), random_state(seed != 0 ? seed : 1) {
+  if (settings.capacity == 0) {
+    throw ParticleException("Emitter capacity must be positive");
+  }
+  if (!(settings.life_min > 0.0F) || settings.life_max < settings.life_min) {
+    throw ParticleException("Emitter lifetime range is invalid");
+  }
+  if (settings.rate < 0.0F) {
+    throw ParticleException("Emitter rate must not be negative");
+  }
+  for (auto* array : {&x, &y, &velocity_x, &velocity_y, &age, &inverse_life, &size}) {
+    array->resize(settings.capacity);
+  }
+  color.resize(settings.capacity);
+}
+
+void Emitter::SetPosition(float x, float y) {
+  position_x = x;
+  position_y = y;
+}
+
+void Emitter::SetEmitting(bool emitting) {
+  this->emitting = emitting;
+  spawn_accumulator = 0.0F;
+}
+
+void Emitter::Burst(std::size_t count) { Spawn(count); }
+
+void Emitter::Update(float delta, ThreadPool* pool) {
+  ForEachChunk(pool, count,
+               [this, delta](std::size_t begin, std::size_t end) { Simulate(begin, end, delta); });
+
+  // Swap dead particles with the last live one, the order of particles does not matter
+  std::size_t index = 0;
+  while (index < count) {
+    if (age[index] * inverse_life[index] < 1.0F) {
+      ++index;
+      continue;
+    }
+    const std::size_t last = --count;
+    x[index] = x[last];
+    y[index] = y[last];
+    velocity_x[index] = velocity_x[last];
+    velocity_y[index] = velocity_y[last];
+    age[index] = age[last];
+    inverse_life[index] = inverse_life[last];
+    size[index] = size[last];
+    color[index] = color[last];
+  }
+
+  if (emitting) {
+    spawn_accumulator += settings.rate * delta;
+    const float spawn_count = std::floor(spawn_accumulator);
+    spawn_accumulator -= spawn_count;
+    Spawn(static_cast<std::size_t>(spawn_count));
+  }
+}
+
+void Emitter::Render(Renderer& renderer, Texture* texture, ThreadPool* pool) {
+  if (count == 0) {
+    return;
+  }
+
+  if (!Renderer::IsGeometrySupported()) {
+    const bool whole_texture = settings.source.width == 0 || settings.source.height == 0;
+    Color modulation;
+    if (texture != nullptr) {
+      modulation = texture->GetColorModulation();
+      modulation.a = texture->GetAlphaModulation();
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      const int extent = static_cast<int>(std::lround(size[i]));
+      const Rectangle dest{static_cast<int>(std::lround(x[i] - size[i] * 0.5F)),
+                           static_cast<int>(std::lround(y[i] - size[i] * 0.5F)), extent, extent};
+      if (texture != nullptr) {
+        // The color of a particle modulates the texture, like the vertex color of a quad
+        texture->SetColorModulation(color[i]);
+        texture->SetAlphaModulation(color[i].a);
+        if (whole_texture) {
+          renderer.Copy(*texture, dest);
+        } else {
+          renderer.Copy(*texture, settings.source, dest);
+        }
+      } else {
+        renderer.SetDrawColor(color[i]);
+        renderer.FillRectangle(dest);
+      }
+    }
+    if (texture != nullptr) {
+      texture->SetColorModulation(modulation);
+      texture->SetAlphaModulation(modulation.a);
+    }
+    return;
+  }
+
+  float inverse_width = 0.0F;
+  float inverse_height = 0.0F;
+  if (texture != nullptr) {
+    Dimensions dimensions = texture->Query().dimensions;
+    inverse_width = dimensions.width > 0 ? 1.0F / static_cast<float>(dimensions.width) : 0.0F;
+    inverse_height = dimensions.height > 0 ? 1.0F / static_cast<float>(dimensions.height) : 0.0F;
+  }
+
+  if (vertices.size() < count * 4) {
+    vertices.resize(count * 4);
+  }
+  // Index pattern is the same for every frame, so it is only extended when needed
+  for (auto quad = static_cast<int>(indices.size() / 6); quad < static_cast<int>(count); ++quad) {
+    int first = quad * 4;
+    indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+  }
+  ForEachChunk(pool, count,
+               [this, inverse_width, inverse_height](std::size_t begin, std::size_t end) {
+                 BuildVertices(begin, end, inverse_width, inverse_height);
+               });
+  renderer.RenderGeometry(texture, vertices.data(), static_cast<int>(count * 4), indices.data(),
+                          static_cast<int>(count * 6));
+}
+
+void Emitter::Render(GL::Renderer& renderer, const GL::Texture& texture, int layer) {
+  Rectangle source = settings.source;
+  if (source.width == 0 || source.height == 0) {
+    source = Rectangle{{0, 0}, texture.GetSize()};
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    const float extent = size[i];
+    renderer.Draw(texture, layer, source, x[i] - extent * 0.5F, y[i] - extent * 0.5F, extent,
+                  extent, 0.0F, color[i]);
+  }
+}
+
+void Emitter::Clear() {
+  count = 0;
+  spawn_accumulator = 0.0F;
+}
+
+void Emitter::Spawn(std::size_t spawn_count) {
+  const std::size_t available = settings.capacity - count;
+  if (spawn_count > available) {
+    dropped += spawn_count - available;
+    spawn_count = available;
+  }
+  const float start_size = settings.size.GetTable().front();
+  const Color start_color = settings.color.GetTable().front();
+  for (std::size_t i = count; i < count + spawn_count; ++i) {
+    const float angle = (settings.direction + (Random() - 0.5F) * settings.spread) *
+                        DEGREES_TO_RADIANS;
+    const float speed = settings.speed_min + (settings.speed_max - settings.speed_min) * Random();
+    const float life = settings.life_min + (settings.life_max - settings.life_min) * Random();
+    x[i] = position_x + (Random() - 0.5F) * settings.spawn_width;
+    y[i] = position_y + (Random() - 0.5F) * settings.spawn_height;
+    velocity_x[i] = std::cos(angle) * speed;
+    velocity_y[i] = std::sin(angle) * speed;
+    age[i] = 0.0F;
+    inverse_life[i] = 1.0F / life;
+    size[i] = start_size;
+    color[i] = start_color;
+  }
+  count += spawn_count;
+}
+
+void Emitter::Simulate(std::size_t begin, std::size_t end, float delta) {
+  const float damping = std::max(0.0F, 1.0F - settings.drag * delta);
+  const float impulse_x = settings.gravity_x * delta;
+  const float impulse_y = settings.gravity_y * delta;
+  float* px = x.data();
+  float* py = y.data();
+  float* pvx = velocity_x.data();
+  float* pvy = velocity_y.data();
+  float* page = age.data();
+
+  std::size_t i = begin;
+#ifdef __SSE2__
+  const __m128 damping4 = _mm_set1_ps(damping);
+  const __m128 impulse_x4 = _mm_set1_ps(impulse_x);
+  const __m128 impulse_y4 = _mm_set1_ps(impulse_y);
+  const __m128 delta4 = _mm_set1_ps(delta);
+  for (; i + 4 <= end; i += 4) {
+    __m128 vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pvx + i), damping4), impulse_x4);
+    __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pvy + i), damping4), impulse_y4);
+    _mm_storeu_ps(pvx + i, vx);
+    _mm_storeu_ps(pvy + i, vy);
+    _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(vx, delta4)));
+    _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(vy, delta4)));
+    _mm_storeu_ps(page + i, _mm_add_ps(_mm_loadu_ps(page + i), delta4));
+  }
+#endif
+  for (; i < end; ++i) {
+    pvx[i] = pvx[i] * damping + impulse_x;
+    pvy[i] = pvy[i] * damping + impulse_y;
+    px[i] += pvx[i] * delta;
+    py[i] += pvy[i] * delta;
+    page[i] += delta;
+  }
+
+  const auto& size_table = settings.size.GetTable();
+  const auto& color_table = settings.color.GetTable();
+  for (i = begin; i < end; ++i) {
+    const std::size_t sample = Curve::GetIndex(page[i] * inverse_life[i]);
+    size[i] = size_table[sample];
+    color[i] = color_table[sample];
+  }
+}
+
+void Emitter::BuildVertices(std::size_t begin, std::size_t end, float inverse_width,
+                            float inverse_height) {
+  const Rectangle& source = settings.source;
+  float u0 = 0.0F;
+  float v0 = 0.0F;
+  float u1 = 1.0F;
+  float v1 = 1.0F;
+  if (source.width != 0 && source.height != 0) {
+    u0 = static_cast<float>(source.x) * inverse_width;
+    v0 = static_cast<float>(source.y) * inverse_height;
+    u1 = static_cast<float>(source.x + source.width) * inverse_width;
+    v1 = static_cast<float>(source.y + source.height) * inverse_height;
+  }
+  Renderer::Vertex* vertex = vertices.data() + begin * 4;
+  for (std::size_t i = begin; i < end; ++i, vertex += 4) {
+    const float half = size[i] * 0.5F;
+    const float left = x[i] - half;
+    const float top = y[i] - half;
+    const float right = x[i] + half;
+    const float bottom = y[i] + half;
+    vertex[0] = {left, top, color[i], u0, v0};
+    vertex[1] = {right, top, color[i], u1, v0};
+    vertex[2] = {right, bottom, color[i], u1, v1};
+    vertex[3] = {left, bottom, color[i], u0, v1};
+  }
+}
+
+float Emitter::Random() {
+  // Xorshift32, the top 24 bits give a uniform float in range [0, 1)
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+  return static_cast<float>(random_state >> 8) * (1.0F / 16777216.0F);
+}
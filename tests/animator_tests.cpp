@@ -0,0 +1,85 @@
+// Check the Animator with fixed time steps, including animations of nodes that are destroyed
+// while they run.
+
+#include <memory>
+
+#include <sdlxx/gui/animator.h>
+#include <sdlxx/gui/node.h>
+
+#include "harness.h"
+
+using namespace sdlxx;
+
+namespace {
+
+class Dot : public Node {
+public:
+  Dot() : Node("dot") {}
+};
+
+/// A property reaches its final value exactly, and then the callback is called once
+bool TestCompletion() {
+  Animator animator;
+  float value = 0.0F;
+  int calls = 0;
+  Animator::Handle handle =
+      animator.Animate(value, 10.0F, Time::Milliseconds(100), Easing::QUAD_IN_OUT,
+                       [&calls]() { ++calls; });
+  animator.Update(Time::Milliseconds(50));
+  bool halfway = value == 5.0F && calls == 0 && animator.IsAnimating(handle);
+  animator.Update(Time::Milliseconds(60));
+  animator.Update(Time::Milliseconds(60));
+  return halfway && value == 10.0F && calls == 1 && !animator.IsAnimating(handle) &&
+         animator.GetSize() == 0;
+}
+
+/// A cancelled animation keeps the current value and does not call its callback, and its slot
+/// is reused without affecting the old handle
+bool TestCancel() {
+  Animator animator;
+  float value = 0.0F;
+  bool called = false;
+  Animator::Handle handle = animator.Animate(value, 10.0F, Time::Milliseconds(100),
+                                             Easing::LINEAR, [&called]() { called = true; });
+  animator.Update(Time::Milliseconds(50));
+  if (!animator.Cancel(handle) || animator.Cancel(handle)) {
+    return false;
+  }
+  animator.Update(Time::Milliseconds(100));
+  float other = 0.0F;
+  Animator::Handle reused = animator.Animate(other, 1.0F, Time::Milliseconds(100));
+  return value == 5.0F && !called && !animator.IsAnimating(handle) &&
+         animator.IsAnimating(reused) && handle.index == reused.index;
+}
+
+/// An animation of a destroyed node is cancelled, and does not write into a new node that takes
+/// its memory
+bool TestDestroyedNode() {
+  Animator animator;
+  auto node = std::make_unique<Dot>();
+  const Node* address = node.get();
+  bool called = false;
+  Animator::Handle handle = animator.MoveTo(*node, 100.0F, 100.0F, Time::Milliseconds(100),
+                                            Easing::LINEAR, [&called]() { called = true; });
+  Animator::Handle other = animator.RotateTo(*node, 90.0F, Time::Milliseconds(100));
+  animator.Update(Time::Milliseconds(50));
+  if (node->GetTransform().x != 50.0F || node->GetTransform().angle != 45.0F) {
+    return false;
+  }
+  node.reset();
+  auto next = std::make_unique<Dot>();
+  animator.Update(Time::Milliseconds(100));
+  return next.get() == address && next->GetTransform().x == 0.0F &&
+         next->GetTransform().angle == 0.0F && !called && !animator.IsAnimating(handle) &&
+         !animator.IsAnimating(other) && animator.GetSize() == 0;
+}
+
+}  // namespace
+
+int main() {
+  return test::RunTests({
+      {"animator_completion", TestCompletion},
+      {"animator_cancel", TestCancel},
+      {"animator_destroyed_node", TestDestroyedNode},
+  });
+}
@@ -0,0 +1,264 @@
+// Compare the OpenGL backend with the software renderer. Every case is a generic function that
+// draws through the shared primitive and sprite API, so it is drawn once with GL::Renderer and
+// once with Renderer and SpriteBatch on a surface, and the frames are compared pixel by pixel.
+// The post-processing chain is checked for properties that do not depend on the driver.
+// Run with SDL_VIDEODRIVER=offscreen and LIBGL_ALWAYS_SOFTWARE=1 to test headlessly on llvmpipe.
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SDL_pixels.h>
+#include <sdlxx/core.h>
+#include <sdlxx/core/gl_effects.h>
+#include <sdlxx/core/gl_renderer.h>
+
+using namespace sdlxx;
+
+namespace {
+
+// Exit code that makes CTest report a test as skipped
+constexpr int SKIP_RETURN_CODE = 77;
+
+// Size of the frames of all cases
+constexpr Dimensions FRAME_SIZE{128, 128};
+
+// Maximum difference of a channel of a matching pixel
+constexpr int TOLERANCE = 2;
+
+struct Case {
+  std::string name;
+  double max_differing;  // Fraction of pixels that may differ, for rasterization differences
+  std::function<void(Renderer&, SpriteBatch&, Texture&)> draw_reference;
+  std::function<void(GL::Renderer&, GL::Renderer&, GL::Texture&)> draw;
+};
+
+template <typename Draw>
+Case MakeCase(std::string name, double max_differing, Draw draw) {
+  return {std::move(name), max_differing, draw, draw};
+}
+
+/// A 64x64 RGBA32 image with opaque quadrants, a translucent center and a transparent corner
+Surface CreatePattern() {
+  Surface surface(64, 64, 32, SDL_PIXELFORMAT_RGBA32);
+  surface.FillRectangle({0, 0, 32, 32}, Color::RED);
+  surface.FillRectangle({32, 0, 32, 32}, Color::GREEN);
+  surface.FillRectangle({0, 32, 32, 32}, Color::BLUE);
+  surface.FillRectangle({32, 32, 32, 32}, Color::YELLOW);
+  surface.FillRectangle({16, 16, 32, 32}, Color(255, 255, 255, 128));
+  surface.FillRectangle({56, 56, 8, 8}, Color::TRANSPARENT);
+  return surface;
+}
+
+std::vector<Case> GetCases() {
+  std::vector<Case> cases;
+  cases.push_back(MakeCase("primitives", 0.0, [](auto& renderer, auto&, auto&) {
+    renderer.SetDrawColor(Color(0x203040));
+    renderer.Clear();
+    renderer.SetDrawColor(Color::RED);
+    renderer.FillRectangles({{4, 4, 40, 20}, {100, 90, 28, 38}});
+    renderer.SetDrawColor(Color::WHITE);
+    renderer.DrawRectangles({{50, 4, 30, 30}, {60, 14, 2, 2}});
+    renderer.DrawLines({{4, 40}, {120, 40}, {120, 80}, {4, 80}});
+    renderer.DrawPoints({{10, 100}, {12, 100}, {14, 102}});
+    renderer.SetClipRectangle({20, 50, 40, 20});
+    renderer.SetDrawColor(Color::GREEN);
+    renderer.FillRectangle({0, 0, 128, 128});
+    renderer.ResetClipRectangle();
+  }));
+  cases.push_back(MakeCase("diagonal_lines", 0.01, [](auto& renderer, auto&, auto&) {
+    renderer.SetDrawColor(Color::BLACK);
+    renderer.Clear();
+    renderer.SetDrawColor(Color::YELLOW);
+    for (int i = 0; i < 128; i += 16) {
+      renderer.DrawLine({0, i}, {127, 127 - i});
+    }
+  }));
+  cases.push_back(MakeCase("sprites", 0.01, [](auto& renderer, auto& sprites, auto& texture) {
+    renderer.SetDrawColor(Color(0x404040));
+    renderer.Clear();
+    sprites.Draw(texture, {0, 0, 64, 64}, 0.0F, 0.0F, 64.0F, 64.0F);
+    sprites.Draw(texture, {16, 16, 32, 32}, 64.0F, 0.0F, 64.0F, 64.0F);
+    sprites.Draw(texture, {0, 0, 64, 64}, 0.0F, 64.0F, 32.0F, 32.0F, 0.0F, Color(255, 128, 0));
+    sprites.Draw(texture, {8, 8, 48, 48}, 64.0F, 64.0F, 64.0F, 64.0F);
+    sprites.Flush();
+  }));
+  cases.push_back(MakeCase("rotated_sprites", 0.02, [](auto& renderer, auto& sprites,
+                                                       auto& texture) {
+    renderer.SetDrawColor(Color::BLACK);
+    renderer.Clear();
+    for (int i = 0; i < 16; ++i) {
+      auto position = static_cast<float>(i * 7);
+      sprites.Draw(texture, {0, 0, 64, 64}, position, position, 24.0F, 24.0F, i * 22.5F,
+                   Color(255, 255, static_cast<uint8_t>(i * 16)));
+    }
+    sprites.Flush();
+  }));
+  cases.push_back(MakeCase("blend_modes", 0.0, [](auto& renderer, auto& sprites, auto& texture) {
+    renderer.SetDrawColor(Color(0x808080));
+    renderer.Clear();
+    const BlendMode modes[] = {BlendMode::NONE, BlendMode::BLEND, BlendMode::ADD, BlendMode::MOD};
+    for (int i = 0; i < 4; ++i) {
+      texture.SetBlendMode(modes[i]);
+      auto offset = static_cast<float>(i * 32);
+      sprites.Draw(texture, {0, 0, 64, 64}, offset, offset, 32.0F, 32.0F);
+      sprites.Flush();
+    }
+    texture.SetBlendMode(BlendMode::BLEND);
+  }));
+  return cases;
+}
+
+int CountDifferences(const uint8_t* expected, int expected_pitch, const uint8_t* actual,
+                     int actual_pitch) {
+  int differing = 0;
+  for (int y = 0; y < FRAME_SIZE.height; ++y) {
+    for (int x = 0; x < FRAME_SIZE.width; ++x) {
+      for (int c = 0; c < 4; ++c) {
+        int delta = expected[y * expected_pitch + x * 4 + c] - actual[y * actual_pitch + x * 4 + c];
+        if (std::abs(delta) > TOLERANCE) {
+          ++differing;
+          break;
+        }
+      }
+    }
+  }
+  return differing;
+}
+
+std::vector<uint8_t> ReadFrame(GL::Renderer& renderer) {
+  std::vector<uint8_t> pixels(static_cast<std::size_t>(FRAME_SIZE.width) * FRAME_SIZE.height * 4);
+  renderer.ReadPixels({0, 0, FRAME_SIZE.width, FRAME_SIZE.height}, pixels.data(),
+                      FRAME_SIZE.width * 4);
+  return pixels;
+}
+
+void DrawScene(GL::Renderer& renderer) {
+  renderer.SetDrawColor(Color(0x285078));
+  renderer.Clear();
+  renderer.SetDrawColor(Color::WHITE);
+  renderer.FillRectangle({16, 16, 24, 24});
+  renderer.SetDrawColor(Color(200, 0, 0));
+  renderer.FillRectangle({64, 72, 40, 16});
+}
+
+/// Check the post-processing chain against properties that hold for any driver
+int TestPostProcessing(GL::Renderer& renderer) {
+  GL::PostProcessor post(renderer);
+  auto run = [&]() {
+    post.Begin();
+    DrawScene(renderer);
+    post.End();
+    return ReadFrame(renderer);
+  };
+  std::vector<std::pair<std::string, bool>> results;
+
+  std::vector<uint8_t> plain = run();
+  GL::ColorGrading first(post);
+  std::size_t programs = post.GetShaderCache().GetProgramCount();
+  GL::ColorGrading second(post);
+  results.emplace_back("post_shader_cache", post.GetShaderCache().GetProgramCount() == programs);
+
+  post.Add(first);
+  post.Add(second);
+  std::vector<uint8_t> identity = run();
+  results.emplace_back("post_identity_chain", CountDifferences(plain.data(), FRAME_SIZE.width * 4,
+                                                               identity.data(),
+                                                               FRAME_SIZE.width * 4) == 0);
+
+  GL::ColorGradingSettings grayscale;
+  grayscale.saturation = 0.0F;
+  second.SetSettings(grayscale);
+  std::vector<uint8_t> gray = run();
+  bool is_gray = true;
+  for (std::size_t i = 0; i < gray.size(); i += 4) {
+    is_gray = is_gray && std::abs(gray[i] - gray[i + 1]) <= 1 &&
+              std::abs(gray[i] - gray[i + 2]) <= 1;
+  }
+  results.emplace_back("post_grayscale", is_gray);
+
+  GL::Bloom bloom(post);
+  GL::CrtEffect crt(post);
+  post.ClearEffects();
+  post.Add(bloom);
+  std::vector<uint8_t> glow = run();
+  // The pixel right of the white square is only lit by the glow
+  std::size_t beside = (24 * FRAME_SIZE.width + 43) * 4;
+  results.emplace_back("post_bloom", glow[beside] > plain[beside] + 4);
+
+  post.Add(first);
+  post.Add(crt);
+  run();
+  std::size_t pool_size = post.GetPoolSize();
+  for (int frame = 0; frame < 3; ++frame) {
+    run();
+  }
+  results.emplace_back("post_pool_reuse", post.GetPoolSize() == pool_size);
+
+  int failed = 0;
+  for (const auto& [name, passed] : results) {
+    failed += passed ? 0 : 1;
+    std::cout << (passed ? "PASSED " : "FAILED ") << name << std::endl;
+  }
+  return failed;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const bool es = argc > 1 && std::string(argv[1]) == "--es";
+  try {
+    CoreApi core(CoreApi::Flag::VIDEO);
+    std::optional<Window> window;
+    std::optional<GL::Context> context;
+    try {
+      GL::Context::SetAttribute(GL::Attribute::CONTEXT_PROFILE_MASK,
+                                static_cast<int>(es ? GL::Profile::ES : GL::Profile::CORE));
+      GL::Context::SetAttribute(GL::Attribute::CONTEXT_MAJOR_VERSION, 3);
+      GL::Context::SetAttribute(GL::Attribute::CONTEXT_MINOR_VERSION, es ? 0 : 3);
+      window.emplace("gl_tests", FRAME_SIZE, Window::Flag::OPENGL | Window::Flag::HIDDEN);
+      context.emplace(*window);
+      context->MakeCurrent(*window);
+    } catch (const Exception& e) {
+      std::cout << "SKIPPED: no OpenGL context: " << e.what() << std::endl;
+      return SKIP_RETURN_CODE;
+    }
+    GL::Renderer gl_renderer(*context, GL::Context::GetDrawableSize(*window));
+    GL::Texture gl_texture(gl_renderer, CreatePattern());
+    std::cout << "OpenGL " << (es ? "ES " : "") << gl_renderer.GetFunctions().major_version << "."
+              << gl_renderer.GetFunctions().minor_version << ", persistent mapping "
+              << (gl_renderer.IsPersistentlyMapped() ? "on" : "off") << std::endl;
+
+    int failed = 0;
+    for (const Case& test : GetCases()) {
+      Surface surface(FRAME_SIZE.width, FRAME_SIZE.height, 32, SDL_PIXELFORMAT_RGBA32);
+      Renderer renderer(surface);
+      SpriteBatch batch(renderer);
+      Texture texture(renderer, CreatePattern());
+      texture.SetBlendMode(BlendMode::BLEND);
+      test.draw_reference(renderer, batch, texture);
+      renderer.Flush();
+
+      test.draw(gl_renderer, gl_renderer, gl_texture);
+      std::vector<uint8_t> pixels = ReadFrame(gl_renderer);
+
+      int differing = CountDifferences(static_cast<const uint8_t*>(surface.GetPixels()),
+                                       surface.GetPitch(), pixels.data(), FRAME_SIZE.width * 4);
+      int allowed = static_cast<int>(test.max_differing * FRAME_SIZE.width * FRAME_SIZE.height);
+      bool passed = differing <= allowed;
+      failed += passed ? 0 : 1;
+      std::cout << (passed ? "PASSED " : "FAILED ") << test.name << " (" << differing
+                << " pixels differ, " << allowed << " allowed)" << std::endl;
+    }
+    failed += TestPostProcessing(gl_renderer);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
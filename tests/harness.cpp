@@ -0,0 +1,332 @@
+#include "harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+using namespace sdlxx;
+using namespace sdlxx::test;
+
+namespace {
+
+// Frame size of the benchmarks
+constexpr Dimensions BENCHMARK_SIZE{1280, 720};
+
+struct Options {
+  std::string golden_dir = "golden";
+  std::string output_dir = ".";
+  std::string filter;
+  bool update = false;
+  int tolerance = 2;               // Maximum difference of a channel of a matching pixel
+  double max_differing = 0.001;    // Maximum fraction of pixels that do not match
+  bool benchmarks = false;
+  double min_time = 0.25;          // Minimum duration of a benchmark in seconds
+  std::string results = "render_results.json";
+  std::string baseline;
+  double threshold = 0.2;          // Maximum relative drop of throughput
+};
+
+struct Image {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> pixels;
+};
+
+std::optional<std::vector<uint8_t>> ReadFile(const std::string& path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    return std::nullopt;
+  }
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), {});
+}
+
+void WriteFile(const std::string& path, const std::vector<uint8_t>& data) {
+  std::ofstream stream(path, std::ios::binary);
+  stream.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+  if (!stream) {
+    throw std::runtime_error("Failed to write " + path);
+  }
+}
+
+uint32_t ReadBigEndian(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) << 24U | static_cast<uint32_t>(data[1]) << 16U |
+         static_cast<uint32_t>(data[2]) << 8U | data[3];
+}
+
+std::optional<Image> DecodeQoi(const std::vector<uint8_t>& data) {
+  if (data.size() < 22 || std::string(data.begin(), data.begin() + 4) != "qoif") {
+    return std::nullopt;
+  }
+  Image image;
+  image.width = static_cast<int>(ReadBigEndian(data.data() + 4));
+  image.height = static_cast<int>(ReadBigEndian(data.data() + 8));
+  std::size_t count = static_cast<std::size_t>(image.width) * image.height;
+  image.pixels.reserve(count * 4);
+
+  uint8_t seen[64][4] = {};
+  uint8_t pixel[4] = {0, 0, 0, 255};
+  std::size_t p = 14;
+  while (image.pixels.size() < count * 4 && p < data.size()) {
+    uint8_t op = data[p++];
+    int run = 1;
+    if (op == 0xFE && p + 3 <= data.size()) {
+      std::copy(&data[p], &data[p] + 3, pixel);
+      p += 3;
+    } else if (op == 0xFF && p + 4 <= data.size()) {
+      std::copy(&data[p], &data[p] + 4, pixel);
+      p += 4;
+    } else if (op >> 6U == 0) {
+      std::copy(seen[op], seen[op] + 4, pixel);
+    } else if (op >> 6U == 1) {
+      pixel[0] += ((op >> 4U) & 3U) - 2;
+      pixel[1] += ((op >> 2U) & 3U) - 2;
+      pixel[2] += (op & 3U) - 2;
+    } else if (op >> 6U == 2 && p < data.size()) {
+      int dg = (op & 0x3F) - 32;
+      uint8_t next = data[p++];
+      pixel[0] += dg - 8 + (next >> 4U);
+      pixel[1] += dg;
+      pixel[2] += dg - 8 + (next & 0x0FU);
+    } else {
+      run = (op & 0x3F) + 1;
+    }
+    int hash = (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+    std::copy(pixel, pixel + 4, seen[hash]);
+    for (int i = 0; i < run; ++i) {
+      image.pixels.insert(image.pixels.end(), pixel, pixel + 4);
+    }
+  }
+  if (image.pixels.size() < count * 4) {
+    return std::nullopt;
+  }
+  image.pixels.resize(count * 4);
+  return image;
+}
+
+/// Compare a frame with a golden image and write a difference mask if they do not match
+bool Compare(const OffscreenContext::Frame& frame, const Image& golden, const Options& options,
+             const std::string& diff_path, std::string& message) {
+  if (frame.width != golden.width || frame.height != golden.height) {
+    message = "size " + std::to_string(frame.width) + "x" + std::to_string(frame.height) +
+              " differs from golden " + std::to_string(golden.width) + "x" +
+              std::to_string(golden.height);
+    return false;
+  }
+  std::vector<uint8_t> diff(golden.pixels.size());
+  std::size_t differing = 0;
+  int max_delta = 0;
+  for (int y = 0; y < frame.height; ++y) {
+    const uint8_t* row = frame.pixels + static_cast<std::ptrdiff_t>(frame.pitch) * y;
+    for (int x = 0; x < frame.width; ++x) {
+      std::size_t offset = (static_cast<std::size_t>(y) * frame.width + x) * 4;
+      int delta = 0;
+      for (int c = 0; c < 4; ++c) {
+        delta = std::max(delta, std::abs(row[x * 4 + c] - golden.pixels[offset + c]));
+      }
+      max_delta = std::max(max_delta, delta);
+      bool matches = delta <= options.tolerance;
+      differing += matches ? 0 : 1;
+      diff[offset] = matches ? 0 : 255;
+      diff[offset + 3] = 255;
+    }
+  }
+  double fraction =
+      static_cast<double>(differing) / (static_cast<double>(frame.width) * frame.height);
+  if (fraction <= options.max_differing) {
+    return true;
+  }
+  WriteFile(diff_path, OffscreenContext::EncodeQoi({diff.data(), frame.width, frame.height,
+                                                     frame.width * 4}));
+  std::ostringstream stream;
+  stream << differing << " pixels (" << fraction * 100 << "%) differ, max channel delta "
+         << max_delta;
+  message = stream.str();
+  return false;
+}
+
+int RunRenderCases(const Options& options) {
+  int failed = 0;
+  for (const RenderCase& test : GetRenderCases()) {
+    if (test.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    std::string golden_path = options.golden_dir + "/" + test.name + ".qoi";
+    std::string actual_path = options.output_dir + "/" + test.name + ".actual.qoi";
+    try {
+      OffscreenContext context(test.size, true);
+      test.draw(context);
+      OffscreenContext::Frame frame = context.GetFrame();
+      std::vector<uint8_t> encoded = OffscreenContext::EncodeQoi(frame);
+
+      if (options.update) {
+        WriteFile(golden_path, encoded);
+        std::cout << "[ UPDATED ] " << test.name << std::endl;
+        continue;
+      }
+      std::optional<std::vector<uint8_t>> data = ReadFile(golden_path);
+      if (!data) {
+        WriteFile(actual_path, encoded);
+        std::cout << "[ FAILED  ] " << test.name << ": no golden image, wrote " << actual_path
+                  << std::endl;
+        ++failed;
+        continue;
+      }
+      std::optional<Image> golden = DecodeQoi(*data);
+      std::string message = "golden image is corrupted";
+      if (golden && Compare(frame, *golden, options,
+                            options.output_dir + "/" + test.name + ".diff.qoi", message)) {
+        std::cout << "[   OK    ] " << test.name << std::endl;
+      } else {
+        WriteFile(actual_path, encoded);
+        std::cout << "[ FAILED  ] " << test.name << ": " << message << std::endl;
+        ++failed;
+      }
+    } catch (const std::exception& e) {
+      std::cout << "[ FAILED  ] " << test.name << ": " << e.what() << std::endl;
+      ++failed;
+    }
+  }
+  return failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+std::map<std::string, double> ReadBaseline(const std::string& path) {
+  std::map<std::string, double> baseline;
+  std::ifstream stream(path);
+  if (!stream) {
+    throw std::runtime_error("Failed to read the baseline " + path);
+  }
+  std::regex entry(R"re("name"\s*:\s*"([^"]+)".*"value"\s*:\s*([-+0-9.eE]+))re");
+  std::string line;
+  while (std::getline(stream, line)) {
+    std::smatch match;
+    if (std::regex_search(line, match, entry)) {
+      baseline[match[1]] = std::stod(match[2]);
+    }
+  }
+  return baseline;
+}
+
+int RunBenchmarks(const Options& options) {
+  std::map<std::string, double> baseline;
+  if (!options.baseline.empty()) {
+    baseline = ReadBaseline(options.baseline);
+  }
+  std::ofstream results(options.results);
+  results << "{\n  \"benchmarks\": [";
+  int regressions = 0;
+  int missing = 0;
+  bool first = true;
+  for (const Benchmark& benchmark : GetBenchmarks()) {
+    if (benchmark.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    OffscreenContext context(BENCHMARK_SIZE, true);
+    benchmark.run(context);  // Warm up caches and lazily created resources
+    double work = 0;
+    std::chrono::duration<double> elapsed{};
+    auto start = std::chrono::steady_clock::now();
+    while (elapsed.count() < options.min_time) {
+      work += benchmark.run(context);
+      context.GetFrame();
+      elapsed = std::chrono::steady_clock::now() - start;
+    }
+    double value = work / elapsed.count();
+
+    results << (first ? "\n" : ",\n") << "    {\"name\": \"" << benchmark.name
+            << "\", \"unit\": \"" << benchmark.unit << "\", \"value\": " << value << "}";
+    first = false;
+
+    std::cout << "[  BENCH  ] " << benchmark.name << ": " << value << " " << benchmark.unit;
+    auto it = baseline.find(benchmark.name);
+    if (it != baseline.end()) {
+      double change = value / it->second - 1.0;
+      std::cout << " (" << (change >= 0 ? "+" : "") << change * 100 << "% vs baseline)";
+      if (change < -options.threshold) {
+        std::cout << " REGRESSION";
+        ++regressions;
+      }
+    } else if (!options.baseline.empty()) {
+      std::cout << " NO BASELINE";
+      ++missing;
+    }
+    std::cout << std::endl;
+  }
+  results << "\n  ]\n}\n";
+  if (regressions > 0) {
+    std::cout << regressions << " benchmarks are slower than the baseline by more than "
+              << options.threshold * 100 << "%" << std::endl;
+  }
+  if (missing > 0) {
+    std::cout << missing << " benchmarks have no baseline result" << std::endl;
+  }
+  return regressions > 0 || missing > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+}  // namespace
+
+std::vector<RenderCase>& sdlxx::test::GetRenderCases() {
+  static std::vector<RenderCase> cases;
+  return cases;
+}
+
+std::vector<Benchmark>& sdlxx::test::GetBenchmarks() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+int main(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string argument = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << argument << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      return argv[++i];
+    };
+    if (argument == "--golden-dir") {
+      options.golden_dir = value();
+    } else if (argument == "--output-dir") {
+      options.output_dir = value();
+    } else if (argument == "--filter") {
+      options.filter = value();
+    } else if (argument == "--update") {
+      options.update = true;
+    } else if (argument == "--tolerance") {
+      options.tolerance = std::stoi(value());
+    } else if (argument == "--max-differing") {
+      options.max_differing = std::stod(value());
+    } else if (argument == "--benchmarks") {
+      options.benchmarks = true;
+    } else if (argument == "--min-time") {
+      options.min_time = std::stod(value());
+    } else if (argument == "--results") {
+      options.results = value();
+    } else if (argument == "--baseline") {
+      options.baseline = value();
+    } else if (argument == "--threshold") {
+      options.threshold = std::stod(value());
+    } else {
+      std::cerr << "Unknown argument " << argument << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  try {
+    return options.benchmarks ? RunBenchmarks(options) : RunRenderCases(options);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
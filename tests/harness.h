@@ -0,0 +1,102 @@
+/**
+ * \file
+ * \brief A minimal harness for image-diff and throughput tests of the rendering API.
+ *
+ * Test cases draw a frame with an OffscreenContext in deterministic mode, and the frame is
+ * compared with a golden QOI image. Benchmarks repeat an operation and report its throughput,
+ * which is written as JSON and compared with a baseline from a previous run.
+ *
+ * RunTests() runs the unit tests of the other test executables.
+ */
+
+#ifndef SDLXX_TESTS_HARNESS_H
+#define SDLXX_TESTS_HARNESS_H
+
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sdlxx/core/dimensions.h>
+#include <sdlxx/core/offscreen.h>
+
+namespace sdlxx::test {
+
+/// A test that draws a frame to compare with a golden image
+struct RenderCase {
+  std::string name;
+  Dimensions size;
+  std::function<void(OffscreenContext&)> draw;
+};
+
+/// A benchmark that returns the amount of work done, in units of its throughput
+struct Benchmark {
+  std::string name;
+  std::string unit;
+  std::function<double(OffscreenContext&)> run;
+};
+
+std::vector<RenderCase>& GetRenderCases();
+
+std::vector<Benchmark>& GetBenchmarks();
+
+/// A helper that registers test cases and benchmarks from static initializers
+struct Registrar {
+  Registrar(std::string name, Dimensions size, std::function<void(OffscreenContext&)> draw) {
+    GetRenderCases().push_back({std::move(name), size, std::move(draw)});
+  }
+
+  Registrar(std::string name, std::string unit, std::function<double(OffscreenContext&)> run) {
+    GetBenchmarks().push_back({std::move(name), std::move(unit), std::move(run)});
+  }
+};
+
+/// A unit test that returns whether it passed
+struct UnitTest {
+  std::string name;
+  std::function<bool()> run;
+};
+
+/**
+ * Run unit tests and print PASSED or FAILED for each of them. A test that throws fails, and the
+ * message of the exception is printed.
+ *
+ * \return EXIT_SUCCESS if all tests passed, EXIT_FAILURE otherwise.
+ */
+inline int RunTests(const std::vector<UnitTest>& tests) {
+  int failed = 0;
+  for (const UnitTest& test : tests) {
+    bool passed = false;
+    try {
+      passed = test.run();
+    } catch (const std::exception& e) {
+      std::cerr << test.name << ": " << e.what() << std::endl;
+    }
+    failed += passed ? 0 : 1;
+    std::cout << (passed ? "PASSED " : "FAILED ") << test.name << std::endl;
+  }
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace sdlxx::test
+
+#define SDLXX_CONCAT_IMPL(a, b) a##b
+#define SDLXX_CONCAT(a, b) SDLXX_CONCAT_IMPL(a, b)
+
+/// Register a function `void(OffscreenContext&)` that draws a frame of the given size
+#define RENDER_TEST(name, width, height)                                             \
+  static void SDLXX_CONCAT(render_test_, name)(sdlxx::OffscreenContext&);            \
+  static const sdlxx::test::Registrar SDLXX_CONCAT(render_test_registrar_, name){    \
+      #name, {width, height}, &SDLXX_CONCAT(render_test_, name)};                    \
+  static void SDLXX_CONCAT(render_test_, name)(sdlxx::OffscreenContext & context)
+
+/// Register a function `double(OffscreenContext&)` that returns the amount of work done
+#define RENDER_BENCHMARK(name, unit)                                                 \
+  static double SDLXX_CONCAT(render_benchmark_, name)(sdlxx::OffscreenContext&);     \
+  static const sdlxx::test::Registrar SDLXX_CONCAT(render_benchmark_registrar_, name){ \
+      #name, unit, &SDLXX_CONCAT(render_benchmark_, name)};                          \
+  static double SDLXX_CONCAT(render_benchmark_, name)(sdlxx::OffscreenContext & context)
+
+#endif  // SDLXX_TESTS_HARNESS_H
@@ -0,0 +1,100 @@
+// Check the FLAC decoder against the same audio stored as PCM in a WAV file. The FLAC file uses
+// every subframe type, stereo decorrelation and variable block sizes, and has a seek table.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sdlxx/mixer/audio_decoder.h>
+
+#include "harness.h"
+
+using namespace sdlxx;
+
+namespace {
+
+std::string directory;
+
+std::string GetPath(const std::string& name) { return directory + "/" + name; }
+
+// Decode in chunks of different sizes, so that chunks cross the blocks of the FLAC file
+std::vector<float> DecodeAll(AudioDecoder& decoder, std::size_t frames) {
+  std::vector<float> samples(frames * static_cast<std::size_t>(decoder.GetChannels()));
+  std::size_t decoded = 0;
+  for (std::size_t chunk = 1; decoded < frames; chunk = chunk * 3 + 1) {
+    std::size_t count = decoder.Decode(samples.data() + decoded * decoder.GetChannels(),
+                                       std::min(chunk, frames - decoded));
+    decoded += count;
+    if (count == 0) {
+      break;
+    }
+  }
+  samples.resize(decoded * static_cast<std::size_t>(decoder.GetChannels()));
+  return samples;
+}
+
+/// The whole file decodes to the same samples as the WAV file
+bool TestDecode() {
+  std::unique_ptr<AudioDecoder> flac = AudioDecoder::Open(GetPath("tone.flac"));
+  WavDecoder wav(GetPath("tone.wav"));
+  return dynamic_cast<FlacDecoder*>(flac.get()) != nullptr &&
+         flac->GetChannels() == wav.GetChannels() &&
+         flac->GetFrequency() == wav.GetFrequency() &&
+         flac->GetFrameCount() == wav.GetFrameCount() &&
+         DecodeAll(*flac, flac->GetFrameCount() + 1) == DecodeAll(wav, wav.GetFrameCount());
+}
+
+/// Seeking backwards, forwards and to the end continues at the same frames as the WAV file
+bool TestSeek() {
+  FlacDecoder flac(GetPath("tone.flac"));
+  WavDecoder wav(GetPath("tone.wav"));
+  for (std::size_t frame : {4000, 100, 11000, 0, 5555, 5556, 12000, 1}) {
+    flac.Seek(frame);
+    wav.Seek(frame);
+    if (DecodeAll(flac, 700) != DecodeAll(wav, 700)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// A truncated file is played up to its last complete frame
+bool TestTruncated() {
+  std::ifstream input(GetPath("tone.flac"), std::ios::binary);
+  std::vector<char> contents((std::istreambuf_iterator<char>(input)),
+                             std::istreambuf_iterator<char>());
+  std::string path = (std::filesystem::temp_directory_path() / "sdlxx_truncated.flac").string();
+  std::ofstream(path, std::ios::binary)
+      .write(contents.data(), static_cast<std::streamsize>(contents.size() / 2));
+
+  FlacDecoder flac(path);
+  WavDecoder wav(GetPath("tone.wav"));
+  std::vector<float> truncated = DecodeAll(flac, flac.GetFrameCount());
+  std::vector<float> complete = DecodeAll(wav, wav.GetFrameCount());
+  std::filesystem::remove(path);
+  return !truncated.empty() && truncated.size() < complete.size() &&
+         flac.GetFrameCount() * 2 == truncated.size() &&
+         std::equal(truncated.begin(), truncated.end(), complete.begin());
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: mixer_tests <directory with tone.flac and tone.wav>" << std::endl;
+    return EXIT_FAILURE;
+  }
+  directory = argv[1];
+  return test::RunTests({
+      {"flac_decode", TestDecode},
+      {"flac_seek", TestSeek},
+      {"flac_truncated", TestTruncated},
+  });
+}
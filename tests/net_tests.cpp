@@ -0,0 +1,108 @@
+// Check UdpConnection over links that lose chosen datagrams. Every case connects two
+// connections in one process, so the results do not depend on timing or on the network.
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sdlxx/net/udp_connection.h>
+
+#include "harness.h"
+
+using namespace sdlxx;
+
+namespace {
+
+/// One direction of a connection, which drops the datagrams with the given indices
+struct Link {
+  explicit Link(std::vector<std::size_t> dropped = {}) : dropped(std::move(dropped)) {}
+
+  std::vector<std::size_t> dropped;
+  std::size_t sent = 0;
+  std::deque<std::vector<uint8_t>> packets;
+
+  UdpConnection::PacketSender GetSender() {
+    return [this](const uint8_t* data, std::size_t size) {
+      bool drop = false;
+      for (std::size_t index : dropped) {
+        drop = drop || index == sent;
+      }
+      ++sent;
+      if (!drop) {
+        packets.emplace_back(data, data + size);
+      }
+    };
+  }
+
+  void Deliver(UdpConnection& connection, Time now) {
+    while (!packets.empty()) {
+      connection.ReceivePacket(packets.front().data(), packets.front().size(), now);
+      packets.pop_front();
+    }
+  }
+};
+
+std::vector<std::string> ReceiveAll(UdpConnection& connection) {
+  std::vector<std::string> messages;
+  while (std::optional<UdpConnection::Message> message = connection.Receive()) {
+    messages.push_back(std::move(message->data));
+  }
+  return messages;
+}
+
+/// A lost first packet must not be acknowledged by packets sent before the peer received any
+bool TestFirstPacketLost() {
+  Link a_to_b({0});
+  Link b_to_a;
+  UdpConnection a({Delivery::RELIABLE_ORDERED}, a_to_b.GetSender());
+  UdpConnection b({Delivery::RELIABLE_ORDERED}, b_to_a.GetSender());
+
+  a.Send(0, "hello");
+  a.Update(Time::Milliseconds(0));
+  b.Send(0, "reply");
+  b.Update(Time::Milliseconds(0));
+  b_to_a.Deliver(a, Time::Milliseconds(10));
+  if (!a.HasPendingReliable()) {
+    return false;
+  }
+
+  std::vector<std::string> received;
+  for (int32_t time = 20; time <= 2000 && received.empty(); time += 20) {
+    a.Update(Time::Milliseconds(time));
+    a_to_b.Deliver(b, Time::Milliseconds(time));
+    received = ReceiveAll(b);
+  }
+  return received == std::vector<std::string>{"hello"};
+}
+
+/// The largest message that fits in a packet of MAX_MTU is not mistaken for a fragment
+bool TestLargestMessage() {
+  Link link;
+  UdpConnection sender({Delivery::UNRELIABLE}, link.GetSender(), UdpConnection::MAX_MTU);
+  UdpConnection receiver({Delivery::UNRELIABLE}, [](const uint8_t*, std::size_t) {},
+                         UdpConnection::MAX_MTU);
+  std::string message(UdpConnection::MAX_MTU - 14, 'x');
+  sender.Send(0, message);
+  sender.Update(Time::Milliseconds(0));
+  link.Deliver(receiver, Time::Milliseconds(0));
+  if (link.sent != 1 || ReceiveAll(receiver) != std::vector<std::string>{message}) {
+    return false;
+  }
+  try {
+    UdpConnection({Delivery::UNRELIABLE}, link.GetSender(), UdpConnection::MAX_MTU + 1);
+  } catch (const UdpConnectionException&) {
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+int main() {
+  return test::RunTests({
+      {"udp_first_packet_lost", TestFirstPacketLost},
+      {"udp_largest_message", TestLargestMessage},
+  });
+}
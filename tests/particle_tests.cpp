@@ -0,0 +1,112 @@
+// Check the baked curves and the lifetime of particles. Particles are spawned with no speed and
+// stepped with fixed time steps, so every result is known exactly.
+
+#include <cmath>
+#include <cstdint>
+
+#include <sdlxx/particles.h>
+
+#include "harness.h"
+
+using namespace sdlxx;
+
+namespace {
+
+bool IsNear(float a, float b) { return std::abs(a - b) < 1e-4F; }
+
+bool IsChannelNear(uint8_t a, uint8_t b) { return std::abs(a - b) <= 1; }
+
+EmitterSettings MakeSettings() {
+  EmitterSettings settings;
+  settings.capacity = 64;
+  settings.rate = 0.0F;
+  settings.life_min = 1.0F;
+  settings.life_max = 1.0F;
+  settings.speed_min = 0.0F;
+  settings.speed_max = 0.0F;
+  settings.size = Curve({{0.0F, 2.0F}, {1.0F, 10.0F}});
+  return settings;
+}
+
+/// A curve is sampled linearly between its keys and is constant beyond the outer keys
+bool TestCurveBaking() {
+  Curve curve({{0.75F, 4.0F}, {0.25F, 0.0F}});
+  const auto& table = curve.GetTable();
+  for (std::size_t i = 0; i < CURVE_SAMPLES; ++i) {
+    float age = static_cast<float>(i) / static_cast<float>(CURVE_SAMPLES - 1);
+    float expected = age <= 0.25F ? 0.0F : age >= 0.75F ? 4.0F : (age - 0.25F) * 8.0F;
+    if (!IsNear(table[i], expected)) {
+      return false;
+    }
+  }
+  return IsNear(curve.Evaluate(0.5F), table[Curve::GetIndex(0.5F)]) &&
+         Curve::GetIndex(-1.0F) == 0 && Curve::GetIndex(2.0F) == CURVE_SAMPLES - 1;
+}
+
+/// A gradient interpolates every channel, including alpha
+bool TestGradientBaking() {
+  Gradient gradient({{0.0F, Color(0, 255, 0, 0)}, {1.0F, Color(200, 55, 100, 255)}});
+  const auto& table = gradient.GetTable();
+  for (std::size_t i = 0; i < CURVE_SAMPLES; ++i) {
+    float age = static_cast<float>(i) / static_cast<float>(CURVE_SAMPLES - 1);
+    Color color = table[i];
+    if (!IsChannelNear(color.r, static_cast<uint8_t>(std::lround(200.0F * age))) ||
+        !IsChannelNear(color.g, static_cast<uint8_t>(std::lround(255.0F - 200.0F * age))) ||
+        !IsChannelNear(color.b, static_cast<uint8_t>(std::lround(100.0F * age))) ||
+        !IsChannelNear(color.a, static_cast<uint8_t>(std::lround(255.0F * age)))) {
+      return false;
+    }
+  }
+  return table.front().a == 0 && table.back().a == 255;
+}
+
+/// Particles beyond the capacity are dropped, and the live ones take the sizes of their age
+bool TestBurst() {
+  Emitter emitter(MakeSettings());
+  emitter.Burst(100);
+  if (emitter.GetCount() != 64 || emitter.GetDroppedCount() != 36) {
+    return false;
+  }
+  emitter.Update(0.5F);
+  float expected = MakeSettings().size.Evaluate(0.5F);
+  for (std::size_t i = 0; i < emitter.GetCount(); ++i) {
+    if (!IsNear(emitter.GetSize(i), expected)) {
+      return false;
+    }
+  }
+  emitter.Update(0.625F);
+  return emitter.GetCount() == 0;
+}
+
+/// Removing dead particles moves the state of the survivors with them
+bool TestSwapRemove() {
+  Emitter emitter(MakeSettings());
+  emitter.SetPosition(10.0F, 20.0F);
+  emitter.Burst(10);
+  emitter.Update(0.625F);
+  emitter.SetPosition(100.0F, 200.0F);
+  emitter.Burst(5);
+  emitter.Update(0.5F);
+  if (emitter.GetCount() != 5) {
+    return false;
+  }
+  float expected = MakeSettings().size.Evaluate(0.5F);
+  for (std::size_t i = 0; i < emitter.GetCount(); ++i) {
+    if (emitter.GetX(i) != 100.0F || emitter.GetY(i) != 200.0F ||
+        !IsNear(emitter.GetSize(i), expected)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  return test::RunTests({
+      {"particle_curve_baking", TestCurveBaking},
+      {"particle_gradient_baking", TestGradientBaking},
+      {"particle_burst", TestBurst},
+      {"particle_swap_remove", TestSwapRemove},
+  });
+}
@@ -0,0 +1,379 @@
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <SDL_pixels.h>
+#include <sdlxx/core.h>
+
+#include "harness.h"
+
+using namespace sdlxx;
+
+namespace {
+
+/// A 64x64 RGBA32 image with opaque quadrants, a translucent center and a transparent corner
+Surface CreatePattern() {
+  Surface surface(64, 64, 32, SDL_PIXELFORMAT_RGBA32);
+  surface.FillRectangle({0, 0, 32, 32}, Color::RED);
+  surface.FillRectangle({32, 0, 32, 32}, Color::GREEN);
+  surface.FillRectangle({0, 32, 32, 32}, Color::BLUE);
+  surface.FillRectangle({32, 32, 32, 32}, Color::YELLOW);
+  surface.FillRectangle({16, 16, 32, 32}, Color(255, 255, 255, 128));
+  surface.FillRectangle({56, 56, 8, 8}, Color::TRANSPARENT);
+  return surface;
+}
+
+/// A deterministic pseudo-random generator, so frames do not depend on the standard library
+class Random {
+public:
+  int Next(int bound) {
+    state = state * 1103515245U + 12345U;
+    return static_cast<int>((state >> 16U) % static_cast<uint32_t>(bound));
+  }
+
+private:
+  uint32_t state = 1;
+};
+
+double Megapixels(int width, int height, int count) {
+  return static_cast<double>(width) * height * count / 1e6;
+}
+
+}  // namespace
+
+// Render cases
+
+RENDER_TEST(clear, 64, 64) {
+  context.GetRenderer().SetDrawColor(Color(0x336699));
+  context.GetRenderer().Clear();
+}
+
+RENDER_TEST(fill_rectangles, 128, 128) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLACK);
+  renderer.Clear();
+  renderer.SetDrawColor(Color::RED);
+  renderer.FillRectangle({8, 8, 48, 48});
+  renderer.SetDrawColor(Color::CYAN);
+  renderer.FillRectangles({{64, 8, 16, 16}, {88, 8, 32, 16}, {64, 32, 56, 24}});
+  renderer.SetDrawColor(Color::MAGENTA);
+  renderer.FillRectangle({-16, 100, 64, 64});  // Clipped by the edges
+}
+
+RENDER_TEST(draw_lines, 128, 128) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::WHITE);
+  renderer.Clear();
+  renderer.SetDrawColor(Color::BLACK);
+  for (int i = 0; i <= 128; i += 16) {
+    renderer.DrawLine({0, i}, {127, 127 - i});
+    renderer.DrawLine({i, 0}, {i / 2, 127});
+  }
+  renderer.SetDrawColor(Color::RED);
+  renderer.DrawLines({{10, 10}, {60, 20}, {30, 70}, {100, 110}});
+}
+
+RENDER_TEST(draw_points, 64, 64) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLACK);
+  renderer.Clear();
+  renderer.SetDrawColor(Color::GREEN);
+  std::vector<Point> points;
+  for (int i = 0; i < 64; ++i) {
+    points.push_back({i, (i * i) % 64});
+  }
+  renderer.DrawPoints(points);
+  renderer.DrawPoint({63, 0});
+}
+
+RENDER_TEST(draw_rectangles, 96, 96) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLACK);
+  renderer.Clear();
+  renderer.SetDrawColor(Color::YELLOW);
+  renderer.DrawRectangle({4, 4, 88, 88});
+  renderer.DrawRectangles({{10, 10, 1, 1}, {20, 20, 30, 2}, {40, 40, 2, 30}});
+}
+
+RENDER_TEST(viewport_and_clip, 128, 128) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLACK);
+  renderer.Clear();
+  renderer.SetViewport({32, 32, 64, 64});
+  renderer.SetDrawColor(Color::BLUE);
+  renderer.FillRectangle({-16, -16, 64, 64});
+  renderer.ResetViewport();
+  renderer.SetClipRectangle({0, 64, 128, 32});
+  renderer.SetDrawColor(Color::RED);
+  renderer.FillRectangle({16, 16, 96, 96});
+  renderer.ResetClipRectangle();
+}
+
+RENDER_TEST(texture_copy, 128, 128) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color(0x202020));
+  renderer.Clear();
+  Texture texture(renderer, CreatePattern());
+  renderer.Copy(texture, {0, 0, 64, 64});
+  renderer.Copy(texture, {16, 16, 32, 32}, {64, 0, 64, 64});
+  renderer.Copy(texture, {0, 64, 128, 64});
+}
+
+RENDER_TEST(texture_copy_rotated, 128, 128) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLACK);
+  renderer.Clear();
+  Texture texture(renderer, CreatePattern());
+  renderer.Copy(texture, {32, 32, 64, 64}, 30.0);
+  renderer.Copy(texture, {0, 0, 32, 32}, 0.0, Renderer::Flip::HORIZONTAL);
+  renderer.Copy(texture, {96, 96, 32, 32}, 90.0, Renderer::Flip::VERTICAL);
+}
+
+RENDER_TEST(texture_blend_modes, 128, 64) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color(0x808080));
+  renderer.Clear();
+  Texture texture(renderer, CreatePattern());
+  const BlendMode modes[] = {BlendMode::NONE, BlendMode::BLEND, BlendMode::ADD, BlendMode::MOD};
+  for (int i = 0; i < 4; ++i) {
+    texture.SetBlendMode(modes[i]);
+    renderer.Copy(texture, {i * 32, 0, 32, 32});
+    texture.SetAlphaModulation(128);
+    renderer.Copy(texture, {i * 32, 32, 32, 32});
+    texture.SetAlphaModulation(255);
+  }
+}
+
+RENDER_TEST(texture_color_modulation, 64, 64) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLACK);
+  renderer.Clear();
+  Texture texture(renderer, CreatePattern());
+  texture.SetColorModulation(Color(0x80FF40));
+  renderer.Copy(texture);
+}
+
+RENDER_TEST(geometry, 128, 128) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLACK);
+  renderer.Clear();
+  if (!Renderer::IsGeometrySupported()) {
+    return;
+  }
+  Texture texture(renderer, CreatePattern());
+  const Renderer::Vertex triangle[] = {{64.0F, 8.0F, Color::RED, 0.0F, 0.0F},
+                                       {120.0F, 120.0F, Color::GREEN, 0.0F, 0.0F},
+                                       {8.0F, 120.0F, Color::BLUE, 0.0F, 0.0F}};
+  renderer.RenderGeometry(nullptr, triangle, 3);
+  const Renderer::Vertex quad[] = {{16.0F, 16.0F, Color::WHITE, 0.0F, 0.0F},
+                                   {48.0F, 16.0F, Color::WHITE, 1.0F, 0.0F},
+                                   {48.0F, 48.0F, Color::WHITE, 1.0F, 1.0F},
+                                   {16.0F, 48.0F, Color::WHITE, 0.0F, 1.0F}};
+  const int indices[] = {0, 1, 2, 0, 2, 3};
+  renderer.RenderGeometry(&texture, quad, 4, indices, 6);
+}
+
+RENDER_TEST(sprite_batch, 128, 128) {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLACK);
+  renderer.Clear();
+  Texture texture(renderer, CreatePattern());
+  SpriteBatch batch(renderer);
+  for (int i = 0; i < 16; ++i) {
+    auto position = static_cast<float>(i * 8);
+    batch.Draw(texture, {0, 0, 64, 64}, position, position, 16.0F, 16.0F, i * 22.5F,
+               Color(255, 255, static_cast<uint8_t>(i * 16)));
+  }
+  batch.Flush();
+}
+
+RENDER_TEST(surface_fill_and_blit, 128, 128) {
+  Surface& target = context.GetSurface();
+  target.Fill(Color(0x404040));
+  target.FillRectangles({{0, 0, 16, 16}, {112, 112, 16, 16}}, Color::WHITE);
+  Surface pattern = CreatePattern();
+  target.Blit(pattern, {0, 0, 64, 64}, {8, 40, 64, 64});
+  target.BlitScaled(pattern, {0, 0, 64, 64}, {64, 8, 48, 96});
+}
+
+RENDER_TEST(tile_renderer, 200, 150) {
+  Surface& target = context.GetSurface();
+  ThreadPool pool;
+  TileRenderer tiles(target, pool);
+  Surface pattern = CreatePattern();
+  tiles.SetDrawColor(Color(0x102030));
+  tiles.Clear();
+  tiles.SetDrawBlendMode(BlendMode::BLEND);
+  tiles.SetDrawColor(Color(255, 0, 0, 128));
+  tiles.FillRectangle({10, 10, 150, 100});
+  tiles.SetDrawBlendMode(BlendMode::ADD);
+  tiles.SetDrawColor(Color(0, 128, 255, 200));
+  tiles.DrawLine({0, 149}, {199, 0});
+  tiles.DrawRectangle({60, 60, 130, 80});
+  tiles.Copy(pattern, {0, 0, 64, 64}, {100, 20, 96, 96});
+  tiles.Present();
+}
+
+RENDER_TEST(tile_renderer_matches_software_renderer, 160, 120) {
+  // The software renderer draws the reference, that is then compared with the tile renderer
+  Renderer& renderer = context.GetRenderer();
+  Surface pattern = CreatePattern();
+  Texture texture(renderer, pattern);
+  texture.SetBlendMode(BlendMode::BLEND);
+  renderer.SetDrawColor(Color(0x305070));
+  renderer.Clear();
+  renderer.SetDrawColor(Color::YELLOW);
+  renderer.FillRectangle({5, 5, 70, 40});
+  renderer.DrawLine({0, 0}, {159, 119});
+  renderer.Copy(texture, {0, 0, 64, 64}, {80, 40, 64, 64});
+  OffscreenContext::Frame reference = context.GetFrame();
+
+  Surface copy(160, 120, 32, SDL_PIXELFORMAT_RGBA32);
+  ThreadPool pool;
+  TileRenderer tiles(copy, pool);
+  tiles.SetDrawColor(Color(0x305070));
+  tiles.Clear();
+  tiles.SetDrawColor(Color::YELLOW);
+  tiles.FillRectangle({5, 5, 70, 40});
+  tiles.DrawLine({0, 0}, {159, 119});
+  tiles.Copy(pattern, {0, 0, 64, 64}, {80, 40, 64, 64});
+  tiles.Present();
+
+  // Lines and blending may round differently, so a few pixels are allowed to differ
+  const auto* pixels = static_cast<const uint8_t*>(copy.GetPixels());
+  int differing = 0;
+  for (int y = 0; y < reference.height; ++y) {
+    for (int x = 0; x < reference.width; ++x) {
+      for (int c = 0; c < 4; ++c) {
+        int delta = reference.pixels[y * reference.pitch + x * 4 + c] -
+                    pixels[y * copy.GetPitch() + x * 4 + c];
+        if (std::abs(delta) > 2) {
+          ++differing;
+          break;
+        }
+      }
+    }
+  }
+  if (differing > reference.width * reference.height / 100) {
+    throw std::runtime_error(std::to_string(differing) + " pixels differ from the renderer");
+  }
+}
+
+RENDER_TEST(tile_renderer_without_alpha, 160, 120) {
+  // On a target without an alpha channel, translucent fills and lines blend with the alpha of the
+  // drawing color, so the colors match those drawn on an opaque target with an alpha channel
+  ThreadPool pool;
+  auto draw = [&pool](Surface& target) {
+    TileRenderer tiles(target, pool);
+    tiles.SetDrawColor(Color(0x305070));
+    tiles.Clear();
+    tiles.SetDrawBlendMode(BlendMode::BLEND);
+    tiles.SetDrawColor(Color(255, 0, 0, 128));
+    tiles.FillRectangle({10, 10, 100, 70});
+    tiles.SetDrawBlendMode(BlendMode::ADD);
+    tiles.SetDrawColor(Color(0, 128, 255, 100));
+    tiles.FillRectangle({60, 40, 90, 70});
+    tiles.DrawLine({0, 119}, {159, 0});
+    tiles.Present();
+  };
+  Surface reference(160, 120, 32, SDL_PIXELFORMAT_ARGB8888);
+  draw(reference);
+  Surface target(160, 120, 32, SDL_PIXELFORMAT_RGB888);
+  draw(target);
+
+  // Both formats store blue, green and red in the same bytes, the fourth byte is ignored
+  const auto* expected = static_cast<const uint8_t*>(reference.GetPixels());
+  const auto* actual = static_cast<const uint8_t*>(target.GetPixels());
+  for (int y = 0; y < 120; ++y) {
+    for (int x = 0; x < 160; ++x) {
+      for (int c = 0; c < 3; ++c) {
+        if (expected[y * reference.GetPitch() + x * 4 + c] !=
+            actual[y * target.GetPitch() + x * 4 + c]) {
+          throw std::runtime_error("pixel " + std::to_string(x) + "," + std::to_string(y) +
+                                   " differs from the target with alpha");
+        }
+      }
+    }
+  }
+  context.GetSurface().Blit(target);
+}
+
+// Benchmarks
+
+RENDER_BENCHMARK(clear, "MPix/s") {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::BLUE);
+  for (int i = 0; i < 10; ++i) {
+    renderer.Clear();
+  }
+  Dimensions size = context.GetSize();
+  return Megapixels(size.width, size.height, 10);
+}
+
+RENDER_BENCHMARK(fill_rate_opaque, "MPix/s") {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::RED);
+  Random random;
+  for (int i = 0; i < 100; ++i) {
+    renderer.FillRectangle({random.Next(1024), random.Next(464), 256, 256});
+  }
+  return Megapixels(256, 256, 100);
+}
+
+RENDER_BENCHMARK(lines, "klines/s") {
+  Renderer& renderer = context.GetRenderer();
+  renderer.SetDrawColor(Color::WHITE);
+  Random random;
+  for (int i = 0; i < 1000; ++i) {
+    renderer.DrawLine({random.Next(1280), random.Next(720)}, {random.Next(1280), random.Next(720)});
+  }
+  return 1.0;
+}
+
+RENDER_BENCHMARK(texture_copy, "ksprites/s") {
+  Renderer& renderer = context.GetRenderer();
+  Texture texture(renderer, CreatePattern());
+  Random random;
+  for (int i = 0; i < 1000; ++i) {
+    renderer.Copy(texture, {random.Next(1216), random.Next(656), 64, 64});
+  }
+  return 1.0;
+}
+
+RENDER_BENCHMARK(sprite_batch, "ksprites/s") {
+  Renderer& renderer = context.GetRenderer();
+  Texture texture(renderer, CreatePattern());
+  SpriteBatch batch(renderer, 1000);
+  Random random;
+  for (int i = 0; i < 1000; ++i) {
+    batch.Draw(texture, {0, 0, 64, 64}, static_cast<float>(random.Next(1216)),
+               static_cast<float>(random.Next(656)), 64.0F, 64.0F);
+  }
+  batch.Flush();
+  return 1.0;
+}
+
+RENDER_BENCHMARK(surface_blit, "MPix/s") {
+  static Surface pattern = CreatePattern();
+  Surface& target = context.GetSurface();
+  Random random;
+  for (int i = 0; i < 1000; ++i) {
+    target.Blit(pattern, {0, 0, 64, 64}, {random.Next(1216), random.Next(656), 64, 64});
+  }
+  return Megapixels(64, 64, 1000);
+}
+
+RENDER_BENCHMARK(tile_renderer_fill_rate, "MPix/s") {
+  static ThreadPool pool;
+  TileRenderer tiles(context.GetSurface(), pool);
+  tiles.SetDrawBlendMode(BlendMode::BLEND);
+  tiles.SetDrawColor(Color(255, 0, 0, 128));
+  Random random;
+  for (int i = 0; i < 100; ++i) {
+    tiles.FillRectangle({random.Next(1024), random.Next(464), 256, 256});
+  }
+  tiles.Present();
+  return Megapixels(256, 256, 100);
+}
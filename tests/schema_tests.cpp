@@ -0,0 +1,169 @@
+// Check that values survive a round trip through the bit streams, the deltas of a Schema and
+// the snapshot encoder and decoder, including values that do not fit into their fields.
+
+#include <cstdint>
+#include <vector>
+
+#include <sdlxx/net/bit_stream.h>
+#include <sdlxx/net/schema.h>
+#include <sdlxx/net/snapshot.h>
+
+#include "harness.h"
+
+using namespace sdlxx;
+
+namespace {
+
+struct Player {
+  float x;
+  float y;
+  uint8_t health;
+  int32_t score;
+  bool alive;
+  uint16_t team;
+};
+
+// The health field has 7 bits, so health above 127 must not overwrite the score
+using PlayerSchema = Schema<Player, Field<&Player::x, Codec::Quantized<-1024, 1024, 16>>,
+                            Field<&Player::y, Codec::Quantized<-1024, 1024, 16>>,
+                            Field<&Player::health, Codec::Unsigned<uint8_t, 7>>,
+                            Field<&Player::score, Codec::VarInt<int32_t>>,
+                            Field<&Player::alive, Codec::Bool>,
+                            Field<&Player::team, Codec::Unsigned<uint16_t, 3>>>;
+
+/// The state that a receiver sees, with fields that do not fit cut to their bits
+Player Encoded(Player player) {
+  player.health &= 0x7FU;
+  player.team &= 0x7U;
+  return player;
+}
+
+bool Same(const Player& a, const Player& b) {
+  return PlayerSchema::Equal(a, b) && a.health == b.health && a.team == b.team;
+}
+
+/// Every kind of value reads back as written, and reading past the end throws
+bool TestBitStream() {
+  BitWriter writer;
+  writer.WriteBits(5, 3);
+  writer.WriteBool(true);
+  writer.WriteBits(0xDEADBEEFU, 32);
+  writer.WriteVarUint(300);
+  writer.WriteVarUint(UINT64_MAX);
+  writer.WriteVarInt(-70000);
+  writer.WriteFloat(-1.5F);
+  writer.WriteQuantized(0.25F, 0.0F, 1.0F, 8);
+  writer.AlignToByte();
+  writer.WriteBits(1, 1);
+  const std::vector<uint8_t>& data = writer.GetData();
+
+  BitReader reader(data.data(), data.size());
+  bool same = reader.ReadBits(3) == 5 && reader.ReadBool() && reader.ReadBits(32) == 0xDEADBEEFU &&
+              reader.ReadVarUint() == 300 && reader.ReadVarUint() == UINT64_MAX &&
+              reader.ReadVarInt() == -70000 && reader.ReadFloat() == -1.5F &&
+              reader.ReadQuantized(0.0F, 1.0F, 8) == 64.0F / 255.0F;
+  reader.AlignToByte();
+  same = same && reader.ReadBits(1) == 1;
+  reader.AlignToByte();
+  try {
+    reader.ReadBits(1);
+  } catch (const BitStreamException&) {
+    return same;
+  }
+  return false;
+}
+
+/// Fields that are too large for their bits keep only their low bits and leave the next field
+/// intact, and values with the same low bits have the same encoding
+bool TestUnsignedMask() {
+  Player player{1.0F, 2.0F, 200, -5, true, 13};
+  BitWriter writer;
+  PlayerSchema::Write(writer, player);
+  const std::vector<uint8_t>& data = writer.GetData();
+  BitReader reader(data.data(), data.size());
+  Player read{};
+  PlayerSchema::Read(reader, read);
+  Player other = player;
+  other.health = 72;
+  other.team = 5;
+  return Same(read, Encoded(player)) && read.score == -5 && read.alive &&
+         PlayerSchema::Equal(player, other);
+}
+
+/// A delta applied to its baseline gives the new value, and unchanged fields take one bit
+bool TestSchemaDelta() {
+  Player baseline{10.0F, -20.0F, 100, 1000, true, 1};
+  std::vector<Player> values = {
+      {10.0F, -20.0F, 100, 1000, true, 1},
+      {11.0F, -20.0F, 100, 995, true, 1},
+      {11.0F, 500.0F, 255, -1000000, false, 9},
+      {-1024.0F, 1024.0F, 0, 0, true, 0},
+  };
+  for (const Player& value : values) {
+    BitWriter writer;
+    PlayerSchema::WriteDelta(writer, baseline, value);
+    const std::vector<uint8_t>& data = writer.GetData();
+    BitReader reader(data.data(), data.size());
+    Player read{};
+    PlayerSchema::ReadDelta(reader, Encoded(baseline), read);
+    if (!Same(read, Encoded(value)) || read.score != value.score || read.alive != value.alive) {
+      return false;
+    }
+  }
+  BitWriter unchanged;
+  PlayerSchema::WriteDelta(unchanged, baseline, values[0]);
+  return unchanged.GetBitCount() == PlayerSchema::FIELD_COUNT;
+}
+
+/// Snapshots with added, changed and removed entities decode to the encoded ones, with deltas to
+/// the confirmed snapshots and full snapshots while nothing is confirmed
+bool TestSnapshots() {
+  std::vector<Snapshot<Player>> snapshots(6);
+  snapshots[0].entities = {{1, {0.0F, 0.0F, 100, 0, true, 0}}, {5, {5.0F, 5.0F, 150, 7, true, 2}}};
+  snapshots[1].entities = {{1, {1.0F, 0.0F, 100, 0, true, 0}}, {5, {5.0F, 5.0F, 150, 7, true, 2}},
+                           {9, {-3.0F, 8.0F, 90, -2, true, 12}}};
+  snapshots[2].entities = {{5, {5.0F, 6.0F, 140, 8, true, 2}},
+                           {9, {-3.0F, 8.0F, 90, -2, true, 12}}};
+  snapshots[3].entities = {{5, {5.0F, 6.0F, 12, 8, true, 2}}, {9, {-3.0F, 8.0F, 90, -2, false, 4}},
+                           {1000, {0.0F, 0.0F, 255, 0, true, 7}}};
+  snapshots[4].entities = {};
+  snapshots[5].entities = {{2, {2.0F, 2.0F, 2, 2, true, 2}}};
+
+  SnapshotEncoder<PlayerSchema> encoder(4);
+  SnapshotDecoder<PlayerSchema> decoder(4);
+  for (std::size_t i = 0; i < snapshots.size(); ++i) {
+    snapshots[i].sequence = static_cast<uint32_t>(i + 1);
+    BitWriter writer;
+    encoder.Encode(writer, snapshots[i]);
+    const std::vector<uint8_t>& data = writer.GetData();
+    BitReader reader(data.data(), data.size());
+    const Snapshot<Player>& decoded = decoder.Decode(reader);
+    if (decoded.sequence != snapshots[i].sequence ||
+        decoded.entities.size() != snapshots[i].entities.size()) {
+      return false;
+    }
+    for (std::size_t e = 0; e < decoded.entities.size(); ++e) {
+      const auto& expected = snapshots[i].entities[e];
+      if (decoded.entities[e].id != expected.id ||
+          !Same(decoded.entities[e].state, Encoded(expected.state))) {
+        return false;
+      }
+    }
+    // The second snapshot is lost on the way back, so the third is based on the first
+    if (i != 1) {
+      encoder.Acknowledge(decoded.sequence);
+    }
+  }
+  return encoder.GetBaselineSequence() == snapshots.back().sequence;
+}
+
+}  // namespace
+
+int main() {
+  return test::RunTests({
+      {"bit_stream", TestBitStream},
+      {"schema_unsigned_mask", TestUnsignedMask},
+      {"schema_delta", TestSchemaDelta},
+      {"snapshot", TestSnapshots},
+  });
+}
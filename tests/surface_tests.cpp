@@ -0,0 +1,90 @@
+// Check the copy-on-write sharing of Surface pixels. Every case writes through one surface or
+// pointer and checks which copies see the write.
+
+#include <cstdint>
+
+#include <SDL_pixels.h>
+#include <sdlxx/core/image_processor.h>
+#include <sdlxx/core/pixel_view.h>
+#include <sdlxx/core/surface.h>
+#include <sdlxx/core/thread_pool.h>
+
+#include "harness.h"
+
+using namespace sdlxx;
+
+namespace {
+
+using View = PixelView<PixelFormat::RGBA8888>;
+using ConstView = ConstPixelView<PixelFormat::RGBA8888>;
+
+Surface CreateSurface() {
+  Surface surface(4, 4, 32, SDL_PIXELFORMAT_RGBA8888);
+  surface.Fill(Color::RED);
+  return surface;
+}
+
+bool IsRed(const Surface& surface) {
+  return ConstView(surface)(0, 0) == PixelFormat::RGBA8888::Pack(Color::RED);
+}
+
+/// Copies share the pixels until one of them is modified
+bool TestCopyOnWrite() {
+  Surface surface = CreateSurface();
+  Surface copy = surface;
+  bool shared = surface.IsShared() && copy.IsShared();
+  surface.Fill(Color::BLUE);
+  return shared && !surface.IsShared() && IsRed(copy) && !IsRed(surface);
+}
+
+/// A copy made after the pixel pointer was taken does not see writes through the pointer
+bool TestPixelsPointer() {
+  Surface surface = CreateSurface();
+  void* pixels = surface.GetPixels();
+  Surface copy = surface;
+  *static_cast<uint32_t*>(pixels) = PixelFormat::RGBA8888::Pack(Color::BLUE);
+  return IsRed(copy) && !IsRed(surface);
+}
+
+/// The same for a writable view made before the copy
+bool TestPixelView() {
+  Surface surface = CreateSurface();
+  View view(surface);
+  Surface copy = surface;
+  view.SetColor(0, 0, Color::BLUE);
+  return IsRed(copy) && !IsRed(surface);
+}
+
+/// A locked surface may be written through a pointer taken at any time, so it is not shared
+bool TestLock() {
+  Surface surface = CreateSurface();
+  SurfaceLock lock(surface);
+  Surface copy = surface;
+  return !surface.IsShared() && !copy.IsShared();
+}
+
+/// Results of the image processor and surfaces blurred in place are still shared by their copies,
+/// and a blur in place does not change the copies
+bool TestImageProcessor() {
+  ThreadPool pool(1);
+  ImageProcessor processor(pool);
+  Surface surface = CreateSurface();
+  Surface resized = processor.Resize(surface, {8, 8});
+  Surface resized_copy = resized;
+  Surface copy = surface;
+  processor.BoxBlur(surface, 1);
+  Surface blurred_copy = surface;
+  return resized_copy.IsShared() && blurred_copy.IsShared() && IsRed(copy) && IsRed(surface);
+}
+
+}  // namespace
+
+int main() {
+  return test::RunTests({
+      {"surface_copy_on_write", TestCopyOnWrite},
+      {"surface_pixels_pointer", TestPixelsPointer},
+      {"surface_pixel_view", TestPixelView},
+      {"surface_lock", TestLock},
+      {"surface_image_processor", TestImageProcessor},
+  });
+}
@@ -0,0 +1,151 @@
+// Check the TimerWheel with a fake clock that advances one tick at a time, including timers that
+// cross the boundaries of the levels and callbacks that cancel, reschedule or throw.
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <sdlxx/core/timer_wheel.h>
+
+#include "harness.h"
+
+using namespace sdlxx;
+
+namespace {
+
+/// The duration of the specified number of ticks, which are 1 ms long in all tests
+Time Ticks(uint64_t count) { return Time::Microseconds(static_cast<int64_t>(count) * 1000); }
+
+/// Timers fire exactly at their expiry tick, also when they are cascaded from the upper levels
+bool TestLevels() {
+  TimerWheel wheel(Ticks(1));
+  const std::vector<uint64_t> delays = {1,     2,     255,   256,   257,   511,   512,
+                                        65535, 65536, 65537, 65792, 70000, (1U << 24) + 3};
+  std::vector<uint64_t> fired_at(delays.size(), 0);
+  std::vector<int> calls(delays.size(), 0);
+  uint64_t tick = 0;
+  for (std::size_t i = 0; i < delays.size(); ++i) {
+    wheel.Schedule(Ticks(delays[i]), [&, i]() {
+      fired_at[i] = tick;
+      ++calls[i];
+    });
+  }
+  while (tick < 70001) {
+    ++tick;
+    wheel.Advance(Ticks(1));
+  }
+  // Jump close to the timer of the top level, and then continue one tick at a time
+  const uint64_t far = delays.back();
+  wheel.Advance(Ticks(far - 2 - tick));
+  tick = far - 2;
+  if (calls.back() != 0 || wheel.GetSize() != 1) {
+    return false;
+  }
+  while (tick < far + 1) {
+    ++tick;
+    wheel.Advance(Ticks(1));
+  }
+  for (std::size_t i = 0; i < delays.size(); ++i) {
+    if (calls[i] != 1 || fired_at[i] != delays[i]) {
+      return false;
+    }
+  }
+  return wheel.GetSize() == 0;
+}
+
+/// A callback cancels another timer that expired in the same tick, and a periodic timer
+/// cancels itself, so neither fires again
+bool TestCancelDuringFiring() {
+  TimerWheel wheel(Ticks(1));
+  int first_calls = 0;
+  int second_calls = 0;
+  TimerWheel::Handle first;
+  TimerWheel::Handle second;
+  // The order of timers within a tick is unspecified, so each one cancels the other
+  first = wheel.Schedule(Ticks(300), [&]() {
+    ++first_calls;
+    wheel.Cancel(second);
+  });
+  second = wheel.Schedule(Ticks(300), [&]() {
+    ++second_calls;
+    wheel.Cancel(first);
+  });
+  int periodic_calls = 0;
+  TimerWheel::Handle periodic;
+  periodic = wheel.Schedule(Ticks(100), [&]() {
+    if (++periodic_calls == 3) {
+      wheel.Cancel(periodic);
+    }
+  }, Ticks(100));
+  for (int i = 0; i < 1000; ++i) {
+    wheel.Advance(Ticks(1));
+  }
+  return first_calls + second_calls == 1 && periodic_calls == 3 && !wheel.IsScheduled(first) &&
+         !wheel.IsScheduled(second) && !wheel.IsScheduled(periodic) && !wheel.Cancel(periodic) &&
+         wheel.GetSize() == 0;
+}
+
+/// Periodic timers are rescheduled across the level boundary, and a timer scheduled from a
+/// callback fires on a later tick, not in the tick that is being fired
+bool TestReschedule() {
+  TimerWheel wheel(Ticks(1));
+  uint64_t tick = 0;
+  std::vector<uint64_t> periodic_ticks;
+  std::vector<uint64_t> chained_ticks;
+  TimerWheel::Handle periodic =
+      wheel.Schedule(Ticks(200), [&]() { periodic_ticks.push_back(tick); }, Ticks(300));
+  std::function<void()> chain = [&]() {
+    chained_ticks.push_back(tick);
+    if (chained_ticks.size() < 3) {
+      wheel.Schedule(Time{}, chain);
+    }
+  };
+  wheel.Schedule(Ticks(255), chain);
+  while (tick < 1000) {
+    ++tick;
+    wheel.Advance(Ticks(1));
+  }
+  return periodic_ticks == std::vector<uint64_t>{200, 500, 800} &&
+         chained_ticks == std::vector<uint64_t>{255, 256, 257} && wheel.IsScheduled(periodic) &&
+         wheel.GetSize() == 1;
+}
+
+/// An exception from a callback reaches the caller, the timer that threw is released or
+/// rescheduled, and the other timers of the same tick still fire
+bool TestThrowingCallback() {
+  TimerWheel wheel(Ticks(1));
+  int periodic_calls = 0;
+  int other_calls = 0;
+  TimerWheel::Handle once = wheel.Schedule(Ticks(10), []() { throw std::runtime_error("once"); });
+  TimerWheel::Handle periodic = wheel.Schedule(Ticks(20), [&]() {
+    ++periodic_calls;
+    throw std::runtime_error("periodic");
+  }, Ticks(20));
+  wheel.Schedule(Ticks(10), [&]() { ++other_calls; });
+  wheel.Schedule(Ticks(20), [&]() { ++other_calls; });
+
+  int thrown = 0;
+  for (int i = 0; i < 50; ++i) {
+    try {
+      wheel.Advance(Ticks(1));
+    } catch (const std::runtime_error&) {
+      ++thrown;
+    }
+  }
+  // The one-shot timer throws at 10 and the periodic one at 20 and 40
+  return thrown == 3 && other_calls == 2 && periodic_calls == 2 && !wheel.IsScheduled(once) &&
+         !wheel.Cancel(once) && wheel.IsScheduled(periodic) && wheel.GetSize() == 1 &&
+         wheel.Cancel(periodic) && wheel.GetSize() == 0;
+}
+
+}  // namespace
+
+int main() {
+  return test::RunTests({
+      {"timer_wheel_levels", TestLevels},
+      {"timer_wheel_cancel_during_firing", TestCancelDuringFiring},
+      {"timer_wheel_reschedule", TestReschedule},
+      {"timer_wheel_throwing_callback", TestThrowingCallback},
+  });
+}